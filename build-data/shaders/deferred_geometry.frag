@@ -1,17 +1,21 @@
 #version 450
 
+#extension GL_GOOGLE_include_directive : enable
+#include "gbuffer.include"
+
 layout( early_fragment_tests ) in;
+layout( constant_id = 0 ) const uint NUM_SAMPLES = 1;
 
 layout( location = 0 ) in vec3 inPosition;
 layout( location = 1 ) in vec3 inNormal;
 
-layout( location = 0 ) out vec4 outPosition;
-layout( location = 1 ) out vec4 outNormal;
-layout( location = 2 ) out vec4 outColor;
+layout( location = 0 ) out vec4 outColor;
+layout( location = 1 ) out vec2 outNormal;
 
 void main()
 {
-	outPosition = vec4( inPosition, 1.0F );
-	outNormal   = vec4( inNormal, 1.0F );
-	outColor    = vec4( vec3(1.0F), gl_SampleMaskIn[0] == 255 ? 0.0F : 1.0F );
+	// alpha marks pixels the primitive only covers partly, the edge detection shades them per sample
+	const uint fullMask = ( 1u << NUM_SAMPLES ) - 1u;
+	outColor  = vec4( vec3(1.0F), uint( gl_SampleMaskIn[0] ) == fullMask ? 0.0F : 1.0F );
+	outNormal = encodeNormal( normalize( inNormal ) );
 }
\ No newline at end of file
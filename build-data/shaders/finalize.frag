@@ -5,7 +5,15 @@ layout( location = 0 ) in vec2 inUV;
 
 layout (set = 0, binding = 0) uniform sampler2D superRender;
 
+// rendered part of the texture
+layout( push_constant ) uniform PushConstants
+{
+	vec2 uvScale;
+} push;
+
 void main()
 {
-	outColor = texture( superRender, inUV );
+	// the filter must not reach the texels outside of the rendered part
+	const vec2 uvMax = push.uvScale - 0.5F / vec2( textureSize( superRender, 0 ) );
+	outColor = texture( superRender, min( inUV * push.uvScale, uvMax ) );
 }
\ No newline at end of file
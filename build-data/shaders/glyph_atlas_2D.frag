@@ -0,0 +1,58 @@
+#version 450
+
+layout( constant_id = 0 ) const float texelPerEm = 32.0F;
+layout( constant_id = 1 ) const float distanceRange = 0.125F;
+
+layout( location = 0 ) out vec4 color;
+layout( location = 0 ) in vec2 uv;
+
+struct AtlasEntry
+{
+	uint texelOffset;
+	uint width;
+	uint height;
+	float originX;
+	float originY;
+};
+
+layout( set = 1, binding = 0 ) buffer readonly GlyphAtlasEntries
+{
+	readonly AtlasEntry entries[];
+};
+
+layout( set = 1, binding = 1 ) buffer readonly GlyphAtlasTexels
+{
+	readonly uint texels[];
+};
+
+layout( location = 1 ) flat in uint glyphIndex;
+layout( location = 2 ) flat in vec4 glyphColor;
+layout( location = 3 ) flat in float pixelPerEm;
+
+float readTexel( const AtlasEntry entry, ivec2 position )
+{
+	position = clamp( position, ivec2( 0 ), ivec2( entry.width, entry.height ) - 1 );
+	const uint index = entry.texelOffset + uint( position.y ) * entry.width + uint( position.x );
+	return float( ( texels[index >> 2] >> ( 8u * ( index & 3u ) ) ) & 0xFFu ) / 255.0F;
+}
+
+void main()
+{
+	const AtlasEntry entry = entries[glyphIndex];
+	if( entry.width == 0 )
+	{
+		discard;
+	}
+	
+	// bilinear filter between the four nearest texel centers
+	const vec2 position = ( uv - vec2( entry.originX, entry.originY ) ) * texelPerEm - 0.5F;
+	const ivec2 base = ivec2( floor( position ) );
+	const vec2 weight = position - floor( position );
+	
+	const float bottom = mix( readTexel( entry, base ), readTexel( entry, base + ivec2( 1, 0 ) ), weight.x );
+	const float top = mix( readTexel( entry, base + ivec2( 0, 1 ) ), readTexel( entry, base + ivec2( 1, 1 ) ), weight.x );
+	
+	// signed distance in em, positive inside the glyph
+	const float distance = ( mix( bottom, top, weight.y ) - 0.5F ) * 2.0F * distanceRange;
+	color = vec4( glyphColor.rgb, glyphColor.a * clamp( distance * pixelPerEm + 0.5F, 0.0F, 1.0F ) );
+}
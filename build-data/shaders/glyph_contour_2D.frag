@@ -1,28 +1,71 @@
 #version 450
 
-layout( constant_id = 2 ) const uint  maxGlyphCount = 1;
+layout( constant_id = 2 ) const bool quantizedGlyphs = false;
 
 layout( location = 0 ) out vec4 color;
 layout( location = 0 ) in vec2 uv;
 
 layout( set = 0, binding = 0 ) buffer readonly GlyphOffsets
 {
-	readonly uint values[];
-} offsets[maxGlyphCount];
+	readonly uint offsets[];
+};
 
 layout( set = 0, binding = 1 ) buffer readonly GlyphPoints
 {
-	readonly float values[];
-} points[maxGlyphCount];
-
-layout(push_constant) uniform PushConstants {
-	uint  glyphIndex;
-	float r;
-	float g;
-	float b;
-	float a;
-	float pixelPerEm;
-} push;
+	readonly uint points[];
+};
+
+// position of every glyph in the offset and point buffers, counted in elements
+struct GlyphRange
+{
+	uint offsetStart;
+	uint offsetCount;
+	uint pointStart;
+	uint pointCount;
+	vec2 pointOrigin;
+	vec2 pointScale;
+};
+
+layout( set = 0, binding = 2 ) buffer readonly GlyphRanges
+{
+	readonly GlyphRange glyphRanges[];
+};
+
+layout( location = 1 ) flat in uint glyphIndex;
+layout( location = 2 ) flat in vec4 glyphColor;
+layout( location = 3 ) flat in float pixelPerEm;
+
+// quantized glyphs hold two 16 bit elements per word, their points are decoded with the origin and scale of the glyph
+uint offsetStart;
+uint pointStart;
+vec2 pointOrigin;
+vec2 pointScale;
+
+uint readOffset( const uint index )
+{
+	const uint element = offsetStart + index;
+	if( quantizedGlyphs )
+	{
+		return bitfieldExtract( offsets[element >> 1], int( element & 1 ) * 16, 16 );
+	}
+	return offsets[element];
+}
+
+float readPoint( const uint index )
+{
+	const uint element = pointStart + index;
+	if( quantizedGlyphs )
+	{
+		const uint axis = index & 1;
+		return pointOrigin[axis] + float( bitfieldExtract( points[element >> 1], int( element & 1 ) * 16, 16 ) ) * pointScale[axis];
+	}
+	return uintBitsToFloat( points[element] );
+}
+
+vec2 readCurvePoint( const uint index )
+{
+	return vec2( readPoint( index ), readPoint( index + 1 ) );
+}
 
 vec2 solvePolyY( const vec2 p1, const vec2 p2, const vec2 p3 )
 {
@@ -98,24 +141,34 @@ bool testRoot2( const ivec2 code )
 
 void main()
 {	
+	const GlyphRange range = glyphRanges[glyphIndex];
+	if( range.offsetCount == 0 )
+	{
+		discard;
+	}
+	offsetStart = range.offsetStart;
+	pointStart = range.pointStart;
+	pointOrigin = range.pointOrigin;
+	pointScale = range.pointScale;
+	
 	uint nXCurve = 0;
 	uint xOffset = 0;
 	
-	const uint stepCount = clamp( uint(1000.0F/push.pixelPerEm), 1, 8 );
+	const uint stepCount = clamp( uint(1000.0F/pixelPerEm), 1, 8 );
 	const float offsetStep = 1.0F/stepCount;
 	
 	float coverage = 0.0F;
 	for( float pixelOffset = -0.5F + 0.5F*offsetStep; pixelOffset < 0.5F; pixelOffset += offsetStep )
 	{		
-		const vec2 posX = vec2( uv.x + pixelOffset/push.pixelPerEm , uv.y );
-		const vec2 posY = vec2( uv.x, uv.y + pixelOffset/push.pixelPerEm );
+		const vec2 posX = vec2( uv.x + pixelOffset/pixelPerEm , uv.y );
+		const vec2 posY = vec2( uv.x, uv.y + pixelOffset/pixelPerEm );
 		
 		for( uint bandIndex = 0; bandIndex < 32; ++bandIndex )
 		{	
-			if( posX.x <= points[push.glyphIndex].values[2*bandIndex] )
+			if( posX.x <= readPoint( 2*bandIndex ) )
 			{
-				nXCurve = offsets[push.glyphIndex].values[4*bandIndex];
-				xOffset = offsets[push.glyphIndex].values[4*bandIndex+1];
+				nXCurve = readOffset( 4*bandIndex );
+				xOffset = readOffset( 4*bandIndex+1 );
 				break;
 			}
 		}
@@ -125,26 +178,26 @@ void main()
 		
 		for( uint bandIndex = 0; bandIndex < 32; ++bandIndex )
 		{	
-			if( posY.y <= points[push.glyphIndex].values[2*bandIndex + 1] )
+			if( posY.y <= readPoint( 2*bandIndex + 1 ) )
 			{	
-				nYCurve = offsets[push.glyphIndex].values[4*bandIndex+2];
-				yOffset = offsets[push.glyphIndex].values[4*bandIndex+3];
+				nYCurve = readOffset( 4*bandIndex+2 );
+				yOffset = readOffset( 4*bandIndex+3 );
 				break;
 			}
 		}
 		
 		for( uint curveIndex = 0; curveIndex < nXCurve; ++curveIndex )
 		{
-			const uint curveOffset = offsets[push.glyphIndex].values[xOffset+curveIndex];
-			const vec2 startPoint   = ( vec2( points[push.glyphIndex].values[curveOffset],   points[push.glyphIndex].values[curveOffset+1] ) - posX );
-			const vec2 controlPoint = ( vec2( points[push.glyphIndex].values[curveOffset+2], points[push.glyphIndex].values[curveOffset+3] ) - posX );
-			const vec2 endPoint     = ( vec2( points[push.glyphIndex].values[curveOffset+4], points[push.glyphIndex].values[curveOffset+5] ) - posX );
+			const uint curveOffset = readOffset( xOffset+curveIndex );
+			const vec2 startPoint   = ( readCurvePoint( curveOffset ) - posX );
+			const vec2 controlPoint = ( readCurvePoint( curveOffset+2 ) - posX );
+			const vec2 endPoint     = ( readCurvePoint( curveOffset+4 ) - posX );
 			
 			if( max( max( startPoint.y, controlPoint.y ), endPoint.y ) < 0.0F ) break;
 			const ivec2 code = calcRootCode( startPoint.x, controlPoint.x, endPoint.x );
 			if( testCurve( code ) )
 			{
-				const vec2 r = solvePolyX( startPoint, controlPoint, endPoint ) * push.pixelPerEm;
+				const vec2 r = solvePolyX( startPoint, controlPoint, endPoint ) * pixelPerEm;
 				
 				if( testRoot1(code) ) coverage -= clamp( r.x + 0.5F, 0.0F, 1.0F );
 				if( testRoot2(code) ) coverage += clamp( r.y + 0.5F, 0.0F, 1.0F );
@@ -153,22 +206,22 @@ void main()
 		
 		for( uint curveIndex = 0; curveIndex < nYCurve; ++curveIndex )
 		{
-			const uint curveOffset = offsets[push.glyphIndex].values[yOffset+curveIndex];
+			const uint curveOffset = readOffset( yOffset+curveIndex );
 			
-			const vec2 startPoint   = vec2( points[push.glyphIndex].values[curveOffset],   points[push.glyphIndex].values[curveOffset+1] ) - posY;
-			const vec2 controlPoint = vec2( points[push.glyphIndex].values[curveOffset+2], points[push.glyphIndex].values[curveOffset+3] ) - posY;
-			const vec2 endPoint     = vec2( points[push.glyphIndex].values[curveOffset+4], points[push.glyphIndex].values[curveOffset+5] ) - posY;
+			const vec2 startPoint   = readCurvePoint( curveOffset ) - posY;
+			const vec2 controlPoint = readCurvePoint( curveOffset+2 ) - posY;
+			const vec2 endPoint     = readCurvePoint( curveOffset+4 ) - posY;
 			
 			if( max( max( startPoint.x, controlPoint.x ), endPoint.x ) < 0.0F ) break;
 			const ivec2 code = calcRootCode( startPoint.y, controlPoint.y, endPoint.y );
 			if( testCurve( code ) )
 			{
-				const vec2 r = solvePolyY( startPoint, controlPoint, endPoint ) * push.pixelPerEm;
+				const vec2 r = solvePolyY( startPoint, controlPoint, endPoint ) * pixelPerEm;
 				
 				if( testRoot1(code) ) coverage += clamp( r.x + 0.5F, 0.0F, 1.0F );
 				if( testRoot2(code) ) coverage -= clamp( r.y + 0.5F, 0.0F, 1.0F );
 			}
 		}
 	}
-	color = vec4( push.r, push.g, push.b, push.a * abs( coverage ) / ( 2.0F*stepCount ) );
+	color = vec4( glyphColor.rgb, glyphColor.a * abs( coverage ) / ( 2.0F*stepCount ) );
 }
\ No newline at end of file
@@ -2,38 +2,85 @@
 
 layout( early_fragment_tests ) in;
 
-layout( constant_id = 0 ) const float emPerPixelWidth = 1;
-layout( constant_id = 1 ) const float emPerPixelHeight = 1;
-layout( constant_id = 2 ) const uint  maxGlyphCount = 1;
+layout( constant_id = 0 ) const bool quantizedGlyphs = false;
 
-layout( location = 0 ) out vec4 outPosition;
-layout( location = 1 ) out vec4 outNormal;
-layout( location = 2 ) out vec4 outColor;
+// size of a pixel in clip space
+layout( push_constant ) uniform PixelSize
+{
+	float emPerPixelWidth;
+	float emPerPixelHeight;
+};
+
+// the normal attachment is write masked, decals keep the normal of the surface
+layout( location = 0 ) out vec4 outColor;
 
 layout( location = 0 ) in vec2 inUV;
 layout( location = 1 ) in vec2 inSearcherX;
 layout( location = 2 ) in vec2 inSearcherY;
 
-layout(push_constant) uniform PushConstants {
-	uint glyphIndex;
-	float r;
-	float g;
-	float b;
-	float a;
-} push;
+layout( location = 3 ) flat in uint glyphIndex;
+layout( location = 4 ) flat in vec4 glyphColor;
 
 layout( set = 0, binding = 0 ) buffer readonly GlyphOffsets
 {
-	uint values[];
-} offsets[maxGlyphCount];
+	uint offsets[];
+};
 
 layout( set = 0, binding = 1 ) buffer readonly GlyphPoints
 {
-	float values[];
-} points[maxGlyphCount];
+	uint points[];
+};
+
+// position of every glyph in the offset and point buffers, counted in elements
+struct GlyphRange
+{
+	uint offsetStart;
+	uint offsetCount;
+	uint pointStart;
+	uint pointCount;
+	vec2 pointOrigin;
+	vec2 pointScale;
+};
+
+layout( set = 0, binding = 2 ) buffer readonly GlyphRanges
+{
+	GlyphRange glyphRanges[];
+};
 
 
 
+// quantized glyphs hold two 16 bit elements per word, their points are decoded with the origin and scale of the glyph
+uint offsetStart;
+uint pointStart;
+vec2 pointOrigin;
+vec2 pointScale;
+
+uint readOffset( const uint index )
+{
+	const uint element = offsetStart + index;
+	if( quantizedGlyphs )
+	{
+		return bitfieldExtract( offsets[element >> 1], int( element & 1 ) * 16, 16 );
+	}
+	return offsets[element];
+}
+
+float readPoint( const uint index )
+{
+	const uint element = pointStart + index;
+	if( quantizedGlyphs )
+	{
+		const uint axis = index & 1;
+		return pointOrigin[axis] + float( bitfieldExtract( points[element >> 1], int( element & 1 ) * 16, 16 ) ) * pointScale[axis];
+	}
+	return uintBitsToFloat( points[element] );
+}
+
+vec2 readCurvePoint( const uint index )
+{
+	return vec2( readPoint( index ), readPoint( index + 1 ) );
+}
+
 // solves distance on (1,0)
 vec2 solvePolyY( const vec2 p1, const vec2 p2, const vec2 p3 )
 {
@@ -112,6 +159,16 @@ const float MAX_SAMPLE_COUNT = 4.0F;
 
 void main()
 {	
+	const GlyphRange range = glyphRanges[glyphIndex];
+	if( range.offsetCount == 0 )
+	{
+		discard;
+	}
+	offsetStart = range.offsetStart;
+	pointStart = range.pointStart;
+	pointOrigin = range.pointOrigin;
+	pointScale = range.pointScale;
+	
 	vec2 emPerPixel = vec2( emPerPixelWidth, emPerPixelHeight );
 	
 	const vec2 absXDirection = abs( inSearcherX/emPerPixel );
@@ -134,20 +191,20 @@ void main()
 		
 		for( uint bandIndex = 0; bandIndex < 32; ++bandIndex )
 		{	
-			if( posX.x <= points[push.glyphIndex].values[2*bandIndex] )
+			if( posX.x <= readPoint( 2*bandIndex ) )
 			{
-				nXCurve = offsets[push.glyphIndex].values[4*bandIndex];
-				xOffset = offsets[push.glyphIndex].values[4*bandIndex+1];
+				nXCurve = readOffset( 4*bandIndex );
+				xOffset = readOffset( 4*bandIndex+1 );
 				break;
 			}
 		}
 		
 		for( uint curveIndex = 0; curveIndex < nXCurve; ++curveIndex )
 		{
-			const uint curveOffset = offsets[push.glyphIndex].values[xOffset+curveIndex];
-			const vec2 startPoint   = ( vec2( points[push.glyphIndex].values[curveOffset],   points[push.glyphIndex].values[curveOffset+1] ) - posX );
-			const vec2 controlPoint = ( vec2( points[push.glyphIndex].values[curveOffset+2], points[push.glyphIndex].values[curveOffset+3] ) - posX );
-			const vec2 endPoint     = ( vec2( points[push.glyphIndex].values[curveOffset+4], points[push.glyphIndex].values[curveOffset+5] ) - posX );
+			const uint curveOffset = readOffset( xOffset+curveIndex );
+			const vec2 startPoint   = ( readCurvePoint( curveOffset ) - posX );
+			const vec2 controlPoint = ( readCurvePoint( curveOffset+2 ) - posX );
+			const vec2 endPoint     = ( readCurvePoint( curveOffset+4 ) - posX );
 			
 			if( max( max( startPoint.y, controlPoint.y ), endPoint.y ) < 0.0F ) break;
 			const ivec2 code = calcRootCode( startPoint.x, controlPoint.x, endPoint.x );
@@ -170,20 +227,20 @@ void main()
 		
 		for( uint bandIndex = 0; bandIndex < 32; ++bandIndex )
 		{	
-			if( posY.y <= points[push.glyphIndex].values[2*bandIndex + 1] )
+			if( posY.y <= readPoint( 2*bandIndex + 1 ) )
 			{	
-				nYCurve = offsets[push.glyphIndex].values[4*bandIndex+2];
-				yOffset = offsets[push.glyphIndex].values[4*bandIndex+3];
+				nYCurve = readOffset( 4*bandIndex+2 );
+				yOffset = readOffset( 4*bandIndex+3 );
 				break;
 			}
 		}
 		
 		for( uint curveIndex = 0; curveIndex < nYCurve; ++curveIndex )
 		{
-			const uint curveOffset = offsets[push.glyphIndex].values[yOffset+curveIndex];
-			const vec2 startPoint   = vec2( points[push.glyphIndex].values[curveOffset],   points[push.glyphIndex].values[curveOffset+1] ) - posY;
-			const vec2 controlPoint = vec2( points[push.glyphIndex].values[curveOffset+2], points[push.glyphIndex].values[curveOffset+3] ) - posY;
-			const vec2 endPoint     = vec2( points[push.glyphIndex].values[curveOffset+4], points[push.glyphIndex].values[curveOffset+5] ) - posY;
+			const uint curveOffset = readOffset( yOffset+curveIndex );
+			const vec2 startPoint   = readCurvePoint( curveOffset ) - posY;
+			const vec2 controlPoint = readCurvePoint( curveOffset+2 ) - posY;
+			const vec2 endPoint     = readCurvePoint( curveOffset+4 ) - posY;
 			
 			if( max( max( startPoint.x, controlPoint.x ), endPoint.x ) < 0.0F ) break;
 			const ivec2 code = calcRootCode( startPoint.y, controlPoint.y, endPoint.y );
@@ -197,7 +254,5 @@ void main()
 		}
 	}
 	
-	outPosition = vec4( 0.0F );
-	outNormal   = vec4( 0.0F );
-	outColor    = vec4( push.r, push.g, push.b, push.a * abs( coverage ) / ( sampleCount.x + sampleCount.y ) );
+	outColor = vec4( glyphColor.rgb, glyphColor.a * abs( coverage ) / ( sampleCount.x + sampleCount.y ) );
 }
\ No newline at end of file
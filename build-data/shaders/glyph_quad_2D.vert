@@ -1,19 +1,23 @@
 #version 450
 
-layout (constant_id = 0) const float width = 1;
-layout (constant_id = 1) const float height = 1;
+// pixel to clip space, shared with the labels of the overlay
+layout( push_constant ) uniform ScreenSpace
+{
+	float width;
+	float height;
+};
 
-layout( location = 0 ) in vec2 position;
+// per instance
+layout( location = 0 ) in vec4 glyphBox;
+layout( location = 1 ) in vec3 placement;
+layout( location = 2 ) in uint glyphId;
+layout( location = 3 ) in vec4 glyphColor;
+layout( location = 4 ) in vec4 clipRect;
 
 layout( location = 0 ) out vec2 uv;
-
-layout(push_constant) uniform PushConstants {
-    layout(offset=32) float pixelPerEm;
-	float cosA;
-	float sinA;
-	float x;
-	float y;
-} push;
+layout( location = 1 ) flat out uint glyphIndex;
+layout( location = 2 ) flat out vec4 color;
+layout( location = 3 ) flat out float pixelPerEm;
 
 const vec2 directions[4] =
 {
@@ -25,6 +29,16 @@ const vec2 directions[4] =
 
 void main() 
 {
-	uv = 0.5F * directions[gl_VertexIndex%4] / push.pixelPerEm + position;
-	gl_Position = vec4( ( push.pixelPerEm * mat2( push.cosA, push.sinA, -push.sinA, push.cosA )*uv + vec2( push.x, push.y ) )*vec2( width, height ) + vec2( -1.0, 1.0 ), 0.0F, 1.0F ); //
-}
\ No newline at end of file
+	const vec2 direction = directions[gl_VertexIndex%4];
+	const vec2 corner = vec2( direction.x < 0.0F ? glyphBox.x : glyphBox.z, direction.y > 0.0F ? glyphBox.w : glyphBox.y );
+	const float size = placement.z;
+	
+	// clamping the corners to the clip rectangle replaces the scissor, uv follows the clamped corner
+	const vec2 pixel = clamp( size * ( 0.5F * direction / size + corner ) + placement.xy, clipRect.xy, clipRect.zw );
+	uv = ( pixel - placement.xy ) / size;
+	
+	glyphIndex = glyphId;
+	color = glyphColor;
+	pixelPerEm = size;
+	gl_Position = vec4( pixel * vec2( width, height ) + vec2( -1.0, 1.0 ), 0.0F, 1.0F );
+}
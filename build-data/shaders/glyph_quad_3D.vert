@@ -1,17 +1,24 @@
 #version 450
 
-layout (constant_id = 0) const float emPerPixelWidth = 1;
-layout (constant_id = 1) const float emPerPixelHeight = 1;
+// size of a pixel in clip space
+layout( push_constant ) uniform PixelSize
+{
+	float emPerPixelWidth;
+	float emPerPixelHeight;
+};
 
-layout( location = 0 ) in vec2 inPosition;
+// per instance, the text matrix already contains camera, world transformation and font size
+layout( location = 0 ) in mat4 inTextMatrix;
+layout( location = 4 ) in vec4 inGlyphBox;
+layout( location = 5 ) in vec4 inColor;
+layout( location = 6 ) in vec2 inGlyphOffset;
+layout( location = 7 ) in uint inGlyphId;
 
 layout( location = 0 ) out vec2 outUV;
 layout( location = 1 ) out vec2 outSearcherX;
 layout( location = 2 ) out vec2 outSearcherY;
-
-layout(push_constant) uniform PushConstants {
-    layout(offset=32) mat4 perspectiv;
-} push;
+layout( location = 3 ) flat out uint outGlyphIndex;
+layout( location = 4 ) flat out vec4 outColor;
 
 const vec2 directions[4] =
 {
@@ -38,26 +45,31 @@ void main()
 {
 	const vec2 emPerPixel = vec2( emPerPixelWidth, emPerPixelHeight );
 	const uint vertexIndex = gl_VertexIndex%4;
+	const mat4 perspectiv = inTextMatrix * mat4( vec4( 1.0F, 0.0F, 0.0F, 0.0F ), vec4( 0.0F, 1.0F, 0.0F, 0.0F ), vec4( 0.0F, 0.0F, 1.0F, 0.0F ), vec4( inGlyphOffset, 0.0F, 1.0F ) );
+	const vec2 inPosition = vec2( directions[vertexIndex].x < 0.0F ? inGlyphBox.x : inGlyphBox.z, directions[vertexIndex].y > 0.0F ? inGlyphBox.w : inGlyphBox.y );
 	
 	vec4 originalCorner = vec4( inPosition,0.0F,1.0F );
 	vec4 advancedCorner = vec4( originalCorner.xy + directions[vertexIndex], 0.0F, 1.0F );
 	
-	originalCorner = push.perspectiv*originalCorner;
-	advancedCorner = push.perspectiv*advancedCorner;
+	originalCorner = perspectiv*originalCorner;
+	advancedCorner = perspectiv*advancedCorner;
 	
 	float factor = length( vec2( 1.0F, 1.0F ) ) / length( ( advancedCorner/advancedCorner.w - originalCorner/originalCorner.w ).xy );
 	
 	outUV = inPosition + factor * directions[vertexIndex] * emPerPixel;
 	
-	gl_Position = push.perspectiv * vec4( outUV, 0.0F, 1.0F );
+	gl_Position = perspectiv * vec4( outUV, 0.0F, 1.0F );
 	
 	{
-		const vec4 searcherX = push.perspectiv * vec4( outUV + vec2( 1.0F, 0.0F ), 0.0F, 1.0F );
+		const vec4 searcherX = perspectiv * vec4( outUV + vec2( 1.0F, 0.0F ), 0.0F, 1.0F );
 		outSearcherX = searcherX.xy/searcherX.w - gl_Position.xy/gl_Position.w;
 	}
 	
 	{
-		const vec4 searcherY = push.perspectiv * vec4( outUV + vec2( 0.0F, 1.0F ), 0.0F, 1.0F );
+		const vec4 searcherY = perspectiv * vec4( outUV + vec2( 0.0F, 1.0F ), 0.0F, 1.0F );
 		outSearcherY = searcherY.xy/searcherY.w - gl_Position.xy/gl_Position.w;
 	}
+	
+	outGlyphIndex = inGlyphId;
+	outColor = inColor;
 }
\ No newline at end of file
@@ -1,25 +1,24 @@
 #version 450
 
-layout (constant_id = 0) const float screen_space_width_factor = 1;
-layout (constant_id = 1) const float screen_space_height_factor = 1;
-
-layout(push_constant) uniform PushConstants {
-    layout(offset=16) float x;
-	float y;
-	float width;
-	float height;
-} push;
-
-const vec2 uv[4] =
+// pixel to clip space, shared with the glyph quads of the overlay
+layout( push_constant ) uniform ScreenSpace
 {
-	vec2( 0.0F, 0.0F ),
-	vec2( 1.0F, 0.0F ),
-	vec2( 0.0F, 1.0F ),
-	vec2( 1.0F, 1.0F )
+	float screen_space_width_factor;
+	float screen_space_height_factor;
 };
 
+// per instance, pixels from the bottom left corner
+layout( location = 0 ) in vec4 rect;
+layout( location = 1 ) in vec4 labelColor;
+layout( location = 2 ) in vec4 clipRect;
+
+layout( location = 0 ) flat out vec4 color;
+
 void main() 
 {
-	const vec2 corner = vec2( screen_space_width_factor, screen_space_height_factor ) * vec2( push.x + (gl_VertexIndex%2) * push.width, push.y + ( gl_VertexIndex > 1 ? push.height : 0.0F ) ) + vec2( -1.0, 1.0 );
+	// clamping the corners to the clip rectangle replaces the scissor
+	const vec2 pixel = clamp( rect.xy + vec2( gl_VertexIndex%2, gl_VertexIndex > 1 ? 1.0F : 0.0F ) * rect.zw, clipRect.xy, clipRect.zw );
+	const vec2 corner = vec2( screen_space_width_factor, screen_space_height_factor ) * pixel + vec2( -1.0, 1.0 );
 	gl_Position = vec4( corner, 0.0F, 1.0F );
-}
\ No newline at end of file
+	color = labelColor;
+}
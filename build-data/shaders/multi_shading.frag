@@ -1,6 +1,7 @@
 #version 450
 
 #extension GL_GOOGLE_include_directive : enable
+#include "gbuffer.include"
 #include "shading.include"
 
 layout( early_fragment_tests ) in;
@@ -8,7 +9,14 @@ layout( constant_id = 0 ) const uint NUM_SAMPLES = 1;
 
 layout( input_attachment_index = 0, set = 0, binding = 0 ) uniform subpassInputMS colorInput;
 layout( input_attachment_index = 1, set = 0, binding = 1 ) uniform subpassInputMS normalInput;
-layout( input_attachment_index = 2, set = 0, binding = 2 ) uniform subpassInputMS positionInput;
+layout( input_attachment_index = 2, set = 0, binding = 2 ) uniform subpassInputMS depthInput;
+
+layout( push_constant ) uniform PushConstants
+{
+	mat4 clipToWorld;
+} push;
+
+layout( location = 0 ) in vec2 inUV;
 
 layout( location = 0 ) out vec4 outColor;
 
@@ -18,8 +26,8 @@ vec3 resolveColor()
 
 	for( int sampleId = 0; sampleId < NUM_SAMPLES; ++sampleId )
 	{
-		texel += shading( subpassLoad( colorInput, sampleId ).rgb, subpassLoad( positionInput, sampleId ).xyz, subpassLoad( normalInput, sampleId ).xyz );
-		//subpassLoad( colorInput, sampleId ).rgb * clamp( dot( normalize(light - subpassLoad( positionInput, sampleId ).xyz), subpassLoad( normalInput, sampleId ).xyz ), 0.0, 1.0 );
+		const vec3 position = reconstructPosition( push.clipToWorld, inUV, subpassLoad( depthInput, sampleId ).r );
+		texel += shading( subpassLoad( colorInput, sampleId ).rgb, position, decodeNormal( subpassLoad( normalInput, sampleId ).xy ) );
 	}
 	return texel/NUM_SAMPLES;
 }
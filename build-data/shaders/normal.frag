@@ -1,11 +1,10 @@
 #version 450
 
-layout( location = 0 ) out vec4 outPosition;
-layout( location = 1 ) out vec4 outNormal;
-layout( location = 2 ) out vec4 outColor;
+layout( location = 0 ) out vec4 outColor;
+layout( location = 1 ) out vec2 outNormal;
 
 void main()
 {
-	outNormal   = vec4( 0.0F );
 	outColor    = vec4( 1.0F );
+	outNormal   = vec2( 0.0F );
 }
\ No newline at end of file
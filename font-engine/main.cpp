@@ -1,13 +1,299 @@
-#include "FontEngine.hpp"
+#include <resources/FontEngine.hpp>
+#include <resources/FontResource.hpp>
+#include <resources/GameResourceEngine.hpp>
+#include <resources/GlyphQuantizer.hpp>
+#include <resources/GlyphRasterizer.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
 #include <string>
+#include <string_view>
+#include <vector>
 
-int main( int argc, char* argv[] )
+namespace
 {
-	noxcain::FontEngine font_engine;
+	void print_usage( const char* program )
+	{
+		std::cerr << "usage: " << program << " stats font...\n"
+			<< "       " << program << " quantize [--max-deviation value] pixel_per_em font...\n"
+			<< "       " << program << " render font_id pixel_per_em text output.pgm\n"
+			<< "       " << program << " diff font_id pixel_per_em text reference.pgm [max_deviation]\n"
+			<< "       " << program << " cost pixel_per_em\n"
+			<< "render, diff and cost use the fonts of the resource engine, which are loaded relative to the working directory\n";
+	}
 
-	std::string in = "D:/Projekte/vulkan-game-engine/resources/Fonts/28 Days Later.ttf";
-	std::string out = "D:/Desktop/test.nxf";
+	bool parse_number( const char* text, noxcain::FLOAT32& value )
+	{
+		char* end = nullptr;
+		const float number = std::strtof( text, &end );
+		if( !end || *end != '\0' || end == text || !std::isfinite( number ) || number <= 0.0F )
+		{
+			return false;
+		}
+		value = number;
+		return true;
+	}
 
-	return font_engine.read_font(in, out);
-}
\ No newline at end of file
+	bool parse_number( const char* text, std::size_t& value )
+	{
+		char* end = nullptr;
+		const unsigned long number = std::strtoul( text, &end, 10 );
+		if( !end || *end != '\0' || end == text )
+		{
+			return false;
+		}
+		value = std::size_t( number );
+		return true;
+	}
+
+	bool read_font( const std::string& font_path, noxcain::FontEngine& font )
+	{
+		if( !font.readFont( font_path ) )
+		{
+			std::cerr << "can not read font " << font_path << "\n";
+			return false;
+		}
+		return true;
+	}
+
+	/// <summary>
+	/// expected fragment cost of the band layout, see FontEngine::BandStatistics
+	/// </summary>
+	bool print_band_statistics( const std::string& font_path )
+	{
+		noxcain::FontEngine font;
+		if( !read_font( font_path, font ) )
+		{
+			return false;
+		}
+
+		const noxcain::FontEngine::BandStatistics& statistics = font.get_band_statistics();
+		std::cout << font_path << ": " << font.get_glyph_count() << " glyphs, " << statistics.band_count << " bands\n"
+			<< std::fixed << std::setprecision( 2 )
+			<< "  curves per band: " << statistics.average_curves_per_band << " average, " << statistics.max_curves_per_band << " max\n"
+			<< "  curves per sample: " << statistics.average_curves_per_sample << "\n"
+			<< "  bytes per glyph: " << statistics.average_bytes_per_glyph << " average, " << statistics.max_bytes_per_glyph << " max\n" << std::defaultfloat;
+		return true;
+	}
+
+	/// <summary>
+	/// coverage error of the 16 bit glyph data, see GlyphQuantizer::measure_error
+	/// </summary>
+	/// <returns>false if the font can not be read or its max deviation is above the limit</returns>
+	bool print_quantization_error( const std::string& font_path, noxcain::FLOAT32 pixel_per_em, noxcain::FLOAT32 max_deviation )
+	{
+		noxcain::FontEngine font;
+		if( !read_font( font_path, font ) )
+		{
+			return false;
+		}
+
+		const noxcain::GlyphQuantizer::ErrorReport report = noxcain::GlyphQuantizer::measure_error( font, pixel_per_em );
+		std::cout << font_path << " at " << report.pixel_per_em << " pixel per em: " << report.glyph_count << " glyphs\n"
+			<< std::fixed << std::setprecision( 4 )
+			<< "  max deviation: " << report.max_deviation << " in glyph " << report.worst_glyph_index << ", average per glyph " << report.average_deviation << "\n"
+			<< "  pixels above one 8 bit step: " << report.deviating_pixel_count << " of " << report.pixel_count << "\n"
+			<< "  bytes: " << report.float_bytes << " float, " << report.quantized_bytes << " quantized\n" << std::defaultfloat;
+		return report.max_deviation <= max_deviation;
+	}
+
+	/// <summary>
+	/// renders the glyphs of the text from the data uploaded to the gpu, top aligned in one row with one pixel between them
+	/// </summary>
+	/// <param name="text">ascii, every byte is one unicode</param>
+	noxcain::GlyphRasterizer::GlyphBitmap render_text( std::size_t font_id, noxcain::FLOAT32 pixel_per_em, std::string_view text )
+	{
+		const noxcain::FontResource& font = noxcain::ResourceEngine::get_engine().get_font( font_id );
+		const noxcain::GlyphRasterizer rasterizer( pixel_per_em );
+
+		std::vector<noxcain::GlyphRasterizer::GlyphBitmap> glyphs;
+		for( const char character : text )
+		{
+			const noxcain::FontResource::CharacterInfo info = font.get_character_info( noxcain::UINT32( static_cast<unsigned char>( character ) ) );
+			if( info.glyph_index != noxcain::FontResource::INVALID_UNICODE )
+			{
+				glyphs.push_back( rasterizer.render_glyph( font, info.glyph_index ) );
+			}
+		}
+
+		noxcain::GlyphRasterizer::GlyphBitmap sheet;
+		for( const auto& glyph : glyphs )
+		{
+			sheet.width += glyph.width + ( sheet.width ? 1 : 0 );
+			sheet.height = std::max( sheet.height, glyph.height );
+			sheet.curve_tests += glyph.curve_tests;
+		}
+		sheet.coverage.resize( std::size_t( sheet.width ) * sheet.height );
+
+		std::size_t column_offset = 0;
+		for( const auto& glyph : glyphs )
+		{
+			for( std::size_t row = 0; row < glyph.height; ++row )
+			{
+				std::copy_n( glyph.coverage.begin() + row * glyph.width, glyph.width, sheet.coverage.begin() + row * sheet.width + column_offset );
+			}
+			column_offset += glyph.width + 1;
+		}
+		return sheet;
+	}
+
+	bool write_bitmap( const std::string& file_name, const noxcain::GlyphRasterizer::GlyphBitmap& bitmap )
+	{
+		std::ofstream file( file_name, std::ios::binary | std::ios::trunc );
+		file << "P5\n" << bitmap.width << " " << bitmap.height << "\n255\n";
+
+		std::vector<char> pixels( bitmap.coverage.size() );
+		std::transform( bitmap.coverage.begin(), bitmap.coverage.end(), pixels.begin(), []( noxcain::FLOAT32 coverage )
+		{
+			return char( std::lround( std::clamp( coverage, 0.0F, 1.0F ) * 255.0F ) );
+		} );
+		file.write( pixels.data(), pixels.size() );
+		return bool( file );
+	}
+
+	bool read_bitmap( const std::string& file_name, noxcain::GlyphRasterizer::GlyphBitmap& bitmap )
+	{
+		std::ifstream file( file_name, std::ios::binary );
+		std::string format;
+		noxcain::UINT32 max_value = 0;
+		file >> format >> bitmap.width >> bitmap.height >> max_value;
+		file.get();
+		if( !file || format != "P5" || max_value != 255 )
+		{
+			return false;
+		}
+
+		std::vector<char> pixels( std::size_t( bitmap.width ) * bitmap.height );
+		file.read( pixels.data(), pixels.size() );
+		bitmap.coverage.resize( pixels.size() );
+		std::transform( pixels.begin(), pixels.end(), bitmap.coverage.begin(), []( char pixel )
+		{
+			return noxcain::FLOAT32( static_cast<unsigned char>( pixel ) ) / 255.0F;
+		} );
+		return bool( file );
+	}
+
+	/// <summary>
+	/// renders the text like the render mode and compares it with a stored rendering, changes of the font data, the band layout or the rasterizer show up as deviation
+	/// </summary>
+	bool diff_text( std::size_t font_id, noxcain::FLOAT32 pixel_per_em, std::string_view text, const std::string& reference_file, noxcain::FLOAT32 max_deviation )
+	{
+		noxcain::GlyphRasterizer::GlyphBitmap reference;
+		if( !read_bitmap( reference_file, reference ) )
+		{
+			std::cerr << "can not read reference " << reference_file << "\n";
+			return false;
+		}
+
+		// the reference holds 8 bit coverage
+		noxcain::GlyphRasterizer::GlyphBitmap bitmap = render_text( font_id, pixel_per_em, text );
+		for( noxcain::FLOAT32& coverage : bitmap.coverage )
+		{
+			coverage = std::round( coverage * 255.0F ) / 255.0F;
+		}
+
+		const noxcain::FLOAT32 deviation = noxcain::GlyphRasterizer::compare( bitmap, reference );
+		std::cout << "font " << font_id << " at " << pixel_per_em << " pixel per em: " << bitmap.width << "x" << bitmap.height << " pixels, reference " << reference.width << "x" << reference.height
+			<< ", max deviation " << deviation << "\n";
+		return deviation <= max_deviation;
+	}
+
+	/// <summary>
+	/// fragment cost of every font, all glyphs are rendered from the data uploaded to the gpu
+	/// </summary>
+	void print_render_cost( noxcain::FLOAT32 pixel_per_em )
+	{
+		const auto& fonts = noxcain::ResourceEngine::get_engine().get_fonts();
+		const noxcain::GlyphRasterizer rasterizer( pixel_per_em );
+		for( std::size_t font_id = 0; font_id < fonts.size(); ++font_id )
+		{
+			const auto start = std::chrono::steady_clock::now();
+			const auto bitmaps = rasterizer.render_font( fonts[font_id] );
+			const noxcain::DOUBLE duration = std::chrono::duration<noxcain::DOUBLE, std::milli>( std::chrono::steady_clock::now() - start ).count();
+
+			noxcain::UINT64 pixel_count = 0;
+			noxcain::UINT64 curve_tests = 0;
+			for( const auto& bitmap : bitmaps )
+			{
+				pixel_count += bitmap.coverage.size();
+				curve_tests += bitmap.curve_tests;
+			}
+			std::cout << "font " << font_id << ": " << bitmaps.size() << " glyphs, " << pixel_count << " pixels, "
+				<< std::fixed << std::setprecision( 2 ) << noxcain::DOUBLE( curve_tests ) / noxcain::DOUBLE( std::max<noxcain::UINT64>( pixel_count, 1 ) ) << " curve tests per pixel, "
+				<< duration << " ms\n";
+		}
+	}
+}
+
+int main( int argc, char** argv )
+{
+	const std::string_view mode = argc > 1 ? argv[1] : "";
+	if( mode == "stats" && argc > 2 )
+	{
+		bool is_okay = true;
+		for( int index = 2; index < argc; ++index )
+		{
+			is_okay = print_band_statistics( argv[index] ) && is_okay;
+		}
+		return is_okay ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	std::size_t font_id = 0;
+	noxcain::FLOAT32 pixel_per_em = 0;
+	if( mode == "quantize" )
+	{
+		int argument = 2;
+		noxcain::FLOAT32 max_deviation = std::numeric_limits<noxcain::FLOAT32>::infinity();
+		if( argc > argument + 1 && std::string_view( argv[argument] ) == "--max-deviation" )
+		{
+			if( !parse_number( argv[argument + 1], max_deviation ) )
+			{
+				print_usage( argv[0] );
+				return EXIT_FAILURE;
+			}
+			argument += 2;
+		}
+
+		if( argc > argument + 1 && parse_number( argv[argument], pixel_per_em ) )
+		{
+			bool is_okay = true;
+			for( int index = argument + 1; index < argc; ++index )
+			{
+				is_okay = print_quantization_error( argv[index], pixel_per_em, max_deviation ) && is_okay;
+			}
+			return is_okay ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if( mode == "render" && argc == 6 && parse_number( argv[2], font_id ) && parse_number( argv[3], pixel_per_em ) )
+	{
+		if( !write_bitmap( argv[5], render_text( font_id, pixel_per_em, argv[4] ) ) )
+		{
+			std::cerr << "can not write " << argv[5] << "\n";
+			return EXIT_FAILURE;
+		}
+		return EXIT_SUCCESS;
+	}
+
+	// one 8 bit step for the rounding of the reference and one for the float differences between compilers
+	noxcain::FLOAT32 max_deviation = 2.0F / 255.0F;
+	if( mode == "diff" && ( argc == 6 || ( argc == 7 && parse_number( argv[6], max_deviation ) ) ) && parse_number( argv[2], font_id ) && parse_number( argv[3], pixel_per_em ) )
+	{
+		return diff_text( font_id, pixel_per_em, argv[4], argv[5], max_deviation ) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if( mode == "cost" && argc == 3 && parse_number( argv[2], pixel_per_em ) )
+	{
+		print_render_cost( pixel_per_em );
+		return EXIT_SUCCESS;
+	}
+
+	print_usage( argv[0] );
+	return EXIT_FAILURE;
+}
@@ -40,6 +40,49 @@ namespace noxcain
 		/// <returns>True if surface was externaly swap with another instance</returns>
 		virtual void recreate_swapchain( bool recreate_surface ) const = 0;
 
+		/// <summary>
+		/// Checks if frames are rendered into offscreen images instead of a swapchain, no surface is created in that case
+		/// </summary>
+		/// <returns>True for surfaces without a display</returns>
+		virtual bool is_offscreen() const
+		{
+			return false;
+		}
+
+		/// <summary>
+		/// size of the offscreen images, only used if is_offscreen is true
+		/// </summary>
+		virtual vk::Extent2D get_offscreen_extent() const
+		{
+			return vk::Extent2D();
+		}
+
+		/// <summary>
+		/// called by the submit thread after a frame was rendered into an offscreen image, takes the place of the presentation
+		/// </summary>
+		/// <param name="image_index">index of the offscreen image, valid until the call returns</param>
+		virtual void offscreen_frame_complete( UINT32 image_index ) const
+		{
+		}
+
+		/// <summary>
+		/// Checks if all vulkan calls should be checked by the khronos validation layer
+		/// </summary>
+		/// <returns>True if the messages of the layer should be passed to validation_message</returns>
+		virtual bool is_validated() const
+		{
+			return false;
+		}
+
+		/// <summary>
+		/// called for every warning and error of the validation layer, from any thread
+		/// </summary>
+		/// <param name="is_error">true for violations of the specification</param>
+		/// <param name="message">message of the layer, only valid until the call returns</param>
+		virtual void validation_message( bool is_error, const char* message ) const
+		{
+		}
+
 		virtual explicit operator bool() const
 		{
 			return false;
@@ -7,7 +7,19 @@
 
 #include <Defines.hpp>
 
+#include <algorithm>
 #include <concepts>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define NX_ENDIAN_SWAP_SSE2
+#elif defined( __ARM_NEON )
+#include <arm_neon.h>
+#define NX_ENDIAN_SWAP_NEON
+#endif
 
 namespace noxcain
 {
@@ -27,6 +39,151 @@ namespace noxcain
 	&& requires ( const FileType file )
 	{
 		{ file.is_open() };
+		{ file.fail() };
+		{ file.gcount() };
+	};
+
+	/// <summary>
+	/// reverses the byte order of count fundamental values in place, 16 and 32 bit values are swapped 16 bytes at once if possible
+	/// </summary>
+	template<typename T>
+	void swap_endianness( T* values, std::size_t count )
+	{
+		static_assert( std::is_arithmetic_v<T>, "only fundamental types can be swapped" );
+		constexpr std::size_t size = sizeof( T );
+		if constexpr( size == 1 )
+		{
+			return;
+		}
+		else
+		{
+			BYTE* bytes = reinterpret_cast<BYTE*>( values );
+			std::size_t index = 0;
+
+			if constexpr( size == 2 || size == 4 )
+			{
+				constexpr std::size_t VALUES_PER_BLOCK = 16 / size;
+				const std::size_t block_end = count - count % VALUES_PER_BLOCK;
+#if defined( NX_ENDIAN_SWAP_SSE2 )
+				for( ; index < block_end; index += VALUES_PER_BLOCK )
+				{
+					__m128i block = _mm_loadu_si128( reinterpret_cast<const __m128i*>( bytes + index * size ) );
+					if constexpr( size == 4 )
+					{
+						//swap the 16 bit halves first, the byte swap below finishes the 32 bit reverse
+						block = _mm_shufflelo_epi16( block, _MM_SHUFFLE( 2, 3, 0, 1 ) );
+						block = _mm_shufflehi_epi16( block, _MM_SHUFFLE( 2, 3, 0, 1 ) );
+					}
+					block = _mm_or_si128( _mm_slli_epi16( block, 8 ), _mm_srli_epi16( block, 8 ) );
+					_mm_storeu_si128( reinterpret_cast<__m128i*>( bytes + index * size ), block );
+				}
+#elif defined( NX_ENDIAN_SWAP_NEON )
+				for( ; index < block_end; index += VALUES_PER_BLOCK )
+				{
+					uint8x16_t block = vld1q_u8( bytes + index * size );
+					if constexpr( size == 4 )
+					{
+						block = vrev32q_u8( block );
+					}
+					else
+					{
+						block = vrev16q_u8( block );
+					}
+					vst1q_u8( bytes + index * size, block );
+				}
+#endif
+			}
+
+			for( ; index < count; ++index )
+			{
+				BYTE* value = bytes + index * size;
+				for( std::size_t byte_index = 0; byte_index < size / 2; ++byte_index )
+				{
+					const BYTE byte = value[byte_index];
+					value[byte_index] = value[size - 1 - byte_index];
+					value[size - 1 - byte_index] = byte;
+				}
+			}
+		}
+	}
+
+	/// <summary>
+	/// in memory copy of a resource file section, reads like a resource file stream without any stream calls
+	/// </summary>
+	class ResourceBlock
+	{
+	public:
+		ResourceBlock() = default;
+		ResourceBlock( std::vector<BYTE>&& block_data, bool endianness_correction ) : data( std::move( block_data ) ), need_endianness_correction( endianness_correction )
+		{
+		}
+
+		/// <summary>
+		/// interprets the data at current position as fundamental type in the correct endianness
+		/// </summary>
+		template <typename T>
+		T read_fundamental()
+		{
+			T value = T();
+			read_array( &value, 1 );
+			return value;
+		}
+
+		/// <summary>
+		/// copies count fundamental values to target and corrects their endianness at once
+		/// </summary>
+		/// <returns>false if block end was reached, missing values are zero</returns>
+		template <typename T>
+		bool read_array( T* target, std::size_t count )
+		{
+			const std::size_t byte_count = count * sizeof( T );
+			const std::size_t available = position < data.size() ? std::min<std::size_t>( byte_count, data.size() - position ) : 0;
+			if( available )
+			{
+				std::memcpy( target, data.data() + position, available );
+			}
+			if( available < byte_count )
+			{
+				std::memset( reinterpret_cast<BYTE*>( target ) + available, 0, byte_count - available );
+			}
+			position += byte_count;
+
+			if( need_endianness_correction )
+			{
+				swap_endianness( target, count );
+			}
+			return available == byte_count;
+		}
+
+		/// <summary>
+		/// special read_fundamental for compact float in font file
+		/// </summary>
+		DOUBLE read_f2dot14()
+		{
+			const INT16 value = read_fundamental<INT16>();
+			return DOUBLE( value ) / 16384.0;
+		}
+
+		UINT64 get_position() const
+		{
+			return position;
+		}
+
+		ResourceBlock& set_position( UINT64 new_position )
+		{
+			position = new_position;
+			return *this;
+		}
+
+		UINT64 get_size() const
+		{
+			return data.size();
+		}
+
+	private:
+		std::vector<BYTE> data;
+		UINT64 position = 0;
+		bool need_endianness_correction = false;
 	};
 
 	/// <summary>
@@ -52,6 +209,19 @@ namespace noxcain
 		/// </summary>
 		DOUBLE read_f2dot14();
 
+		/// <summary>
+		/// reads count fundamental values with one stream call directly into target, the endianness is corrected in bulk if needed
+		/// </summary>
+		/// <returns>true if all count values were read</returns>
+		template <typename T>
+		bool read_array( T* target, std::size_t count );
+
+		/// <summary>
+		/// buffers size bytes starting at position, following reads on the block avoid any stream calls
+		/// </summary>
+		/// <returns>block with the bytes actually read, smaller than size if the stream ended early</returns>
+		ResourceBlock read_block( UINT64 position, UINT64 size );
+
 		/// <summary>
 		/// open data stream to resource
 		/// </summary>
@@ -128,6 +298,45 @@ namespace noxcain
 		return value;
 	}
 
+	template<IsFileStream StreamType>
+	template<typename T>
+	inline bool ResourceFileStream<StreamType>::read_array( T* target, std::size_t count )
+	{
+		if( count == 0 )
+		{
+			return true;
+		}
+		const std::size_t byte_count = count * sizeof( T );
+		StreamType::read( reinterpret_cast<char*>( target ), byte_count );
+		if( StreamType::fail() || std::size_t( StreamType::gcount() ) != byte_count )
+		{
+			return false;
+		}
+
+		if( need_endianness_correction )
+		{
+			swap_endianness( target, count );
+		}
+		return true;
+	}
+
+	template<IsFileStream StreamType>
+	ResourceBlock ResourceFileStream<StreamType>::read_block( UINT64 position, UINT64 size )
+	{
+		std::vector<BYTE> data( size );
+		StreamType::seekg( position );
+		if( size )
+		{
+			StreamType::read( reinterpret_cast<char*>( data.data() ), size );
+			if( StreamType::fail() )
+			{
+				//a truncated block reports the missing bytes on its own reads
+				data.resize( std::min<UINT64>( size, UINT64( std::max<std::streamsize>( StreamType::gcount(), 0 ) ) ) );
+			}
+		}
+		return ResourceBlock( std::move( data ), need_endianness_correction );
+	}
+
 	template<IsFileStream StreamType>
 	ResourceFileStream<StreamType>::~ResourceFileStream()
 	{
@@ -165,7 +374,7 @@ namespace noxcain
 	}
 
 #ifdef __ANDROID__
-	using ResourceFile = ResourceFileStream<AndroidFile>
+	using ResourceFile = ResourceFileStream<AndroidFile>;
 #else
 	using ResourceFile = ResourceFileStream<std::ifstream>;
 #endif
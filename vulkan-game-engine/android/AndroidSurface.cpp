@@ -4,6 +4,7 @@
 #include "../logic/GameLogicEngine.hpp"
 
 #include <renderer/GameGraphicEngine.hpp>
+#include <renderer/PipelineCache.hpp>
 #include <logic/GameLogicEngine.hpp>
 #include <tools/ResultHandler.hpp>
 
@@ -37,6 +38,11 @@ noxcain::AndroidSurface::AndroidSurface(android_app *state) : app_state( state )
     app_state->onInputEvent = input_event_callback;
     app_state->userData = this;
     AndroidFile::set_manager( app_state->activity->assetManager );
+    if( app_state->activity->internalDataPath )
+    {
+        // the assets are read only, the pipeline cache needs the app data directory
+        PipelineCache::set_directory( app_state->activity->internalDataPath );
+    }
 }
 
 void noxcain::AndroidSurface::draw() {
@@ -137,10 +143,13 @@ int32_t noxcain::AndroidSurface::input_event_callback(struct android_app *app, A
 }
 
 noxcain::NxFile &noxcain::AndroidFile::read(char *buffer, std::size_t count) {
+    last_read_count = 0;
     if( asset_manager && file )
     {
-        AAsset_read( file, buffer, count );
+        const int read_count = AAsset_read( file, buffer, count );
+        last_read_count = read_count > 0 ? std::size_t( read_count ) : 0;
     }
+    read_failed = last_read_count != count;
     return *this;
 }
 
@@ -162,6 +171,14 @@ bool noxcain::AndroidFile::is_open() const {
     return file;
 }
 
+bool noxcain::AndroidFile::fail() const {
+    return read_failed;
+}
+
+std::size_t noxcain::AndroidFile::gcount() const {
+    return last_read_count;
+}
+
 void noxcain::AndroidFile::open(const char *path) {
     if( asset_manager ) {
         file = AAssetManager_open(asset_manager, path, AASSET_MODE_STREAMING);
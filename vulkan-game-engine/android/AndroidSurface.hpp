@@ -33,6 +33,8 @@ namespace noxcain
 		static void set_manager( AAssetManager* manager );
 		void open( const char* path );
 		bool is_open() const;
+		bool fail() const;
+		std::size_t gcount() const;
 		NxFile& seekg( UINT32 offset );
 		UINT32 tellg();
 		NxFile& read_fundamental( char* buffer, std::size_t count );
@@ -40,5 +42,7 @@ namespace noxcain
 	private:
 		static AAssetManager* asset_manager;
 		AAsset* file = nullptr;
+		std::size_t last_read_count = 0;
+		bool read_failed = false;
 	};
 }
\ No newline at end of file
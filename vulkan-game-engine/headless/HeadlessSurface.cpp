@@ -0,0 +1,361 @@
+#if defined( __linux__ ) && !defined( __ANDROID__ )
+
+#include "HeadlessSurface.hpp"
+
+#include <renderer/CommandStatistics.hpp>
+#include <renderer/GameGraphicEngine.hpp>
+#include <renderer/PipelineCache.hpp>
+#include <logic/GameLogicEngine.hpp>
+#include <tools/FrameStatistics.hpp>
+#include <tools/TimeFrame.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+	bool parse_number( const char* text, noxcain::UINT32& value )
+	{
+		char* end = nullptr;
+		const unsigned long number = std::strtoul( text, &end, 10 );
+		if( !end || *end != '\0' || end == text || number == 0 || number > 0xFFFFFFFFUL )
+		{
+			return false;
+		}
+		value = noxcain::UINT32( number );
+		return true;
+	}
+
+	void print_usage( const char* program )
+	{
+		std::cerr << "usage: " << program << " [--frames count] [--width pixels] [--height pixels] [--dump directory] [--dump-interval frames] [--trace file] [--benchmark fields] [--record file] [--replay file] [--dynamic-resolution fps] [--resources directory] [--validation]\n";
+	}
+}
+
+bool noxcain::HeadlessSurface::parse_arguments( int argc, char** argv, Settings& settings )
+{
+	for( int index = 1; index < argc; ++index )
+	{
+		const std::string_view argument( argv[index] );
+		if( argument == "--validation" )
+		{
+			// the only switch without a value
+			settings.is_validated = true;
+			continue;
+		}
+
+		const char* value = index + 1 < argc ? argv[index + 1] : nullptr;
+		bool is_valid = value != nullptr;
+
+		if( argument == "--frames" && is_valid )
+		{
+			is_valid = parse_number( value, settings.frame_count );
+		}
+		else if( argument == "--width" && is_valid )
+		{
+			is_valid = parse_number( value, settings.extent.width );
+		}
+		else if( argument == "--height" && is_valid )
+		{
+			is_valid = parse_number( value, settings.extent.height );
+		}
+		else if( argument == "--dump" && is_valid )
+		{
+			settings.dump_directory = value;
+		}
+		else if( argument == "--dump-interval" && is_valid )
+		{
+			is_valid = parse_number( value, settings.dump_interval );
+		}
+		else if( argument == "--trace" && is_valid )
+		{
+			settings.trace_file = value;
+		}
+		else if( argument == "--benchmark" && is_valid )
+		{
+			is_valid = parse_number( value, settings.benchmark_field_count );
+		}
+		else if( argument == "--record" && is_valid )
+		{
+			settings.record_file = value;
+		}
+		else if( argument == "--replay" && is_valid )
+		{
+			settings.replay_file = value;
+		}
+		else if( argument == "--dynamic-resolution" && is_valid )
+		{
+			is_valid = parse_number( value, settings.dynamic_resolution_fps );
+		}
+		else if( argument == "--resources" && is_valid )
+		{
+			// resources are loaded relative to the working directory
+			std::error_code error;
+			std::filesystem::current_path( value, error );
+			is_valid = !error;
+		}
+		else
+		{
+			is_valid = false;
+		}
+
+		if( !is_valid )
+		{
+			print_usage( argv[0] );
+			return false;
+		}
+		++index;
+	}
+	return true;
+}
+
+bool noxcain::HeadlessSurface::draw()
+{
+	if( !settings.dump_directory.empty() )
+	{
+		std::error_code error;
+		std::filesystem::create_directories( settings.dump_directory, error );
+		if( error )
+		{
+			std::cerr << "can not create dump directory " << settings.dump_directory << "\n";
+			return false;
+		}
+	}
+
+	// up to eight time frames per collection and frame are kept for the report
+	TimeFrameCollector::set_history_depth( std::max<std::size_t>( TimeFrameCollector::get_history_depth(), std::size_t( settings.frame_count ) * 8 ) );
+
+	if( settings.benchmark_field_count )
+	{
+		// the benchmark runs as long as frames are requested
+		BenchmarkSettings benchmark_settings;
+		benchmark_settings.field_count = settings.benchmark_field_count;
+		benchmark_settings.frame_count = 0;
+		LogicEngine::select_benchmark( benchmark_settings );
+	}
+
+	if( !settings.replay_file.empty() && !LogicEngine::select_input_replay( settings.replay_file ) )
+	{
+		std::cerr << "can not read input log " << settings.replay_file << "\n";
+		return false;
+	}
+
+	if( !settings.record_file.empty() && !LogicEngine::start_input_recording( settings.record_file ) )
+	{
+		std::cerr << "can not write input log " << settings.record_file << "\n";
+		return false;
+	}
+
+	if( settings.dynamic_resolution_fps )
+	{
+		DynamicResolutionSettings resolution_settings;
+		resolution_settings.target_frame_time = std::chrono::nanoseconds( 1000000000 / settings.dynamic_resolution_fps );
+		LogicEngine::enable_dynamic_resolution( resolution_settings );
+	}
+
+	if( !settings.trace_file.empty() && !TimeFrameCollector::start_trace( settings.trace_file ) )
+	{
+		std::cerr << "can not write trace file " << settings.trace_file << "\n";
+		return false;
+	}
+
+	if( !GraphicEngine::run( shared_from_this() ) )
+	{
+		std::cerr << "no vulkan device can render offscreen\n";
+		TimeFrameCollector::stop_trace();
+		return false;
+	}
+
+	{
+		std::unique_lock lock( state_mutex );
+		state_condition.wait( lock, [this]() { return is_closed; } );
+	}
+
+	if( TimeFrameCollector::is_tracing() )
+	{
+		TimeFrameCollector::stop_trace();
+	}
+
+	print_report( std::cout );
+
+	std::unique_lock lock( state_mutex );
+	return completed_frame_count >= settings.frame_count && !validation_error_count;
+}
+
+vk::SurfaceKHR noxcain::HeadlessSurface::create_surface( const vk::Instance& instance )
+{
+	return vk::SurfaceKHR();
+}
+
+void noxcain::HeadlessSurface::add_surface_extension( std::vector<const char*>& extensions ) const
+{
+}
+
+void noxcain::HeadlessSurface::close() const
+{
+	std::unique_lock lock( state_mutex );
+	is_closed = true;
+	state_condition.notify_all();
+}
+
+noxcain::HeadlessSurface::operator bool() const
+{
+	std::unique_lock lock( state_mutex );
+	return !is_closed;
+}
+
+bool noxcain::HeadlessSurface::window_changed() const
+{
+	return false;
+}
+
+void noxcain::HeadlessSurface::recreate_swapchain( bool recreate_surface ) const
+{
+	// there is no message loop, the images are recreated right away
+	if( GraphicEngine::execute_swapchain_recreation( false ) ) LogicEngine::resume();
+	else LogicEngine::finish();
+}
+
+bool noxcain::HeadlessSurface::is_offscreen() const
+{
+	return true;
+}
+
+vk::Extent2D noxcain::HeadlessSurface::get_offscreen_extent() const
+{
+	return settings.extent;
+}
+
+void noxcain::HeadlessSurface::offscreen_frame_complete( UINT32 image_index ) const
+{
+	UINT32 frame_number = 0;
+	{
+		std::unique_lock lock( state_mutex );
+		if( completed_frame_count >= settings.frame_count )
+		{
+			// frames in flight when the logic finished
+			return;
+		}
+
+		last_frame_time = std::chrono::steady_clock::now();
+		if( !completed_frame_count )
+		{
+			first_frame_time = last_frame_time;
+		}
+		frame_number = completed_frame_count++;
+	}
+
+	if( !settings.dump_directory.empty() && frame_number % settings.dump_interval == 0 )
+	{
+		write_frame( image_index, frame_number );
+	}
+
+	if( frame_number + 1 == settings.frame_count )
+	{
+		LogicEngine::finish();
+	}
+}
+
+bool noxcain::HeadlessSurface::is_validated() const
+{
+	return settings.is_validated;
+}
+
+void noxcain::HeadlessSurface::validation_message( bool is_error, const char* message ) const
+{
+	++( is_error ? validation_error_count : validation_warning_count );
+
+	// one write per message, messages of different threads do not interleave within a line
+	std::ostringstream line;
+	line << ( is_error ? "validation error: " : "validation warning: " ) << message << "\n";
+	std::cerr << line.str();
+}
+
+noxcain::HeadlessSurface::HeadlessSurface( const Settings& settings ) : settings( settings )
+{
+}
+
+void noxcain::HeadlessSurface::write_frame( UINT32 image_index, UINT32 frame_number ) const
+{
+	std::vector<BYTE> pixels;
+	if( !GraphicEngine::read_offscreen_image( image_index, pixels ) )
+	{
+		return;
+	}
+
+	std::ostringstream file_name;
+	file_name << "frame_" << std::setw( 6 ) << std::setfill( '0' ) << frame_number << ".ppm";
+
+	std::ofstream file( std::filesystem::path( settings.dump_directory ) / file_name.str(), std::ios::binary | std::ios::trunc );
+	file << "P6\n" << settings.extent.width << " " << settings.extent.height << "\n255\n";
+
+	// ppm has no alpha channel
+	std::vector<char> row( std::size_t( settings.extent.width ) * 3 );
+	for( std::size_t y = 0; y < settings.extent.height; ++y )
+	{
+		const BYTE* source = pixels.data() + y * settings.extent.width * 4;
+		for( std::size_t x = 0; x < settings.extent.width; ++x )
+		{
+			row[3 * x] = char( source[4 * x] );
+			row[3 * x + 1] = char( source[4 * x + 1] );
+			row[3 * x + 2] = char( source[4 * x + 2] );
+		}
+		file.write( row.data(), row.size() );
+	}
+}
+
+void noxcain::HeadlessSurface::print_report( std::ostream& stream ) const
+{
+	{
+		std::unique_lock lock( state_mutex );
+		const DOUBLE duration = std::chrono::duration<DOUBLE, std::milli>( last_frame_time - first_frame_time ).count();
+		stream << "frames: " << completed_frame_count << ", resolution: " << settings.extent.width << "x" << settings.extent.height << "\n";
+		if( settings.dynamic_resolution_fps )
+		{
+			const auto resolution = LogicEngine::get_graphic_settings().get_accumulated_resolution();
+			stream << "dynamic resolution: last frame rendered at " << resolution.width << "x" << resolution.height << "\n";
+		}
+		if( completed_frame_count > 1 && duration > 0.0 )
+		{
+			stream << std::fixed << std::setprecision( 3 ) << "average frame: " << duration / ( completed_frame_count - 1 ) << " ms, "
+				<< ( completed_frame_count - 1 ) * 1000.0 / duration << " fps\n";
+		}
+	}
+
+	// the benchmark level already printed its summary with these
+	if( !settings.benchmark_field_count )
+	{
+		LogicEngine::get_cpu_frame_statistics().write_summary( stream );
+		LogicEngine::get_gpu_frame_statistics().write_summary( stream );
+		write_stage_summary( stream );
+	}
+
+	GraphicEngine::get_pipeline_cache().get_statistics().write_summary( stream );
+
+	if( settings.is_validated )
+	{
+		stream << "validation: " << validation_error_count << " errors, " << validation_warning_count << " warnings\n";
+	}
+
+	stream << "commands of the last frame:\n";
+	for( const CommandStatistics::TaskCounts& task : CommandStatistics::get_task_counts() )
+	{
+		stream << "  " << task.task_name << ( task.is_reused ? " (reused)" : "" ) << ": recorded " << task.recorded_count << ", skipped " << task.reused_count
+			<< " (" << std::fixed << std::setprecision( 1 ) << task.get_skip_ratio() * 100.0 << "%),";
+		const auto values = task.counts.get_values();
+		for( std::size_t index = 0; index < values.size(); ++index )
+		{
+			stream << ( index ? ", " : " " ) << values[index].first << " " << values[index].second;
+		}
+		stream << "\n";
+	}
+}
+
+#endif // __linux__
@@ -0,0 +1,94 @@
+#pragma once
+#include <PresentationSurface.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+namespace noxcain
+{
+	/// <summary>
+	/// presentation surface without a display, frames are rendered into offscreen images until the frame count is reached
+	/// </summary>
+	class HeadlessSurface : public PresentationSurface
+	{
+	public:
+		struct Settings
+		{
+			UINT32 frame_count = 1000;
+			vk::Extent2D extent = vk::Extent2D( 1280, 720 );
+
+			// every dump_interval-th frame is written as ppm file, nothing is written if empty
+			std::string dump_directory;
+			UINT32 dump_interval = 1;
+
+			// chrome trace of all time frames, nothing is written if empty
+			std::string trace_file;
+
+			// runs the generated benchmark level with this many fields instead of the game if not 0
+			UINT32 benchmark_field_count = 0;
+
+			// input log written while running, nothing is recorded if empty
+			std::string record_file;
+
+			// input log replayed instead of live input, the run also ends at its end
+			std::string replay_file;
+
+			// the dynamic resolution keeps the gpu frame time below this frame rate if not 0
+			UINT32 dynamic_resolution_fps = 0;
+
+			// all vulkan calls are checked by the validation layer, the run fails on any error
+			bool is_validated = false;
+		};
+
+		/// <summary>
+		/// reads the settings from the command line, prints the usage on invalid arguments
+		/// </summary>
+		/// <returns>false if the engine should not be started</returns>
+		static bool parse_arguments( int argc, char** argv, Settings& settings );
+
+		/// <summary>
+		/// runs the engine until all frames are rendered and prints the timings of all stages
+		/// </summary>
+		/// <returns>true if all frames were rendered</returns>
+		bool draw();
+
+		vk::SurfaceKHR create_surface( const vk::Instance& instance ) override;
+		void add_surface_extension( std::vector<const char*>& extensions ) const override;
+
+		void close() const override;
+		explicit operator bool() const override;
+		bool window_changed() const override;
+		void recreate_swapchain( bool recreate_surface ) const override;
+
+		bool is_offscreen() const override;
+		vk::Extent2D get_offscreen_extent() const override;
+		void offscreen_frame_complete( UINT32 image_index ) const override;
+
+		bool is_validated() const override;
+		void validation_message( bool is_error, const char* message ) const override;
+
+		HeadlessSurface( const Settings& settings );
+
+	private:
+		const Settings settings;
+
+		// frames are completed on the submit thread
+		mutable std::mutex state_mutex;
+		mutable std::condition_variable state_condition;
+		mutable bool is_closed = false;
+		mutable UINT32 completed_frame_count = 0;
+		mutable std::chrono::steady_clock::time_point first_frame_time;
+		mutable std::chrono::steady_clock::time_point last_frame_time;
+
+		// messages arrive on any thread that calls into vulkan
+		mutable std::atomic<UINT32> validation_error_count = 0;
+		mutable std::atomic<UINT32> validation_warning_count = 0;
+
+		void write_frame( UINT32 image_index, UINT32 frame_number ) const;
+		void print_report( std::ostream& stream ) const;
+	};
+}
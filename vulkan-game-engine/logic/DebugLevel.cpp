@@ -7,8 +7,15 @@
 #include <logic/gui/Button.hpp>
 #include <logic/gui/Label.hpp>
 
+#include <renderer/CommandStatistics.hpp>
+#include <renderer/GameGraphicEngine.hpp>
+#include <renderer/PipelineCache.hpp>
+
 #include <tools/TimeFrame.hpp>
 
+#include <iomanip>
+#include <sstream>
+
 void noxcain::DebugLevel::initialize()
 {
 	setup_events();
@@ -58,7 +65,7 @@ void noxcain::DebugLevel::initialize()
 		}
 		
 		auto& group_description = time_frame_group_labels[index];
-		group_description->setup_as_group_label( *background, LABEL_DISTANCE, -LABEL_DISTANCE - BLOCK_HEIGHT * index, LABEL_WIDTH, 25.0, BASE_COLOR_FAC, BASE_COLOR_FAC, BASE_COLOR_FAC, time_frame_collections[index]->get_description() );
+		group_description->setup_as_group_label( *background, LABEL_DISTANCE, -LABEL_DISTANCE - BLOCK_HEIGHT * index, LABEL_WIDTH, 25.0, BASE_COLOR_FAC, BASE_COLOR_FAC, BASE_COLOR_FAC, time_frame_collections[index].get_description() );
 		background->add_branch( *group_description );
 	}
 
@@ -159,7 +166,7 @@ void noxcain::DebugLevel::update_level_logic( const std::chrono::nanoseconds& de
 	std::size_t time_frame_count = 0;
 	for( index = 0; index < collections.size(); ++index )
 	{
-		for( const auto& time_frame : *collections[index] )
+		for( const auto& time_frame : collections[index] )
 		{
 			if( time_frame.end <= start_frame ) continue;
 			if( time_frame.start_frame >= end ) break;
@@ -173,8 +180,8 @@ void noxcain::DebugLevel::update_level_logic( const std::chrono::nanoseconds& de
 
 			time_label->setup_as_time_frame(
 				*time_frame_group_labels[index], factor * ( time_frame.start_frame - start_frame ).count(), ( time_frame.end - time_frame.start_frame ).count()* factor,
-				time_frame.color[0], time_frame.color[1], time_frame.color[2],
-				time_frame.description, std::chrono::duration_cast<std::chrono::nanoseconds>( time_frame.end - time_frame.start_frame ).count(),
+				time_frame.zone->color[0], time_frame.zone->color[1], time_frame.zone->color[2],
+				time_frame.zone->description, std::chrono::duration_cast<std::chrono::nanoseconds>( time_frame.end - time_frame.start_frame ).count(),
 				*scissor_label );
 
 			++time_frame_count;
@@ -185,6 +192,47 @@ void noxcain::DebugLevel::update_level_logic( const std::chrono::nanoseconds& de
 	{
 		time_frame_labels[time_frame_count]->hide();
 	}
+
+	update_statistic_labels();
+}
+
+void noxcain::DebugLevel::update_statistic_labels()
+{
+	// the pipeline cache first, then one line per recording task
+	std::vector<std::string> lines;
+	std::stringstream cache_text;
+	GraphicEngine::get_pipeline_cache().get_statistics().write_summary( cache_text );
+	lines.push_back( cache_text.str() );
+	lines.back().pop_back();
+
+	for( const CommandStatistics::TaskCounts& task : CommandStatistics::get_task_counts() )
+	{
+		const CommandCounts& counts = task.counts;
+		std::stringstream text;
+		text << task.task_name << ( task.is_reused ? " (reused)" : "" ) << ": "
+			<< task.recorded_count << " recorded, " << task.reused_count << " skipped (" << std::fixed << std::setprecision( 1 ) << task.get_skip_ratio() * 100.0 << "%), "
+			<< counts.command_count << " commands, "
+			<< counts.pipeline_binds << " pipeline binds, " << counts.pipeline_switches << " switches, "
+			<< counts.descriptor_binds << " descriptor binds, " << counts.push_constants << " push constants (" << counts.push_constant_bytes << " bytes), "
+			<< counts.draws << " draws, " << counts.instances << " instances";
+		lines.push_back( text.str() );
+	}
+
+	for( std::size_t index = 0; index < lines.size(); ++index )
+	{
+		if( index >= statistic_labels.size() )
+		{
+			auto& label = statistic_labels.emplace_back( std::make_unique<VectorText2D>( ui.get_texts() ) );
+			if( index ) label->set_vertical_anchor( VerticalAnchorType::TOP, *statistic_labels[index - 1], VerticalAnchorType::BOTTOM );
+			else label->set_vertical_anchor( VerticalAnchorType::TOP, *background, VerticalAnchorType::BOTTOM, -LABEL_DISTANCE );
+			label->set_left_anchor( *background );
+			label->set_depth_level( 20 );
+			label->get_text().set_color( 1.0, 1.0, 1.0, 1.0 );
+			label->get_text().set_size( 20 );
+			label->show();
+		}
+		statistic_labels[index]->get_text().set_utf8( lines[index] );
+	}
 }
 
 noxcain::DebugLevel::DebugLevel() : exit_button( std::make_unique<BaseButton>( ui ) )
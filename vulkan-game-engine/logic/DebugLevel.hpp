@@ -78,6 +78,10 @@ namespace noxcain
 		std::chrono::steady_clock::time_point performance_time_stamp;
 		std::unique_ptr<Region> scissor_label;
 
+		// pipeline cache and recording task lines below the time frames
+		std::vector<std::unique_ptr<VectorText2D>> statistic_labels;
+		void update_statistic_labels();
+
 		void initialize();
 
 		void setup_events();
@@ -0,0 +1,56 @@
+#include "DynamicResolution.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+noxcain::DynamicResolution::DynamicResolution( const DynamicResolutionSettings& settings ) : settings( settings )
+{
+}
+
+const noxcain::DynamicResolutionSettings& noxcain::DynamicResolution::get_settings() const
+{
+	return settings;
+}
+
+noxcain::FLOAT32 noxcain::DynamicResolution::update( const std::chrono::nanoseconds& gpu_frame_time, FLOAT32 current_factor )
+{
+	const FLOAT32 factor = clamp_factor( current_factor );
+	if( settle_frame_count )
+	{
+		--settle_frame_count;
+		return factor;
+	}
+
+	const DOUBLE load = std::chrono::duration<DOUBLE>( gpu_frame_time ) / std::chrono::duration<DOUBLE>( settings.target_frame_time );
+	FLOAT32 new_factor = factor;
+	if( load > settings.upper_load )
+	{
+		// the gpu time grows with the pixel count, the square of the factor
+		const FLOAT32 wanted_factor = FLOAT32( factor * std::sqrt( settings.lowered_load / load ) );
+		new_factor = clamp_factor( std::min( std::floor( wanted_factor / settings.factor_step ) * settings.factor_step, factor - settings.factor_step ) );
+		calm_frame_count = 0;
+	}
+	else if( load < settings.lower_load )
+	{
+		if( ++calm_frame_count >= settings.raise_frame_count )
+		{
+			new_factor = clamp_factor( factor + settings.factor_step );
+			calm_frame_count = 0;
+		}
+	}
+	else
+	{
+		calm_frame_count = 0;
+	}
+
+	if( new_factor != factor )
+	{
+		settle_frame_count = settings.settle_frame_count;
+	}
+	return new_factor;
+}
+
+noxcain::FLOAT32 noxcain::DynamicResolution::clamp_factor( FLOAT32 factor ) const
+{
+	return std::clamp( factor, settings.min_super_sampling_factor, settings.max_super_sampling_factor );
+}
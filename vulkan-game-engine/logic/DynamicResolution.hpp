@@ -0,0 +1,54 @@
+#pragma once
+#include <Defines.hpp>
+
+#include <chrono>
+
+namespace noxcain
+{
+	/// <summary>
+	/// limits and thresholds of the dynamic resolution, loads are gpu frame times relative to the target frame time
+	/// </summary>
+	struct DynamicResolutionSettings
+	{
+		std::chrono::nanoseconds target_frame_time = std::chrono::nanoseconds( 16666667 );
+
+		// the render targets are allocated for the maximal factor
+		FLOAT32 min_super_sampling_factor = 0.5F;
+		FLOAT32 max_super_sampling_factor = 1.0F;
+
+		// changes are multiples of this step, so small load changes do not re-record all commands
+		FLOAT32 factor_step = 0.05F;
+
+		// a single frame above the upper load lowers the factor until the lowered load is expected
+		DOUBLE upper_load = 0.95;
+		DOUBLE lowered_load = 0.85;
+
+		// the factor is raised by one step after this many frames in a row below the lower load
+		DOUBLE lower_load = 0.7;
+		UINT32 raise_frame_count = 60;
+
+		// frames in flight still show the cost of the old factor
+		UINT32 settle_frame_count = 3;
+	};
+
+	/// <summary>
+	/// chooses the super sampling factor from the gpu frame times, lowers it at once under load and raises it slowly
+	/// </summary>
+	class DynamicResolution
+	{
+	public:
+		DynamicResolution( const DynamicResolutionSettings& settings );
+
+		const DynamicResolutionSettings& get_settings() const;
+
+		/// <returns>the factor for the next frames</returns>
+		FLOAT32 update( const std::chrono::nanoseconds& gpu_frame_time, FLOAT32 current_factor );
+
+	private:
+		const DynamicResolutionSettings settings;
+		UINT32 calm_frame_count = 0;
+		UINT32 settle_frame_count = 0;
+
+		FLOAT32 clamp_factor( FLOAT32 factor ) const;
+	};
+}
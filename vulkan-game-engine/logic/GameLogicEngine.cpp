@@ -11,10 +11,15 @@
 #include <logic/VectorText3D.hpp>
 #include <logic/InputEventHandler.hpp>
 
+#include <logic/level/BenchmarkLevel.hpp>
 #include <logic/level/MineSweeperLevel.hpp>
 
 #include <tools/TimeFrame.hpp>
 
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
 std::unique_ptr<noxcain::LogicEngine> noxcain::LogicEngine::engine = std::unique_ptr<LogicEngine>( new LogicEngine() );
 
 noxcain::LogicEngine::LogicEngine()
@@ -26,13 +31,16 @@ noxcain::LogicEngine::LogicEngine()
 	write_graphic_settings.current_sample_count = 2;
 	write_graphic_settings.max_sample_count = 8;
 	write_graphic_settings.current_super_sampling_factor = 1.0F;
+	write_graphic_settings.max_super_sampling_factor = 1.0F;
 }
 
 noxcain::UINT32 noxcain::LogicEngine::logic_update()
 {
 	if( !current_level )
 	{
-		current_level = std::make_unique<MineSweeperLevel>();
+		std::srand( random_seed );
+		if( benchmark_settings ) current_level = std::make_unique<BenchmarkLevel>( *benchmark_settings );
+		else current_level = std::make_unique<MineSweeperLevel>();
 		debug_level = std::make_unique<DebugLevel>();
 	}
 	
@@ -45,24 +53,56 @@ noxcain::UINT32 noxcain::LogicEngine::logic_update()
 		{
 			std::vector<KeyEvent> old_key_events;
 			std::vector<RegionalKeyEvent> old_region_key_events;
+			std::vector<RecordedInputEvent> frame_events;
+			std::chrono::nanoseconds deltaTime = std::chrono::nanoseconds::zero();
+			bool is_replay_finished = false;
 			{
 				std::unique_lock event_lock( event_mutex );
+				if( is_replaying )
+				{
+					// live input is ignored, the log delivers the events and the delta time of this frame
+					is_replay_finished = !input_replay.read_frame( deltaTime, replay_events );
+					for( const RecordedInputEvent& event : replay_events )
+					{
+						if( push_event( event.type, event.param1, event.param2, event.param3 ) && input_recorder )
+						{
+							recorded_events.push_back( event );
+						}
+					}
+				}
 				old_key_events.swap( new_key_events );
 				old_region_key_events.swap( new_region_key_events );
+				frame_events.swap( recorded_events );
 				if( old_region_key_events.empty() )
 				{
 					old_region_key_events.emplace_back( RegionalKeyEvent::KeyCodes::NONE, RegionalKeyEvent::Events::NONE, cursor_position.x, cursor_position.y );
 				}
 			}
 
-			if( time_start_reset )
+			if( is_replay_finished )
 			{
-				last_update_time_point = std::chrono::steady_clock::now();
-				time_start_reset = false;
+				finish_game();
+				status = Status::EXIT;
+				status_condition.notify_all();
+				continue;
+			}
+
+			if( !is_replaying )
+			{
+				if( time_start_reset )
+				{
+					last_update_time_point = std::chrono::steady_clock::now();
+					time_start_reset = false;
+				}
+				auto time_now = std::chrono::steady_clock::now();
+				deltaTime = ( std::chrono::duration_cast<std::chrono::nanoseconds>( time_now - last_update_time_point ) );
+				last_update_time_point = time_now;
+			}
+
+			if( input_recorder )
+			{
+				input_recorder.write_frame( deltaTime, frame_events );
 			}
-			auto time_now = std::chrono::steady_clock::now();
-			std::chrono::nanoseconds deltaTime = ( std::chrono::duration_cast<std::chrono::nanoseconds>( time_now - last_update_time_point ) );
-			last_update_time_point = time_now;
 
 			//debug level is just an overlay so it dont get any own key events
 			current_level->update_key_events( old_key_events );
@@ -110,6 +150,24 @@ noxcain::LogicEngine::~LogicEngine()
 
 void noxcain::LogicEngine::finish_game()
 {
+	{
+		std::unique_lock event_lock( event_mutex );
+		input_recorder.close();
+		input_replay.close();
+	}
+
+	if( current_level )
+	{
+		current_level->finish_level();
+	}
+
+	std::ofstream file( "frame_statistics.csv", std::ios::trunc );
+	if( file )
+	{
+		FrameStatistics::write_csv_header( file );
+		cpu_frame_statistics.write_csv_rows( file );
+		gpu_frame_statistics.write_csv_rows( file );
+	}
 }
 
 const noxcain::GameLevel::RenderableContainer<noxcain::GeometryObject>& noxcain::LogicEngine::get_geometry_objects()
@@ -145,38 +203,52 @@ const noxcain::GameLevel::RenderableContainer<noxcain::VectorText3D>& noxcain::L
 void noxcain::LogicEngine::set_event( InputEventTypes type, INT32 param1, INT32 param2, UINT32 param3 )
 {
 	std::lock_guard<std::mutex> lock( engine->event_mutex );
+	if( engine->is_replaying )
+	{
+		return;
+	}
+	if( engine->push_event( type, param1, param2, param3 ) && engine->input_recorder )
+	{
+		engine->recorded_events.push_back( engine->input_recorder.make_event( type, param1, param2, param3 ) );
+	}
+}
+
+bool noxcain::LogicEngine::push_event( InputEventTypes type, INT32 param1, INT32 param2, UINT32 param3 )
+{
 	switch( type )
 	{
 		case InputEventTypes::KEY_DOWN:
 		{
-			engine->new_key_events.emplace_back( true, param3 );
-			break;
+			new_key_events.emplace_back( true, param3 );
+			return true;
 		}
 		case InputEventTypes::KEY_UP:
 		{
-			engine->new_key_events.emplace_back( false, param3 );
-			break;
+			new_key_events.emplace_back( false, param3 );
+			return true;
 		}
 		case InputEventTypes::REGION_KEY_DOWN:
 		{
-			engine->new_region_key_events.emplace_back( static_cast<RegionalKeyEvent::KeyCodes>( param3 ), RegionalKeyEvent::Events::DOWN, param1, param2 );
-			break;
+			new_region_key_events.emplace_back( static_cast<RegionalKeyEvent::KeyCodes>( param3 ), RegionalKeyEvent::Events::DOWN, param1, param2 );
+			return true;
 		}
 		case InputEventTypes::REGION_KEY_UP:
 		{
-			engine->new_region_key_events.emplace_back( static_cast<RegionalKeyEvent::KeyCodes>( param3 ), RegionalKeyEvent::Events::UP, param1, param2 );
-			break;
+			new_region_key_events.emplace_back( static_cast<RegionalKeyEvent::KeyCodes>( param3 ), RegionalKeyEvent::Events::UP, param1, param2 );
+			return true;
 		}
 		case InputEventTypes::REGION_MOVE:
 		{
-			if( engine->current_level )
+			if( current_level )
 			{
-				engine->cursor_position.x = param1;
-				engine->cursor_position.y = param2;
-				break;
+				cursor_position.x = param1;
+				cursor_position.y = param2;
+				return true;
 			}
+			return false;
 		}
 	};
+	return false;
 }
 
 void noxcain::LogicEngine::apply_graphic_settings()
@@ -258,6 +330,51 @@ void noxcain::LogicEngine::show_performance_overlay()
 	engine->debug_level->switch_on();
 }
 
+void noxcain::LogicEngine::select_benchmark( const BenchmarkSettings& settings )
+{
+	engine->benchmark_settings = settings;
+}
+
+bool noxcain::LogicEngine::start_input_recording( const std::string& file_name )
+{
+	std::unique_lock lock( engine->event_mutex );
+
+	// every recording plays with another seed, the replay restores it
+	if( !engine->is_replaying )
+	{
+		engine->random_seed = UINT32( std::chrono::system_clock::now().time_since_epoch().count() );
+	}
+	return engine->input_recorder.open( file_name, engine->random_seed );
+}
+
+bool noxcain::LogicEngine::select_input_replay( const std::string& file_name )
+{
+	std::unique_lock lock( engine->event_mutex );
+	if( !engine->input_replay.open( file_name ) )
+	{
+		return false;
+	}
+	engine->random_seed = engine->input_replay.get_random_seed();
+	engine->is_replaying = true;
+	return true;
+}
+
+void noxcain::LogicEngine::enable_dynamic_resolution( const DynamicResolutionSettings& settings )
+{
+	std::unique_lock lock( engine->write_settings_mutex );
+	engine->dynamic_resolution.emplace( settings );
+	engine->write_graphic_settings.is_dynamic_resolution = true;
+	engine->write_graphic_settings.max_super_sampling_factor = settings.max_super_sampling_factor;
+	engine->write_graphic_settings.current_super_sampling_factor = settings.max_super_sampling_factor;
+}
+
+void noxcain::LogicEngine::update_dynamic_resolution( const std::chrono::nanoseconds& gpu_frame_time )
+{
+	// applied with the other settings before the next frame is recorded
+	std::unique_lock lock( write_settings_mutex );
+	write_graphic_settings.current_super_sampling_factor = dynamic_resolution->update( gpu_frame_time, write_graphic_settings.current_super_sampling_factor );
+}
+
 noxcain::CursorPosition noxcain::LogicEngine::get_cursor_position()
 {
 	std::unique_lock lock( engine->event_mutex );
@@ -274,6 +391,16 @@ noxcain::NxMatrix4x4 noxcain::LogicEngine::get_camera_matrix()
 	return engine->current_level->get_active_camera();
 }
 
+noxcain::UINT64 noxcain::LogicEngine::get_scene_version()
+{
+	std::unique_lock lock( engine->status_mutex );
+	engine->status_condition.wait( lock, []()->bool
+	{
+		return engine->status == Status::DORMANT || engine->status == Status::EXIT;
+	} );
+	return engine->current_level->get_scene_version();
+}
+
 void noxcain::LogicEngine::set_sample_count( UINT32 count )
 {
 	std::unique_lock lock( engine->write_settings_mutex );
@@ -324,4 +451,18 @@ noxcain::ResolutionSetting noxcain::GraphicSetting::get_accumulated_resolution()
 	setting.width = UINT32( settings.current_resolution.width * settings.current_super_sampling_factor );
 	setting.height = UINT32( settings.current_resolution.height * settings.current_super_sampling_factor );
 	return setting;
+}
+
+noxcain::ResolutionSetting noxcain::GraphicSetting::get_allocated_resolution() const
+{
+	if( !settings.is_dynamic_resolution )
+	{
+		return get_accumulated_resolution();
+	}
+
+	const FLOAT32 factor = std::max( settings.current_super_sampling_factor, settings.max_super_sampling_factor );
+	ResolutionSetting setting;
+	setting.width = UINT32( settings.current_resolution.width * factor );
+	setting.height = UINT32( settings.current_resolution.height * factor );
+	return setting;
 }
\ No newline at end of file
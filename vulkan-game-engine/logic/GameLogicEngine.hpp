@@ -6,6 +6,11 @@
 
 #include <logic/Renderable.hpp>
 #include <logic/Level.hpp>
+#include <logic/InputRecording.hpp>
+#include <logic/DynamicResolution.hpp>
+#include <logic/level/BenchmarkLevel.hpp>
+
+#include <tools/FrameStatistics.hpp>
 
 #include <memory>
 #include <thread>
@@ -14,6 +19,8 @@
 #include <list>
 #include <condition_variable>
 #include <vector>
+#include <optional>
+#include <string>
 
 namespace noxcain
 {
@@ -50,6 +57,9 @@ namespace noxcain
 			FLOAT32 max_super_sampling_factor = 0;
 			FLOAT32 current_super_sampling_factor = 0;
 
+			// the factor changes every few frames, the render targets are kept at the maximal factor
+			bool is_dynamic_resolution = false;
+
 			ResolutionSetting current_resolution;
 		}&settings;
 
@@ -63,7 +73,15 @@ namespace noxcain
 		FLOAT32 get_max_super_sampling_factor() const;
 		FLOAT32 get_super_sampling_factor() const;
 		
+		/// <summary>
+		/// rendered part of the deferred targets
+		/// </summary>
 		ResolutionSetting get_accumulated_resolution() const;
+
+		/// <summary>
+		/// size of the deferred targets, larger than the accumulated resolution while the dynamic resolution lowered the factor
+		/// </summary>
+		ResolutionSetting get_allocated_resolution() const;
 	};
 
 	enum class InputEventTypes
@@ -89,6 +107,7 @@ namespace noxcain
 		}
 
 		static NxMatrix4x4 get_camera_matrix();
+		static UINT64 get_scene_version();
 
 		static void set_sample_count( UINT32 sample_count );
 		static void set_graphic_settings( UINT32 sampleCount, FLOAT32 superSamplingFactor, UINT32 width, UINT32 height );
@@ -110,16 +129,43 @@ namespace noxcain
 
 		static void show_performance_overlay();
 
+		/// <summary>
+		/// replaces the game with the generated benchmark level, has to be called before the engine runs
+		/// </summary>
+		static void select_benchmark( const BenchmarkSettings& settings );
+
+		/// <summary>
+		/// writes the input events and delta time of every logic frame into the file until the game is finished, has to be called before the engine runs
+		/// </summary>
+		static bool start_input_recording( const std::string& file_name );
+
+		/// <summary>
+		/// replaces the live input and the measured delta times with a recorded log, the game finishes at its end, has to be called before the engine runs
+		/// </summary>
+		static bool select_input_replay( const std::string& file_name );
+
+		/// <summary>
+		/// lets the gpu frame time choose the super sampling factor between the limits of the settings, has to be called before the engine runs
+		/// </summary>
+		static void enable_dynamic_resolution( const DynamicResolutionSettings& settings );
+
 		static CursorPosition get_cursor_position();
 
-		static void set_cpu_cycle_duration( std::chrono::nanoseconds duration )
+		static void add_cpu_cycle( const debugTimePoint& start, const debugTimePoint& end )
 		{
-			engine->cpu_cycle_duration = duration;
+			engine->cpu_cycle_duration = end - start;
+			engine->cpu_frame_statistics.add_frame( start, end );
 		}
 
-		static void set_gpu_cycle_duration( std::chrono::nanoseconds duration )
+		/// <param name="gpu_time">time the gpu worked on the frame, zero if unknown</param>
+		static void add_gpu_cycle( const debugTimePoint& start, const debugTimePoint& end, const std::chrono::nanoseconds& gpu_time )
 		{
-			engine->gpu_cycle_duration = duration;
+			engine->gpu_cycle_duration = end - start;
+			engine->gpu_frame_statistics.add_frame( start, end );
+			if( engine->dynamic_resolution )
+			{
+				engine->update_dynamic_resolution( gpu_time.count() ? gpu_time : engine->gpu_cycle_duration );
+			}
 		}
 
 		static std::chrono::nanoseconds get_cpu_cycle_duration()
@@ -132,6 +178,16 @@ namespace noxcain
 			return engine->gpu_cycle_duration;
 		}
 
+		static const FrameStatistics& get_cpu_frame_statistics()
+		{
+			return engine->cpu_frame_statistics;
+		}
+
+		static const FrameStatistics& get_gpu_frame_statistics()
+		{
+			return engine->gpu_frame_statistics;
+		}
+
 	private:
 		//singelton
 		LogicEngine();
@@ -148,8 +204,19 @@ namespace noxcain
 		std::chrono::nanoseconds cpu_cycle_duration = std::chrono::seconds( 1 );
 		bool time_start_reset = true;
 
+		// cpu hitches are attributed to recording stages, gpu hitches to gpu zones below the whole frame
+		FrameStatistics cpu_frame_statistics = FrameStatistics( "cpu", []( const std::string& collection_description, const TimeFrameZoneInfo& )
+		{
+			return collection_description != "GPU Overall" && collection_description != "GPU Zones";
+		} );
+		FrameStatistics gpu_frame_statistics = FrameStatistics( "gpu", []( const std::string& collection_description, const TimeFrameZoneInfo& zone )
+		{
+			return collection_description == "GPU Zones" && zone.description != "frame";
+		} );
+
 		//levels
 		std::unique_ptr<GameLevel> current_level;
+		std::optional<BenchmarkSettings> benchmark_settings;
 		std::unique_ptr<DebugLevel> debug_level;
 
 		//inputEvents
@@ -159,6 +226,19 @@ namespace noxcain
 
 		CursorPosition cursor_position;
 
+		// applies an event to the new events, false if it was ignored
+		bool push_event( InputEventTypes type, INT32 param1, INT32 param2, UINT32 param3 );
+
+		//input recording and replay
+		InputRecorder input_recorder;
+		std::vector<RecordedInputEvent> recorded_events;
+		InputReplay input_replay;
+		std::vector<RecordedInputEvent> replay_events;
+		bool is_replaying = false;
+
+		// seeds std::rand on the logic thread, recordings store it for the replay
+		UINT32 random_seed = 1;
+
 		//game status
 		mutable std::mutex status_mutex;
 		enum class Status
@@ -174,6 +254,10 @@ namespace noxcain
 		std::shared_mutex write_settings_mutex;
 		GraphicSetting::Settings read_graphic_settings;
 		GraphicSetting::Settings write_graphic_settings;
+
+		// only used by the submit thread once the engine runs
+		std::optional<DynamicResolution> dynamic_resolution;
+		void update_dynamic_resolution( const std::chrono::nanoseconds& gpu_frame_time );
 		
 		// finish game 
 		void finish_game();
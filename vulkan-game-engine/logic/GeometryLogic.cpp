@@ -1,4 +1,5 @@
 #include "GeometryLogic.hpp"
+#include <renderer/CommandStatistics.hpp>
 #include <resources/GeometryResource.hpp>
 #include <resources/GameResourceEngine.hpp>
 #include <math/Matrix.hpp>
@@ -12,7 +13,7 @@ noxcain::GeometryObject::GeometryObject( Renderable<GeometryObject>::List& visib
 {
 }
 
-void noxcain::GeometryObject::record( vk::CommandBuffer command_buffer, vk::PipelineLayout layout, UINT32 index_count ) const
+void noxcain::GeometryObject::record( CountingCommandBuffer& command_buffer, vk::PipelineLayout layout, UINT32 index_count ) const
 {
 	const auto& pos = get_world_matrix().gpuData();
 	command_buffer.pushConstants( layout, vk::ShaderStageFlagBits::eVertex, VERTEX_PUSH_OFFSET, VERTEX_PUSH_SIZE, pos.data() );
@@ -10,6 +10,7 @@
 namespace noxcain
 {
 	class BoundingBox;
+	class CountingCommandBuffer;
 	class GeometryObject : public SceneGraphNode, public Renderable<GeometryObject>
 	{
 	public:
@@ -18,7 +19,7 @@ namespace noxcain
 
 		GeometryObject( Renderable<GeometryObject>::List& visibility_list );
 
-		void record( vk::CommandBuffer command_buffer, vk::PipelineLayout layout, UINT32 index_count ) const;
+		void record( CountingCommandBuffer& command_buffer, vk::PipelineLayout layout, UINT32 index_count ) const;
 
 		void set_geometry( std::size_t id )
 		{
@@ -0,0 +1,136 @@
+#include "InputRecording.hpp"
+
+#include <logic/GameLogicEngine.hpp>
+
+#include <array>
+
+namespace
+{
+	constexpr std::array<char, 4> MAGIC = { 'N', 'X', 'I', 'R' };
+	constexpr noxcain::UINT32 VERSION = 1;
+
+	// reading more events per frame means the log is broken
+	constexpr noxcain::UINT32 MAX_FRAME_EVENT_COUNT = 1 << 16;
+
+	template<typename T>
+	void write_value( std::ostream& stream, const T& value )
+	{
+		stream.write( reinterpret_cast<const char*>( &value ), sizeof( T ) );
+	}
+
+	template<typename T>
+	bool read_value( std::istream& stream, T& value )
+	{
+		return bool( stream.read( reinterpret_cast<char*>( &value ), sizeof( T ) ) );
+	}
+}
+
+bool noxcain::InputRecorder::open( const std::string& file_name, UINT32 random_seed )
+{
+	close();
+
+	file.open( file_name, std::ios::out | std::ios::binary | std::ios::trunc );
+	if( !file )
+	{
+		return false;
+	}
+
+	file.write( MAGIC.data(), MAGIC.size() );
+	write_value( file, VERSION );
+	write_value( file, random_seed );
+	start_time = std::chrono::steady_clock::now();
+	return bool( file );
+}
+
+void noxcain::InputRecorder::close()
+{
+	if( file.is_open() )
+	{
+		file.close();
+	}
+}
+
+noxcain::RecordedInputEvent noxcain::InputRecorder::make_event( InputEventTypes type, INT32 param1, INT32 param2, UINT32 param3 ) const
+{
+	return { type, param1, param2, param3, std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - start_time ) };
+}
+
+void noxcain::InputRecorder::write_frame( const std::chrono::nanoseconds& delta_time, const std::vector<RecordedInputEvent>& events )
+{
+	write_value( file, UINT64( delta_time.count() ) );
+	write_value( file, UINT32( events.size() ) );
+	for( const RecordedInputEvent& event : events )
+	{
+		write_value( file, UINT8( event.type ) );
+		write_value( file, event.param1 );
+		write_value( file, event.param2 );
+		write_value( file, event.param3 );
+		write_value( file, UINT64( event.time.count() ) );
+	}
+}
+
+noxcain::InputRecorder::operator bool() const
+{
+	return file.is_open() && file.good();
+}
+
+bool noxcain::InputReplay::open( const std::string& file_name )
+{
+	close();
+
+	file.open( file_name, std::ios::in | std::ios::binary );
+	std::array<char, 4> magic = {};
+	UINT32 version = 0;
+	if( !file || !file.read( magic.data(), magic.size() ) || magic != MAGIC || !read_value( file, version ) || version != VERSION || !read_value( file, random_seed ) )
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+void noxcain::InputReplay::close()
+{
+	if( file.is_open() )
+	{
+		file.close();
+	}
+}
+
+noxcain::UINT32 noxcain::InputReplay::get_random_seed() const
+{
+	return random_seed;
+}
+
+bool noxcain::InputReplay::read_frame( std::chrono::nanoseconds& delta_time, std::vector<RecordedInputEvent>& events )
+{
+	events.clear();
+
+	UINT64 delta = 0;
+	UINT32 event_count = 0;
+	if( !read_value( file, delta ) || !read_value( file, event_count ) || event_count > MAX_FRAME_EVENT_COUNT )
+	{
+		return false;
+	}
+	delta_time = std::chrono::nanoseconds( std::chrono::nanoseconds::rep( delta ) );
+
+	events.reserve( event_count );
+	for( UINT32 index = 0; index < event_count; ++index )
+	{
+		UINT8 type = 0;
+		UINT64 time = 0;
+		RecordedInputEvent& event = events.emplace_back();
+		if( !read_value( file, type ) || !read_value( file, event.param1 ) || !read_value( file, event.param2 ) || !read_value( file, event.param3 ) || !read_value( file, time ) )
+		{
+			return false;
+		}
+		event.type = InputEventTypes( type );
+		event.time = std::chrono::nanoseconds( std::chrono::nanoseconds::rep( time ) );
+	}
+	return true;
+}
+
+noxcain::InputReplay::operator bool() const
+{
+	return file.is_open() && file.good();
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <Defines.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace noxcain
+{
+	enum class InputEventTypes;
+
+	struct RecordedInputEvent
+	{
+		InputEventTypes type;
+		INT32 param1 = 0;
+		INT32 param2 = 0;
+		UINT32 param3 = 0;
+
+		// since the recording was started, only informative
+		std::chrono::nanoseconds time = std::chrono::nanoseconds::zero();
+	};
+
+	/// <summary>
+	/// writes the input events of every logic frame together with its delta time into a binary log
+	/// </summary>
+	/// <remarks>
+	/// header: "NXIR", version, random seed
+	/// frame: delta time [ns] (UINT64), event count (UINT32), events
+	/// event: type (UINT8), param1 (INT32), param2 (INT32), param3 (UINT32), time [ns] (UINT64)
+	/// all values are stored in the byte order of the recording machine
+	/// </remarks>
+	class InputRecorder
+	{
+	public:
+		bool open( const std::string& file_name, UINT32 random_seed );
+		void close();
+
+		RecordedInputEvent make_event( InputEventTypes type, INT32 param1, INT32 param2, UINT32 param3 ) const;
+		void write_frame( const std::chrono::nanoseconds& delta_time, const std::vector<RecordedInputEvent>& events );
+
+		explicit operator bool() const;
+
+	private:
+		std::ofstream file;
+		std::chrono::steady_clock::time_point start_time;
+	};
+
+	/// <summary>
+	/// reads a log written by the InputRecorder frame by frame
+	/// </summary>
+	class InputReplay
+	{
+	public:
+		bool open( const std::string& file_name );
+		void close();
+
+		UINT32 get_random_seed() const;
+
+		/// <returns>false at the end of the log or if the log is broken</returns>
+		bool read_frame( std::chrono::nanoseconds& delta_time, std::vector<RecordedInputEvent>& events );
+
+		explicit operator bool() const;
+
+	private:
+		std::ifstream file;
+		UINT32 random_seed = 0;
+	};
+}
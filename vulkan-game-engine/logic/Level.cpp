@@ -47,7 +47,8 @@ void noxcain::GameLevel::add_user_interface( GameUserInterface& new_interface )
 void noxcain::GameLevel::update_key_events( const std::vector<KeyEvent>& key_events )
 {
 	
-	TimeFrame time_frame( time_collector, 0.8, 0.0, 0.0, 0.8, "key events" );
+	static const TimeFrameZone time_frame_zone( "key events", 0.8, 0.0, 0.0, 0.8 );
+	TimeFrame time_frame( time_collector, time_frame_zone );
 	for( auto& key_handler : key_handlers )
 	{
 		key_handler.check_trigger( key_events );
@@ -56,7 +57,8 @@ void noxcain::GameLevel::update_key_events( const std::vector<KeyEvent>& key_eve
 
 void noxcain::GameLevel::update_logic( const std::chrono::nanoseconds& deltaTime, const std::vector<RegionalKeyEvent>& region_key_events )
 {
-	time_collector.start_frame( 0.0, 0.8, 0.8, 0.8, "region input events" );
+	static const TimeFrameZone region_input_events_zone( "region input events", 0.0, 0.8, 0.8, 0.8 );
+	time_collector.start_frame( region_input_events_zone );
 
 	const auto& window_resolution = GraphicEngine::get_window_resolution();
 	ui_root->set_size( window_resolution.width, window_resolution.height );
@@ -74,13 +76,18 @@ void noxcain::GameLevel::update_logic( const std::chrono::nanoseconds& deltaTime
 		ui_root->hit_tree( region_key_events, interaction_parent_stack, interaction_children_stack, interaction_miss_stack );
 	}
 
-	time_collector.end_is_start( 0.0, 0.8, 0.0, 0.8, "level logic" );
+	static const TimeFrameZone level_logic_zone( "level logic", 0.0, 0.8, 0.0, 0.8 );
+	time_collector.end_is_start( level_logic_zone );
 
 	update_level_logic( deltaTime );
 
-	time_collector.end_is_start( 0.8, 0.8, 0.0, 0.8, "update scene graph" );
+	static const TimeFrameZone update_scene_graph_zone( "update scene graph", 0.8, 0.8, 0.0, 0.8 );
+	time_collector.end_is_start( update_scene_graph_zone );
 
-	scene_root->update_global_matrices( scene_graph_parent_stack, scene_graph_children_stack );
+	if( scene_root->update_global_matrices( scene_graph_parent_stack, scene_graph_children_stack ) )
+	{
+		++scene_version;
+	}
 
 	time_collector.end_frame();
 
@@ -100,6 +107,10 @@ noxcain::GameLevel::~GameLevel()
 {
 }
 
+void noxcain::GameLevel::finish_level()
+{
+}
+
 noxcain::NxMatrix4x4 noxcain::GameLevel::get_active_camera() const
 {
 	return activeCameraPerspective * activeCameraPosition.inverse();
@@ -63,12 +63,26 @@ namespace noxcain
 		GameLevel();
 		virtual ~GameLevel();
 
+		/// <summary>
+		/// called once when the game finishes, before the level is destroyed
+		/// </summary>
+		virtual void finish_level();
+
 		/// <summary>
 		/// get combination of camera position, direction and perspectiv matrix
 		/// </summary>
 		/// <returns>complete camera frustum matrix</returns>
 		NxMatrix4x4 get_active_camera() const;
 
+		/// <summary>
+		/// changes whenever a world matrix of the scene graph changed
+		/// </summary>
+		/// <returns>scene version</returns>
+		UINT64 get_scene_version() const
+		{
+			return scene_version;
+		}
+
 		/// <summary>
 		/// get current level status
 		/// </summary>
@@ -162,6 +176,7 @@ namespace noxcain
 
 	private:
 		Status status = Status::STARTING;
+		UINT64 scene_version = 0;
 		
 		// level scene graph;
 		SceneGraphNode::Stack scene_graph_parent_stack;
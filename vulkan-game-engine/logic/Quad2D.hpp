@@ -6,18 +6,22 @@
 #include <logic/Renderable.hpp>
 #include <logic/RegionEventReceiver.hpp>
 
-#include <vulkan/vulkan.hpp>
+#include <array>
 
 namespace noxcain
 {
 	class RenderableQuad2D : public Region, public Renderable<RenderableQuad2D>
 	{
 	public:
-		static constexpr std::size_t VERTEX_PUSH_OFFSET = 16;
-		static constexpr std::size_t FRAGMENT_PUSH_OFFSET = 0;
-
-		static constexpr std::size_t VERTEX_PUSH_SIZE = 16;
-		static constexpr std::size_t FRAGMENT_PUSH_SIZE = 16;
+		/// <summary>
+		/// per instance vertex data of the label pipeline, all values in pixels from the bottom left corner
+		/// </summary>
+		struct Instance
+		{
+			std::array<FLOAT32, 4> rect; // left, bottom, width, height
+			std::array<FLOAT32, 4> color;
+			std::array<FLOAT32, 4> clip; // left, bottom, right, top
+		};
 
 		RenderableQuad2D( Renderable<RenderableQuad2D>::List& visibility_list );
 
@@ -48,7 +52,7 @@ namespace noxcain
 			return depth;
 		}
 
-		vk::Rect2D record( const vk::CommandBuffer& command_buffer, vk::PipelineLayout pipeline_layout, vk::Rect2D last_scissor, vk::Rect2D default_scissor ) const;
+		void write_instance( Instance& instance, const std::array<FLOAT32, 4>& default_clip ) const;
 	private:
 		UINT32 depth = 0;
 		std::array<FLOAT32, 4> color = { 0.0, 0.0, 0.0, 0.0 };
@@ -197,6 +197,13 @@ bool noxcain::Region::check_region( INT32 x, INT32 y ) const
 	return get_bottom() <= y && y < get_top() && get_left() <= x && x < get_right();
 }
 
+std::array<noxcain::FLOAT32, 4> noxcain::Region::get_pixel_bounds() const
+{
+	const INT32 pixel_left = INT32( get_left() + 0.5 );
+	const INT32 pixel_top = INT32( get_top() + 0.5 );
+	return { FLOAT32( pixel_left ), FLOAT32( pixel_top - INT32( get_height() + 0.5 ) ), FLOAT32( pixel_left + INT32( get_width() + 0.5 ) ), FLOAT32( pixel_top ) };
+}
+
 void noxcain::Region::set_vertical_anchor( VerticalAnchorType ownAnchorRef, const Region& target, VerticalAnchorType targetAnchorRef, const DynamicValue& offset )
 {
 	switch( ownAnchorRef )
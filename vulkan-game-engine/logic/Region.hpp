@@ -111,6 +111,11 @@ namespace noxcain
 
 		bool check_region( INT32 x, INT32 y ) const;
 
+		/// <summary>
+		/// bounds rounded to whole pixels as left, bottom, right, top
+		/// </summary>
+		std::array<FLOAT32, 4> get_pixel_bounds() const;
+
 	protected:
 		enum class AnchorType
 		{
@@ -1,4 +1,6 @@
 #pragma once
+#include <Defines.hpp>
+
 #include <list>
 #include <functional>
 
@@ -17,7 +19,14 @@ namespace noxcain
 		Iterator insert( const T& renderable );
 		void erase( const Iterator& slider_position );
 		bool sort( const std::function<bool( const T&, const T& )>& compare );
+
+		// changes with every insertion, removal and reordering of the list
+		UINT64 get_version() const
+		{
+			return version;
+		}
 	private:
+		UINT64 version = 0;
 		enum class Status
 		{
 			NEED_NOTHING,
@@ -130,12 +139,14 @@ namespace noxcain
 	inline typename RenderableList<T>::Iterator RenderableList<T>::insert( const T& renderable )
 	{
 		status = Status::NEED_SORT;
+		++version;
 		return BaseList::emplace( BaseList::begin(), renderable );
 	}
 	template<typename T>
 	inline void RenderableList<T>::erase( const Iterator& slider_position )
 	{
 		BaseList::erase( slider_position );
+		++version;
 		if( status == Status::NEED_NOTHING )
 		{
 			status = Status::NEED_MATCH;
@@ -148,6 +159,7 @@ namespace noxcain
 		if( status == Status::NEED_SORT )
 		{
 			BaseList::sort( compare );
+			++version;
 		}
 		bool need_match = status != Status::NEED_NOTHING;
 		status = Status::NEED_NOTHING;
@@ -7,8 +7,9 @@ void noxcain::SceneGraphNode::set_local_matrix( const NxMatrix4x4& matrix )
 	local_matrix = matrix;
 }
 
-void noxcain::SceneGraphNode::update_global_matrices( noxcain::SceneGraphNode::Stack& scene_graph_parent_stack, noxcain::SceneGraphNode::Stack& scene_graph_children_stack )
+bool noxcain::SceneGraphNode::update_global_matrices( noxcain::SceneGraphNode::Stack& scene_graph_parent_stack, noxcain::SceneGraphNode::Stack& scene_graph_children_stack )
 {
+	bool is_changed = false;
 	scene_graph_parent_stack.clear();
 	scene_graph_parent_stack.emplace_back( *this );
 
@@ -19,7 +20,12 @@ void noxcain::SceneGraphNode::update_global_matrices( noxcain::SceneGraphNode::S
 		{
 			for( SceneGraphNode& child : parent.children )
 			{
-				child.global_matrix = parent.global_matrix*child.local_matrix;
+				const NxMatrix4x4 new_matrix = parent.global_matrix*child.local_matrix;
+				if( new_matrix != child.global_matrix )
+				{
+					child.global_matrix = new_matrix;
+					is_changed = true;
+				}
 				scene_graph_children_stack.emplace_back( child );
 			}
 		}
@@ -27,4 +33,5 @@ void noxcain::SceneGraphNode::update_global_matrices( noxcain::SceneGraphNode::S
 	}
 	scene_graph_parent_stack.clear();
 	scene_graph_children_stack.clear();
+	return is_changed;
 }
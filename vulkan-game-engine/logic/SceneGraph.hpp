@@ -27,7 +27,11 @@ namespace noxcain
 			return global_matrix;
 		}
 		
-		void update_global_matrices( Stack& scene_graph_parent_stack, Stack& scene_graph_children_stack );
+		/// <summary>
+		/// updates the world matrices of all nodes below this one
+		/// </summary>
+		/// <returns>true if any world matrix changed</returns>
+		bool update_global_matrices( Stack& scene_graph_parent_stack, Stack& scene_graph_children_stack );
 
 	protected:
 		NxMatrix4x4 local_matrix;
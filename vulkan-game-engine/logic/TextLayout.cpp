@@ -0,0 +1,130 @@
+#include "TextLayout.hpp"
+
+#include <resources/GameResourceEngine.hpp>
+#include <resources/FontResource.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+std::mutex noxcain::TextLayout::cache_mutex;
+std::unordered_multimap<std::size_t, std::weak_ptr<const noxcain::TextLayout>> noxcain::TextLayout::cache;
+std::size_t noxcain::TextLayout::prune_size = 64;
+
+std::shared_ptr<const noxcain::TextLayout> noxcain::TextLayout::get_layout( std::size_t font_index, DOUBLE fixed_line_length, const std::vector<UINT32>& unicodes, const TextLayout* previous )
+{
+	const std::size_t hash = compute_hash( font_index, fixed_line_length, unicodes );
+	{
+		std::unique_lock lock( cache_mutex );
+		auto [begin, end] = cache.equal_range( hash );
+		for( auto iter = begin; iter != end; ++iter )
+		{
+			auto cached_layout = iter->second.lock();
+			if( cached_layout && cached_layout->is_equal( font_index, fixed_line_length, unicodes ) )
+			{
+				return cached_layout;
+			}
+		}
+	}
+
+	auto new_layout = std::make_shared<TextLayout>();
+	new_layout->font_index = font_index;
+	new_layout->fixed_line_length = fixed_line_length;
+	new_layout->unicodes = unicodes;
+
+	std::size_t start_index = 0;
+	Cursor start;
+	if( previous && previous->font_index == font_index && previous->fixed_line_length == fixed_line_length )
+	{
+		const std::size_t max_prefix = std::min( previous->unicodes.size(), unicodes.size() );
+		start_index = std::mismatch( unicodes.begin(), unicodes.begin() + max_prefix, previous->unicodes.begin() ).first - unicodes.begin();
+		if( start_index )
+		{
+			const Cursor& cursor = previous->cursors[start_index];
+			start = cursor;
+			new_layout->glyphs.assign( previous->glyphs.begin(), previous->glyphs.begin() + cursor.glyph_count );
+			new_layout->line_lengths.assign( previous->line_lengths.begin(), previous->line_lengths.begin() + cursor.line_count );
+			new_layout->cursors.assign( previous->cursors.begin(), previous->cursors.begin() + start_index );
+		}
+	}
+	new_layout->layout( start_index, start );
+
+	std::unique_lock lock( cache_mutex );
+	cache.emplace( hash, new_layout );
+
+	// layouts only live as long as a text uses them
+	if( cache.size() > 2 * prune_size )
+	{
+		for( auto iter = cache.begin(); iter != cache.end(); )
+		{
+			iter = iter->second.expired() ? cache.erase( iter ) : std::next( iter );
+		}
+		prune_size = std::max<std::size_t>( 64, cache.size() );
+	}
+	return new_layout;
+}
+
+void noxcain::TextLayout::layout( std::size_t start_index, const Cursor& start )
+{
+	const auto& font = ResourceEngine::get_engine().get_font( font_index );
+
+	glyphs.reserve( unicodes.size() );
+	cursors.reserve( unicodes.size() + 1 );
+
+	DOUBLE x_offset = start.x_offset;
+	max_width = start.max_width;
+
+	for( std::size_t index = start_index; index < unicodes.size(); ++index )
+	{
+		const UINT32 unicode = unicodes[index];
+		cursors.push_back( { x_offset, max_width, UINT32( glyphs.size() ), UINT32( line_lengths.size() ) } );
+
+		const auto info = font.get_character_info( unicode );
+
+		if( ( fixed_line_length && x_offset > 0 && x_offset + info.advance_width > fixed_line_length ) || unicode == 0xA )
+		{
+			line_lengths.push_back( x_offset );
+			x_offset = 0;
+		}
+
+		if( unicode != 0xA )
+		{
+			if( info.glyph_index != FontResource::INVALID_UNICODE )
+			{
+				glyphs.push_back( { x_offset, info.glyph_index, 0, UINT8( line_lengths.size() ), font.get_glyph_box( info.glyph_index ) } );
+			}
+			x_offset += info.advance_width;
+			if( max_width < x_offset ) max_width = x_offset;
+		}
+	}
+	cursors.push_back( { x_offset, max_width, UINT32( glyphs.size() ), UINT32( line_lengths.size() ) } );
+
+	line_lengths.push_back( x_offset );
+	line_height = font.get_ascender() - font.get_descender() + font.get_line_gap();
+	max_height = line_lengths.size() * line_height - font.get_line_gap();
+}
+
+bool noxcain::TextLayout::is_equal( std::size_t other_font_index, DOUBLE other_fixed_line_length, const std::vector<UINT32>& other_unicodes ) const
+{
+	return font_index == other_font_index && fixed_line_length == other_fixed_line_length && unicodes == other_unicodes;
+}
+
+std::size_t noxcain::TextLayout::compute_hash( std::size_t font_index, DOUBLE fixed_line_length, const std::vector<UINT32>& unicodes )
+{
+	// FNV-1a over the key
+	UINT64 value = 0xcbf29ce484222325;
+	auto add = [&value]( UINT64 word )
+	{
+		value = ( value ^ word ) * 0x100000001b3;
+	};
+
+	UINT64 line_length_bits = 0;
+	std::memcpy( &line_length_bits, &fixed_line_length, sizeof( line_length_bits ) );
+
+	add( font_index );
+	add( line_length_bits );
+	for( UINT32 unicode : unicodes )
+	{
+		add( unicode );
+	}
+	return std::size_t( value );
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <Defines.hpp>
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace noxcain
+{
+	/// <summary>
+	/// immutable glyph positions of a unicode sequence in em, texts with equal font, line length and unicodes share one layout
+	/// </summary>
+	class TextLayout
+	{
+	public:
+		struct GlyphInstance
+		{
+			DOUBLE x_offset = 0;
+			UINT32 glyph_id = 0;
+			UINT8 color_index = 0;
+			UINT8 line_index = 0;
+			std::array<FLOAT32, 4> box = {}; // glyph quad in em, min x, min y, max x, max y
+		};
+
+		/// <summary>
+		/// returns the cached layout or creates it, if previous starts with the same unicodes only the differing tail is laid out
+		/// </summary>
+		static std::shared_ptr<const TextLayout> get_layout( std::size_t font_index, DOUBLE fixed_line_length, const std::vector<UINT32>& unicodes, const TextLayout* previous = nullptr );
+
+		const std::vector<GlyphInstance>& get_glyphs() const
+		{
+			return glyphs;
+		}
+
+		const std::vector<DOUBLE>& get_line_lengths() const
+		{
+			return line_lengths;
+		}
+
+		DOUBLE get_max_width() const
+		{
+			return max_width;
+		}
+
+		DOUBLE get_max_height() const
+		{
+			return max_height;
+		}
+
+		DOUBLE get_line_height() const
+		{
+			return line_height;
+		}
+
+	private:
+		// layout state in front of a unicode, the layout can be continued from every cursor
+		struct Cursor
+		{
+			DOUBLE x_offset = 0;
+			DOUBLE max_width = 0;
+			UINT32 glyph_count = 0;
+			UINT32 line_count = 0;
+		};
+
+		std::size_t font_index = 0;
+		DOUBLE fixed_line_length = 0;
+		std::vector<UINT32> unicodes;
+
+		std::vector<GlyphInstance> glyphs;
+		std::vector<DOUBLE> line_lengths;
+		std::vector<Cursor> cursors;
+		DOUBLE max_width = 0;
+		DOUBLE max_height = 0;
+		DOUBLE line_height = 0;
+
+		void layout( std::size_t start_index, const Cursor& start );
+		bool is_equal( std::size_t other_font_index, DOUBLE other_fixed_line_length, const std::vector<UINT32>& other_unicodes ) const;
+		static std::size_t compute_hash( std::size_t font_index, DOUBLE fixed_line_length, const std::vector<UINT32>& unicodes );
+
+		static std::mutex cache_mutex;
+		static std::unordered_multimap<std::size_t, std::weak_ptr<const TextLayout>> cache;
+		static std::size_t prune_size;
+	};
+}
@@ -1,6 +1,9 @@
 #pragma once
 #include <Defines.hpp>
+#include <logic/TextLayout.hpp>
+
 #include <array>
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -30,6 +33,7 @@ namespace noxcain
 
 		void set_utf8( const std::string& utf8String );
 		void set_unicodes( const std::vector<UINT32>& new_unicodes );
+		void set_unicode( UINT32 unicode );
 
 		void set_size( DOUBLE size )
 		{
@@ -58,7 +62,7 @@ namespace noxcain
 
 		const DOUBLE get_length() const
 		{
-			return size* max_width;
+			return size * layout->get_max_width();
 		}
 
 		DOUBLE get_descender() const;
@@ -76,14 +80,6 @@ namespace noxcain
 		}
 	
 	private:
-		struct GylphInstance
-		{
-			DOUBLE x_offset = 0;
-			UINT32 glyph_id = 0;
-			UINT8 color_index = 0;
-			UINT8 line_index = 0;
-		};
-
 		Alignments text_alignment = Alignments::LEFT;
 
 		void calculate_offsets();
@@ -93,14 +89,12 @@ namespace noxcain
 		std::size_t font_index = 0;
 
 		std::vector<UINT32> unicodes;
-		std::vector<GylphInstance> glyphs;
-		std::vector<DOUBLE> line_lengths;
+
+		// shared with all texts of the same content, replaced on every change
+		std::shared_ptr<const TextLayout> layout;
 
 		DOUBLE fixed_line_length = 0;
-		DOUBLE line_height = 0;
 		DOUBLE size = 1;
-		DOUBLE max_width = 0;
-		DOUBLE max_height = 0;
 
 		std::vector<std::array<FLOAT32, 4>> colors = { { 1.0F, 1.0F, 1.0F, 1.0F } };
 	};
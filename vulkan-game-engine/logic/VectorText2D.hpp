@@ -3,18 +3,31 @@
 #include <Defines.hpp>
 
 #include <array>
+#include <vector>
 
 #include <logic/Region.hpp>
 #include <logic/Renderable.hpp>
 #include <logic/VectorText.hpp>
 
-#include <vulkan/vulkan.hpp>
-
 namespace noxcain
 {
 	class VectorText2D : public Renderable<VectorText2D>, public Region
 	{
 	public:
+		/// <summary>
+		/// per glyph vertex data of the 2D text pipelines
+		/// </summary>
+		struct Instance
+		{
+			std::array<FLOAT32, 4> box; // glyph quad in em, min x, min y, max x, max y
+			FLOAT32 x; // pixel position of the glyph origin
+			FLOAT32 y;
+			FLOAT32 size; // pixel per em
+			UINT32 glyph_id; // global glyph index of all fonts
+			std::array<FLOAT32, 4> color;
+			std::array<FLOAT32, 4> clip; // left, bottom, right, top in pixels
+		};
+
 		VectorText2D( Renderable<VectorText2D>::List& visibility_list );
 
 		const VectorText& get_text() const
@@ -47,7 +60,7 @@ namespace noxcain
 			return depth;
 		}
 
-		vk::Rect2D record( const vk::CommandBuffer& command_buffer, vk::PipelineLayout pipeline_layout, vk::Rect2D current_scissor, vk::Rect2D default_scissor ) const;
+		void write_instances( std::vector<Instance>& instances, const std::array<FLOAT32, 4>& default_clip ) const;
 	private:
 		UINT32 depth = 0;
 		VectorText text;
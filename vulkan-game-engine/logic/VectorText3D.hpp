@@ -8,7 +8,6 @@
 #include <vector>
 #include <string>
 #include <array>
-#include <vulkan/vulkan.hpp>
 
 namespace noxcain
 {	
@@ -17,6 +16,18 @@ namespace noxcain
 	class VectorText3D : public SceneGraphNode, public Renderable<VectorText3D>
 	{
 	public:
+		/// <summary>
+		/// per glyph vertex data of the decal pipeline
+		/// </summary>
+		struct Instance
+		{
+			std::array<FLOAT32, 16> matrix; // camera, world and font size of the text, column major
+			std::array<FLOAT32, 4> box; // glyph quad in em, min x, min y, max x, max y
+			std::array<FLOAT32, 4> color;
+			std::array<FLOAT32, 2> offset; // glyph origin in em
+			UINT32 glyph_id; // global glyph index of all fonts
+		};
+
 		VectorText3D( Renderable<VectorText3D>::List& visibility_list );
 		
 		void set_text( std::string utf8 )
@@ -24,6 +35,16 @@ namespace noxcain
 			text.set_utf8( utf8 );
 		}
 
+		void set_unicodes( const std::vector<UINT32>& unicodes )
+		{
+			text.set_unicodes( unicodes );
+		}
+
+		void set_unicode( UINT32 unicode )
+		{
+			text.set_unicode( unicode );
+		}
+
 		void set_font_size( DOUBLE size )
 		{
 			text.set_size( size );
@@ -54,7 +75,7 @@ namespace noxcain
 		DOUBLE get_width();
 		DOUBLE get_height();
 
-		void record( vk::CommandBuffer command_buffer, vk::PipelineLayout pipeline_layout, const NxMatrix4x4& camera ) const;
+		void write_instances( std::vector<Instance>& instances, const NxMatrix4x4& camera ) const;
 	private:
 		VectorText text;
 	};
@@ -167,7 +167,7 @@ void noxcain::VectorTextLabel2D::set_background_color( DOUBLE red, DOUBLE green,
 void noxcain::VectorTextLabel2D::set_centered_icon( DOUBLE size, UINT32 unicode )
 {
 	text_content.get_text().set_size( size );
-	text_content.get_text().set_unicodes( { unicode } );
+	text_content.get_text().set_unicode( unicode );
 	text_content.get_text().set_text_alignment( VectorText::Alignments::LEFT );
 
 	std::function get_x_offset = [this]()
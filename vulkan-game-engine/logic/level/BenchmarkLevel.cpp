@@ -0,0 +1,270 @@
+#include "BenchmarkLevel.hpp"
+
+#include <logic/GameLogicEngine.hpp>
+#include <logic/GeometryLogic.hpp>
+#include <logic/VectorText2D.hpp>
+#include <logic/VectorText3D.hpp>
+
+#include <resources/BoundingBox.hpp>
+#include <resources/GameResourceEngine.hpp>
+#include <resources/GeometryResource.hpp>
+
+#include <tools/FrameStatistics.hpp>
+#include <tools/TimeFrame.hpp>
+
+#include <math/Vector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+namespace
+{
+	// the camera needs this long for one pass along its path
+	constexpr noxcain::DOUBLE CAMERA_LOOP_SECONDS = 20.0;
+}
+
+class noxcain::BenchmarkLevel::Field : public SceneGraphNode
+{
+	constexpr static std::size_t geometry_id = 0;
+	GeometryObject field_geometry;
+	VectorText3D number_decal;
+public:
+	const DOUBLE x;
+	const DOUBLE y;
+	const DOUBLE phase;
+
+	Field( BenchmarkLevel& owner, DOUBLE x, DOUBLE y, DOUBLE phase, UINT32 number ) :
+		field_geometry( owner.geometry_list ),
+		number_decal( owner.vector_decal_list ),
+		x( x ), y( y ), phase( phase )
+	{
+		owner.board->add_branch( *this );
+		add_branch( field_geometry );
+		field_geometry.add_branch( number_decal );
+		field_geometry.set_geometry( geometry_id );
+
+		number_decal.show();
+		number_decal.set_font_color( 0.0, 0.0, 0.0 );
+		number_decal.set_text( std::to_string( number ) );
+		number_decal.set_font_size( 1.0 );
+
+		const auto& bounding_box = field_geometry.get_bounding_box();
+		const DOUBLE size_width = ( 0.6 * bounding_box.get_width() ) / number_decal.get_width();
+		const DOUBLE size_height = ( 0.6 * bounding_box.get_height() ) / number_decal.get_height();
+		number_decal.set_font_size( std::min( size_width, size_height ) );
+		number_decal.set_local_matrix( NxMatrix4x4().translation( { -0.5 * number_decal.get_width(), -0.5 * number_decal.get_height(), 0.0 } ) );
+
+		set_height( 0.0 );
+	}
+
+	void set_height( DOUBLE height )
+	{
+		set_local_matrix( NxMatrix4x4().translation( { x, y, height } ) );
+	}
+
+	static const BoundingBox& get_object_space_bounding_box()
+	{
+		return ResourceEngine::get_engine().get_geometry( geometry_id ).get_bounding_box();
+	}
+};
+
+noxcain::BenchmarkLevel::BenchmarkLevel( const BenchmarkSettings& settings ) : settings( settings ), churn_random( settings.seed )
+{
+	time_collector.name_collection( "Level logic" );
+
+	vector_decal_renderables.emplace_back( vector_decal_list );
+	geometry_renderables.emplace_back( geometry_list );
+
+	// the summary covers every frame of the run
+	TimeFrameCollector::activate();
+	if( settings.frame_count )
+	{
+		TimeFrameCollector::set_history_depth( std::max<std::size_t>( TimeFrameCollector::get_history_depth(), std::size_t( settings.frame_count ) * 8 ) );
+	}
+
+	board = std::make_unique<SceneGraphNode>();
+	get_scene_root().add_branch( *board );
+
+	setup_board();
+	setup_camera_paths();
+	setup_ui();
+
+	add_user_interface( benchmark_ui );
+	start_time = std::chrono::steady_clock::now();
+}
+
+noxcain::BenchmarkLevel::~BenchmarkLevel()
+{
+}
+
+void noxcain::BenchmarkLevel::finish_level()
+{
+	if( !is_summary_written )
+	{
+		write_summary( std::cout );
+		is_summary_written = true;
+	}
+}
+
+void noxcain::BenchmarkLevel::setup_board()
+{
+	std::mt19937 random( settings.seed );
+	std::uniform_real_distribution<DOUBLE> phase_distribution( 0.0, 2.0 * PI );
+	std::uniform_int_distribution<UINT32> number_distribution( 0, 999 );
+
+	const UINT32 column_count = std::max<UINT32>( 1, UINT32( std::ceil( std::sqrt( DOUBLE( settings.field_count ) ) ) ) );
+	const UINT32 row_count = ( settings.field_count + column_count - 1 ) / column_count;
+
+	const auto& bounding_box = Field::get_object_space_bounding_box();
+	const DOUBLE column_step = 0.75 * bounding_box.get_width();
+	const DOUBLE row_step = bounding_box.get_height();
+	const DOUBLE board_width = column_step * column_count;
+	const DOUBLE board_height = row_step * ( row_count + 0.5 );
+	board_radius = 0.5 * std::sqrt( board_width * board_width + board_height * board_height );
+
+	fields.reserve( settings.field_count );
+	for( UINT32 index = 0; index < settings.field_count; ++index )
+	{
+		const UINT32 column_index = index % column_count;
+		const UINT32 row_index = index / column_count;
+		const DOUBLE x = column_index * column_step - 0.5 * board_width;
+		const DOUBLE y = row_index * row_step + ( column_index % 2 ? 0.0 : 0.5 * row_step ) - 0.5 * board_height;
+		const DOUBLE phase = phase_distribution( random );
+		fields.emplace_back( std::make_unique<Field>( *this, x, y, phase, number_distribution( random ) ) );
+	}
+}
+
+void noxcain::BenchmarkLevel::setup_camera_paths()
+{
+	const DOUBLE r = board_radius;
+	const DOUBLE h = 0.8 * board_radius;
+
+	// eye circles the board while sinking towards it
+	camera_paths.emplace_back( CubicSpline(
+		{
+			NxVector3D( -r, -r, h ), NxVector3D( 0, -1.5 * r, h ),
+			NxVector3D( r, -r, 0.8 * h ), NxVector3D( r, 0, 0.6 * h ),
+			NxVector3D( r, r, 0.4 * h ), NxVector3D( 0, r, 0.3 * h ),
+			NxVector3D( -r, 0.5 * r, 0.6 * h ), NxVector3D( -r, -r, h )
+		} ) );
+
+	// target sweeps over the board
+	camera_paths.emplace_back( CubicSpline(
+		{
+			NxVector3D( 0, 0, 0 ), NxVector3D( 0.3 * r, -0.3 * r, 0 ),
+			NxVector3D( 0.5 * r, 0, 0 ), NxVector3D( 0.3 * r, 0.3 * r, 0 ),
+			NxVector3D( -0.3 * r, 0.5 * r, 0 ), NxVector3D( -0.5 * r, 0, 0 ),
+			NxVector3D( -0.3 * r, -0.3 * r, 0 ), NxVector3D( 0, 0, 0 )
+		} ) );
+}
+
+void noxcain::BenchmarkLevel::setup_ui()
+{
+	churn_labels.reserve( CHURN_LABEL_COUNT );
+	for( std::size_t index = 0; index < CHURN_LABEL_COUNT; ++index )
+	{
+		auto& label = churn_labels.emplace_back( std::make_unique<VectorText2D>( benchmark_ui.get_texts() ) );
+		if( index ) label->set_vertical_anchor( VerticalAnchorType::TOP, *churn_labels[index - 1], VerticalAnchorType::BOTTOM );
+		else label->set_top_anchor( get_screen_root() );
+		label->set_left_anchor( get_screen_root(), 5 );
+		label->get_text().set_size( 24 );
+		label->show();
+	}
+}
+
+void noxcain::BenchmarkLevel::update_board( DOUBLE seconds )
+{
+	for( auto& field : fields )
+	{
+		field->set_height( 0.5 * std::sin( 2.0 * seconds + field->phase ) );
+	}
+}
+
+void noxcain::BenchmarkLevel::update_camera( DOUBLE seconds )
+{
+	const auto resolution = LogicEngine::get_graphic_settings().get_accumulated_resolution();
+	if( resolution.width == 0 || resolution.height == 0 )
+	{
+		return;
+	}
+
+	const DOUBLE path_position = std::fmod( seconds / CAMERA_LOOP_SECONDS, 1.0 );
+	const NxVector3D eye = camera_paths[0].get_position( path_position );
+	const NxVector3D target = camera_paths[1].get_position( path_position );
+
+	// the camera looks along its negative z axis
+	NxVector3D z_axis = eye - target;
+	z_axis.normalize();
+	NxVector3D x_axis = NxVector3D( 0, 1, 0 ).cross( z_axis );
+	x_axis.normalize();
+	const NxVector3D y_axis = z_axis.cross( x_axis );
+	activeCameraPosition = NxMatrix4x4( x_axis, y_axis, z_axis, eye );
+
+	const DOUBLE near_plane = 0.05 * board_radius;
+	const DOUBLE far_plane = 4.0 * board_radius;
+	const DOUBLE right = near_plane * std::tan( PI / 6.0 );
+	const DOUBLE top = -right * DOUBLE( resolution.height ) / DOUBLE( resolution.width );
+
+	activeCameraPerspective.getColumn( 0 )[0] = near_plane / right;
+	activeCameraPerspective.getColumn( 1 )[1] = near_plane / top;
+	activeCameraPerspective.getColumn( 2 )[2] = far_plane / ( near_plane - far_plane );
+	activeCameraPerspective.getColumn( 2 )[3] = -1.0;
+	activeCameraPerspective.getColumn( 3 )[2] = ( far_plane * near_plane ) / ( near_plane - far_plane );
+	activeCameraPerspective.getColumn( 3 )[3] = 0.0;
+}
+
+void noxcain::BenchmarkLevel::update_ui()
+{
+	std::uniform_int_distribution<UINT32> value_distribution( 0, 99999 );
+	for( std::size_t index = 0; index < churn_labels.size(); ++index )
+	{
+		auto& label = churn_labels[index];
+
+		// every label is hidden for a while at a different time
+		if( ( frame_index / 30 + index ) % CHURN_LABEL_COUNT == 0 )
+		{
+			label->hide();
+			continue;
+		}
+		label->show();
+		label->get_text().set_utf8( "FRAME " + std::to_string( frame_index ) + "  VALUE " + std::to_string( value_distribution( churn_random ) ) );
+	}
+}
+
+void noxcain::BenchmarkLevel::write_summary( std::ostream& stream )
+{
+	const DOUBLE wall_time = std::chrono::duration<DOUBLE>( std::chrono::steady_clock::now() - start_time ).count();
+	const DOUBLE logic_time = std::chrono::duration<DOUBLE, std::milli>( logic_duration ).count();
+
+	stream << std::fixed << std::setprecision( 3 ) << "benchmark: " << settings.field_count << " fields, " << frame_index << " frames, step "
+		<< std::chrono::duration<DOUBLE, std::milli>( settings.time_step ).count() << " ms, seed " << settings.seed << "\n";
+	if( frame_index && wall_time > 0.0 )
+	{
+		stream << "wall time: " << wall_time << " s, " << frame_index / wall_time << " fps, level logic average " << logic_time / frame_index << " ms\n";
+	}
+	LogicEngine::get_cpu_frame_statistics().write_summary( stream );
+	LogicEngine::get_gpu_frame_statistics().write_summary( stream );
+	write_stage_summary( stream );
+}
+
+void noxcain::BenchmarkLevel::update_level_logic( const std::chrono::nanoseconds& deltaTime )
+{
+	if( settings.frame_count && frame_index >= settings.frame_count )
+	{
+		set_status( Status::FINISHED );
+		return;
+	}
+
+	const auto logic_start = std::chrono::steady_clock::now();
+
+	// the scene only depends on the frame index, so every run renders the same frames
+	const DOUBLE seconds = std::chrono::duration<DOUBLE>( settings.time_step ).count() * frame_index;
+	update_board( seconds );
+	update_camera( seconds );
+	update_ui();
+	++frame_index;
+
+	logic_duration += std::chrono::steady_clock::now() - logic_start;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <memory>
+#include <ostream>
+#include <random>
+#include <logic/Level.hpp>
+#include <math/Spline.hpp>
+
+
+namespace noxcain
+{
+	class VectorText2D;
+
+	/// <summary>
+	/// describes the generated benchmark scene, the same settings always produce the same frames
+	/// </summary>
+	struct BenchmarkSettings
+	{
+		UINT32 field_count = 1000;
+
+		// 0 runs until the engine is finished from outside, e.g. by the headless surface
+		UINT32 frame_count = 1000;
+
+		// every frame advances the scene by this step, regardless of the real frame time
+		std::chrono::nanoseconds time_step = std::chrono::nanoseconds( 16666667 );
+		UINT32 seed = 1;
+	};
+
+	/// <summary>
+	/// generated hex board with decals, flown over by a scripted camera while the ui text changes every frame
+	/// </summary>
+	class BenchmarkLevel : public GameLevel
+	{
+	private:
+		class Field;
+
+		const BenchmarkSettings settings;
+
+		Renderable<VectorText3D>::List vector_decal_list;
+		Renderable<GeometryObject>::List geometry_list;
+		GameUserInterface benchmark_ui;
+
+		std::unique_ptr<SceneGraphNode> board;
+		std::vector<std::unique_ptr<Field>> fields;
+		DOUBLE board_radius = 1.0;
+
+		std::vector<CubicSpline> camera_paths;
+
+		constexpr static std::size_t CHURN_LABEL_COUNT = 8;
+		std::vector<std::unique_ptr<VectorText2D>> churn_labels;
+		std::mt19937 churn_random;
+
+		UINT64 frame_index = 0;
+		std::chrono::nanoseconds logic_duration = std::chrono::nanoseconds::zero();
+		std::chrono::steady_clock::time_point start_time;
+		bool is_summary_written = false;
+
+		void setup_board();
+		void setup_camera_paths();
+		void setup_ui();
+
+		void update_board( DOUBLE seconds );
+		void update_camera( DOUBLE seconds );
+		void update_ui();
+
+		void write_summary( std::ostream& stream );
+
+		void update_level_logic( const std::chrono::nanoseconds& deltaTime ) override;
+	public:
+		BenchmarkLevel( const BenchmarkSettings& settings );
+		~BenchmarkLevel();
+
+		void finish_level() override;
+	};
+}
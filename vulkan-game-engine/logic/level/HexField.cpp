@@ -10,7 +10,7 @@
 void noxcain::MineSweeperLevel::HexField::update_position( UINT32 unicode )
 {
 	mine_count_decal.show();
-	mine_count_decal.set_text( std::string( { char( unicode ) } ) );
+	mine_count_decal.set_unicode( unicode );
 	const auto& font = ResourceEngine::get_engine().get_font( mine_count_decal.get_font_id() );
 
 	const auto& hexBoundingBox = field_geometry.get_bounding_box();
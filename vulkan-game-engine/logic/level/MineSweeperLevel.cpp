@@ -18,21 +18,46 @@
 #include <math/Spline.hpp>
 
 #include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+	std::string format_frame_statistics( const std::string& prefix, const noxcain::FrameStatistics& statistics )
+	{
+		const noxcain::FrameStatistics::Percentiles percentiles = statistics.get_window_percentiles();
+		const auto to_milliseconds = []( std::chrono::nanoseconds duration ) { return std::chrono::duration<noxcain::DOUBLE, std::milli>( duration ).count(); };
+
+		std::ostringstream text;
+		text << prefix << ": " << std::fixed << std::setprecision( 1 );
+		if( percentiles.p50.count() )
+		{
+			text << 1000.0 / to_milliseconds( percentiles.p50 ) << " fps  ";
+		}
+		text << "p50 " << to_milliseconds( percentiles.p50 ) << "  p95 " << to_milliseconds( percentiles.p95 ) << "  p99 " << to_milliseconds( percentiles.p99 )
+			<< "  max " << to_milliseconds( percentiles.max ) << " ms";
+		return text.str();
+	}
+}
 
 void noxcain::MineSweeperLevel::create_performance_hud()
 {
 	//fps displays
 	cpu_cycle_label->set_top_anchor( get_screen_root() );
 	gpu_cycle_label->set_vertical_anchor( VerticalAnchorType::TOP, *cpu_cycle_label, VerticalAnchorType::BOTTOM );
+	hitch_label->set_vertical_anchor( VerticalAnchorType::TOP, *gpu_cycle_label, VerticalAnchorType::BOTTOM );
 
 	cpu_cycle_label->set_left_anchor( get_screen_root(), 5 );
 	gpu_cycle_label->set_left_anchor( get_screen_root(), 5 );
+	hitch_label->set_left_anchor( get_screen_root(), 5 );
 
 	cpu_cycle_label->get_text().set_size( 24 );
 	gpu_cycle_label->get_text().set_size( 24 );
+	hitch_label->get_text().set_size( 24 );
 
 	cpu_cycle_label->show();
 	gpu_cycle_label->show();
+	hitch_label->show();
 
 	// add debug button
 	debug_button->get_area().set_vertical_anchor( VerticalAnchorType::TOP, *switch_font_button, VerticalAnchorType::BOTTOM, -5 );
@@ -52,8 +77,34 @@ void noxcain::MineSweeperLevel::create_performance_hud()
 
 	debug_button->show();
 
+	// add trace button, the trace is written to the working directory
+	trace_button->get_area().set_vertical_anchor( VerticalAnchorType::TOP, *debug_button, VerticalAnchorType::BOTTOM, -5 );
+	trace_button->get_area().set_left_anchor( get_screen_root(), 5 );
+	trace_button->get_area().set_width( 100 );
+	trace_button->get_area().set_height( 40 );
+
+	trace_button->get_text_element().set_utf8( "TRACE" );
+	trace_button->get_text_element().set_size( 24 );
+	trace_button->set_auto_resize( VectorTextLabel2D::AutoResizeModes::FULL );
+
+	trace_button->set_click_handler( [this]( const RegionalKeyEvent&, BaseButton& ) -> bool
+	{
+		if( TimeFrameCollector::is_tracing() )
+		{
+			TimeFrameCollector::stop_trace();
+			trace_button->get_text_element().set_utf8( "TRACE" );
+		}
+		else if( TimeFrameCollector::start_trace( "trace.json" ) )
+		{
+			trace_button->get_text_element().set_utf8( "STOP TRACE" );
+		}
+		return true;
+	} );
+
+	trace_button->show();
+
 	// add switch Font Button
-	switch_font_button->get_area().set_vertical_anchor( VerticalAnchorType::TOP, *gpu_cycle_label, VerticalAnchorType::BOTTOM, -5 );
+	switch_font_button->get_area().set_vertical_anchor( VerticalAnchorType::TOP, *hitch_label, VerticalAnchorType::BOTTOM, -5 );
 	switch_font_button->get_area().set_left_anchor( get_screen_root(), 5 );
 	switch_font_button->get_area().set_width( 100 );
 	switch_font_button->get_area().set_height( 40 );
@@ -77,11 +128,12 @@ void noxcain::MineSweeperLevel::create_performance_hud()
 	switch_font_button->show();
 
 	performance_ui_base->set_top_anchor( *switch_font_button );
-	performance_ui_base->set_bottom_anchor( *debug_button );
+	performance_ui_base->set_bottom_anchor( *trace_button );
 	performance_ui_base->set_left_anchor( *switch_font_button );
 	performance_ui_base->set_right_anchor( *switch_font_button );
 
 	performance_ui_base->add_branch( *debug_button );
+	performance_ui_base->add_branch( *trace_button );
 	performance_ui_base->add_branch( *switch_font_button );
 
 	performance_ui.set_regional_event_root( *performance_ui_base );
@@ -263,7 +315,9 @@ noxcain::MineSweeperLevel::MineSweeperLevel() :
 	performance_ui_base( std::make_unique<PassivRecieverNode>() ),
 	cpu_cycle_label( std::make_unique<VectorText2D>( performance_ui.get_texts() ) ),
 	gpu_cycle_label( std::make_unique<VectorText2D>( performance_ui.get_texts() ) ),
+	hitch_label( std::make_unique<VectorText2D>( performance_ui.get_texts() ) ),
 	debug_button( std::make_unique<BaseButton>( performance_ui ) ),
+	trace_button( std::make_unique<BaseButton>( performance_ui ) ),
 	switch_font_button( std::make_unique<BaseButton>( performance_ui ) ),
 	
 	default_ui_base( std::make_unique<PassivRecieverNode>() ),
@@ -529,8 +583,24 @@ void noxcain::MineSweeperLevel::update_level_logic( const std::chrono::nanosecon
 	cycle_display_wait_time += deltaTime;
 	if( cycle_display_wait_time > CYCLE_TIME_DISPLAY_REFRESH_RATE )
 	{
-		cpu_cycle_label->get_text().set_utf8( "CPU: " + std::to_string( std::chrono::seconds( 1 ) / LogicEngine::get_cpu_cycle_duration() ) + " fps" );
-		gpu_cycle_label->get_text().set_utf8( "GPU: " + std::to_string( std::chrono::seconds( 1 ) / LogicEngine::get_gpu_cycle_duration() ) + " fps" );
+		cpu_cycle_label->get_text().set_utf8( format_frame_statistics( "CPU", LogicEngine::get_cpu_frame_statistics() ) );
+		gpu_cycle_label->get_text().set_utf8( format_frame_statistics( "GPU", LogicEngine::get_gpu_frame_statistics() ) );
+
+		// the most recent hitch of either side
+		const auto cpu_hitches = LogicEngine::get_cpu_frame_statistics().get_hitches();
+		const auto gpu_hitches = LogicEngine::get_gpu_frame_statistics().get_hitches();
+		std::ostringstream hitch_text;
+		hitch_text << "HITCHES: " << LogicEngine::get_cpu_frame_statistics().get_hitch_count() << " CPU, " << LogicEngine::get_gpu_frame_statistics().get_hitch_count() << " GPU";
+		for( const auto* hitches : { &cpu_hitches, &gpu_hitches } )
+		{
+			if( !hitches->empty() )
+			{
+				const FrameStatistics::Hitch& hitch = hitches->back();
+				hitch_text << std::fixed << std::setprecision( 1 ) << "  |  " << ( hitches == &cpu_hitches ? "CPU " : "GPU " )
+					<< std::chrono::duration<DOUBLE, std::milli>( hitch.duration ).count() << " ms in " << ( hitch.zone.empty() ? "?" : hitch.zone );
+			}
+		}
+		hitch_label->get_text().set_utf8( hitch_text.str() );
 		cycle_display_wait_time = std::chrono::nanoseconds( 0 );
 	}
 
@@ -78,10 +78,12 @@ namespace noxcain
 		std::chrono::nanoseconds cycle_display_wait_time = std::chrono::nanoseconds::zero();
 		std::unique_ptr<VectorText2D> cpu_cycle_label;
 		std::unique_ptr<VectorText2D> gpu_cycle_label;
+		std::unique_ptr<VectorText2D> hitch_label;
 
 		//TEST BUTTONS
 		std::unique_ptr<PassivRecieverNode> performance_ui_base;
 		std::unique_ptr<BaseButton> debug_button;
+		std::unique_ptr<BaseButton> trace_button;
 		std::unique_ptr<BaseButton> switch_font_button;
 		
 		//STANDART
@@ -3,8 +3,14 @@
 #ifdef WIN32
 
 #include <windows/Windows.hpp>
+#include <logic/GameLogicEngine.hpp>
 #include <Windows.h>
 
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+
 int CALLBACK WinMain(
 	_In_ HINSTANCE hInstance,
 	_In_ HINSTANCE hPrevInstance,
@@ -12,6 +18,56 @@ int CALLBACK WinMain(
 	_In_ int       nCmdShow
 )
 {
+	// "--benchmark [fields]" replaces the game with the generated benchmark level
+	const std::string_view command_line( lpCmdLine );
+	const std::size_t benchmark_argument = command_line.find( "--benchmark" );
+	if( benchmark_argument != std::string_view::npos )
+	{
+		noxcain::BenchmarkSettings benchmark_settings;
+		const unsigned long field_count = std::strtoul( lpCmdLine + benchmark_argument + std::strlen( "--benchmark" ), nullptr, 10 );
+		if( field_count ) benchmark_settings.field_count = noxcain::UINT32( field_count );
+		noxcain::LogicEngine::select_benchmark( benchmark_settings );
+	}
+
+	// "--dynamic-resolution fps" lowers the render resolution while the gpu misses the frame rate
+	const std::size_t dynamic_resolution_argument = command_line.find( "--dynamic-resolution" );
+	if( dynamic_resolution_argument != std::string_view::npos )
+	{
+		const unsigned long fps = std::strtoul( lpCmdLine + dynamic_resolution_argument + std::strlen( "--dynamic-resolution" ), nullptr, 10 );
+		noxcain::DynamicResolutionSettings resolution_settings;
+		if( fps ) resolution_settings.target_frame_time = std::chrono::nanoseconds( 1000000000 / fps );
+		noxcain::LogicEngine::enable_dynamic_resolution( resolution_settings );
+	}
+
+	// "--replay file" feeds a recorded input log instead of the live input, "--record file" writes one
+	const auto get_file_argument = [&command_line]( std::string_view name ) -> std::string
+	{
+		const std::size_t argument = command_line.find( name );
+		if( argument == std::string_view::npos )
+		{
+			return std::string();
+		}
+		const std::size_t begin = command_line.find_first_not_of( ' ', argument + name.size() );
+		if( begin == std::string_view::npos )
+		{
+			return std::string();
+		}
+		const std::size_t end = command_line.find( ' ', begin );
+		return std::string( command_line.substr( begin, end == std::string_view::npos ? end : end - begin ) );
+	};
+
+	const std::string replay_file = get_file_argument( "--replay" );
+	if( !replay_file.empty() && !noxcain::LogicEngine::select_input_replay( replay_file ) )
+	{
+		return 1;
+	}
+
+	const std::string record_file = get_file_argument( "--record" );
+	if( !record_file.empty() && !noxcain::LogicEngine::start_input_recording( record_file ) )
+	{
+		return 1;
+	}
+
 	std::shared_ptr window_class = std::make_shared<noxcain::WindowClass>( hInstance );
 	if( *window_class )
 	{
@@ -23,10 +79,29 @@ int CALLBACK WinMain(
 #elif __ANDROID__
 
 #include <android/AndroidSurface.hpp>
+#include <logic/GameLogicEngine.hpp>
 
 void android_main( struct android_app* app_state )
 {
+	// weak devices keep their frame rate by rendering fewer pixels
+	noxcain::LogicEngine::enable_dynamic_resolution( noxcain::DynamicResolutionSettings() );
+
 	auto surface = std::make_shared<noxcain::AndroidSurface>( app_state );
 	surface->draw();
 }
+
+#elif __linux__
+
+#include <headless/HeadlessSurface.hpp>
+
+int main( int argc, char** argv )
+{
+	noxcain::HeadlessSurface::Settings settings;
+	if( !noxcain::HeadlessSurface::parse_arguments( argc, argv, settings ) )
+	{
+		return 1;
+	}
+	auto surface = std::make_shared<noxcain::HeadlessSurface>( settings );
+	return surface->draw() ? 0 : 1;
+}
 #endif
\ No newline at end of file
@@ -33,6 +33,16 @@ namespace noxcain
 		NxMatrix4x4 operator*( const NxMatrix4x4& other ) const;
 
 		std::array<DOUBLE, 4> operator*( const std::array<DOUBLE, 4>& vector ) const;
+
+		inline bool operator==( const NxMatrix4x4& other ) const
+		{
+			return matrix == other.matrix;
+		}
+
+		inline bool operator!=( const NxMatrix4x4& other ) const
+		{
+			return matrix != other.matrix;
+		}
 		
 		inline const DOUBLE& operator[]( const std::size_t index ) const
 		{
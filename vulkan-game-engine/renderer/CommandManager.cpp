@@ -5,6 +5,7 @@
 #include <renderer/GameGraphicEngine.hpp>
 #include <renderer/GraphicEngineConstants.hpp>
 #include <renderer/MemoryManagement.hpp>
+#include <renderer/ReleaseQueue.hpp>
 #include <renderer/RenderQuery.hpp>
 
 #include <logic/GameLogicEngine.hpp>
@@ -50,14 +51,20 @@ void noxcain::CommandManager::run_render_loop()
 
 	CommandSubmit submit;
 
+	const RenderQuery::ZoneId frame_zone = GraphicEngine::get_render_query().register_zone( "frame", 0.5, 0.5, 0.5 );
+
 	while( submit.check_swapchain() && LogicEngine::is_running() )
 	{
 		r_handle_bool.reset();
 		const auto start_time = std::chrono::steady_clock::now();
+		static const TimeFrameZone frame_start_zone( "frame start", 1.0, 1.0, 1.0, 1.0 );
+		record_time_frame.add_marker( frame_start_zone );
+
 		// validate all pre record and render objects with high priority 
 		// and with out dependencie to command buffers
 		{
-			TimeFrame time_frame( record_time_frame, 0.0, 0.8, 0.0, 1.0, "pre buffer" );
+			static const TimeFrameZone time_frame_zone( "pre buffer", 0.0, 0.8, 0.0, 1.0 );
+			TimeFrame time_frame( record_time_frame, time_frame_zone );
 			
 			if( !update_logic( submit ) || !validate_render_passes() )
 			{
@@ -80,10 +87,12 @@ void noxcain::CommandManager::run_render_loop()
 			return;
 		}
 
-
+		// objects retired from here on may be used by this frame
+		const UINT64 frame_index = GraphicEngine::get_release_queue().begin_frame();
 
 		// validate all command buffer dependent objects 
-		record_time_frame.start_frame( 0.0, 0.6, 0.2, 1.0, "buffer" );
+		static const TimeFrameZone buffer_zone( "buffer", 0.0, 0.6, 0.2, 1.0 );
+		record_time_frame.start_frame( buffer_zone );
 
 		geometry_task.set_buffer_id( id );
 		vector_decal_task.set_buffer_id( id );
@@ -109,10 +118,12 @@ void noxcain::CommandManager::run_render_loop()
 		}
 
 		// start master recording
-		record_time_frame.end_is_start( 0.0, 0.4, 0.4, 1.0, "record" );
+		static const TimeFrameZone record_zone( "record", 0.0, 0.4, 0.4, 1.0 );
+		record_time_frame.end_is_start( record_zone );
 
 		CommandSubmit::SubmitCommandBufferData buffer_data;
 		buffer_data.id = id;
+		buffer_data.frame_index = frame_index;
 		buffer_data.main_buffer = command_buffers[id].front();
 		buffer_data.finalize_command_buffers = std::vector<vk::CommandBuffer>( command_buffers[id].begin() + 1, command_buffers[id].end() );
 
@@ -120,15 +131,13 @@ void noxcain::CommandManager::run_render_loop()
 		auto resolution = g_settings.get_accumulated_resolution();
 		bool multi_sampling = g_settings.get_sample_count() > 1;
 
-		vk::QueryPool timestamp_pool = GraphicEngine::get_render_query().get_timestamp_pool();
+		const RenderQuery& render_query = GraphicEngine::get_render_query();
 
 		buffer_data.main_buffer.begin( vk::CommandBufferBeginInfo( vk::CommandBufferUsageFlagBits::eOneTimeSubmit ) );
+		render_query.reset_zones( buffer_data.main_buffer, id );
+		render_query.begin_zone( buffer_data.main_buffer, id, frame_zone );
 
-		if( timestamp_pool )
-		{
-			buffer_data.main_buffer.resetQueryPool( timestamp_pool, 0, RenderQuery::TIMESTAMP_COUNT );
-		}
-
+		// only the accumulated part of the targets is rendered
 		buffer_data.main_buffer.beginRenderPass( vk::RenderPassBeginInfo( deferred_render_pass.get_render_pass(), deferred_frame_buffer,
 																		  vk::Rect2D( vk::Offset2D( 0, 0 ), vk::Extent2D( resolution.width, resolution.height ) ),
 																		  UINT32( deferred_clear_colors.size() ), deferred_clear_colors.data() ), vk::SubpassContents::eSecondaryCommandBuffers );
@@ -193,12 +202,7 @@ void noxcain::CommandManager::run_render_loop()
 				// overlay commands
 				cBuffer.executeCommands( { sub_command_buffers[2 * index + 1] } );
 				cBuffer.endRenderPass();
-				
-				if( timestamp_pool )
-				{
-					cBuffer.writeTimestamp( vk::PipelineStageFlagBits::eBottomOfPipe, timestamp_pool, (UINT32)RenderQuery::TimeStampIds::END );
-				}
-				
+				render_query.end_zone( cBuffer, id, frame_zone );
 				cBuffer.end();
 			}
 		}
@@ -208,7 +212,7 @@ void noxcain::CommandManager::run_render_loop()
 		record_time_frame.end_frame();
 
 		const auto end_time = std::chrono::steady_clock::now();
-		LogicEngine::set_cpu_cycle_duration( end_time - start_time );
+		LogicEngine::add_cpu_cycle( start_time, end_time );
 	}
 	return;
 }
@@ -218,6 +222,7 @@ bool noxcain::CommandManager::validate_render_passes()
 	if( GraphicEngine::get_memory_manager().has_render_destination_memory() )
 	{
 		deferred_render_pass.update_format( default_color_format, GraphicEngine::get_memory_manager().get_image( MemoryManager::RenderDestinationImages::COLOR ).format );
+		deferred_render_pass.update_format( normal_format, GraphicEngine::get_memory_manager().get_image( MemoryManager::RenderDestinationImages::NORMAL ).format );
 		deferred_render_pass.update_format( depth_format, GraphicEngine::get_memory_manager().get_image( MemoryManager::RenderDestinationImages::DEPTH_SAMPLED ).format );
 		deferred_render_pass.update_format( stencil_format, GraphicEngine::get_memory_manager().get_image( MemoryManager::RenderDestinationImages::STENCIL_UNSAMPLED ).format );
 
@@ -243,28 +248,25 @@ inline bool noxcain::CommandManager::update_logic( CommandSubmit& submit_control
 
 bool noxcain::CommandManager::check_settings( CommandSubmit& submit_controller )
 {
-	ResultHandler<vk::Result> r_handle( vk::Result::eSuccess );
-	vk::Device device = GraphicEngine::get_device();
-	
 	//get current graphic settings
 	const auto& graphic_settings = LogicEngine::get_graphic_settings();
 	const UINT32 sample_count = graphic_settings.get_sample_count();
-	const auto resolution = graphic_settings.get_accumulated_resolution();
+
+	// a lowered dynamic resolution renders into a part of the targets, only the allocated size needs new ones
+	const auto resolution = graphic_settings.get_allocated_resolution();
 	
 	//check for deferred renderer, render pass and render targets
 	if( !deferred_frame_buffer || sample_count != old_sample_count || resolution.width != old_frame_buffer_width || resolution.height != old_frame_buffer_height )
 	{
 		submit_controller.clean_command_buffer();
-		r_handle << device.waitIdle();
-		if( r_handle.all_okay() )
-		{
-			device.destroyFramebuffer( deferred_frame_buffer );
-			deferred_frame_buffer = vk::Framebuffer();
 
-			return GraphicEngine::get_memory_manager().setup_main_render_destination();
-		}
+		// frames in flight may still use the old frame buffer and its images
+		GraphicEngine::get_release_queue().retire( deferred_frame_buffer );
+		deferred_frame_buffer = vk::Framebuffer();
+
+		return GraphicEngine::get_memory_manager().setup_main_render_destination();
 	}
-	return r_handle.all_okay();
+	return true;
 }
 
 bool noxcain::CommandManager::validate_frame_buffers()
@@ -273,63 +275,55 @@ bool noxcain::CommandManager::validate_frame_buffers()
 	vk::Device device = GraphicEngine::get_device();
 	
 	auto sample_count = LogicEngine::get_graphic_settings().get_sample_count();
-	auto resolution = LogicEngine::get_graphic_settings().get_accumulated_resolution();
+	auto resolution = LogicEngine::get_graphic_settings().get_allocated_resolution();
 
 	// validate deferred_frame_buffer
 	if( !deferred_frame_buffer )
 	{
-		r_handle << device.waitIdle();
-		if( r_handle.all_okay() )
-		{
-			auto attachment_count = deferred_render_pass.get_attachment_count();
-
-			std::vector<vk::ImageView> views;
-			deferred_clear_colors.clear();
-			views.reserve( attachment_count );
-			deferred_clear_colors.reserve( attachment_count );
+		auto attachment_count = deferred_render_pass.get_attachment_count();
 
-			// attachment0 color
-			views.push_back( GraphicEngine::get_memory_manager().get_image( MemoryManager::RenderDestinationImages::COLOR ).view );
-			deferred_clear_colors.push_back( vk::ClearColorValue( std::array<FLOAT32, 4>( { 0.0F, 0.0F, 0.0F, 0.0F } ) ) );
+		std::vector<vk::ImageView> views;
+		deferred_clear_colors.clear();
+		views.reserve( attachment_count );
+		deferred_clear_colors.reserve( attachment_count );
 
-			// attachment1 color resolved
-			views.push_back( GraphicEngine::get_memory_manager().get_image( MemoryManager::RenderDestinationImages::COLOR_RESOLVED ).view );
-			deferred_clear_colors.push_back( vk::ClearColorValue( std::array<FLOAT32, 4>( { 0.0F, 0.0F, 0.0F, 0.0F } ) ) );
+		// attachment0 color
+		views.push_back( GraphicEngine::get_memory_manager().get_image( MemoryManager::RenderDestinationImages::COLOR ).view );
+		deferred_clear_colors.push_back( vk::ClearColorValue( std::array<FLOAT32, 4>( { 0.0F, 0.0F, 0.0F, 0.0F } ) ) );
 
-			// attachment2 normal
-			views.push_back( GraphicEngine::get_memory_manager().get_image( MemoryManager::RenderDestinationImages::NORMAL ).view );
-			deferred_clear_colors.push_back( vk::ClearColorValue( std::array<FLOAT32, 4>( { 0.0F, 0.0F, 0.0F, 0.0F } ) ) );
+		// attachment1 color resolved
+		views.push_back( GraphicEngine::get_memory_manager().get_image( MemoryManager::RenderDestinationImages::COLOR_RESOLVED ).view );
+		deferred_clear_colors.push_back( vk::ClearColorValue( std::array<FLOAT32, 4>( { 0.0F, 0.0F, 0.0F, 0.0F } ) ) );
 
-			// attachment3 slider_position
-			views.push_back( GraphicEngine::get_memory_manager().get_image( MemoryManager::RenderDestinationImages::POSITION ).view );
-			deferred_clear_colors.push_back( vk::ClearColorValue( std::array<FLOAT32, 4>( { 0.0F, 0.0F, 0.0F, 0.0F } ) ) );
+		// attachment2 octahedral normal
+		views.push_back( GraphicEngine::get_memory_manager().get_image( MemoryManager::RenderDestinationImages::NORMAL ).view );
+		deferred_clear_colors.push_back( vk::ClearColorValue( std::array<FLOAT32, 4>( { 0.0F, 0.0F, 0.0F, 0.0F } ) ) );
 
-			// attachment4 depth only
-			views.push_back( GraphicEngine::get_memory_manager().get_image( MemoryManager::RenderDestinationImages::DEPTH_SAMPLED ).view );
-			deferred_clear_colors.push_back( vk::ClearDepthStencilValue( 1.0F, 0U ) );
+		// attachment3 depth only, the shading reconstructs the position from it
+		views.push_back( GraphicEngine::get_memory_manager().get_image( MemoryManager::RenderDestinationImages::DEPTH_SAMPLED ).view );
+		deferred_clear_colors.push_back( vk::ClearDepthStencilValue( 1.0F, 0U ) );
 
-			if( sample_count > 1 )
-			{
-				// attachment5 stencil only
-				views.push_back( GraphicEngine::get_memory_manager().get_image( MemoryManager::RenderDestinationImages::STENCIL_UNSAMPLED ).view );
-				deferred_clear_colors.push_back( vk::ClearDepthStencilValue( 0.0F, 1U ) );
-			}
+		if( sample_count > 1 )
+		{
+			// attachment4 stencil only
+			views.push_back( GraphicEngine::get_memory_manager().get_image( MemoryManager::RenderDestinationImages::STENCIL_UNSAMPLED ).view );
+			deferred_clear_colors.push_back( vk::ClearDepthStencilValue( 0.0F, 1U ) );
+		}
 
-			vk::Extent3D extent( resolution.width, resolution.height, 1 );
+		vk::Extent3D extent( resolution.width, resolution.height, 1 );
 
-			if( views.size() != attachment_count )
-			{
-				// error TODO
-				return false;
-			}
+		if( views.size() != attachment_count )
+		{
+			// error TODO
+			return false;
+		}
 
-			deferred_frame_buffer = r_handle << device.createFramebuffer( vk::FramebufferCreateInfo( vk::FramebufferCreateFlags(), deferred_render_pass.get_render_pass(), UINT32( views.size() ), views.data(), extent.width, extent.height, extent.depth ) );
+		deferred_frame_buffer = r_handle << device.createFramebuffer( vk::FramebufferCreateInfo( vk::FramebufferCreateFlags(), deferred_render_pass.get_render_pass(), UINT32( views.size() ), views.data(), extent.width, extent.height, extent.depth ) );
 
-			if( deferred_clear_colors.size() != attachment_count )
-			{
-				deferred_clear_colors.clear();
-				deferred_clear_colors.resize( attachment_count, vk::ClearColorValue() );
-			}
+		if( deferred_clear_colors.size() != attachment_count )
+		{
+			deferred_clear_colors.clear();
+			deferred_clear_colors.resize( attachment_count, vk::ClearColorValue() );
 		}
 		if( !r_handle.all_okay() )
 		{
@@ -342,30 +336,19 @@ bool noxcain::CommandManager::validate_frame_buffers()
 	}
 
 	// validate finailze_frame_buffer 
-	auto current_swapchain = GraphicEngine::get_swapchain();
-	if( !old_swapchain || old_swapchain != current_swapchain || finalize_frame_buffers.empty() )
+	const UINT64 current_presentation_version = GraphicEngine::get_presentation_version();
+	if( old_presentation_version != current_presentation_version || finalize_frame_buffers.empty() )
 	{
-		if( !current_swapchain )
+		if( !GraphicEngine::get_swapchain_image_count() )
 		{
 			return false;
 		}
 
-		if( !finalize_frame_buffers.empty() )
+		for( auto frame_buffer : finalize_frame_buffers )
 		{
-			r_handle << device.waitIdle();
-			if( r_handle.all_okay() )
-			{
-				for( auto frame_buffer : finalize_frame_buffers )
-				{
-					device.destroyFramebuffer( frame_buffer );
-				}
-				finalize_frame_buffers.clear();
-			}
-			else
-			{
-				return false;
-			}
+			GraphicEngine::get_release_queue().retire( frame_buffer );
 		}
+		finalize_frame_buffers.clear();
 
 		const auto swap_chain_image_count = GraphicEngine::get_swapchain_image_count();
 		for( std::size_t index = 0; index < swap_chain_image_count; ++index )
@@ -408,7 +391,7 @@ bool noxcain::CommandManager::validate_frame_buffers()
 		{
 			return false;
 		}
-		old_swapchain = current_swapchain;
+		old_presentation_version = current_presentation_version;
 	}
 
 	return r_handle.all_okay();
@@ -452,6 +435,7 @@ void noxcain::CommandManager::describe_deferred_render_pass()
 	auto fixed_single_sample_count = deferred_render_pass.get_sample_count_handle();
 
 	default_color_format = deferred_render_pass.get_format_handle();
+	normal_format = deferred_render_pass.get_format_handle();
 	stencil_format = deferred_render_pass.get_format_handle();
 	depth_format = deferred_render_pass.get_format_handle();
 
@@ -468,24 +452,18 @@ void noxcain::CommandManager::describe_deferred_render_pass()
 																   vk::ImageLayout::eUndefined, vk::ImageLayout::eShaderReadOnlyOptimal );
 
 	// attachment 2
-	auto normal_att = deferred_render_pass.add_attachment( default_color_format, multi_sample_count, vk::AttachmentDescriptionFlags(),
+	auto normal_att = deferred_render_pass.add_attachment( normal_format, multi_sample_count, vk::AttachmentDescriptionFlags(),
 														   vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eDontCare,
 														   vk::AttachmentLoadOp::eDontCare, vk::AttachmentStoreOp::eDontCare,
 														   vk::ImageLayout::eUndefined, vk::ImageLayout::eShaderReadOnlyOptimal );
 
-	// attachment 3
-	auto position_att = deferred_render_pass.add_attachment( default_color_format, multi_sample_count, vk::AttachmentDescriptionFlags(),
-															 vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eDontCare,
-															 vk::AttachmentLoadOp::eDontCare, vk::AttachmentStoreOp::eDontCare,
-															 vk::ImageLayout::eUndefined, vk::ImageLayout::eShaderReadOnlyOptimal );
-
-	// attachment 4
+	// attachment 3, read by the shading subpasses
 	auto depth_att = deferred_render_pass.add_attachment( depth_format, multi_sample_count, vk::AttachmentDescriptionFlags(),
 														  vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eDontCare,
 														  vk::AttachmentLoadOp::eDontCare, vk::AttachmentStoreOp::eDontCare,
 														  vk::ImageLayout::eUndefined, vk::ImageLayout::eDepthStencilReadOnlyOptimal );
 
-	// attachment 5
+	// attachment 4
 	auto stencil_att = deferred_render_pass.add_attachment( stencil_format, fixed_single_sample_count, vk::AttachmentDescriptionFlags(),
 															vk::AttachmentLoadOp::eDontCare, vk::AttachmentStoreOp::eDontCare,
 															vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eDontCare,
@@ -497,7 +475,6 @@ void noxcain::CommandManager::describe_deferred_render_pass()
 															   { // COLOR
 																   { color_att, vk::ImageLayout::eColorAttachmentOptimal },
 																   { normal_att, vk::ImageLayout::eColorAttachmentOptimal },
-																   { position_att, vk::ImageLayout::eColorAttachmentOptimal },
 															   },
 															   { //RESOLVE
 															   },
@@ -509,8 +486,7 @@ void noxcain::CommandManager::describe_deferred_render_pass()
 														   },
 															{ // COLOR
 																{ color_att, vk::ImageLayout::eColorAttachmentOptimal },
-																{ normal_att, vk::ImageLayout::eColorAttachmentOptimal },
-																{ position_att, vk::ImageLayout::eColorAttachmentOptimal }
+																{ normal_att, vk::ImageLayout::eColorAttachmentOptimal }
 															},
 															{ // RESOLVE
 															},
@@ -521,7 +497,7 @@ void noxcain::CommandManager::describe_deferred_render_pass()
 	auto edge_detection_subpass = deferred_render_pass.add_subpass( { // INPUT
 																		{ color_att, vk::ImageLayout::eShaderReadOnlyOptimal },
 																		{ normal_att, vk::ImageLayout::eShaderReadOnlyOptimal },
-																		{ position_att, vk::ImageLayout::eShaderReadOnlyOptimal }
+																		{ depth_att, vk::ImageLayout::eDepthStencilReadOnlyOptimal }
 																	},
 																		{ // COLOR
 																		},
@@ -533,14 +509,14 @@ void noxcain::CommandManager::describe_deferred_render_pass()
 																	RenderPassDescription::SamplingMode::MULTI );
 
 	auto multi_shading_render_subpass =
-		deferred_render_pass.add_subpass( { { color_att, vk::ImageLayout::eShaderReadOnlyOptimal }, { normal_att, vk::ImageLayout::eShaderReadOnlyOptimal }, { position_att, vk::ImageLayout::eShaderReadOnlyOptimal } },
+		deferred_render_pass.add_subpass( { { color_att, vk::ImageLayout::eShaderReadOnlyOptimal }, { normal_att, vk::ImageLayout::eShaderReadOnlyOptimal }, { depth_att, vk::ImageLayout::eDepthStencilReadOnlyOptimal } },
 										  { { color_resolved_att, vk::ImageLayout::eColorAttachmentOptimal } }, // COLOR
 										  {}, // RESOLVE
 										  {}, // PRESERVE
 										  { stencil_att, vk::ImageLayout::eDepthStencilReadOnlyOptimal },
 										  RenderPassDescription::SamplingMode::MULTI );
 	auto single_shading_render_subpass =
-		deferred_render_pass.add_subpass( { { color_att, vk::ImageLayout::eShaderReadOnlyOptimal }, { normal_att, vk::ImageLayout::eShaderReadOnlyOptimal }, { position_att, vk::ImageLayout::eShaderReadOnlyOptimal } },
+		deferred_render_pass.add_subpass( { { color_att, vk::ImageLayout::eShaderReadOnlyOptimal }, { normal_att, vk::ImageLayout::eShaderReadOnlyOptimal }, { depth_att, vk::ImageLayout::eDepthStencilReadOnlyOptimal } },
 										  { { color_resolved_att, vk::ImageLayout::eColorAttachmentOptimal } },// COLOR
 										  {}, // RESOLVE
 										  {}, // PRESERVE
@@ -553,10 +529,30 @@ void noxcain::CommandManager::describe_deferred_render_pass()
 										 geometry_subpass, vk::PipelineStageFlagBits::eLateFragmentTests, vk::AccessFlagBits::eDepthStencilAttachmentWrite,
 										 decal_subpass, vk::PipelineStageFlagBits::eEarlyFragmentTests, vk::AccessFlagBits::eDepthStencilAttachmentRead );
 
+	// the decals blend into the color written by the geometry
+	deferred_render_pass.add_dependency( vk::DependencyFlagBits::eByRegion,
+										 geometry_subpass, vk::PipelineStageFlagBits::eColorAttachmentOutput, vk::AccessFlagBits::eColorAttachmentWrite,
+										 decal_subpass, vk::PipelineStageFlagBits::eColorAttachmentOutput, vk::AccessFlagBits::eColorAttachmentRead );
+
+	// the depth written by the geometry is read as input attachment
+	deferred_render_pass.add_dependency( vk::DependencyFlagBits::eByRegion,
+										 geometry_subpass, vk::PipelineStageFlagBits::eLateFragmentTests, vk::AccessFlagBits::eDepthStencilAttachmentWrite,
+										 edge_detection_subpass, vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eInputAttachmentRead,
+										 RenderPassDescription::SamplingMode::MULTI );
+
+	deferred_render_pass.add_dependency( vk::DependencyFlagBits::eByRegion,
+										 geometry_subpass, vk::PipelineStageFlagBits::eLateFragmentTests, vk::AccessFlagBits::eDepthStencilAttachmentWrite,
+										 multi_shading_render_subpass, vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eInputAttachmentRead,
+										 RenderPassDescription::SamplingMode::MULTI );
+
+	deferred_render_pass.add_dependency( vk::DependencyFlagBits::eByRegion,
+										 geometry_subpass, vk::PipelineStageFlagBits::eLateFragmentTests, vk::AccessFlagBits::eDepthStencilAttachmentWrite,
+										 single_shading_render_subpass, vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eInputAttachmentRead,
+										 RenderPassDescription::SamplingMode::SINGLE );
 
 	deferred_render_pass.add_dependency( vk::DependencyFlagBits::eByRegion,
 										 decal_subpass, vk::PipelineStageFlagBits::eColorAttachmentOutput, vk::AccessFlagBits::eColorAttachmentWrite,
-										 edge_detection_subpass, vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eShaderRead,
+										 edge_detection_subpass, vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eInputAttachmentRead,
 										 RenderPassDescription::SamplingMode::MULTI );
 
 	deferred_render_pass.add_dependency( vk::DependencyFlagBits::eByRegion,
@@ -566,7 +562,7 @@ void noxcain::CommandManager::describe_deferred_render_pass()
 
 	deferred_render_pass.add_dependency( vk::DependencyFlagBits::eByRegion,
 										 decal_subpass, vk::PipelineStageFlagBits::eColorAttachmentOutput, vk::AccessFlagBits::eColorAttachmentWrite,
-										 single_shading_render_subpass, vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eShaderRead,
+										 single_shading_render_subpass, vk::PipelineStageFlagBits::eFragmentShader, vk::AccessFlagBits::eInputAttachmentRead,
 										 RenderPassDescription::SamplingMode::SINGLE );
 
 	deferred_render_pass.set_decider( multi_sample_count );
@@ -583,7 +579,7 @@ void noxcain::CommandManager::describe_finalize_render_pass()
 	auto final_render_target = finalize_render_pass.add_attachment( swap_chain_image_format, fixed_single_sample_count, vk::AttachmentDescriptionFlags(),
 																	vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eStore,
 																	vk::AttachmentLoadOp::eDontCare, vk::AttachmentStoreOp::eDontCare,
-																	vk::ImageLayout::eUndefined, vk::ImageLayout::ePresentSrcKHR );
+																	vk::ImageLayout::eUndefined, GraphicEngine::get_presentation_layout() );
 
 	auto post_processing_subpass = finalize_render_pass.add_subpass(
 		{// input
@@ -722,25 +718,17 @@ noxcain::CommandManager::~CommandManager()
 		command_main_thread.join();
 	}
 
-	vk::Device device = GraphicEngine::get_device();
-	if( device )
+	ReleaseQueue& release_queue = GraphicEngine::get_release_queue();
+	release_queue.retire( deferred_frame_buffer );
+
+	for( const auto& frame_buffer : finalize_frame_buffers )
 	{
-		ResultHandler r_handler( vk::Result::eSuccess );
-		r_handler << device.waitIdle();
-		if( r_handler.all_okay() )
-		{
-			device.destroyFramebuffer( deferred_frame_buffer );
-			
-			for( const auto& frame_buffer : finalize_frame_buffers )
-			{
-				device.destroyFramebuffer( frame_buffer );
-			}
-			
-			for( const auto& pool : command_pools )
-			{
-				device.destroyCommandPool( pool );
-			}
-		}
+		release_queue.retire( frame_buffer );
+	}
+
+	for( const auto& pool : command_pools )
+	{
+		release_queue.retire( pool );
 	}
 }
 
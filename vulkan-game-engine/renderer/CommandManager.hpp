@@ -36,6 +36,7 @@ namespace noxcain
 		void describe_finalize_render_pass();
 		
 		RenderPassDescription::FormatHandle default_color_format;
+		RenderPassDescription::FormatHandle normal_format;
 		RenderPassDescription::FormatHandle stencil_format;
 		RenderPassDescription::FormatHandle depth_format;
 		RenderPassDescription::SampleCountHandle multi_sample_count;
@@ -66,7 +67,7 @@ namespace noxcain
 
 		std::vector<vk::Framebuffer> finalize_frame_buffers;
 		std::vector<vk::ClearValue> finalize_clear_colors;
-		vk::SwapchainKHR old_swapchain;
+		UINT64 old_presentation_version = 0;
 
 		vk::ClearColorValue clear_color;
 
@@ -0,0 +1,170 @@
+#include "CommandStatistics.hpp"
+
+#include <tools/TimeFrame.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+
+namespace
+{
+	struct Registry
+	{
+		std::mutex task_mutex;
+		std::vector<noxcain::CommandStatistics::TaskCounts> tasks;
+	};
+
+	Registry& get_registry()
+	{
+		static Registry registry;
+		return registry;
+	}
+}
+
+noxcain::CommandCounts& noxcain::CommandCounts::operator+=( const CommandCounts& other )
+{
+	command_count += other.command_count;
+	pipeline_binds += other.pipeline_binds;
+	pipeline_switches += other.pipeline_switches;
+	descriptor_binds += other.descriptor_binds;
+	descriptor_sets += other.descriptor_sets;
+	vertex_buffer_binds += other.vertex_buffer_binds;
+	index_buffer_binds += other.index_buffer_binds;
+	push_constants += other.push_constants;
+	push_constant_bytes += other.push_constant_bytes;
+	dynamic_states += other.dynamic_states;
+	draws += other.draws;
+	instances += other.instances;
+	return *this;
+}
+
+std::vector<std::pair<std::string, noxcain::UINT64>> noxcain::CommandCounts::get_values() const
+{
+	return
+	{
+		{ "commands", command_count },
+		{ "pipeline binds", pipeline_binds },
+		{ "pipeline switches", pipeline_switches },
+		{ "descriptor binds", descriptor_binds },
+		{ "descriptor sets", descriptor_sets },
+		{ "vertex buffer binds", vertex_buffer_binds },
+		{ "index buffer binds", index_buffer_binds },
+		{ "push constants", push_constants },
+		{ "push constant bytes", push_constant_bytes },
+		{ "dynamic states", dynamic_states },
+		{ "draws", draws },
+		{ "instances", instances }
+	};
+}
+
+noxcain::CountingCommandBuffer::CountingCommandBuffer( vk::CommandBuffer buffer, CommandCounts& counts ) : buffer( buffer ), counts( counts )
+{
+}
+
+void noxcain::CountingCommandBuffer::bindPipeline( vk::PipelineBindPoint bind_point, vk::Pipeline pipeline )
+{
+	++counts.command_count;
+	++counts.pipeline_binds;
+	if( pipeline != bound_pipeline )
+	{
+		++counts.pipeline_switches;
+		bound_pipeline = pipeline;
+	}
+	buffer.bindPipeline( bind_point, pipeline );
+}
+
+void noxcain::CountingCommandBuffer::bindDescriptorSets( vk::PipelineBindPoint bind_point, vk::PipelineLayout layout, UINT32 first_set, vk::ArrayProxy<const vk::DescriptorSet> descriptor_sets, vk::ArrayProxy<const UINT32> dynamic_offsets )
+{
+	++counts.command_count;
+	++counts.descriptor_binds;
+	counts.descriptor_sets += descriptor_sets.size();
+	buffer.bindDescriptorSets( bind_point, layout, first_set, descriptor_sets, dynamic_offsets );
+}
+
+void noxcain::CountingCommandBuffer::bindVertexBuffers( UINT32 first_binding, vk::ArrayProxy<const vk::Buffer> buffers, vk::ArrayProxy<const vk::DeviceSize> offsets )
+{
+	++counts.command_count;
+	++counts.vertex_buffer_binds;
+	buffer.bindVertexBuffers( first_binding, buffers, offsets );
+}
+
+void noxcain::CountingCommandBuffer::bindIndexBuffer( vk::Buffer index_buffer, vk::DeviceSize offset, vk::IndexType index_type )
+{
+	++counts.command_count;
+	++counts.index_buffer_binds;
+	buffer.bindIndexBuffer( index_buffer, offset, index_type );
+}
+
+void noxcain::CountingCommandBuffer::pushConstants( vk::PipelineLayout layout, vk::ShaderStageFlags stage_flags, UINT32 offset, UINT32 size, const void* values )
+{
+	++counts.command_count;
+	++counts.push_constants;
+	counts.push_constant_bytes += size;
+	buffer.pushConstants( layout, stage_flags, offset, size, values );
+}
+
+void noxcain::CountingCommandBuffer::setViewport( UINT32 first_viewport, vk::ArrayProxy<const vk::Viewport> viewports )
+{
+	++counts.command_count;
+	++counts.dynamic_states;
+	buffer.setViewport( first_viewport, viewports );
+}
+
+void noxcain::CountingCommandBuffer::setScissor( UINT32 first_scissor, vk::ArrayProxy<const vk::Rect2D> scissors )
+{
+	++counts.command_count;
+	++counts.dynamic_states;
+	buffer.setScissor( first_scissor, scissors );
+}
+
+void noxcain::CountingCommandBuffer::draw( UINT32 vertex_count, UINT32 instance_count, UINT32 first_vertex, UINT32 first_instance )
+{
+	++counts.command_count;
+	++counts.draws;
+	counts.instances += instance_count;
+	buffer.draw( vertex_count, instance_count, first_vertex, first_instance );
+}
+
+void noxcain::CountingCommandBuffer::drawIndexed( UINT32 index_count, UINT32 instance_count, UINT32 first_index, INT32 vertex_offset, UINT32 first_instance )
+{
+	++counts.command_count;
+	++counts.draws;
+	counts.instances += instance_count;
+	buffer.drawIndexed( index_count, instance_count, first_index, vertex_offset, first_instance );
+}
+
+noxcain::DOUBLE noxcain::CommandStatistics::TaskCounts::get_skip_ratio() const
+{
+	const UINT32 frame_count = recorded_count + reused_count;
+	return frame_count ? DOUBLE( reused_count ) / DOUBLE( frame_count ) : 0.0;
+}
+
+void noxcain::CommandStatistics::publish( const std::string& task_name, const CommandCounts& counts, bool is_reused )
+{
+	{
+		Registry& registry = get_registry();
+		std::unique_lock lock( registry.task_mutex );
+		auto task = std::find_if( registry.tasks.begin(), registry.tasks.end(), [&task_name]( const TaskCounts& task_counts ) { return task_counts.task_name == task_name; } );
+		if( task == registry.tasks.end() )
+		{
+			TaskCounts new_task;
+			new_task.task_name = task_name;
+			task = registry.tasks.insert( registry.tasks.end(), std::move( new_task ) );
+		}
+		task->counts = counts;
+		task->is_reused = is_reused;
+		++( is_reused ? task->reused_count : task->recorded_count );
+	}
+
+	if( TimeFrameCollector::is_tracing() )
+	{
+		TimeFrameCollector::add_counters( task_name + " commands", counts.get_values() );
+	}
+}
+
+std::vector<noxcain::CommandStatistics::TaskCounts> noxcain::CommandStatistics::get_task_counts()
+{
+	Registry& registry = get_registry();
+	std::unique_lock lock( registry.task_mutex );
+	return registry.tasks;
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <Defines.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+#include <vulkan/vulkan.hpp>
+
+namespace noxcain
+{
+	/// <summary>
+	/// commands of one or more command buffers, counted by type
+	/// </summary>
+	struct CommandCounts
+	{
+		UINT32 command_count = 0;
+		UINT32 pipeline_binds = 0;
+
+		// binds of another pipeline than the one bound before in the same buffer
+		UINT32 pipeline_switches = 0;
+		UINT32 descriptor_binds = 0;
+		UINT32 descriptor_sets = 0;
+		UINT32 vertex_buffer_binds = 0;
+		UINT32 index_buffer_binds = 0;
+		UINT32 push_constants = 0;
+		UINT64 push_constant_bytes = 0;
+		UINT32 dynamic_states = 0;
+		UINT32 draws = 0;
+		UINT64 instances = 0;
+
+		CommandCounts& operator+=( const CommandCounts& other );
+
+		/// <summary>
+		/// name and value of every count, in declaration order
+		/// </summary>
+		std::vector<std::pair<std::string, UINT64>> get_values() const;
+	};
+
+	/// <summary>
+	/// forwards the commands of the recording tasks to a command buffer and counts them
+	/// </summary>
+	/// <remarks>begin, end and gpu zone timestamps are not counted</remarks>
+	class CountingCommandBuffer
+	{
+	public:
+		CountingCommandBuffer( vk::CommandBuffer buffer, CommandCounts& counts );
+
+		const vk::CommandBuffer& get_buffer() const
+		{
+			return buffer;
+		}
+
+		decltype( auto ) begin( const vk::CommandBufferBeginInfo& begin_info ) const
+		{
+			return buffer.begin( begin_info );
+		}
+
+		decltype( auto ) end() const
+		{
+			return buffer.end();
+		}
+
+		void bindPipeline( vk::PipelineBindPoint bind_point, vk::Pipeline pipeline );
+		void bindDescriptorSets( vk::PipelineBindPoint bind_point, vk::PipelineLayout layout, UINT32 first_set, vk::ArrayProxy<const vk::DescriptorSet> descriptor_sets, vk::ArrayProxy<const UINT32> dynamic_offsets );
+		void bindVertexBuffers( UINT32 first_binding, vk::ArrayProxy<const vk::Buffer> buffers, vk::ArrayProxy<const vk::DeviceSize> offsets );
+		void bindIndexBuffer( vk::Buffer index_buffer, vk::DeviceSize offset, vk::IndexType index_type );
+		void pushConstants( vk::PipelineLayout layout, vk::ShaderStageFlags stage_flags, UINT32 offset, UINT32 size, const void* values );
+		void setViewport( UINT32 first_viewport, vk::ArrayProxy<const vk::Viewport> viewports );
+		void setScissor( UINT32 first_scissor, vk::ArrayProxy<const vk::Rect2D> scissors );
+		void draw( UINT32 vertex_count, UINT32 instance_count, UINT32 first_vertex, UINT32 first_instance );
+		void drawIndexed( UINT32 index_count, UINT32 instance_count, UINT32 first_index, INT32 vertex_offset, UINT32 first_instance );
+
+	private:
+		vk::CommandBuffer buffer;
+		CommandCounts& counts;
+		vk::Pipeline bound_pipeline;
+	};
+
+	/// <summary>
+	/// command counts of the last frame of every recording task
+	/// </summary>
+	class CommandStatistics
+	{
+	public:
+		struct TaskCounts
+		{
+			std::string task_name;
+			CommandCounts counts;
+
+			// the buffers of an earlier frame were submitted again, nothing was recorded
+			bool is_reused = false;
+
+			// frames with new commands and frames that skipped the recording, since the first publish
+			UINT32 recorded_count = 0;
+			UINT32 reused_count = 0;
+
+			// share of the frames that skipped the recording
+			DOUBLE get_skip_ratio() const;
+		};
+
+		/// <summary>
+		/// replaces the counts of the task, counts the frame as recorded or reused and writes the counts as counter track into a running trace
+		/// </summary>
+		static void publish( const std::string& task_name, const CommandCounts& counts, bool is_reused );
+
+		/// <summary>
+		/// the tasks in the order they published first
+		/// </summary>
+		static std::vector<TaskCounts> get_task_counts();
+	};
+}
@@ -2,6 +2,7 @@
 
 #include <renderer/GraphicEngineConstants.hpp>
 #include <renderer/GameGraphicEngine.hpp>
+#include <renderer/ReleaseQueue.hpp>
 #include <renderer/RenderQuery.hpp>
 
 #include <logic/GameLogicEngine.hpp>
@@ -29,19 +30,12 @@ noxcain::CommandSubmit::~CommandSubmit()
 		submit_thread.join();
 	}
 
-	vk::Device device = GraphicEngine::get_device();
-	if( device )
+	// a failed frame may have left its semaphores pending
+	ReleaseQueue& release_queue = GraphicEngine::get_release_queue();
+	release_queue.retire( frame_end_fence );
+	for( const auto& semaphore : semaphores )
 	{
-		ResultHandler r_handler( vk::Result::eSuccess );
-		r_handler << device.waitIdle();
-		if( r_handler.all_okay() )
-		{
-			device.destroyFence( frame_end_fence );
-			for( const auto& semaphore : semaphores )
-			{
-				device.destroySemaphore( semaphore );
-			}
-		}
+		release_queue.retire( semaphore );
 	}
 }
 
@@ -148,6 +142,10 @@ noxcain::UINT32 noxcain::CommandSubmit::submit_loop()
 	create_semaphores();
 	frame_end_fence = r_handler << device.createFence( vk::FenceCreateInfo( vk::FenceCreateFlags() ) );
 
+	// offscreen images are used in turn, the fence wait of each frame keeps the next one free
+	const bool is_offscreen = GraphicEngine::is_offscreen();
+	UINT32 next_offscreen_image = 0;
+
 	if( r_handler.all_okay() )
 	{
 		while( running() )
@@ -175,76 +173,68 @@ noxcain::UINT32 noxcain::CommandSubmit::submit_loop()
 				}
 			}
 
-			time_collection_all.start_frame( 0.0, 0.7, 0.3, 1.0, "" );
+			static const TimeFrameZone frame_zone( "", 0.0, 0.7, 0.3, 1.0 );
+			time_collection_all.start_frame( frame_zone );
+			std::chrono::nanoseconds gpu_time = std::chrono::nanoseconds::zero();
 
 			// submit command buffers
 			{
 				const vk::SwapchainKHR& swapchain = GraphicEngine::get_swapchain();
-				UINT32 image_index = r_handler << device.acquireNextImageKHR( swapchain, GRAPHIC_TIMEOUT_DURATION.count(), get_semaphore( SemaphoreIds::ACQUIRE ), vk::Fence() );
+				UINT32 image_index = 0;
+				if( is_offscreen )
+				{
+					image_index = next_offscreen_image;
+					next_offscreen_image = ( next_offscreen_image + 1 ) % UINT32( current_buffers.finalize_command_buffers.size() );
+				}
+				else
+				{
+					image_index = r_handler << device.acquireNextImageKHR( swapchain, GRAPHIC_TIMEOUT_DURATION.count(), get_semaphore( SemaphoreIds::ACQUIRE ), vk::Fence() );
+				}
+
 				if( r_handler.all_okay() )
 				{
 					vk::PipelineStageFlags render_stage_flags( vk::PipelineStageFlagBits::eColorAttachmentOutput );
 					vk::PipelineStageFlags sampling_stage_flags( vk::PipelineStageFlagBits::eFragmentShader );
 
+					// without presentation nothing waits for the last semaphore, so it is not signaled
+					const UINT32 presentation_semaphore_count = is_offscreen ? 0 : 1;
 					r_handler << queue.submit(
 						{
 							vk::SubmitInfo(
-								1, &get_semaphore( SemaphoreIds::ACQUIRE ), &render_stage_flags,
+								presentation_semaphore_count, &get_semaphore( SemaphoreIds::ACQUIRE ), &render_stage_flags,
 								1, &( current_buffers.main_buffer ),
 								1, &get_semaphore( SemaphoreIds::RENDER ) ),
 							vk::SubmitInfo(
 								1, &get_semaphore( SemaphoreIds::RENDER ), &sampling_stage_flags,
 								1, &( current_buffers.finalize_command_buffers[image_index] ),
-								1, &get_semaphore( SemaphoreIds::SUPER_SAMPLING ) )
+								presentation_semaphore_count, &get_semaphore( SemaphoreIds::SUPER_SAMPLING ) )
 						},
 						frame_end_fence );
 
 					if( r_handler.all_okay() )
 					{
-						r_handler << queue.presentKHR( vk::PresentInfoKHR( 1, &get_semaphore( SemaphoreIds::SUPER_SAMPLING ), 1, &swapchain, &image_index ) );
+						if( !is_offscreen )
+						{
+							r_handler << queue.presentKHR( vk::PresentInfoKHR( 1, &get_semaphore( SemaphoreIds::SUPER_SAMPLING ), 1, &swapchain, &image_index ) );
+						}
+
 						if( !r_handler.is_critical() )
 						{
 							r_handler << device.waitForFences( { frame_end_fence }, VK_TRUE, ~UINT64( 0 ) );
+							const auto fence_time = std::chrono::steady_clock::now();
 							r_handler << device.resetFences( { frame_end_fence } );
 
 							if( !r_handler.is_critical() )
 							{
-								std::array<UINT64, RenderQuery::TIMESTAMP_COUNT> time_stamps;
-								auto end_time = std::chrono::steady_clock::now();
-								auto timestamp_pool = GraphicEngine::get_render_query().get_timestamp_pool();
-								if( timestamp_pool )
+								GraphicEngine::get_release_queue().complete_frame( current_buffers.frame_index );
+
+								// the fence signaled, so reading the zones of this slot never waits
+								gpu_time = GraphicEngine::get_render_query().collect_zones( current_buffers.id, fence_time );
+
+								if( is_offscreen )
 								{
-									DOUBLE timestamp_period = GraphicEngine::get_physical_device().getProperties().limits.timestampPeriod;
-									/*r_handler <<*/ device.getQueryPoolResults( timestamp_pool, 0, RenderQuery::TIMESTAMP_COUNT, vk::ArrayProxy<UINT64>( time_stamps ), 0, vk::QueryResultFlagBits::e64 );
-									if( r_handler.all_okay() )
-									{
-										time_collection_gpu.add_time_frame(
-											end_time - std::chrono::nanoseconds( UINT64( timestamp_period * ( time_stamps[(UINT32)RenderQuery::TimeStampIds::END] - time_stamps[(UINT32)RenderQuery::TimeStampIds::START] ) ) ),
-											end_time - std::chrono::nanoseconds( UINT64( timestamp_period * ( time_stamps[(UINT32)RenderQuery::TimeStampIds::END] - time_stamps[(UINT32)RenderQuery::TimeStampIds::AFTER_GEOMETRY] ) ) ),
-											0.8, 0.8, 0.0, 0.8, "geometry" );
-
-										time_collection_gpu.add_time_frame(
-											end_time - std::chrono::nanoseconds( UINT64( timestamp_period * ( time_stamps[(UINT32)RenderQuery::TimeStampIds::END] - time_stamps[(UINT32)RenderQuery::TimeStampIds::AFTER_GEOMETRY] ) ) ),
-											end_time - std::chrono::nanoseconds( UINT64( timestamp_period * ( time_stamps[(UINT32)RenderQuery::TimeStampIds::END] - time_stamps[(UINT32)RenderQuery::TimeStampIds::AFTER_GLYPHS] ) ) ),
-											0.8, 0.0, 0.0, 0.8, "vector" );
-
-										time_collection_gpu.add_time_frame(
-											end_time - std::chrono::nanoseconds( UINT64( timestamp_period * ( time_stamps[(UINT32)RenderQuery::TimeStampIds::END] - time_stamps[(UINT32)RenderQuery::TimeStampIds::AFTER_GLYPHS] ) ) ),
-											end_time - std::chrono::nanoseconds( UINT64( timestamp_period * ( time_stamps[(UINT32)RenderQuery::TimeStampIds::END] - time_stamps[(UINT32)RenderQuery::TimeStampIds::AFTER_SHADING] ) ) ),
-											0.8, 0.0, 0.8, 0.8, "shading" );
-
-										time_collection_gpu.add_time_frame(
-											end_time - std::chrono::nanoseconds( UINT64( timestamp_period * ( time_stamps[(UINT32)RenderQuery::TimeStampIds::END] - time_stamps[(UINT32)RenderQuery::TimeStampIds::BEFOR_POST] ) ) ),
-											end_time - std::chrono::nanoseconds( UINT64( timestamp_period * ( time_stamps[(UINT32)RenderQuery::TimeStampIds::END] - time_stamps[(UINT32)RenderQuery::TimeStampIds::AFTER_POST] ) ) ),
-											0.0, 0.0, 0.8, 0.8, "post" );
-
-										time_collection_gpu.add_time_frame(
-											end_time - std::chrono::nanoseconds( UINT64( timestamp_period * ( time_stamps[(UINT32)RenderQuery::TimeStampIds::END] - time_stamps[(UINT32)RenderQuery::TimeStampIds::BEFOR_OVERLAY] ) ) ),
-											end_time - std::chrono::nanoseconds( UINT64( timestamp_period * ( time_stamps[(UINT32)RenderQuery::TimeStampIds::END] - time_stamps[(UINT32)RenderQuery::TimeStampIds::AFTER_OVERLAY] ) ) ),
-											0.0, 0.8, 0.8, 0.8, "overlay" );
-									}
+									GraphicEngine::complete_offscreen_frame( image_index );
 								}
-
 							}
 
 						}
@@ -261,7 +251,7 @@ noxcain::UINT32 noxcain::CommandSubmit::submit_loop()
 
 			time_collection_all.end_frame();
 			const auto end_time = std::chrono::steady_clock::now();
-			LogicEngine::set_gpu_cycle_duration( end_time - start_time );
+			LogicEngine::add_gpu_cycle( start_time, end_time, gpu_time );
 
 			if( !r_handler.all_okay() && !r_handler.is_critical() )
 			{
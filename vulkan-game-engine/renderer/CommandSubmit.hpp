@@ -18,6 +18,7 @@ namespace noxcain
 		struct SubmitCommandBufferData
 		{
 			UINT32 id = 0;
+			UINT64 frame_index = 0;
 			vk::CommandBuffer main_buffer;
 			std::vector<vk::CommandBuffer> finalize_command_buffers;
 		};
@@ -32,7 +33,6 @@ namespace noxcain
 
 	private:
 		TimeFrameCollector time_collection_all = TimeFrameCollector( "GPU Overall" );
-		TimeFrameCollector time_collection_gpu = TimeFrameCollector( "GPU Sub Tasks" );
 
 		enum class Status
 		{
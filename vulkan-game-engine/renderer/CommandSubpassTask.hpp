@@ -1,16 +1,23 @@
 #pragma once
 #include <Defines.hpp>
 
+#include <renderer/CommandStatistics.hpp>
 #include <renderer/CommandThreadTools.hpp>
 #include <renderer/GraphicEngineConstants.hpp>
 #include <renderer/GameGraphicEngine.hpp>
+#include <renderer/ReleaseQueue.hpp>
+#include <renderer/RenderQuery.hpp>
 
 #include <tools/ResultHandler.hpp>
+#include <tools/TimeFrame.hpp>
 
 #include <array>
+#include <cstring>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
+#include <type_traits>
 #include <vector>
 #include <vulkan/vulkan.hpp>
 
@@ -32,6 +39,8 @@ namespace noxcain
 		const std::vector<vk::CommandBuffer>& get_finished_buffers();
 
 	protected:
+		const std::string task_name;
+		TimeFrameCollector time_col;
 		
 		std::vector<vk::Framebuffer> frame_buffers;
 		vk::RenderPass render_pass;
@@ -58,7 +67,7 @@ namespace noxcain
 		bool single_use = true;
 		bool finished = false;
 
-		SubpassTask();
+		SubpassTask( const std::string& name );
 		
 		// thread components
 		mutable std::mutex task_mutex;
@@ -67,16 +76,47 @@ namespace noxcain
 		void execute_task();
 
 		// buffer preperations
+		// everything the recorded commands depend on, compared by value
+		using RecordKey = std::vector<UINT64>;
+
+		template<typename V>
+		static void add_to_record_key( RecordKey& record_key, const V& value );
+
 		struct CommandData
 		{
-			vk::CommandPool pool;
+			// the buffers are split evenly over the pools, buffers of different pools may be recorded in parallel
+			std::vector<vk::CommandPool> pools;
 			std::vector<vk::CommandBuffer> buffers;
+
+			// the buffers are submitted again while the key of the next frame in this slot is equal
+			RecordKey record_key;
+			bool is_recorded = false;
+
+			// one entry per buffer, kept with the buffers while they are reused
+			std::vector<CommandCounts> command_counts;
 		};
 		std::vector<CommandData> command_data;
-		bool buffer_preparation( CommandData& pool_data, std::size_t buffer_count );
+		bool buffer_preparation( CommandData& pool_data, std::size_t buffer_count, std::size_t pool_count = 1 );
+		bool build_record_key( RecordKey& record_key );
+		bool reset_buffers( CommandData& pool_data );
 		void shutdown_task();
+
+		/// <summary>
+		/// wraps a buffer of the slot being recorded, its commands are counted for the command statistics
+		/// </summary>
+		CountingCommandBuffer get_counting_buffer( std::size_t buffer_index );
 	};
 
+	template<typename T>
+	template<typename V>
+	inline void SubpassTask<T>::add_to_record_key( RecordKey& record_key, const V& value )
+	{
+		static_assert( std::is_trivially_copyable_v<V> );
+		const std::size_t start = record_key.size();
+		record_key.resize( start + ( sizeof( V ) + sizeof( UINT64 ) - 1 ) / sizeof( UINT64 ), 0 );
+		std::memcpy( record_key.data() + start, &value, sizeof( V ) );
+	}
+
 	template<typename T>
 	inline bool SubpassTask<T>::wait_for_start()
 	{
@@ -126,7 +166,9 @@ namespace noxcain
 	}
 
 	template<typename T>
-	SubpassTask<T>::SubpassTask() :
+	SubpassTask<T>::SubpassTask( const std::string& name ) :
+		task_name( name ),
+		time_col( name ),
 		task_thread( &SubpassTask<T>::execute_task, this ),
 		command_data( RECORD_RING_SIZE )
 	{
@@ -165,10 +207,39 @@ namespace noxcain
 			result_handler << wait_for_recording();
 			if( result_handler.is_critical() ) return;
 
-			// record the commands in the buffers of the selected pool
-			result_handler << static_cast<T*>( this )->record( command_data[buffer_id].buffers );
+			// gather the frame data, the buffers of the selected pool are kept if nothing they depend on changed
+			RecordKey record_key;
+			result_handler << build_record_key( record_key );
 			if( result_handler.is_critical() ) return;
 
+			CommandData& current_data = command_data[buffer_id];
+			const bool is_reused = current_data.is_recorded && record_key == current_data.record_key;
+			if( is_reused )
+			{
+				static const TimeFrameZone frame_zone( "reuse", 0.0F, 0.4F, 0.6F, 1.0F );
+				TimeFrame frame( time_col, frame_zone );
+			}
+			else
+			{
+				// record the commands in the buffers of the selected pool
+				result_handler << reset_buffers( current_data );
+				if( result_handler.is_critical() ) return;
+
+				result_handler << static_cast<T*>( this )->record( current_data.buffers );
+				if( result_handler.is_critical() ) return;
+
+				current_data.record_key.swap( record_key );
+				current_data.is_recorded = true;
+			}
+
+			// reused buffers execute the commands they were recorded with
+			CommandCounts frame_counts;
+			for( const CommandCounts& buffer_counts : current_data.command_counts )
+			{
+				frame_counts += buffer_counts;
+			}
+			CommandStatistics::publish( task_name, frame_counts, is_reused );
+
 			// set the subtask state on finished and notify master
 			std::unique_lock<std::mutex> lock( task_mutex );
 			finished = true;
@@ -177,37 +248,73 @@ namespace noxcain
 	}
 
 	template<typename T>
-	inline bool SubpassTask<T>::buffer_preparation( CommandData& pool_data, std::size_t buffer_count )
+	inline bool SubpassTask<T>::buffer_preparation( CommandData& pool_data, std::size_t buffer_count, std::size_t pool_count )
 	{
 		ResultHandler<vk::Result> r_handler( vk::Result::eSuccess );
-
 		vk::Device device = GraphicEngine::get_device();
-		if( !pool_data.pool )
-		{
-			pool_data.pool = r_handler << device.createCommandPool( vk::CommandPoolCreateInfo( vk::CommandPoolCreateFlagBits::eTransient, GraphicEngine::get_graphic_queue_family_index() ) );
-		}
-		else
-		{
-			r_handler << device.resetCommandPool( pool_data.pool, vk::CommandPoolResetFlags() );
-		}
 
-		if( r_handler.all_okay() )
+		// the buffers of the selected slot are not in use, a new layout replaces the pools with all their buffers
+		if( pool_data.pools.size() != pool_count || pool_data.buffers.size() != buffer_count )
 		{
-
-			if( pool_data.buffers.size() && pool_data.buffers.size() != buffer_count )
+			for( const vk::CommandPool& pool : pool_data.pools )
 			{
-				device.freeCommandBuffers( pool_data.pool, pool_data.buffers );
-				pool_data.buffers.clear();
+				device.destroyCommandPool( pool );
 			}
+			pool_data.pools.clear();
+			pool_data.buffers.clear();
+			pool_data.is_recorded = false;
 
-			if( pool_data.buffers.empty() )
+			const UINT32 pool_buffer_count = UINT32( buffer_count / pool_count );
+			for( std::size_t pool_index = 0; pool_index < pool_count && r_handler.all_okay(); ++pool_index )
 			{
-				pool_data.buffers = r_handler << device.allocateCommandBuffers( vk::CommandBufferAllocateInfo( pool_data.pool, vk::CommandBufferLevel::eSecondary, buffer_count ) );
+				// not transient, the buffers may be submitted over many frames
+				const vk::CommandPool pool = r_handler << device.createCommandPool( vk::CommandPoolCreateInfo( vk::CommandPoolCreateFlags(), GraphicEngine::get_graphic_queue_family_index() ) );
+				if( r_handler.all_okay() )
+				{
+					pool_data.pools.push_back( pool );
+					const std::vector<vk::CommandBuffer> pool_buffers = r_handler << device.allocateCommandBuffers( vk::CommandBufferAllocateInfo( pool, vk::CommandBufferLevel::eSecondary, pool_buffer_count ) );
+					pool_data.buffers.insert( pool_data.buffers.end(), pool_buffers.begin(), pool_buffers.end() );
+				}
 			}
 		}
 		return r_handler.all_okay();
 	}
 
+	template<typename T>
+	inline bool SubpassTask<T>::build_record_key( RecordKey& record_key )
+	{
+		// a destroyed handle invalidates all buffers that recorded it, handle values may be reused afterwards
+		add_to_record_key( record_key, GraphicEngine::get_release_queue().get_retired_count() );
+		add_to_record_key( record_key, GraphicEngine::get_render_query().get_timestamp_pool( buffer_id ) );
+		add_to_record_key( record_key, render_pass );
+		add_to_record_key( record_key, subpass_index );
+		for( const vk::Framebuffer& frame_buffer : frame_buffers )
+		{
+			add_to_record_key( record_key, frame_buffer );
+		}
+		return static_cast<T*>( this )->prepare_recording( record_key );
+	}
+
+	template<typename T>
+	inline bool SubpassTask<T>::reset_buffers( CommandData& pool_data )
+	{
+		ResultHandler<vk::Result> r_handler( vk::Result::eSuccess );
+		for( const vk::CommandPool& pool : pool_data.pools )
+		{
+			r_handler << GraphicEngine::get_device().resetCommandPool( pool, vk::CommandPoolResetFlags() );
+		}
+		pool_data.is_recorded = false;
+		pool_data.command_counts.assign( pool_data.buffers.size(), CommandCounts() );
+		return r_handler.all_okay();
+	}
+
+	template<typename T>
+	inline CountingCommandBuffer SubpassTask<T>::get_counting_buffer( std::size_t buffer_index )
+	{
+		CommandData& current_data = command_data[buffer_id];
+		return CountingCommandBuffer( current_data.buffers[buffer_index], current_data.command_counts[buffer_index] );
+	}
+
 	template<typename T>
 	inline void SubpassTask<T>::shutdown_task()
 	{
@@ -222,20 +329,15 @@ namespace noxcain
 			task_thread.join();
 		}
 
-		vk::Device device = GraphicEngine::get_device();
-		if( device )
+		// the last recorded buffers may still be executed
+		for( const auto& single_command_data : command_data )
 		{
-			ResultHandler r_handler( vk::Result::eSuccess );
-			r_handler << device.waitIdle();
-			if( r_handler.all_okay() )
+			for( const vk::CommandPool& pool : single_command_data.pools )
 			{
-				for( auto single_command_data : command_data )
-				{
-					device.destroyCommandPool( single_command_data.pool );
-				}
-				command_data.clear();
+				GraphicEngine::get_release_queue().retire( pool );
 			}
 		}
+		command_data.clear();
 	}
 
 	template<typename T>
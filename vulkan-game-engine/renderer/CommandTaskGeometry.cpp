@@ -4,6 +4,8 @@
 
 #include <renderer/GameGraphicEngine.hpp>
 #include <renderer/MemoryManagement.hpp>
+#include <renderer/PipelineCache.hpp>
+#include <renderer/ReleaseQueue.hpp>
 #include <renderer/RenderQuery.hpp>
 
 #include <logic/GameLogicEngine.hpp>
@@ -38,29 +40,20 @@ bool noxcain::GeometryTask::setup_layout()
 
 bool noxcain::GeometryTask::build_geomtry_pipeline()
 {
-	std::array<vk::PipelineShaderStageCreateInfo, 2> shaderStages =
-	{
-		vk::PipelineShaderStageCreateInfo( vk::PipelineShaderStageCreateFlags(), vk::ShaderStageFlagBits::eVertex, GraphicEngine::get_shader( VertexShaderIds::DEFERRED_GEOMETRY ), "main", nullptr ),
-		vk::PipelineShaderStageCreateInfo( vk::PipelineShaderStageCreateFlags(), vk::ShaderStageFlagBits::eFragment, GraphicEngine::get_shader( FragmentShaderIds::DEFERRED_GEOMETRY ), "main", nullptr )
-	};
-
 	auto graphic_settings = LogicEngine::get_graphic_settings();
-	auto resolution = graphic_settings.get_accumulated_resolution();
-	const vk::Extent2D extent = vk::Extent2D( resolution.width, resolution.height );
-	std::array<vk::Viewport, 1> viewports =
-	{
-		vk::Viewport( 0.0F, 0.0F, float( extent.width ), float( extent.height ), 0.0F, 1.0F )
-	};
 
-	std::array<vk::Rect2D, viewports.size()> scissors =
+	// the fragment shader marks partly covered pixels for the edge detection
+	auto specialization = createSpecialization( graphic_settings.get_sample_count() );
+	vk::SpecializationInfo specialization_info( specialization.descriptions.size(), specialization.descriptions.data(), specialization.data.size(), specialization.data.data() );
+
+	std::array<vk::PipelineShaderStageCreateInfo, 2> shaderStages =
 	{
-		vk::Rect2D( vk::Offset2D( 0, 0 ), extent )
+		vk::PipelineShaderStageCreateInfo( vk::PipelineShaderStageCreateFlags(), vk::ShaderStageFlagBits::eVertex, GraphicEngine::get_shader( VertexShaderIds::DEFERRED_GEOMETRY ), "main", nullptr ),
+		vk::PipelineShaderStageCreateInfo( vk::PipelineShaderStageCreateFlags(), vk::ShaderStageFlagBits::eFragment, GraphicEngine::get_shader( FragmentShaderIds::DEFERRED_GEOMETRY ), "main", &specialization_info )
 	};
 
-	vk::PipelineViewportStateCreateInfo viewportSate(
-		vk::PipelineViewportStateCreateFlags(),
-		viewports.size(), viewports.data(),
-		scissors.size(), scissors.data() );
+	// viewport and scissor are set while recording
+	vk::PipelineViewportStateCreateInfo viewportSate( vk::PipelineViewportStateCreateFlags(), 1, nullptr, 1, nullptr );
 
 	vk::PipelineRasterizationStateCreateInfo rasterizationState(
 		vk::PipelineRasterizationStateCreateFlags(),
@@ -78,9 +71,8 @@ bool noxcain::GeometryTask::build_geomtry_pipeline()
 															 vk::BlendFactor::eZero, vk::BlendFactor::eZero, vk::BlendOp::eAdd, vk::BlendFactor::eZero, vk::BlendFactor::eZero, vk::BlendOp::eAdd,
 															 vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA );
 
-	std::array<vk::PipelineColorBlendAttachmentState, 3> attachmentState =
+	std::array<vk::PipelineColorBlendAttachmentState, 2> attachmentState =
 	{
-		disableBlendState,
 		disableBlendState,
 		disableBlendState
 	};
@@ -112,20 +104,10 @@ bool noxcain::GeometryTask::build_geomtry_pipeline()
 		return false;
 	}
 
-	if( geomtry_pipeline )
-	{
-		r_handler << device.waitIdle();
-		if( r_handler.all_okay() )
-		{
-			device.destroyPipeline( geomtry_pipeline );
-		}
-		else
-		{
-			return false;
-		}
-	}
+	// frames in flight may still use the old pipeline
+	GraphicEngine::get_release_queue().retire( geomtry_pipeline );
 
-	geomtry_pipeline = r_handler << device.createGraphicsPipeline( vk::PipelineCache(), vk::GraphicsPipelineCreateInfo(
+	geomtry_pipeline = r_handler << GraphicEngine::get_pipeline_cache().create_graphics_pipeline( vk::GraphicsPipelineCreateInfo(
 		vk::PipelineCreateFlags(),
 		shaderStages.size(), shaderStages.data(),
 		&vertexState,
@@ -136,45 +118,39 @@ bool noxcain::GeometryTask::build_geomtry_pipeline()
 		&multisampleState,
 		&depthStencilState,
 		&colorBlendState,
-		nullptr, geomtry_pipeline_layout, render_pass, subpass_index, vk::Pipeline(), -1 ) );
+		get_viewport_dynamic_state(), geomtry_pipeline_layout, render_pass, subpass_index, vk::Pipeline(), -1 ) );
 	return r_handler.all_okay();
 }
 
-noxcain::GeometryTask::GeometryTask()
+noxcain::GeometryTask::GeometryTask() : SubpassTask( "Geometry" ), record_workers( get_record_thread_count() ),
+	gpu_zone( GraphicEngine::get_render_query().register_zone( "geometry", 0.8, 0.8, 0.0 ) )
 {
 }
 
 noxcain::GeometryTask::~GeometryTask()
 {
 	shutdown_task();
-	vk::Device device = GraphicEngine::get_device();
-	if( device )
-	{
-		ResultHandler r_handler( vk::Result::eSuccess );
-		r_handler << device.waitIdle();
-		if( r_handler.all_okay() )
-		{
-			device.destroyPipeline( geomtry_pipeline );
-			device.destroyPipelineLayout( geomtry_pipeline_layout );
-		}
-	}
+	ReleaseQueue& release_queue = GraphicEngine::get_release_queue();
+	release_queue.retire( geomtry_pipeline );
+	release_queue.retire( geomtry_pipeline_layout );
 }
 
 bool noxcain::GeometryTask::buffer_independent_preparation()
 {
-	TimeFrame frame( time_col, 0.8F, 0.0F, 0.2F, 1.0F, "start preps" );
+	static const TimeFrameZone frame_zone( "start preps", 0.8F, 0.0F, 0.2F, 1.0F );
+	TimeFrame frame( time_col, frame_zone );
 	
 	if( !geomtry_pipeline_layout )
 	{
 		if( !setup_layout() ) return false;
 	}
 
-	auto resolution = LogicEngine::get_graphic_settings().get_accumulated_resolution();
-	vk::Extent2D current_extent = vk::Extent2D( resolution.width, resolution.height );
-	if( is_new_render_pass || old_extent != current_extent )
+	// resolution changes keep the pipeline, only the sample count is baked into it
+	const UINT32 sample_count = LogicEngine::get_graphic_settings().get_sample_count();
+	if( is_new_render_pass || old_sample_count != sample_count )
 	{
 		if( !build_geomtry_pipeline() ) return false;
-		old_extent = current_extent;
+		old_sample_count = sample_count;
 		is_new_render_pass = false;
 	};
 
@@ -183,29 +159,82 @@ bool noxcain::GeometryTask::buffer_independent_preparation()
 
 bool noxcain::GeometryTask::buffer_dependent_preparation( CommandData& pool_data )
 {
-	TimeFrame frame( time_col, 0.6F, 0.0F, 0.4F, 1.0F, "buffer preps" );
-	return buffer_preparation( pool_data, 1 );
+	static const TimeFrameZone frame_zone( "buffer preps", 0.6F, 0.0F, 0.4F, 1.0F );
+	TimeFrame frame( time_col, frame_zone );
+
+	geometry_objects.clear();
+	for( const Renderable<GeometryObject>::List& geometries : LogicEngine::get_geometry_objects() )
+	{
+		for( const GeometryObject& geometry : geometries )
+		{
+			geometry_objects.push_back( &geometry );
+		}
+	}
+
+	// small scenes stay in one buffer, splitting them costs more than it saves
+	chunk_count = std::clamp<std::size_t>( geometry_objects.size() / MIN_CHUNK_SIZE, 1, record_workers.get_thread_count() );
+	return buffer_preparation( pool_data, chunk_count, chunk_count );
+}
+
+bool noxcain::GeometryTask::prepare_recording( RecordKey& record_key )
+{
+	static const TimeFrameZone frame_zone( "changes", 0.5F, 0.0F, 0.5F, 1.0F );
+	TimeFrame frame( time_col, frame_zone );
+	add_to_record_key( record_key, geomtry_pipeline );
+	add_to_record_key( record_key, LogicEngine::get_graphic_settings().get_accumulated_resolution() );
+
+	// object transforms and the camera are pushed into the buffer
+	add_to_record_key( record_key, LogicEngine::get_scene_version() );
+	add_to_record_key( record_key, LogicEngine::get_camera_matrix() );
+
+	for( const Renderable<GeometryObject>::List& geometries : LogicEngine::get_geometry_objects() )
+	{
+		add_to_record_key( record_key, geometries.get_version() );
+	}
+	for( const GeometryObject* geometry : geometry_objects )
+	{
+		add_to_record_key( record_key, geometry->get_geometry_id() );
+	}
+	return true;
 }
 
 bool noxcain::GeometryTask::record( const std::vector<vk::CommandBuffer>& buffers )
 {
-	TimeFrame frame( time_col, 0.4F, 0.0F, 0.6F, 1.0F, "record" );
+	static const TimeFrameZone frame_zone( "record", 0.4F, 0.0F, 0.6F, 1.0F );
+	TimeFrame frame( time_col, frame_zone );
+
+	// the primary buffer executes the chunks in order
+	return record_workers.run( buffers.size(), [this]( std::size_t chunk_index )
+	{
+		return record_chunk( chunk_index );
+	} );
+}
+
+bool noxcain::GeometryTask::record_chunk( std::size_t chunk_index )
+{
 	ResultHandler r_handler( vk::Result::eSuccess );
-	const auto& geometry_lists = LogicEngine::get_geometry_objects();
-	auto& c_buffer = buffers.front();
+	CountingCommandBuffer c_buffer = get_counting_buffer( chunk_index );
 	auto& resources = ResourceEngine::get_engine();
 
 	const vk::CommandBufferInheritanceInfo inharitage( render_pass, subpass_index, frame_buffers.empty() ? vk::Framebuffer() : frame_buffers.front() );
-	r_handler << c_buffer.begin( vk::CommandBufferBeginInfo( vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eOneTimeSubmit, &inharitage ) );
+	r_handler << c_buffer.begin( vk::CommandBufferBeginInfo( vk::CommandBufferUsageFlagBits::eRenderPassContinue, &inharitage ) );
 
-	vk::QueryPool timestamp_pool = GraphicEngine::get_render_query().get_timestamp_pool();
-	if( timestamp_pool )
+	const auto resolution = LogicEngine::get_graphic_settings().get_accumulated_resolution();
+	set_viewport( c_buffer, vk::Extent2D( resolution.width, resolution.height ) );
+
+	// the gpu zone begins in chunk 0 and ends in the last chunk, it only spans the pass while the chunks are executed in index order,
+	// executing them in any other order ends the zone before it begins
+	const RenderQuery& render_query = GraphicEngine::get_render_query();
+	if( chunk_index == 0 )
 	{
-		c_buffer.writeTimestamp( vk::PipelineStageFlagBits::eBottomOfPipe, timestamp_pool, (UINT32)RenderQuery::TimeStampIds::START );
+		render_query.begin_zone( c_buffer.get_buffer(), buffer_id, gpu_zone );
 	}
 
-	if( !geometry_lists.empty() )
+	const std::size_t first_object = geometry_objects.size() * chunk_index / chunk_count;
+	const std::size_t end_object = geometry_objects.size() * ( chunk_index + 1 ) / chunk_count;
+	if( end_object > first_object )
 	{
+		// bound state is not inherited between secondary buffers
 		c_buffer.bindPipeline( vk::PipelineBindPoint::eGraphics, geomtry_pipeline );
 
 		std::size_t current_geomtry_id = resources.get_invalid_geomtry_id();
@@ -214,33 +243,31 @@ bool noxcain::GeometryTask::record( const std::vector<vk::CommandBuffer>& buffer
 		const auto& cam = LogicEngine::get_camera_matrix().gpuData();
 		c_buffer.pushConstants( geomtry_pipeline_layout, vk::ShaderStageFlagBits::eVertex, GeometryObject::VERTEX_PUSH_OFFSET+GeometryObject::VERTEX_PUSH_SIZE, cam.size(), cam.data() );
 
-		for( const Renderable<GeometryObject>::List& geometries : geometry_lists )
+		for( std::size_t object_index = first_object; object_index < end_object; ++object_index )
 		{
-			for( const GeometryObject& geometry : geometries )
-			{
-				const std::size_t new_geomtry_id = geometry.get_geometry_id();
-
-				if( new_geomtry_id != current_geomtry_id )
-				{
-					current_geomtry_id = new_geomtry_id;
-					const auto& geometry_resource = resources.get_geometry( current_geomtry_id );
-					const auto& vertex_block = GraphicEngine::get_memory_manager().get_block( geometry_resource.get_vertex_buffer_id() );
-					const auto& index_block = GraphicEngine::get_memory_manager().get_block( geometry_resource.get_index_buffer_id() );
+			const GeometryObject& geometry = *geometry_objects[object_index];
+			const std::size_t new_geomtry_id = geometry.get_geometry_id();
 
-					index_count = index_block.size / sizeof( UINT32 );
+			if( new_geomtry_id != current_geomtry_id )
+			{
+				current_geomtry_id = new_geomtry_id;
+				const auto& geometry_resource = resources.get_geometry( current_geomtry_id );
+				const auto& vertex_block = GraphicEngine::get_memory_manager().get_block( geometry_resource.get_vertex_buffer_id() );
+				const auto& index_block = GraphicEngine::get_memory_manager().get_block( geometry_resource.get_index_buffer_id() );
 
-					c_buffer.bindVertexBuffers( 0, { vertex_block.buffer }, { vertex_block.offset } );
-					c_buffer.bindIndexBuffer( index_block.buffer, index_block.offset, vk::IndexType::eUint32 );
-				}
+				index_count = index_block.size / sizeof( UINT32 );
 
-				geometry.record( c_buffer, geomtry_pipeline_layout, index_count );
+				c_buffer.bindVertexBuffers( 0, { vertex_block.buffer }, { vertex_block.offset } );
+				c_buffer.bindIndexBuffer( index_block.buffer, index_block.offset, vk::IndexType::eUint32 );
 			}
+
+			geometry.record( c_buffer, geomtry_pipeline_layout, index_count );
 		}
 	}
 
-	if( timestamp_pool )
+	if( chunk_index + 1 == chunk_count )
 	{
-		c_buffer.writeTimestamp( vk::PipelineStageFlagBits::eBottomOfPipe, timestamp_pool, (UINT32)RenderQuery::TimeStampIds::AFTER_GEOMETRY );
+		render_query.end_zone( c_buffer.get_buffer(), buffer_id, gpu_zone );
 	}
 
 	r_handler << c_buffer.end();
@@ -4,6 +4,8 @@
 #include <renderer/DescriptorSetManager.hpp>
 #include <renderer/GameGraphicEngine.hpp>
 #include <renderer/MemoryManagement.hpp>
+#include <renderer/PipelineCache.hpp>
+#include <renderer/ReleaseQueue.hpp>
 #include <renderer/RenderQuery.hpp>
 
 #include <logic/GameLogicEngine.hpp>
@@ -12,12 +14,17 @@
 
 #include <resources/GameResourceEngine.hpp>
 #include <resources/FontResource.hpp>
+#include <resources/GlyphAtlas.hpp>
 
 #include <tools/ResultHandler.hpp>
 #include <tools/TimeFrame.hpp>
 
+#include <cstring>
 
-noxcain::OverlayTask::OverlayTask()
+
+noxcain::OverlayTask::OverlayTask() : SubpassTask( "Overlay" ), record_workers( get_record_thread_count() ),
+	post_zone( GraphicEngine::get_render_query().register_zone( "post", 0.0, 0.0, 0.8 ) ),
+	overlay_zone( GraphicEngine::get_render_query().register_zone( "overlay", 0.0, 0.8, 0.8 ) )
 {
 }
 
@@ -28,11 +35,10 @@ bool noxcain::OverlayTask::buffer_independent_preparation()
 		if( !setup_layouts() ) return false;
 	}
 
-	auto current_extent = GraphicEngine::get_window_resolution();
-	if( is_new_render_pass || old_extent != current_extent )
+	// the overlay is single sampled and independent of the window size, only a new render pass needs new pipelines
+	if( is_new_render_pass )
 	{
 		if( !build_text_pipeline() || !build_label_pipeline() || !build_post_pipeline() ) return false;
-		old_extent = current_extent;
 		is_new_render_pass = false;
 	};
 
@@ -44,7 +50,7 @@ bool noxcain::OverlayTask::buffer_dependent_preparation( CommandData& pool_data
 	ResultHandler<vk::Result> r_handle( vk::Result::eSuccess );
 
 	UINT32 image_count = GraphicEngine::get_swapchain_image_count();
-	return buffer_preparation( pool_data, 2 * std::size_t( image_count ) );
+	return buffer_preparation( pool_data, 2 * std::size_t( image_count ), image_count );
 }
 
 bool noxcain::OverlayTask::setup_layouts()
@@ -52,30 +58,25 @@ bool noxcain::OverlayTask::setup_layouts()
 	const vk::Device& device = GraphicEngine::get_device();
 	ResultHandler r_handler( vk::Result::eSuccess );
 
-	// label pipeline layout
+	// label pipeline layout, everything but the pixel to clip space factor comes from the instance buffer
+	// both overlay layouts share this range, so the pushed factor stays valid over pipeline changes
 
-	std::array<vk::PushConstantRange, 2> label_push_constants =
+	std::array<vk::PushConstantRange, 1> screen_push_constants =
 	{
-		vk::PushConstantRange( vk::ShaderStageFlagBits::eFragment, RenderableQuad2D::FRAGMENT_PUSH_OFFSET, RenderableQuad2D::FRAGMENT_PUSH_SIZE ),
-		vk::PushConstantRange( vk::ShaderStageFlagBits::eVertex, RenderableQuad2D::VERTEX_PUSH_OFFSET, RenderableQuad2D::VERTEX_PUSH_SIZE ),
+		vk::PushConstantRange( vk::ShaderStageFlagBits::eVertex, 0, 2 * sizeof( FLOAT32 ) )
 	};
 
-	label_pipeline_layout = r_handler << device.createPipelineLayout( vk::PipelineLayoutCreateInfo( vk::PipelineLayoutCreateFlags(), 0, nullptr, label_push_constants.size(), label_push_constants.data() ) );
-
-	// text pipeline layout
+	label_pipeline_layout = r_handler << device.createPipelineLayout( vk::PipelineLayoutCreateInfo( vk::PipelineLayoutCreateFlags(), 0, nullptr, screen_push_constants.size(), screen_push_constants.data() ) );
 
-	std::array<vk::DescriptorSetLayout, 1> text_descriptor_sets =
-	{
-		GraphicEngine::get_descriptor_set_manager().get_layout( DescriptorSetLayouts::GLYPH )
-	};
+	// text pipeline layout, shared by the vector and the atlas pipeline
 
-	std::array<vk::PushConstantRange, 2> text_push_constants =
+	std::array<vk::DescriptorSetLayout, 2> text_descriptor_sets =
 	{
-		vk::PushConstantRange( vk::ShaderStageFlagBits::eFragment, 0, 32 ),
-		vk::PushConstantRange( vk::ShaderStageFlagBits::eVertex, 32, 64 )
+		GraphicEngine::get_descriptor_set_manager().get_layout( DescriptorSetLayouts::GLYPH ),
+		GraphicEngine::get_descriptor_set_manager().get_layout( DescriptorSetLayouts::GLYPH_ATLAS )
 	};
 
-	text_pipeline_layout = r_handler << device.createPipelineLayout( vk::PipelineLayoutCreateInfo( vk::PipelineLayoutCreateFlags(), text_descriptor_sets.size(), text_descriptor_sets.data(), text_push_constants.size(), text_push_constants.data() ) );
+	text_pipeline_layout = r_handler << device.createPipelineLayout( vk::PipelineLayoutCreateInfo( vk::PipelineLayoutCreateFlags(), text_descriptor_sets.size(), text_descriptor_sets.data(), screen_push_constants.size(), screen_push_constants.data() ) );
 
 	// post pipeline layout
 
@@ -84,7 +85,13 @@ bool noxcain::OverlayTask::setup_layouts()
 		GraphicEngine::get_descriptor_set_manager().get_layout( DescriptorSetLayouts::FIXED_SAMPLED_TEXTURE_1 )
 	};
 
-	post_pipeline_layout = r_handler << device.createPipelineLayout( vk::PipelineLayoutCreateInfo( vk::PipelineLayoutCreateFlags(), post_descriptor_sets.size(), post_descriptor_sets.data(), 0, nullptr ) );
+	// part of the master texture that was rendered, the dynamic resolution renders into the upper left corner
+	std::array<vk::PushConstantRange, 1> post_push_constants =
+	{
+		vk::PushConstantRange( vk::ShaderStageFlagBits::eFragment, 0, UINT32( sizeof( post_uv_scale ) ) )
+	};
+
+	post_pipeline_layout = r_handler << device.createPipelineLayout( vk::PipelineLayoutCreateInfo( vk::PipelineLayoutCreateFlags(), post_descriptor_sets.size(), post_descriptor_sets.data(), post_push_constants.size(), post_push_constants.data() ) );
 
 	return r_handler.all_okay();
 }
@@ -97,21 +104,8 @@ bool noxcain::OverlayTask::build_post_pipeline()
 		vk::PipelineShaderStageCreateInfo( vk::PipelineShaderStageCreateFlags(), vk::ShaderStageFlagBits::eFragment, GraphicEngine::get_shader( FragmentShaderIds::FINALIZE ), "main", nullptr )
 	};
 
-	const vk::Extent2D& extent = GraphicEngine::get_window_resolution();
-	std::array<vk::Viewport, 1> viewports =
-	{
-		vk::Viewport( 0.0F, 0.0F, float( extent.width ), float( extent.height ), 0.0F, 1.0F )
-	};
-
-	std::array<vk::Rect2D, viewports.size()> scissors =
-	{
-		vk::Rect2D( vk::Offset2D( 0, 0 ), extent )
-	};
-
-	vk::PipelineViewportStateCreateInfo viewportSate(
-		vk::PipelineViewportStateCreateFlags(),
-		viewports.size(), viewports.data(),
-		scissors.size(), scissors.data() );
+	// viewport and scissor are set while recording
+	vk::PipelineViewportStateCreateInfo viewportSate( vk::PipelineViewportStateCreateFlags(), 1, nullptr, 1, nullptr );
 
 	vk::PipelineRasterizationStateCreateInfo rasterizationState(
 		vk::PipelineRasterizationStateCreateFlags(),
@@ -147,20 +141,10 @@ bool noxcain::OverlayTask::build_post_pipeline()
 		return false;
 	}
 
-	if( post_pipeline )
-	{
-		r_handler << device.waitIdle();
-		if( r_handler.all_okay() )
-		{
-			device.destroyPipeline( post_pipeline );
-		}
-		else
-		{
-			return false;
-		}
-	}
+	// frames in flight may still use the old pipeline
+	GraphicEngine::get_release_queue().retire( post_pipeline );
 
-	post_pipeline = r_handler << device.createGraphicsPipeline( vk::PipelineCache(), vk::GraphicsPipelineCreateInfo(
+	post_pipeline = r_handler << GraphicEngine::get_pipeline_cache().create_graphics_pipeline( vk::GraphicsPipelineCreateInfo(
 		vk::PipelineCreateFlags(),
 		shaderStages.size(), shaderStages.data(),
 		&vertexState,
@@ -171,7 +155,7 @@ bool noxcain::OverlayTask::build_post_pipeline()
 		&multisampleState,
 		&depthStencilState,
 		&colorBlendState,
-		nullptr,
+		get_viewport_dynamic_state(),
 		post_pipeline_layout,
 		render_pass, subpass_index, vk::Pipeline(), -1 ) );
 	return r_handler.all_okay();
@@ -180,31 +164,15 @@ bool noxcain::OverlayTask::build_post_pipeline()
 bool noxcain::OverlayTask::build_label_pipeline()
 {
 	ResultHandler resultHandler( vk::Result::eSuccess );
-	const vk::Extent2D& extent = GraphicEngine::get_window_resolution();
-
-	auto special = createSpecialization( FLOAT32( 2.0F / extent.width ), FLOAT32( -2.0F / extent.height ) );
-	vk::SpecializationInfo specializationInfo( special.descriptions.size(), special.descriptions.data(), special.data.size(), special.data.data() );
 
 	std::array<vk::PipelineShaderStageCreateInfo, 2> shaderStages =
 	{
-		vk::PipelineShaderStageCreateInfo( vk::PipelineShaderStageCreateFlags(), vk::ShaderStageFlagBits::eVertex, GraphicEngine::get_shader( VertexShaderIds::LABEL ), "main", &specializationInfo ),
-		vk::PipelineShaderStageCreateInfo( vk::PipelineShaderStageCreateFlags(), vk::ShaderStageFlagBits::eFragment, GraphicEngine::get_shader( FragmentShaderIds::LABEL ), "main", &specializationInfo )
-	};
-
-	std::array<vk::Viewport, 1> viewports =
-	{
-		vk::Viewport( 0.0F, 0.0F, static_cast<float>( extent.width ), static_cast<float>( extent.height ), 0.0F, 1.0F )
-	};
-
-	std::array<vk::Rect2D, viewports.size()> scissors =
-	{
-		vk::Rect2D( vk::Offset2D( 0, 0 ), extent )
+		vk::PipelineShaderStageCreateInfo( vk::PipelineShaderStageCreateFlags(), vk::ShaderStageFlagBits::eVertex, GraphicEngine::get_shader( VertexShaderIds::LABEL ), "main", nullptr ),
+		vk::PipelineShaderStageCreateInfo( vk::PipelineShaderStageCreateFlags(), vk::ShaderStageFlagBits::eFragment, GraphicEngine::get_shader( FragmentShaderIds::LABEL ), "main", nullptr )
 	};
 
-	vk::PipelineViewportStateCreateInfo viewportSate(
-		vk::PipelineViewportStateCreateFlags(),
-		viewports.size(), viewports.data(),
-		scissors.size(), scissors.data() );
+	// viewport and scissor are set while recording
+	vk::PipelineViewportStateCreateInfo viewportSate( vk::PipelineViewportStateCreateFlags(), 1, nullptr, 1, nullptr );
 
 	vk::PipelineRasterizationStateCreateInfo rasterizationState(
 		vk::PipelineRasterizationStateCreateFlags(),
@@ -227,12 +195,16 @@ bool noxcain::OverlayTask::build_label_pipeline()
 	vk::PipelineColorBlendStateCreateInfo colorBlendState(
 		vk::PipelineColorBlendStateCreateFlags(), VK_FALSE, vk::LogicOp::eClear, attachmentState.size(), attachmentState.data(), { 0.0F, 0.0F, 0.0F, 0.0F } );
 
-	std::array<vk::VertexInputBindingDescription, 0> inputBindings =
+	std::array<vk::VertexInputBindingDescription, 1> inputBindings =
 	{
+		vk::VertexInputBindingDescription( 0, sizeof( RenderableQuad2D::Instance ), vk::VertexInputRate::eInstance )
 	};
 
-	std::array<vk::VertexInputAttributeDescription, 0> inputAttributeDescription =
+	std::array<vk::VertexInputAttributeDescription, 3> inputAttributeDescription =
 	{
+		vk::VertexInputAttributeDescription( 0, 0, vk::Format::eR32G32B32A32Sfloat, offsetof( RenderableQuad2D::Instance, rect ) ),
+		vk::VertexInputAttributeDescription( 1, 0, vk::Format::eR32G32B32A32Sfloat, offsetof( RenderableQuad2D::Instance, color ) ),
+		vk::VertexInputAttributeDescription( 2, 0, vk::Format::eR32G32B32A32Sfloat, offsetof( RenderableQuad2D::Instance, clip ) )
 	};
 
 	vk::PipelineVertexInputStateCreateInfo vertexState(
@@ -240,12 +212,6 @@ bool noxcain::OverlayTask::build_label_pipeline()
 
 	vk::PipelineInputAssemblyStateCreateInfo assemblyState( vk::PipelineInputAssemblyStateCreateFlags(), vk::PrimitiveTopology::eTriangleStrip, VK_FALSE );
 
-	std::array<vk::DynamicState, 1> dynamicStates =
-	{
-		vk::DynamicState::eScissor
-	};
-	vk::PipelineDynamicStateCreateInfo dynamicStateInfo( vk::PipelineDynamicStateCreateFlags(), dynamicStates.size(), dynamicStates.data() );
-
 	ResultHandler<vk::Result> r_handler( vk::Result::eSuccess );
 	const vk::Device& device = GraphicEngine::get_device();
 	if( !device )
@@ -254,20 +220,10 @@ bool noxcain::OverlayTask::build_label_pipeline()
 		return false;
 	}
 
-	if( label_pipeline )
-	{
-		r_handler << device.waitIdle();
-		if( r_handler.all_okay() )
-		{
-			device.destroyPipeline( label_pipeline );
-		}
-		else
-		{
-			return false;
-		}
-	}
+	// frames in flight may still use the old pipeline
+	GraphicEngine::get_release_queue().retire( label_pipeline );
 
-	label_pipeline = resultHandler << device.createGraphicsPipeline( vk::PipelineCache(), vk::GraphicsPipelineCreateInfo(
+	label_pipeline = resultHandler << GraphicEngine::get_pipeline_cache().create_graphics_pipeline( vk::GraphicsPipelineCreateInfo(
 		vk::PipelineCreateFlags(),
 		shaderStages.size(), shaderStages.data(),
 		&vertexState,
@@ -278,102 +234,212 @@ bool noxcain::OverlayTask::build_label_pipeline()
 		&multisampleState,
 		&depthStencilState,
 		&colorBlendState,
-		&dynamicStateInfo,
+		get_viewport_dynamic_state(),
 		label_pipeline_layout,
 		render_pass, subpass_index + 1, vk::Pipeline(), -1 ) );
 	return r_handler.all_okay();
 }
 
+bool noxcain::OverlayTask::prepare_recording( RecordKey& record_key )
+{
+	static const TimeFrameZone frame_zone( "gather", 0.5F, 0.0F, 0.5F, 1.0F );
+	TimeFrame frame( time_col, frame_zone );
+	if( !gather_instances() )
+	{
+		return false;
+	}
+
+	// labels and glyphs move and change their colour through the instance buffer, the commands only depend on the groups
+	auto& descriptor_set_manager = GraphicEngine::get_descriptor_set_manager();
+	const vk::Extent2D extent = GraphicEngine::get_window_resolution();
+	add_to_record_key( record_key, extent.width );
+	add_to_record_key( record_key, extent.height );
+	add_to_record_key( record_key, post_pipeline );
+
+	const auto graphic_settings = LogicEngine::get_graphic_settings();
+	const auto accumulated_resolution = graphic_settings.get_accumulated_resolution();
+	const auto allocated_resolution = graphic_settings.get_allocated_resolution();
+	post_uv_scale =
+	{
+		allocated_resolution.width ? FLOAT32( accumulated_resolution.width ) / allocated_resolution.width : 1.0F,
+		allocated_resolution.height ? FLOAT32( accumulated_resolution.height ) / allocated_resolution.height : 1.0F
+	};
+	add_to_record_key( record_key, post_uv_scale );
+	add_to_record_key( record_key, descriptor_set_manager.get_basic_set( BasicDescriptorSets::FINALIZED_MASTER_TEXTURE ) );
+	add_to_record_key( record_key, descriptor_set_manager.get_basic_set( BasicDescriptorSets::GLYPHS ) );
+	add_to_record_key( record_key, descriptor_set_manager.get_basic_set( BasicDescriptorSets::GLYPH_ATLAS ) );
+	add_to_record_key( record_key, instance_buffers[buffer_id].get_buffer() );
+	add_to_record_key( record_key, get_glyph_instance_offset() );
+	for( const DrawGroup& group : draw_groups )
+	{
+		add_to_record_key( record_key, group.pipeline );
+		add_to_record_key( record_key, group.first_instance );
+		add_to_record_key( record_key, group.instance_count );
+	}
+	return true;
+}
+
 bool noxcain::OverlayTask::record( const std::vector<vk::CommandBuffer>& buffers )
 {
-	TimeFrame frame( time_col, 0.4F, 0.0F, 0.6F, 1.0F, "record" );
-	const auto& resources = ResourceEngine::get_engine();
+	static const TimeFrameZone frame_zone( "record", 0.4F, 0.0F, 0.6F, 1.0F );
+	TimeFrame frame( time_col, frame_zone );
 
-	for( std::size_t index = 0; index < buffers.size() / 2; ++index )
+	// the framebuffers are independent, the primary buffer of each swapchain image executes its own pair
+	return record_workers.run( buffers.size() / 2, [this, &buffers]( std::size_t index )
 	{
-		vk::CommandBufferInheritanceInfo inhertiance( render_pass, subpass_index, frame_buffers[index] );
-		vk::QueryPool timestamp_pool = GraphicEngine::get_render_query().get_timestamp_pool();
-
-		// post subpass
-		const auto post_buffer = buffers[2 * index];
-		post_buffer.begin( vk::CommandBufferBeginInfo( vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eOneTimeSubmit, &inhertiance ) );
-		
-		if( timestamp_pool )
-		{
-			post_buffer.writeTimestamp( vk::PipelineStageFlagBits::eTopOfPipe, timestamp_pool, (UINT32)RenderQuery::TimeStampIds::BEFOR_POST );
-		}
-		
-		post_buffer.bindPipeline( vk::PipelineBindPoint::eGraphics, post_pipeline );
-		post_buffer.bindDescriptorSets( vk::PipelineBindPoint::eGraphics, post_pipeline_layout, 0, { GraphicEngine::get_descriptor_set_manager().get_basic_set( BasicDescriptorSets::FINALIZED_MASTER_TEXTURE ) }, {} );
-		post_buffer.draw( 3, 1, 0, 0 );
-		
-		if( timestamp_pool )
+		return record_frame_buffer( buffers, index );
+	} );
+}
+
+bool noxcain::OverlayTask::record_frame_buffer( const std::vector<vk::CommandBuffer>& buffers, std::size_t index )
+{
+	const vk::Buffer instance_buffer = instance_buffers[buffer_id].get_buffer();
+	const vk::DeviceSize glyph_instance_offset = get_glyph_instance_offset();
+
+	const vk::Extent2D& extent = GraphicEngine::get_window_resolution();
+	const std::array<FLOAT32, 2> pixel_to_clip = { 2.0F / extent.width, -2.0F / extent.height };
+
+	vk::CommandBufferInheritanceInfo inhertiance( render_pass, subpass_index, frame_buffers[index] );
+	const RenderQuery& render_query = GraphicEngine::get_render_query();
+
+	// post subpass
+	CountingCommandBuffer post_buffer = get_counting_buffer( 2 * index );
+	post_buffer.begin( vk::CommandBufferBeginInfo( vk::CommandBufferUsageFlagBits::eRenderPassContinue, &inhertiance ) );
+	render_query.begin_zone( post_buffer.get_buffer(), buffer_id, post_zone );
+	
+	post_buffer.bindPipeline( vk::PipelineBindPoint::eGraphics, post_pipeline );
+	set_viewport( post_buffer, extent );
+	post_buffer.bindDescriptorSets( vk::PipelineBindPoint::eGraphics, post_pipeline_layout, 0, { GraphicEngine::get_descriptor_set_manager().get_basic_set( BasicDescriptorSets::FINALIZED_MASTER_TEXTURE ) }, {} );
+	post_buffer.pushConstants( post_pipeline_layout, vk::ShaderStageFlagBits::eFragment, 0, UINT32( sizeof( post_uv_scale ) ), post_uv_scale.data() );
+	post_buffer.draw( 3, 1, 0, 0 );
+	render_query.end_zone( post_buffer.get_buffer(), buffer_id, post_zone );
+	
+	post_buffer.end();
+
+	// overlay subpass
+	CountingCommandBuffer overlay_buffer = get_counting_buffer( 2 * index + 1 );
+	inhertiance.setSubpass( inhertiance.subpass + 1 );
+	overlay_buffer.begin( vk::CommandBufferBeginInfo( vk::CommandBufferUsageFlagBits::eRenderPassContinue, &inhertiance ) );
+	render_query.begin_zone( overlay_buffer.get_buffer(), buffer_id, overlay_zone );
+
+	set_viewport( overlay_buffer, extent );
+	overlay_buffer.pushConstants( label_pipeline_layout, vk::ShaderStageFlagBits::eVertex, 0, UINT32( sizeof( pixel_to_clip ) ), pixel_to_clip.data() );
+
+	if( !glyph_instances.empty() )
+	{
+		// the label pipeline does not use sets, the bound text sets stay valid over pipeline changes
+		overlay_buffer.bindDescriptorSets( vk::PipelineBindPoint::eGraphics, text_pipeline_layout, 0, {
+			GraphicEngine::get_descriptor_set_manager().get_basic_set( BasicDescriptorSets::GLYPHS ),
+			GraphicEngine::get_descriptor_set_manager().get_basic_set( BasicDescriptorSets::GLYPH_ATLAS ) }, {} );
+	}
+
+	// the same groups are replayed for every framebuffer
+	vk::Pipeline current_pipeline;
+	for( const DrawGroup& group : draw_groups )
+	{
+		if( group.pipeline != current_pipeline )
 		{
-			post_buffer.writeTimestamp( vk::PipelineStageFlagBits::eBottomOfPipe, timestamp_pool, (UINT32)RenderQuery::TimeStampIds::AFTER_POST );
+			const bool was_label = current_pipeline == label_pipeline;
+			const bool is_label = group.pipeline == label_pipeline;
+			overlay_buffer.bindPipeline( vk::PipelineBindPoint::eGraphics, group.pipeline );
+			if( !current_pipeline || was_label != is_label )
+			{
+				overlay_buffer.bindVertexBuffers( 0, { instance_buffer }, { is_label ? vk::DeviceSize( 0 ) : glyph_instance_offset } );
+			}
+			current_pipeline = group.pipeline;
 		}
-		
-		post_buffer.end();
+		overlay_buffer.draw( 4, group.instance_count, 0, group.first_instance );
+	}
 
-		// overlay subpass
-		const auto overlay_buffer = buffers[2 * index + 1];
-		inhertiance.setSubpass( inhertiance.subpass + 1 );
-		overlay_buffer.begin( vk::CommandBufferBeginInfo( vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eOneTimeSubmit, &inhertiance ) );
+	render_query.end_zone( overlay_buffer.get_buffer(), buffer_id, overlay_zone );
+	overlay_buffer.end();
+	return true;
+}
 
-		if( timestamp_pool )
+bool noxcain::OverlayTask::gather_instances()
+{
+	label_instances.clear();
+	glyph_instances.clear();
+	draw_groups.clear();
+
+	const vk::Extent2D& extent = GraphicEngine::get_window_resolution();
+	const std::array<FLOAT32, 4> default_clip = { 0.0F, 0.0F, FLOAT32( extent.width ), FLOAT32( extent.height ) };
+
+	// the groups keep the submission order for blending, only consecutive instances of the same pipeline share a draw
+	auto add_group = [this]( vk::Pipeline pipeline, std::size_t first_instance, std::size_t end_instance )
+	{
+		if( end_instance <= first_instance )
 		{
-			overlay_buffer.writeTimestamp( vk::PipelineStageFlagBits::eTopOfPipe, timestamp_pool, (UINT32)RenderQuery::TimeStampIds::BEFOR_OVERLAY );
+			return;
 		}
 
+		if( !draw_groups.empty() && draw_groups.back().pipeline == pipeline && draw_groups.back().first_instance + draw_groups.back().instance_count == first_instance )
+		{
+			draw_groups.back().instance_count += UINT32( end_instance - first_instance );
+		}
+		else
+		{
+			draw_groups.push_back( { pipeline, UINT32( first_instance ), UINT32( end_instance - first_instance ) } );
+		}
+	};
 
-		vk::Rect2D default_scissor( vk::Offset2D( 0, 0 ), GraphicEngine::get_window_resolution() );
-		vk::Rect2D current_scissor;
-
-		for( const GameUserInterface& ui : LogicEngine::get_user_interfaces() )
+	for( const GameUserInterface& ui : LogicEngine::get_user_interfaces() )
+	{
+		auto label_iter = ui.get_label_iterator();
+		auto text_iter = ui.get_text_iterator();
+		for( const auto& order : ui.get_order() )
 		{
-			auto label_iter = ui.get_label_iterator();
-			auto text_iter = ui.get_text_iterator();
-			UINT32 order_index = 0;
-			for( const auto& order : ui.get_order() )
+			const std::size_t first_label = label_instances.size();
+			label_instances.resize( first_label + order.label_count );
+			for( UINT32 index = 0; index < order.label_count; ++index, ++label_iter )
 			{
-				if( order.label_count )
-				{
-					overlay_buffer.bindPipeline( vk::PipelineBindPoint::eGraphics, label_pipeline );
-				}
-				for( UINT32 index = 0; index < order.label_count; ++index, ++label_iter )
-				{
-					current_scissor = label_iter->get().record( overlay_buffer, label_pipeline_layout, current_scissor, default_scissor );
-				}
-
-				if( order.text_count )
-				{
-					const auto& vertex_block_info = GraphicEngine::get_memory_manager().get_block( ResourceEngine::get_engine().get_font( 0 ).get_vertex_block_id() );
-					overlay_buffer.bindPipeline( vk::PipelineBindPoint::eGraphics, text_pipeline );
-					overlay_buffer.bindDescriptorSets( vk::PipelineBindPoint::eGraphics, text_pipeline_layout, 0, { GraphicEngine::get_descriptor_set_manager().get_basic_set( BasicDescriptorSets::GLYPHS ) }, {} );
-					overlay_buffer.bindVertexBuffers( 0, { vertex_block_info.buffer }, { vertex_block_info.offset } );
-				}
-				for( UINT32 index = 0; index < order.text_count; ++index, ++text_iter )
-				{
-					current_scissor = text_iter->get().record( overlay_buffer, text_pipeline_layout, current_scissor, default_scissor );
-				}
-				++order_index;
+				label_iter->get().write_instance( label_instances[first_label + index], default_clip );
 			}
-		}
+			add_group( label_pipeline, first_label, label_instances.size() );
 
-		if( timestamp_pool )
-		{
-			overlay_buffer.writeTimestamp( vk::PipelineStageFlagBits::eBottomOfPipe, timestamp_pool, (UINT32)RenderQuery::TimeStampIds::AFTER_OVERLAY );
+			for( UINT32 index = 0; index < order.text_count; ++index, ++text_iter )
+			{
+				// small text samples the distance fields
+				const VectorText2D& text = text_iter->get();
+				const vk::Pipeline pipeline = text.get_text().get_size() < GlyphAtlas::MAX_PIXEL_PER_EM ? atlas_text_pipeline : text_pipeline;
+				const std::size_t first_glyph = glyph_instances.size();
+				text.write_instances( glyph_instances, default_clip );
+				add_group( pipeline, first_glyph, glyph_instances.size() );
+			}
 		}
-		overlay_buffer.end();
 	}
+
+	if( draw_groups.empty() )
+	{
+		return true;
+	}
+
+	// one buffer per ring slot, the slot of buffer_id is not in use by the gpu while recording
+	HostBuffer& instance_buffer = instance_buffers[buffer_id];
+	const UINT64 glyph_instance_offset = get_glyph_instance_offset();
+	if( !instance_buffer.reserve( glyph_instance_offset + glyph_instances.size() * sizeof( VectorText2D::Instance ), vk::BufferUsageFlagBits::eVertexBuffer ) )
+	{
+		return false;
+	}
+
+	BYTE* memory = reinterpret_cast<BYTE*>( instance_buffer.get_memory() );
+	std::memcpy( memory, label_instances.data(), label_instances.size() * sizeof( RenderableQuad2D::Instance ) );
+	std::memcpy( memory + glyph_instance_offset, glyph_instances.data(), glyph_instances.size() * sizeof( VectorText2D::Instance ) );
 	return true;
 }
 
+noxcain::UINT64 noxcain::OverlayTask::get_glyph_instance_offset() const
+{
+	constexpr UINT64 ALIGNMENT = sizeof( VectorText2D::Instance );
+	const UINT64 label_size = label_instances.size() * sizeof( RenderableQuad2D::Instance );
+	return ( label_size + ALIGNMENT - 1 ) / ALIGNMENT * ALIGNMENT;
+}
+
 bool noxcain::OverlayTask::build_text_pipeline()
 {
 	ResultHandler<vk::Result> r_handler( vk::Result::eSuccess );
-	const vk::Extent2D& extent = GraphicEngine::get_window_resolution();
 
-	auto special = createSpecialization( FLOAT32( 2.0F / extent.width ), FLOAT32( -2.0F / extent.height ), UINT32( ResourceEngine::get_engine().get_resource_limits().glyph_count ) );
+	auto special = createSpecialization( GlyphAtlas::TEXEL_PER_EM, GlyphAtlas::DISTANCE_RANGE, vk::Bool32( ResourceEngine::get_engine().are_glyphs_quantized() ) );
 	vk::SpecializationInfo specializationInfo( special.descriptions.size(), special.descriptions.data(), special.data.size(), special.data.data() );
 
 	std::array<vk::PipelineShaderStageCreateInfo, 2> shaderStages =
@@ -383,20 +449,8 @@ bool noxcain::OverlayTask::build_text_pipeline()
 	};
 
 
-	std::array<vk::Viewport, 1> viewports =
-	{
-		vk::Viewport( 0.0F, 0.0F, static_cast<float>( extent.width ), static_cast<float>( extent.height ), 0.0F, 1.0F )
-	};
-
-	std::array<vk::Rect2D, viewports.size()> scissors =
-	{
-		vk::Rect2D( vk::Offset2D( 0, 0 ), extent )
-	};
-
-	vk::PipelineViewportStateCreateInfo viewportSate(
-		vk::PipelineViewportStateCreateFlags(),
-		viewports.size(), viewports.data(),
-		scissors.size(), scissors.data() );
+	// viewport and scissor are set while recording
+	vk::PipelineViewportStateCreateInfo viewportSate( vk::PipelineViewportStateCreateFlags(), 1, nullptr, 1, nullptr );
 
 	vk::PipelineRasterizationStateCreateInfo rasterizationState(
 		vk::PipelineRasterizationStateCreateFlags(),
@@ -421,12 +475,16 @@ bool noxcain::OverlayTask::build_text_pipeline()
 
 	std::array<vk::VertexInputBindingDescription, 1> inputBindings =
 	{
-		vk::VertexInputBindingDescription( 0, 2 * sizeof( FLOAT32 ), vk::VertexInputRate::eVertex )
+		vk::VertexInputBindingDescription( 0, sizeof( VectorText2D::Instance ), vk::VertexInputRate::eInstance )
 	};
 
-	std::array<vk::VertexInputAttributeDescription, 1> inputAttributeDescription =
+	std::array<vk::VertexInputAttributeDescription, 5> inputAttributeDescription =
 	{
-		vk::VertexInputAttributeDescription( 0, 0, vk::Format::eR32G32Sfloat, 0 )
+		vk::VertexInputAttributeDescription( 0, 0, vk::Format::eR32G32B32A32Sfloat, offsetof( VectorText2D::Instance, box ) ),
+		vk::VertexInputAttributeDescription( 1, 0, vk::Format::eR32G32B32Sfloat, offsetof( VectorText2D::Instance, x ) ),
+		vk::VertexInputAttributeDescription( 2, 0, vk::Format::eR32Uint, offsetof( VectorText2D::Instance, glyph_id ) ),
+		vk::VertexInputAttributeDescription( 3, 0, vk::Format::eR32G32B32A32Sfloat, offsetof( VectorText2D::Instance, color ) ),
+		vk::VertexInputAttributeDescription( 4, 0, vk::Format::eR32G32B32A32Sfloat, offsetof( VectorText2D::Instance, clip ) )
 	};
 
 	vk::PipelineVertexInputStateCreateInfo vertexState(
@@ -434,12 +492,6 @@ bool noxcain::OverlayTask::build_text_pipeline()
 
 	vk::PipelineInputAssemblyStateCreateInfo assemblyState( vk::PipelineInputAssemblyStateCreateFlags(), vk::PrimitiveTopology::eTriangleStrip, VK_FALSE );
 
-	std::array<vk::DynamicState, 1> dynamicStates =
-	{
-		vk::DynamicState::eScissor
-	};
-	vk::PipelineDynamicStateCreateInfo dynamicStateInfo( vk::PipelineDynamicStateCreateFlags(), dynamicStates.size(), dynamicStates.data() );
-
 	const vk::Device& device = GraphicEngine::get_device();
 	if( !device )
 	{
@@ -447,20 +499,11 @@ bool noxcain::OverlayTask::build_text_pipeline()
 		return false;
 	}
 
-	if( text_pipeline )
-	{
-		r_handler << device.waitIdle();
-		if( r_handler.all_okay() )
-		{
-			device.destroyPipeline( text_pipeline );
-		}
-		else
-		{
-			return false;
-		}
-	}
+	// frames in flight may still use the old pipelines
+	GraphicEngine::get_release_queue().retire( text_pipeline );
+	GraphicEngine::get_release_queue().retire( atlas_text_pipeline );
 
-	text_pipeline = r_handler << device.createGraphicsPipeline( vk::PipelineCache(), vk::GraphicsPipelineCreateInfo(
+	vk::GraphicsPipelineCreateInfo pipeline_info(
 		vk::PipelineCreateFlags(),
 		shaderStages.size(), shaderStages.data(),
 		&vertexState,
@@ -471,9 +514,15 @@ bool noxcain::OverlayTask::build_text_pipeline()
 		&multisampleState,
 		&depthStencilState,
 		&colorBlendState,
-		&dynamicStateInfo,
+		get_viewport_dynamic_state(),
 		text_pipeline_layout,
-		render_pass, subpass_index + 1, vk::Pipeline(), -1 ) );
+		render_pass, subpass_index + 1, vk::Pipeline(), -1 );
+
+	text_pipeline = r_handler << GraphicEngine::get_pipeline_cache().create_graphics_pipeline( pipeline_info );
+
+	// same state, only the fragment shader samples the glyph atlas
+	shaderStages[1].setModule( GraphicEngine::get_shader( FragmentShaderIds::GLYPH_ATLAS_2D ) );
+	atlas_text_pipeline = r_handler << GraphicEngine::get_pipeline_cache().create_graphics_pipeline( pipeline_info );
 
 	return r_handler.all_okay();
 }
@@ -481,20 +530,13 @@ bool noxcain::OverlayTask::build_text_pipeline()
 noxcain::OverlayTask::~OverlayTask()
 {
 	shutdown_task();
-	vk::Device device = GraphicEngine::get_device();
-	if( device )
-	{
-		ResultHandler r_handler( vk::Result::eSuccess );
-		r_handler << device.waitIdle();
-		if( r_handler.all_okay() )
-		{
-			device.destroyPipeline( post_pipeline );
-			device.destroyPipeline( label_pipeline );
-			device.destroyPipeline( text_pipeline );
-			
-			device.destroyPipelineLayout( post_pipeline_layout );
-			device.destroyPipelineLayout( label_pipeline_layout );
-			device.destroyPipelineLayout( text_pipeline_layout );
-		}
-	}
+	ReleaseQueue& release_queue = GraphicEngine::get_release_queue();
+	release_queue.retire( post_pipeline );
+	release_queue.retire( label_pipeline );
+	release_queue.retire( text_pipeline );
+	release_queue.retire( atlas_text_pipeline );
+
+	release_queue.retire( post_pipeline_layout );
+	release_queue.retire( label_pipeline_layout );
+	release_queue.retire( text_pipeline_layout );
 }
\ No newline at end of file
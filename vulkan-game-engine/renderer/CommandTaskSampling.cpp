@@ -2,34 +2,31 @@
 
 #include <renderer/DescriptorSetManager.hpp>
 #include <renderer/GameGraphicEngine.hpp>
+#include <renderer/PipelineCache.hpp>
+#include <renderer/ReleaseQueue.hpp>
 #include <renderer/RenderQuery.hpp>
 
 #include <logic/GameLogicEngine.hpp>
 #include <tools/ResultHandler.hpp>
 
-noxcain::SamplingTask::SamplingTask()
+noxcain::SamplingTask::SamplingTask() : SubpassTask( "Shading" ),
+	gpu_zone( GraphicEngine::get_render_query().register_zone( "shading", 0.8, 0.0, 0.8 ) )
 {
 }
 
 noxcain::SamplingTask::~SamplingTask()
 {
 	shutdown_task();
-	vk::Device device = GraphicEngine::get_device();
-	if( device )
-	{
-		ResultHandler r_handler( vk::Result::eSuccess );
-		r_handler << device.waitIdle();
-		if( r_handler.all_okay() )
-		{
-			device.destroyPipeline( sampled_pipeline );
-			device.destroyPipeline( unsampled_pipeline );
-			device.destroyPipelineLayout( sampling_pipeline_layout );
-
-			unsampled_pipeline = vk::Pipeline();
-			sampled_pipeline = vk::Pipeline();
-			sampling_pipeline_layout = vk::PipelineLayout();
-		}
-	}
+	ReleaseQueue& release_queue = GraphicEngine::get_release_queue();
+	release_queue.retire( edge_detection_pipeline );
+	release_queue.retire( sampled_pipeline );
+	release_queue.retire( unsampled_pipeline );
+	release_queue.retire( sampling_pipeline_layout );
+
+	edge_detection_pipeline = vk::Pipeline();
+	unsampled_pipeline = vk::Pipeline();
+	sampled_pipeline = vk::Pipeline();
+	sampling_pipeline_layout = vk::PipelineLayout();
 }
 
 bool noxcain::SamplingTask::buffer_independent_preparation()
@@ -39,12 +36,12 @@ bool noxcain::SamplingTask::buffer_independent_preparation()
 		if( !setup_layouts() ) return false;
 	}
 
-	auto resolution = LogicEngine::get_graphic_settings().get_accumulated_resolution();
-	vk::Extent2D current_extent( resolution.width, resolution.height );
-	if( is_new_render_pass || old_extent != current_extent )
+	// resolution changes keep the pipelines, only the sample count is baked into them
+	const UINT32 sample_count = LogicEngine::get_graphic_settings().get_sample_count();
+	if( is_new_render_pass || old_sample_count != sample_count )
 	{
 		if( !build_shading_pipelines() || !build_edge_detection_pipeline() ) return false;
-		old_extent = current_extent;
+		old_sample_count = sample_count;
 		is_new_render_pass = false;
 	};
 
@@ -57,34 +54,65 @@ bool noxcain::SamplingTask::buffer_dependent_preparation( CommandData& pool_data
 	return buffer_preparation( pool_data, 2 );
 }
 
+bool noxcain::SamplingTask::prepare_recording( RecordKey& record_key )
+{
+	// full screen passes, only settings and camera changes need new commands
+	const auto graphic_settings = LogicEngine::get_graphic_settings();
+	add_to_record_key( record_key, graphic_settings.get_sample_count() );
+	add_to_record_key( record_key, graphic_settings.get_accumulated_resolution() );
+	add_to_record_key( record_key, edge_detection_pipeline );
+	add_to_record_key( record_key, sampled_pipeline );
+	add_to_record_key( record_key, unsampled_pipeline );
+	add_to_record_key( record_key, GraphicEngine::get_descriptor_set_manager().get_basic_set( BasicDescriptorSets::SHADING_INPUT_ATTACHMENTS ) );
+
+	// the camera is pushed into the buffer
+	clip_to_world = LogicEngine::get_camera_matrix().inverse();
+	add_to_record_key( record_key, clip_to_world );
+	return true;
+}
+
 bool noxcain::SamplingTask::record( const std::vector<vk::CommandBuffer>& buffers )
 {
 	bool multi_sampling = LogicEngine::get_graphic_settings().get_sample_count() > 1;
-	TimeFrame frame( time_col, 0.4F, 0.0F, 0.6F, 1.0F, "record" );
+	const auto resolution = LogicEngine::get_graphic_settings().get_accumulated_resolution();
+	const vk::Extent2D extent( resolution.width, resolution.height );
+	static const TimeFrameZone frame_zone( "record", 0.4F, 0.0F, 0.6F, 1.0F );
+	TimeFrame frame( time_col, frame_zone );
 	ResultHandler r_handler( vk::Result::eSuccess );
 	vk::CommandBufferInheritanceInfo inheritage( render_pass, subpass_index, frame_buffers.empty() ? vk::Framebuffer() : frame_buffers.front() );
+	const RenderQuery& render_query = GraphicEngine::get_render_query();
 	
 	//EDGE DETECTION
 	if( multi_sampling )
 	{
-		const auto edge_detection_buffer = buffers.front();
-		r_handler << edge_detection_buffer.begin( vk::CommandBufferBeginInfo( vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue, &inheritage ) );
+		CountingCommandBuffer edge_detection_buffer = get_counting_buffer( 0 );
+		r_handler << edge_detection_buffer.begin( vk::CommandBufferBeginInfo( vk::CommandBufferUsageFlagBits::eRenderPassContinue, &inheritage ) );
+		render_query.begin_zone( edge_detection_buffer.get_buffer(), buffer_id, gpu_zone );
 		edge_detection_buffer.bindPipeline( vk::PipelineBindPoint::eGraphics, edge_detection_pipeline );
+		set_viewport( edge_detection_buffer, extent );
 		edge_detection_buffer.bindDescriptorSets( vk::PipelineBindPoint::eGraphics, sampling_pipeline_layout, 0, { GraphicEngine::get_descriptor_set_manager().get_basic_set( BasicDescriptorSets::SHADING_INPUT_ATTACHMENTS ) }, {} );
 		edge_detection_buffer.draw( 3, 1, 0, 0 );
 		r_handler << edge_detection_buffer.end();
 	}
 
 	//SHADING
-	const auto shading_buffer = buffers.back();
+	CountingCommandBuffer shading_buffer = get_counting_buffer( buffers.size() - 1 );
 	if( multi_sampling )
 	{
 		inheritage.setSubpass( inheritage.subpass + 1 );
 	}
-	r_handler << shading_buffer.begin( vk::CommandBufferBeginInfo( vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue, &inheritage ) );
+	r_handler << shading_buffer.begin( vk::CommandBufferBeginInfo( vk::CommandBufferUsageFlagBits::eRenderPassContinue, &inheritage ) );
+	if( !multi_sampling )
+	{
+		render_query.begin_zone( shading_buffer.get_buffer(), buffer_id, gpu_zone );
+	}
 	
 	shading_buffer.bindDescriptorSets( vk::PipelineBindPoint::eGraphics, sampling_pipeline_layout, 0, { GraphicEngine::get_descriptor_set_manager().get_basic_set( BasicDescriptorSets::SHADING_INPUT_ATTACHMENTS ) }, {} );
 	shading_buffer.bindPipeline( vk::PipelineBindPoint::eGraphics, unsampled_pipeline );
+	set_viewport( shading_buffer, extent );
+
+	const auto clip_to_world_data = clip_to_world.gpuData();
+	shading_buffer.pushConstants( sampling_pipeline_layout, vk::ShaderStageFlagBits::eFragment, 0, UINT32( clip_to_world_data.size() ), clip_to_world_data.data() );
 	shading_buffer.draw( 3, 1, 0, 0 );
 	
 	if( multi_sampling )
@@ -93,11 +121,7 @@ bool noxcain::SamplingTask::record( const std::vector<vk::CommandBuffer>& buffer
 		shading_buffer.draw( 3, 1, 0, 0 );
 	}
 	
-	vk::QueryPool timestamp_pool = GraphicEngine::get_render_query().get_timestamp_pool();
-	if( timestamp_pool )
-	{
-		shading_buffer.writeTimestamp( vk::PipelineStageFlagBits::eBottomOfPipe, timestamp_pool, (UINT32)RenderQuery::TimeStampIds::AFTER_SHADING );
-	}
+	render_query.end_zone( shading_buffer.get_buffer(), buffer_id, gpu_zone );
 
 	r_handler << shading_buffer.end();
 
@@ -115,7 +139,12 @@ bool noxcain::SamplingTask::setup_layouts()
 			GraphicEngine::get_descriptor_set_manager().get_layout( DescriptorSetLayouts::INPUT_ATTACHMENT_3 )
 		};
 
-		sampling_pipeline_layout = r_handler << device.createPipelineLayout( vk::PipelineLayoutCreateInfo( vk::PipelineLayoutCreateFlags(), descriptor_sets.size(), descriptor_sets.data(), 0, nullptr ) );
+		std::array<vk::PushConstantRange, 1> push_constants =
+		{
+			vk::PushConstantRange( vk::ShaderStageFlagBits::eFragment, 0, UINT32( NxMatrix4x4().gpuSize() ) )
+		};
+
+		sampling_pipeline_layout = r_handler << device.createPipelineLayout( vk::PipelineLayoutCreateInfo( vk::PipelineLayoutCreateFlags(), descriptor_sets.size(), descriptor_sets.data(), push_constants.size(), push_constants.data() ) );
 
 		return r_handler.all_okay();
 	}
@@ -130,8 +159,6 @@ inline bool noxcain::SamplingTask::build_edge_detection_pipeline()
 		auto specialization = createSpecialization( g_settings.get_sample_count() );
 		vk::SpecializationInfo specialization_info( specialization.descriptions.size(), specialization.descriptions.data(), specialization.data.size(), specialization.data.data() );
 
-		auto resolution = LogicEngine::get_graphic_settings().get_accumulated_resolution();
-
 		//SHADER STAGES
 		std::array<vk::PipelineShaderStageCreateInfo, 2> shader_stages =
 		{
@@ -139,21 +166,8 @@ inline bool noxcain::SamplingTask::build_edge_detection_pipeline()
 			vk::PipelineShaderStageCreateInfo( vk::PipelineShaderStageCreateFlags(), vk::ShaderStageFlagBits::eFragment, GraphicEngine::get_shader( FragmentShaderIds::EDGE_DETECTION ), "main", &specialization_info )
 		};
 
-		//VIEWPORTS AND SCISSORS
-		std::array<vk::Viewport, 1> viewports =
-		{
-			vk::Viewport( 0.0F, 0.0F, float( resolution.width ), float( resolution.height ), 0.0F, 1.0F )
-		};
-
-		std::array<vk::Rect2D, viewports.size()> scissors =
-		{
-			vk::Rect2D( vk::Offset2D( 0, 0 ), vk::Extent2D( resolution.width, resolution.height ) )
-		};
-
-		vk::PipelineViewportStateCreateInfo viewport_sate(
-			vk::PipelineViewportStateCreateFlags(),
-			viewports.size(), viewports.data(),
-			scissors.size(), scissors.data() );
+		//VIEWPORTS AND SCISSORS, set while recording
+		vk::PipelineViewportStateCreateInfo viewport_sate( vk::PipelineViewportStateCreateFlags(), 1, nullptr, 1, nullptr );
 
 		//RASTERIZATION
 		vk::PipelineRasterizationStateCreateInfo rasterization_state(
@@ -191,20 +205,11 @@ inline bool noxcain::SamplingTask::build_edge_detection_pipeline()
 			return false;
 		}
 
-		if( edge_detection_pipeline )
-		{
-			r_handler << device.waitIdle();
-			if( r_handler.all_okay() )
-			{
-				device.destroyPipeline( edge_detection_pipeline );
-			}
-			else
-			{
-				return false;
-			}
-		}
+		// frames in flight may still use the old pipeline
+		GraphicEngine::get_release_queue().retire( edge_detection_pipeline );
+		edge_detection_pipeline = vk::Pipeline();
 
-		edge_detection_pipeline = r_handler << device.createGraphicsPipeline( vk::PipelineCache(), vk::GraphicsPipelineCreateInfo(
+		edge_detection_pipeline = r_handler << GraphicEngine::get_pipeline_cache().create_graphics_pipeline( vk::GraphicsPipelineCreateInfo(
 			vk::PipelineCreateFlags(),
 			shader_stages.size(), shader_stages.data(),
 			&vertex_state,
@@ -215,7 +220,7 @@ inline bool noxcain::SamplingTask::build_edge_detection_pipeline()
 			&multisample_state,
 			&depth_stencil_state,
 			&color_blend_state,
-			nullptr,
+			get_viewport_dynamic_state(),
 			sampling_pipeline_layout,
 			render_pass, subpass_index, vk::Pipeline(), -1 ) );
 		return r_handler.all_okay();
@@ -244,22 +249,8 @@ inline bool noxcain::SamplingTask::build_shading_pipelines()
 		vk::PipelineShaderStageCreateInfo( vk::PipelineShaderStageCreateFlags(), vk::ShaderStageFlagBits::eFragment, GraphicEngine::get_shader( FragmentShaderIds::SINGLE_SHADING ), "main", nullptr )
 	};
 
-	//VIEWPORTS AND SCISSORS
-	const auto resolution = g_settings.get_accumulated_resolution();
-	std::array<vk::Viewport, 1> viewports =
-	{
-		vk::Viewport( 0.0F, 0.0F, float( resolution.width ), float( resolution.height ), 0.0F, 1.0F )
-	};
-
-	std::array<vk::Rect2D, viewports.size()> scissors =
-	{
-		vk::Rect2D( vk::Offset2D( 0, 0 ), vk::Extent2D( resolution.width, resolution.height ) )
-	};
-
-	vk::PipelineViewportStateCreateInfo viewport_sate(
-		vk::PipelineViewportStateCreateFlags(),
-		viewports.size(), viewports.data(),
-		scissors.size(), scissors.data() );
+	//VIEWPORTS AND SCISSORS, set while recording
+	vk::PipelineViewportStateCreateInfo viewport_sate( vk::PipelineViewportStateCreateFlags(), 1, nullptr, 1, nullptr );
 
 	//RASTERIZATION
 	vk::PipelineRasterizationStateCreateInfo rasterization_state(
@@ -308,25 +299,15 @@ inline bool noxcain::SamplingTask::build_shading_pipelines()
 		return false;
 	}
 
-	if( sampled_pipeline || unsampled_pipeline )
-	{
-		r_handler << device.waitIdle();
-		if( r_handler.all_okay() )
-		{
-			device.destroyPipeline( sampled_pipeline );
-			device.destroyPipeline( unsampled_pipeline );
-			unsampled_pipeline = vk::Pipeline();
-			sampled_pipeline = vk::Pipeline();
-		}
-		else
-		{
-			return false;
-		}
-	}
+	// frames in flight may still use the old pipelines
+	GraphicEngine::get_release_queue().retire( sampled_pipeline );
+	GraphicEngine::get_release_queue().retire( unsampled_pipeline );
+	unsampled_pipeline = vk::Pipeline();
+	sampled_pipeline = vk::Pipeline();
 
 	if( multi_sampling )
 	{
-		sampled_pipeline = r_handler << device.createGraphicsPipeline( vk::PipelineCache(), vk::GraphicsPipelineCreateInfo(
+		sampled_pipeline = r_handler << GraphicEngine::get_pipeline_cache().create_graphics_pipeline( vk::GraphicsPipelineCreateInfo(
 			vk::PipelineCreateFlags(),
 			multisample_shader_stages.size(), multisample_shader_stages.data(),
 			&vertex_state,
@@ -337,12 +318,12 @@ inline bool noxcain::SamplingTask::build_shading_pipelines()
 			&multisample_state,
 			&multisample_depth_stencil_state,
 			&color_blend_state,
-			nullptr,
+			get_viewport_dynamic_state(),
 			sampling_pipeline_layout,
 			render_pass, subpass_index + 1, vk::Pipeline(), -1 ) );
 	}
 
-	unsampled_pipeline = r_handler << device.createGraphicsPipeline( vk::PipelineCache(), vk::GraphicsPipelineCreateInfo(
+	unsampled_pipeline = r_handler << GraphicEngine::get_pipeline_cache().create_graphics_pipeline( vk::GraphicsPipelineCreateInfo(
 		vk::PipelineCreateFlags(),
 		singlesample_shader_stages.size(), singlesample_shader_stages.data(),
 		&vertex_state,
@@ -353,7 +334,7 @@ inline bool noxcain::SamplingTask::build_shading_pipelines()
 		&multisample_state,
 		&singlesample_depth_stencil_state,
 		&color_blend_state,
-		nullptr,
+		get_viewport_dynamic_state(),
 		sampling_pipeline_layout,
 		render_pass, subpass_index + ( multi_sampling ? 1 : 0 ), vk::Pipeline(), -1 ) );
 
@@ -3,35 +3,34 @@
 #include <renderer/DescriptorSetManager.hpp>
 #include <renderer/GameGraphicEngine.hpp>
 #include <renderer/MemoryManagement.hpp>
+#include <renderer/PipelineCache.hpp>
+#include <renderer/ReleaseQueue.hpp>
 #include <renderer/RenderQuery.hpp>
 
 #include <logic/GameLogicEngine.hpp>
 #include <logic/Level.hpp>
 #include <logic/VectorText3D.hpp>
 
+#include <math/Matrix.hpp>
+
 #include <resources/GameResourceEngine.hpp>
 #include <resources/FontResource.hpp>
 
 #include <tools/ResultHandler.hpp>
 
-noxcain::VectorDecalTask::VectorDecalTask()
+#include <cstring>
+
+noxcain::VectorDecalTask::VectorDecalTask() : SubpassTask( "Vector" ),
+	gpu_zone( GraphicEngine::get_render_query().register_zone( "vector", 0.8, 0.0, 0.0 ) )
 {
 }
 
 noxcain::VectorDecalTask::~VectorDecalTask()
 {
 	shutdown_task();
-	vk::Device device = GraphicEngine::get_device();
-	if( device )
-	{
-		ResultHandler r_handler( vk::Result::eSuccess );
-		r_handler << device.waitIdle();
-		if( r_handler.all_okay() )
-		{
-			device.destroyPipeline( vector_decal_pipeline );
-			device.destroyPipelineLayout( vector_decal_pipeline_layout );
-		}
-	}
+	ReleaseQueue& release_queue = GraphicEngine::get_release_queue();
+	release_queue.retire( vector_decal_pipeline );
+	release_queue.retire( vector_decal_pipeline_layout );
 }
 
 bool noxcain::VectorDecalTask::buffer_independent_preparation()
@@ -41,12 +40,12 @@ bool noxcain::VectorDecalTask::buffer_independent_preparation()
 		if( !setup_layout() ) return false;
 	}
 
-	auto resolution = LogicEngine::get_graphic_settings().get_accumulated_resolution();
-	vk::Extent2D current_extent = vk::Extent2D( resolution.width, resolution.height );
-	if( is_new_render_pass || old_extent != current_extent )
+	// resolution changes keep the pipeline, only the sample count is baked into it
+	const UINT32 sample_count = LogicEngine::get_graphic_settings().get_sample_count();
+	if( is_new_render_pass || old_sample_count != sample_count )
 	{
 		if( !build_vector_decal_pipeline() ) return false;
-		old_extent = current_extent;
+		old_sample_count = sample_count;
 		is_new_render_pass = false;
 	};
 
@@ -59,48 +58,97 @@ bool noxcain::VectorDecalTask::buffer_dependent_preparation( CommandData& pool_d
 	return buffer_preparation( pool_data, 1 );
 }
 
+bool noxcain::VectorDecalTask::prepare_recording( RecordKey& record_key )
+{
+	static const TimeFrameZone frame_zone( "gather", 0.5F, 0.0F, 0.5F, 1.0F );
+	TimeFrame frame( time_col, frame_zone );
+	if( !gather_instances() )
+	{
+		return false;
+	}
+
+	// instance data is written every frame, the commands only depend on the groups
+	add_to_record_key( record_key, vector_decal_pipeline );
+	add_to_record_key( record_key, LogicEngine::get_graphic_settings().get_accumulated_resolution() );
+	add_to_record_key( record_key, GraphicEngine::get_descriptor_set_manager().get_basic_set( BasicDescriptorSets::GLYPHS ) );
+	add_to_record_key( record_key, instance_buffers[buffer_id].get_buffer() );
+	for( const DrawGroup& group : draw_groups )
+	{
+		add_to_record_key( record_key, group.first_instance );
+		add_to_record_key( record_key, group.instance_count );
+	}
+	return true;
+}
+
 bool noxcain::VectorDecalTask::record( const std::vector<vk::CommandBuffer>& buffers )
 {
-	TimeFrame frame( time_col, 0.4F, 0.0F, 0.6F, 1.0F, "record" );
+	static const TimeFrameZone frame_zone( "record", 0.4F, 0.0F, 0.6F, 1.0F );
+	TimeFrame frame( time_col, frame_zone );
 	ResultHandler r_handler( vk::Result::eSuccess );
 
-	const auto& resources = ResourceEngine::get_engine();
-
-	const auto c_buffer = buffers.front();
-	const auto& decal_list = LogicEngine::get_vector_decals();
+	CountingCommandBuffer c_buffer = get_counting_buffer( 0 );
 
 	const vk::CommandBufferInheritanceInfo inharitage( render_pass, subpass_index, frame_buffers.empty() ? vk::Framebuffer() : frame_buffers.front() );
-	r_handler << c_buffer.begin( vk::CommandBufferBeginInfo( vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eOneTimeSubmit, &inharitage ) );
+	r_handler << c_buffer.begin( vk::CommandBufferBeginInfo( vk::CommandBufferUsageFlagBits::eRenderPassContinue, &inharitage ) );
 
-	if( !decal_list.empty() )
 	{
-		const auto& vertex_block_info = GraphicEngine::get_memory_manager().get_block( ResourceEngine::get_engine().get_font( 0 ).get_vertex_block_id() );
-		c_buffer.bindPipeline( vk::PipelineBindPoint::eGraphics, vector_decal_pipeline );
-		c_buffer.bindDescriptorSets( vk::PipelineBindPoint::eGraphics, vector_decal_pipeline_layout, 0, { GraphicEngine::get_descriptor_set_manager().get_basic_set( BasicDescriptorSets::GLYPHS ) }, {} );
-		c_buffer.bindVertexBuffers( 0, { vertex_block_info.buffer }, { vertex_block_info.offset } );
-
-		std::size_t current_font_id = ResourceEngine::get_engine().get_invalid_font_id();
-		for( const Renderable<VectorText3D>::List& decals : decal_list )
+		GpuZone zone( c_buffer.get_buffer(), buffer_id, gpu_zone );
+		if( !draw_groups.empty() )
 		{
-			for( const VectorText3D& decal_string : decals )
+			const auto resolution = LogicEngine::get_graphic_settings().get_accumulated_resolution();
+			const std::array<FLOAT32, 2> em_per_pixel = { 2.0F / resolution.width, 2.0F / resolution.height };
+
+			c_buffer.bindPipeline( vk::PipelineBindPoint::eGraphics, vector_decal_pipeline );
+			set_viewport( c_buffer, vk::Extent2D( resolution.width, resolution.height ) );
+			c_buffer.pushConstants( vector_decal_pipeline_layout, vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, 0, UINT32( sizeof( em_per_pixel ) ), em_per_pixel.data() );
+			c_buffer.bindDescriptorSets( vk::PipelineBindPoint::eGraphics, vector_decal_pipeline_layout, 0, { GraphicEngine::get_descriptor_set_manager().get_basic_set( BasicDescriptorSets::GLYPHS ) }, {} );
+			c_buffer.bindVertexBuffers( 0, { instance_buffers[buffer_id].get_buffer() }, { 0 } );
+
+			for( const DrawGroup& group : draw_groups )
 			{
-				decal_string.record( c_buffer, vector_decal_pipeline_layout, LogicEngine::get_camera_matrix() );
+				c_buffer.draw( 4, group.instance_count, 0, group.first_instance );
 			}
 		}
 	}
 
-	vk::QueryPool timestamp_pool = GraphicEngine::get_render_query().get_timestamp_pool();
-	if( timestamp_pool )
-	{
-		c_buffer.writeTimestamp( vk::PipelineStageFlagBits::eBottomOfPipe, timestamp_pool, (UINT32)RenderQuery::TimeStampIds::AFTER_GLYPHS );
-	}
-
 	r_handler << c_buffer.end();
 
 	
 	return r_handler.all_okay();
 }
 
+bool noxcain::VectorDecalTask::gather_instances()
+{
+	instances.clear();
+	draw_groups.clear();
+
+	const NxMatrix4x4 camera = LogicEngine::get_camera_matrix();
+	for( const Renderable<VectorText3D>::List& decals : LogicEngine::get_vector_decals() )
+	{
+		for( const VectorText3D& decal_string : decals )
+		{
+			decal_string.write_instances( instances, camera );
+		}
+	}
+
+	if( instances.empty() )
+	{
+		return true;
+	}
+
+	// all fonts share the glyph buffers, every decal glyph is drawn by one call
+	draw_groups.push_back( { 0, UINT32( instances.size() ) } );
+
+	// one buffer per ring slot, the slot of buffer_id is not in use by the gpu while recording
+	HostBuffer& instance_buffer = instance_buffers[buffer_id];
+	if( !instance_buffer.reserve( instances.size() * sizeof( VectorText3D::Instance ), vk::BufferUsageFlagBits::eVertexBuffer ) )
+	{
+		return false;
+	}
+	std::memcpy( instance_buffer.get_memory(), instances.data(), instances.size() * sizeof( VectorText3D::Instance ) );
+	return true;
+}
+
 bool noxcain::VectorDecalTask::setup_layout()
 {
 	ResultHandler r_handler( vk::Result::eSuccess );
@@ -114,13 +162,13 @@ bool noxcain::VectorDecalTask::setup_layout()
 			GraphicEngine::get_descriptor_set_manager().get_layout( DescriptorSetLayouts::GLYPH )
 		};
 
-		std::array<vk::PushConstantRange, 2> decal_push_constants =
+		// size of a pixel in clip space, changes with the resolution
+		std::array<vk::PushConstantRange, 1> push_constants =
 		{
-			vk::PushConstantRange( vk::ShaderStageFlagBits::eFragment, 0, 32 ),
-			vk::PushConstantRange( vk::ShaderStageFlagBits::eVertex, 32, 64 )
+			vk::PushConstantRange( vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment, 0, 2 * sizeof( FLOAT32 ) )
 		};
 
-		vector_decal_pipeline_layout = r_handler << device.createPipelineLayout( vk::PipelineLayoutCreateInfo( vk::PipelineLayoutCreateFlags(), decal_descriptor_sets.size(), decal_descriptor_sets.data(), decal_push_constants.size(), decal_push_constants.data() ) );
+		vector_decal_pipeline_layout = r_handler << device.createPipelineLayout( vk::PipelineLayoutCreateInfo( vk::PipelineLayoutCreateFlags(), decal_descriptor_sets.size(), decal_descriptor_sets.data(), push_constants.size(), push_constants.data() ) );
 		return r_handler.all_okay();
 	}
 	return false;
@@ -129,9 +177,8 @@ bool noxcain::VectorDecalTask::setup_layout()
 inline bool noxcain::VectorDecalTask::build_vector_decal_pipeline()
 {
 	const auto g_settings = LogicEngine::get_graphic_settings();
-	const auto resolution = g_settings.get_accumulated_resolution();
 
-	auto special = createSpecialization( FLOAT32( 2.0F / resolution.width ), FLOAT32( 2.0F / resolution.height ), UINT32( ResourceEngine::get_engine().get_resource_limits().glyph_count ) );
+	auto special = createSpecialization( vk::Bool32( ResourceEngine::get_engine().are_glyphs_quantized() ) );
 	vk::SpecializationInfo specializationInfo( special.descriptions.size(), special.descriptions.data(), special.data.size(), special.data.data() );
 
 	std::array<vk::PipelineShaderStageCreateInfo, 2> shaderStages =
@@ -141,20 +188,8 @@ inline bool noxcain::VectorDecalTask::build_vector_decal_pipeline()
 	};
 
 
-	std::array<vk::Viewport, 1> viewports =
-	{
-		vk::Viewport( 0.0F, 0.0F, FLOAT32( resolution.width ), FLOAT32( resolution.height ), 0.0F, 1.0F )
-	};
-
-	std::array<vk::Rect2D, viewports.size()> scissors =
-	{
-		vk::Rect2D( vk::Offset2D( 0, 0 ), vk::Extent2D( resolution.width, resolution.height ) )
-	};
-
-	vk::PipelineViewportStateCreateInfo viewport_state(
-		vk::PipelineViewportStateCreateFlags(),
-		viewports.size(), viewports.data(),
-		scissors.size(), scissors.data() );
+	// viewport and scissor are set while recording
+	vk::PipelineViewportStateCreateInfo viewport_state( vk::PipelineViewportStateCreateFlags(), 1, nullptr, 1, nullptr );
 
 	vk::PipelineRasterizationStateCreateInfo rasterization_state(
 		vk::PipelineRasterizationStateCreateFlags(),
@@ -168,16 +203,14 @@ inline bool noxcain::VectorDecalTask::build_vector_decal_pipeline()
 		vk::PipelineDepthStencilStateCreateFlags(), VK_TRUE, VK_FALSE, vk::CompareOp::eLessOrEqual, VK_FALSE, VK_FALSE,
 		vk::StencilOpState(), vk::StencilOpState(), 0.0F, 0.0F );
 
-	std::array<vk::PipelineColorBlendAttachmentState, 3> color_blend_attachment_state =
+	// decals only tint the color, the surface normal below them is kept
+	std::array<vk::PipelineColorBlendAttachmentState, 2> color_blend_attachment_state =
 	{
 		vk::PipelineColorBlendAttachmentState( VK_TRUE, vk::BlendFactor::eSrcAlpha, vk::BlendFactor::eOneMinusSrcAlpha, vk::BlendOp::eAdd, vk::BlendFactor::eZero, vk::BlendFactor::eOne, vk::BlendOp::eAdd,
 		vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB ),
 
-		vk::PipelineColorBlendAttachmentState( VK_TRUE, vk::BlendFactor::eSrcAlpha, vk::BlendFactor::eOneMinusSrcAlpha, vk::BlendOp::eAdd, vk::BlendFactor::eZero, vk::BlendFactor::eOne, vk::BlendOp::eAdd,
-		vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB ),
-
-		vk::PipelineColorBlendAttachmentState( VK_TRUE, vk::BlendFactor::eSrcAlpha, vk::BlendFactor::eOneMinusSrcAlpha, vk::BlendOp::eAdd, vk::BlendFactor::eZero, vk::BlendFactor::eOne, vk::BlendOp::eAdd,
-		vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB ),
+		vk::PipelineColorBlendAttachmentState( VK_FALSE, vk::BlendFactor::eZero, vk::BlendFactor::eZero, vk::BlendOp::eAdd, vk::BlendFactor::eZero, vk::BlendFactor::eZero, vk::BlendOp::eAdd,
+		vk::ColorComponentFlags() ),
 	};
 
 	vk::PipelineColorBlendStateCreateInfo color_blend_state(
@@ -185,12 +218,20 @@ inline bool noxcain::VectorDecalTask::build_vector_decal_pipeline()
 
 	std::array<vk::VertexInputBindingDescription, 1> input_bindings =
 	{
-		vk::VertexInputBindingDescription( 0, 2 * sizeof( FLOAT32 ), vk::VertexInputRate::eVertex )
+		vk::VertexInputBindingDescription( 0, sizeof( VectorText3D::Instance ), vk::VertexInputRate::eInstance )
 	};
 
-	std::array<vk::VertexInputAttributeDescription, 1> input_attribute_description =
+	// the text matrix takes one location per column
+	std::array<vk::VertexInputAttributeDescription, 8> input_attribute_description =
 	{
-		vk::VertexInputAttributeDescription( 0, 0, vk::Format::eR32G32Sfloat, 0 )
+		vk::VertexInputAttributeDescription( 0, 0, vk::Format::eR32G32B32A32Sfloat, offsetof( VectorText3D::Instance, matrix ) ),
+		vk::VertexInputAttributeDescription( 1, 0, vk::Format::eR32G32B32A32Sfloat, offsetof( VectorText3D::Instance, matrix ) + 4 * sizeof( FLOAT32 ) ),
+		vk::VertexInputAttributeDescription( 2, 0, vk::Format::eR32G32B32A32Sfloat, offsetof( VectorText3D::Instance, matrix ) + 8 * sizeof( FLOAT32 ) ),
+		vk::VertexInputAttributeDescription( 3, 0, vk::Format::eR32G32B32A32Sfloat, offsetof( VectorText3D::Instance, matrix ) + 12 * sizeof( FLOAT32 ) ),
+		vk::VertexInputAttributeDescription( 4, 0, vk::Format::eR32G32B32A32Sfloat, offsetof( VectorText3D::Instance, box ) ),
+		vk::VertexInputAttributeDescription( 5, 0, vk::Format::eR32G32B32A32Sfloat, offsetof( VectorText3D::Instance, color ) ),
+		vk::VertexInputAttributeDescription( 6, 0, vk::Format::eR32G32Sfloat, offsetof( VectorText3D::Instance, offset ) ),
+		vk::VertexInputAttributeDescription( 7, 0, vk::Format::eR32Uint, offsetof( VectorText3D::Instance, glyph_id ) )
 	};
 
 	vk::PipelineVertexInputStateCreateInfo vertex_state(
@@ -206,20 +247,10 @@ inline bool noxcain::VectorDecalTask::build_vector_decal_pipeline()
 		return false;
 	}
 
-	if( vector_decal_pipeline )
-	{
-		r_handler << device.waitIdle();
-		if( r_handler.all_okay() )
-		{
-			device.destroyPipeline( vector_decal_pipeline );
-		}
-		else
-		{
-			return false;
-		}
-	}
+	// frames in flight may still use the old pipeline
+	GraphicEngine::get_release_queue().retire( vector_decal_pipeline );
 
-	vector_decal_pipeline = r_handler << device.createGraphicsPipeline( vk::PipelineCache(), vk::GraphicsPipelineCreateInfo(
+	vector_decal_pipeline = r_handler << GraphicEngine::get_pipeline_cache().create_graphics_pipeline( vk::GraphicsPipelineCreateInfo(
 		vk::PipelineCreateFlags(),
 		shaderStages.size(), shaderStages.data(),
 		&vertex_state,
@@ -230,6 +261,6 @@ inline bool noxcain::VectorDecalTask::build_vector_decal_pipeline()
 		&multisample_state,
 		&depth_stencil_state,
 		&color_blend_state,
-		nullptr, vector_decal_pipeline_layout, render_pass, subpass_index, vk::Pipeline(), -1 ) );
+		get_viewport_dynamic_state(), vector_decal_pipeline_layout, render_pass, subpass_index, vk::Pipeline(), -1 ) );
 	return r_handler.all_okay();
 }
@@ -2,12 +2,23 @@
 #include <Defines.hpp>
 
 #include <renderer/CommandSubpassTask.hpp>
+#include <renderer/HostBuffer.hpp>
+#include <logic/Quad2D.hpp>
+#include <logic/VectorText2D.hpp>
+#include <logic/VectorText3D.hpp>
+#include <math/Matrix.hpp>
 #include <tools/TimeFrame.hpp>
 
+#include <algorithm>
+#include <array>
+#include <thread>
+
 #include <vulkan/vulkan.hpp>
 
 namespace noxcain
 {
+	class GeometryObject;
+
 	struct SpecializationMeta
 	{
 		SpecializationMeta() = default;
@@ -34,8 +45,28 @@ namespace noxcain
 		( fill( specializationValues ), ... );
 		return meta;
 	};
-	
-	class VectorText2D;
+
+	// viewport and scissor are dynamic in all pipelines, a new resolution only needs new framebuffers
+	inline const vk::PipelineDynamicStateCreateInfo* get_viewport_dynamic_state()
+	{
+		static constexpr std::array<vk::DynamicState, 2> states = { vk::DynamicState::eViewport, vk::DynamicState::eScissor };
+		static const vk::PipelineDynamicStateCreateInfo info( vk::PipelineDynamicStateCreateFlags(), UINT32( states.size() ), states.data() );
+		return &info;
+	}
+
+	// has to be recorded into every secondary buffer, dynamic state is not inherited
+	inline void set_viewport( CountingCommandBuffer& buffer, const vk::Extent2D& extent )
+	{
+		buffer.setViewport( 0, { vk::Viewport( 0.0F, 0.0F, FLOAT32( extent.width ), FLOAT32( extent.height ), 0.0F, 1.0F ) } );
+		buffer.setScissor( 0, { vk::Rect2D( vk::Offset2D( 0, 0 ), extent ) } );
+	}
+
+	// one thread per core, the task thread records too
+	inline std::size_t get_record_thread_count()
+	{
+		return std::clamp<std::size_t>( std::thread::hardware_concurrency(), 1, MAX_RECORD_THREAD_COUNT );
+	}
+
 
 	class OverlayTask : public SubpassTask<OverlayTask>
 	{
@@ -45,16 +76,15 @@ namespace noxcain
 
 		bool buffer_independent_preparation();
 		bool buffer_dependent_preparation( CommandData& pool_data );
+		bool prepare_recording( RecordKey& record_key );
 		bool record( const std::vector<vk::CommandBuffer>& buffers );
 
 	private:
-		TimeFrameCollector time_col = TimeFrameCollector( "Overlay" );
 		bool setup_layouts();
 
-		vk::Extent2D old_extent;
-
 		vk::PipelineLayout post_pipeline_layout;
 		vk::Pipeline post_pipeline;
+		std::array<FLOAT32, 2> post_uv_scale = { 1.0F, 1.0F };
 		inline bool build_post_pipeline();
 
 		vk::PipelineLayout label_pipeline_layout;
@@ -63,7 +93,30 @@ namespace noxcain
 
 		vk::PipelineLayout text_pipeline_layout;
 		vk::Pipeline text_pipeline;
+		vk::Pipeline atlas_text_pipeline;
 		inline bool build_text_pipeline();
+
+		// instances of all quads and glyphs, one draw per group
+		struct DrawGroup
+		{
+			vk::Pipeline pipeline;
+			UINT32 first_instance = 0;
+			UINT32 instance_count = 0;
+		};
+		std::vector<RenderableQuad2D::Instance> label_instances;
+		std::vector<VectorText2D::Instance> glyph_instances;
+		std::vector<DrawGroup> draw_groups;
+		std::array<HostBuffer, RECORD_RING_SIZE> instance_buffers;
+
+		bool gather_instances();
+		UINT64 get_glyph_instance_offset() const;
+
+		// every framebuffer has its own pool, the framebuffers are recorded in parallel
+		RecordWorkers record_workers;
+		bool record_frame_buffer( const std::vector<vk::CommandBuffer>& buffers, std::size_t index );
+
+		const RenderQuery::ZoneId post_zone;
+		const RenderQuery::ZoneId overlay_zone;
 	};
 
 	class GeometryTask : public SubpassTask<GeometryTask>
@@ -74,16 +127,25 @@ namespace noxcain
 
 		bool buffer_independent_preparation();
 		bool buffer_dependent_preparation( CommandData& pool_data );
+		bool prepare_recording( RecordKey& record_key );
 		bool record( const std::vector<vk::CommandBuffer>& buffers );
 
 	private:
-		TimeFrameCollector time_col = TimeFrameCollector( "Geometry" );
-		vk::Extent2D old_extent;
+		UINT32 old_sample_count = 0;
 		bool setup_layout();
 
 		vk::PipelineLayout geomtry_pipeline_layout;
 		vk::Pipeline geomtry_pipeline;
 		inline bool build_geomtry_pipeline();
+
+		// large scenes are split into chunks of at least this size, every chunk has its own pool and is recorded in parallel
+		static constexpr std::size_t MIN_CHUNK_SIZE = 512;
+		RecordWorkers record_workers;
+		std::vector<const GeometryObject*> geometry_objects;
+		std::size_t chunk_count = 1;
+		bool record_chunk( std::size_t chunk_index );
+
+		const RenderQuery::ZoneId gpu_zone;
 	};
 
 	class VectorDecalTask : public SubpassTask<VectorDecalTask>
@@ -94,16 +156,30 @@ namespace noxcain
 
 		bool buffer_independent_preparation();
 		bool buffer_dependent_preparation( CommandData& pool_data );
+		bool prepare_recording( RecordKey& record_key );
 		bool record( const std::vector<vk::CommandBuffer>& buffers );
 
 	private:
-		TimeFrameCollector time_col = TimeFrameCollector( "Vector" );
-		vk::Extent2D old_extent;
+		UINT32 old_sample_count = 0;
 		bool setup_layout();
 
 		vk::PipelineLayout vector_decal_pipeline_layout;
 		vk::Pipeline vector_decal_pipeline;
 		inline bool build_vector_decal_pipeline();
+
+		// glyph instances of all decals, one draw per group
+		struct DrawGroup
+		{
+			UINT32 first_instance = 0;
+			UINT32 instance_count = 0;
+		};
+		std::vector<VectorText3D::Instance> instances;
+		std::vector<DrawGroup> draw_groups;
+		std::array<HostBuffer, RECORD_RING_SIZE> instance_buffers;
+
+		bool gather_instances();
+
+		const RenderQuery::ZoneId gpu_zone;
 	};
 
 	class SamplingTask : public SubpassTask<SamplingTask>
@@ -114,18 +190,23 @@ namespace noxcain
 
 		bool buffer_independent_preparation();
 		bool buffer_dependent_preparation( CommandData& pool_data );
+		bool prepare_recording( RecordKey& record_key );
 		bool record( const std::vector<vk::CommandBuffer>& buffers );
 
 	private:
-		TimeFrameCollector time_col = TimeFrameCollector( "Shading" );
-		vk::Extent2D old_extent;
+		UINT32 old_sample_count = 0;
 		bool setup_layouts();
 
 		vk::PipelineLayout sampling_pipeline_layout;
+
+		// inverse camera, the shading reconstructs world positions from the depth
+		NxMatrix4x4 clip_to_world;
 		vk::Pipeline edge_detection_pipeline;
 		vk::Pipeline sampled_pipeline;
 		vk::Pipeline unsampled_pipeline;
 		inline bool build_shading_pipelines();
 		inline bool build_edge_detection_pipeline();
+
+		const RenderQuery::ZoneId gpu_zone;
 	};
 }
\ No newline at end of file
@@ -1,3 +1,76 @@
+#include "CommandThreadTools.hpp"
 
+noxcain::RecordWorkers::RecordWorkers( std::size_t thread_count )
+{
+	if( thread_count > 1 )
+	{
+		threads.reserve( thread_count - 1 );
+		for( std::size_t thread_index = 1; thread_index < thread_count; ++thread_index )
+		{
+			threads.emplace_back( &RecordWorkers::work, this );
+		}
+	}
+}
 
+noxcain::RecordWorkers::~RecordWorkers()
+{
+	{
+		std::unique_lock lock( worker_mutex );
+		shutdown = true;
+		worker_condition.notify_all();
+	}
 
+	for( auto& thread : threads )
+	{
+		if( thread.joinable() )
+		{
+			thread.join();
+		}
+	}
+}
+
+bool noxcain::RecordWorkers::run( std::size_t job_count, const Job& job )
+{
+	std::unique_lock lock( worker_mutex );
+	current_job = &job;
+	job_total = job_count;
+	next_job = 0;
+	finished_jobs = 0;
+	all_okay = true;
+	worker_condition.notify_all();
+
+	execute_jobs( lock );
+	finish_condition.wait( lock, [this]() { return finished_jobs == job_total; } );
+
+	current_job = nullptr;
+	return all_okay;
+}
+
+void noxcain::RecordWorkers::work()
+{
+	std::unique_lock lock( worker_mutex );
+	while( !shutdown )
+	{
+		worker_condition.wait( lock, [this]() { return shutdown || ( current_job && next_job < job_total ); } );
+		execute_jobs( lock );
+	}
+}
+
+void noxcain::RecordWorkers::execute_jobs( std::unique_lock<std::mutex>& lock )
+{
+	while( current_job && next_job < job_total )
+	{
+		const Job& job = *current_job;
+		const std::size_t job_index = next_job++;
+
+		lock.unlock();
+		const bool is_okay = job( job_index );
+		lock.lock();
+
+		all_okay = all_okay && is_okay;
+		if( ++finished_jobs == job_total )
+		{
+			finish_condition.notify_all();
+		}
+	}
+}
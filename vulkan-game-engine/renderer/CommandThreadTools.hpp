@@ -1,6 +1,11 @@
 #pragma once
+#include <Defines.hpp>
 
+#include <condition_variable>
 #include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace noxcain
 {
@@ -17,4 +22,47 @@ namespace noxcain
 	private:
 		std::function<void()> callback;
 	};
-}
\ No newline at end of file
+
+	/// <summary>
+	/// persistent threads of one task, records independent command buffers in parallel
+	/// </summary>
+	class RecordWorkers
+	{
+	public:
+		using Job = std::function<bool( std::size_t job_index )>;
+
+		RecordWorkers( const RecordWorkers& ) = delete;
+		RecordWorkers& operator=( const RecordWorkers& ) = delete;
+
+		/// <param name="thread_count">recording threads including the calling thread</param>
+		RecordWorkers( std::size_t thread_count );
+		~RecordWorkers();
+
+		std::size_t get_thread_count() const
+		{
+			return threads.size() + 1;
+		}
+
+		/// <summary>
+		/// executes the job for every index, the calling thread takes part and returns when all jobs are done
+		/// </summary>
+		/// <returns>false if any job failed</returns>
+		bool run( std::size_t job_count, const Job& job );
+
+	private:
+		std::mutex worker_mutex;
+		std::condition_variable worker_condition;
+		std::condition_variable finish_condition;
+		std::vector<std::thread> threads;
+
+		const Job* current_job = nullptr;
+		std::size_t job_total = 0;
+		std::size_t next_job = 0;
+		std::size_t finished_jobs = 0;
+		bool all_okay = true;
+		bool shutdown = false;
+
+		void work();
+		void execute_jobs( std::unique_lock<std::mutex>& lock );
+	};
+}
@@ -132,6 +132,18 @@ std::vector<vk::DescriptorPoolSize> noxcain::DescriptorSetLayoutDescription::get
 	return type_counts;
 }
 
+std::vector<std::pair<noxcain::UINT32, noxcain::UINT32>> noxcain::DescriptorSetLayoutDescription::get_binding_counts() const
+{
+	std::shared_lock lock( descriptor_set_layout_mutex );
+	std::vector<std::pair<UINT32, UINT32>> binding_counts;
+	binding_counts.reserve( bindings.size() );
+	for( const auto& binding : bindings )
+	{
+		binding_counts.emplace_back( binding.binding, binding.descriptor_count );
+	}
+	return binding_counts;
+}
+
 std::pair<bool,vk::DescriptorType> noxcain::DescriptorSetLayoutDescription::get_binding_type( UINT32 binding ) const
 {
 	for( const auto& binding_entry : bindings )
@@ -36,6 +36,11 @@ namespace noxcain
 		std::vector<vk::DescriptorPoolSize> get_type_count() const;
 		std::pair<bool, vk::DescriptorType> get_binding_type( UINT32 binding ) const;
 
+		/// <summary>
+		/// binding index and descriptor count of all bindings
+		/// </summary>
+		std::vector<std::pair<UINT32, UINT32>> get_binding_counts() const;
+
 	private:
 		struct Binding
 		{
@@ -65,5 +70,6 @@ namespace noxcain
 	{
 		vk::DescriptorSet set;
 		std::shared_ptr<DescriptorSetLayoutDescription> layout;
+		bool is_written = false;
 	};
 }
\ No newline at end of file
@@ -1,18 +1,26 @@
 #include "DescriptorSetManager.hpp"
 
 #include <renderer/GameGraphicEngine.hpp>
-
-#include <resources/GameResourceEngine.hpp>
-#include <resources/FontResource.hpp>
+#include <renderer/ReleaseQueue.hpp>
 
 #include <tools/ResultHandler.hpp>
 
+#include <algorithm>
+
 bool noxcain::DescriptorSetManager::update_basic_sets( const std::vector<BasicDescriptorSetUpdate>& updates )
 {
 	std::vector<vk::WriteDescriptorSet> writes;
+	std::vector<vk::CopyDescriptorSet> copies;
 
 	std::unique_lock lock( descriptor_set_mutex );
 
+	// frames in flight may still read the current sets, updates go into new sets of a new pool
+	const vk::DescriptorPool replaced_pool = pool;
+	if( replaced_pool && !replace_descriptor_sets( updates, copies ) )
+	{
+		return false;
+	}
+
 	for( const auto& basic_updates : updates )
 	{
 		
@@ -24,6 +32,7 @@ bool noxcain::DescriptorSetManager::update_basic_sets( const std::vector<BasicDe
 				return false;
 			}
 		}
+		basic_descriptor_sets[static_cast<std::size_t>( basic_updates.set )].is_written = true;
 		
 		const auto current_set = basic_descriptor_sets[static_cast<std::size_t>( basic_updates.set )].set;
 		const auto current_layout = basic_descriptor_sets[static_cast<std::size_t>( basic_updates.set )].layout;
@@ -78,12 +87,71 @@ bool noxcain::DescriptorSetManager::update_basic_sets( const std::vector<BasicDe
 	vk::Device device = GraphicEngine::get_device();
 	if( device )
 	{
+		// copies of one call are executed after its writes, the new descriptors must not be overwritten by old ones
+		if( !copies.empty() )
+		{
+			device.updateDescriptorSets( {}, copies );
+		}
 		device.updateDescriptorSets( writes, {} );
+
+		// frees the old sets with their pool
+		GraphicEngine::get_release_queue().retire( replaced_pool );
 		return true;
 	}
 	return false;
 }
 
+bool noxcain::DescriptorSetManager::replace_descriptor_sets( const std::vector<BasicDescriptorSetUpdate>& updates, std::vector<vk::CopyDescriptorSet>& copies )
+{
+	const vk::DescriptorPool old_pool = pool;
+	std::array<vk::DescriptorSet, BASIC_DESCRIPTOR_SET_COUNT> old_sets;
+	for( std::size_t index = 0; index < BASIC_DESCRIPTOR_SET_COUNT; ++index )
+	{
+		old_sets[index] = basic_descriptor_sets[index].set;
+		basic_descriptor_sets[index].set = vk::DescriptorSet();
+	}
+
+	pool = vk::DescriptorPool();
+	create_descriptor_sets();
+	if( !pool || !basic_descriptor_sets.front().set )
+	{
+		GraphicEngine::get_device().destroyDescriptorPool( pool );
+		pool = old_pool;
+		for( std::size_t index = 0; index < BASIC_DESCRIPTOR_SET_COUNT; ++index )
+		{
+			basic_descriptor_sets[index].set = old_sets[index];
+		}
+		return false;
+	}
+
+	// written bindings without update keep their descriptors
+	for( std::size_t index = 0; index < BASIC_DESCRIPTOR_SET_COUNT; ++index )
+	{
+		const auto& basic_set = basic_descriptor_sets[index];
+		if( !basic_set.is_written )
+		{
+			continue;
+		}
+
+		for( const auto& [binding, descriptor_count] : basic_set.layout->get_binding_counts() )
+		{
+			const bool is_overwritten = std::any_of( updates.begin(), updates.end(), [index, binding, descriptor_count]( const BasicDescriptorSetUpdate& basic_update )
+			{
+				return static_cast<std::size_t>( basic_update.set ) == index && std::any_of( basic_update.updates.begin(), basic_update.updates.end(), [binding, descriptor_count]( const DescriptorUpdate& update )
+				{
+					return update.binding == binding && update.start_element == 0 && update.descriptor_count >= descriptor_count;
+				} );
+			} );
+
+			if( !is_overwritten )
+			{
+				copies.emplace_back( old_sets[index], binding, 0, basic_set.set, binding, 0, descriptor_count );
+			}
+		}
+	}
+	return true;
+}
+
 noxcain::DescriptorSetManager::DescriptorSetManager()
 {
 	fixed_finalize_sampler = SamplerDescription::create_sampler_description( vk::SamplerCreateInfo(
@@ -96,9 +164,9 @@ noxcain::DescriptorSetManager::DescriptorSetManager()
 		descriptor_set = DescriptorSetLayoutDescription::create_descriptor_set_layout_description();
 	}
 
-	const auto& resource_limits = ResourceEngine::get_engine().get_resource_limits();
-	descriptor_set_layouts[( std::size_t )DescriptorSetLayouts::GLYPH]->add_binding( vk::DescriptorType::eStorageBuffer, resource_limits.glyph_count, vk::ShaderStageFlagBits::eFragment );
-	descriptor_set_layouts[( std::size_t )DescriptorSetLayouts::GLYPH]->add_binding( vk::DescriptorType::eStorageBuffer, resource_limits.glyph_count, vk::ShaderStageFlagBits::eFragment );
+	descriptor_set_layouts[( std::size_t )DescriptorSetLayouts::GLYPH]->add_binding( vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eFragment );
+	descriptor_set_layouts[( std::size_t )DescriptorSetLayouts::GLYPH]->add_binding( vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eFragment );
+	descriptor_set_layouts[( std::size_t )DescriptorSetLayouts::GLYPH]->add_binding( vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eFragment );
 
 	descriptor_set_layouts[( std::size_t )DescriptorSetLayouts::INPUT_ATTACHMENT_3]->add_binding( vk::DescriptorType::eInputAttachment, 1, vk::ShaderStageFlagBits::eFragment );
 	descriptor_set_layouts[( std::size_t )DescriptorSetLayouts::INPUT_ATTACHMENT_3]->add_binding( vk::DescriptorType::eInputAttachment, 1, vk::ShaderStageFlagBits::eFragment );
@@ -106,9 +174,13 @@ noxcain::DescriptorSetManager::DescriptorSetManager()
 
 	descriptor_set_layouts[( std::size_t )DescriptorSetLayouts::FIXED_SAMPLED_TEXTURE_1]->add_binding( vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment, { fixed_finalize_sampler } );
 
+	descriptor_set_layouts[( std::size_t )DescriptorSetLayouts::GLYPH_ATLAS]->add_binding( vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eFragment );
+	descriptor_set_layouts[( std::size_t )DescriptorSetLayouts::GLYPH_ATLAS]->add_binding( vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eFragment );
+
 	basic_descriptor_sets[( std::size_t )BasicDescriptorSets::SHADING_INPUT_ATTACHMENTS].layout = descriptor_set_layouts[( std::size_t )DescriptorSetLayouts::INPUT_ATTACHMENT_3];
 	basic_descriptor_sets[( std::size_t )BasicDescriptorSets::FINALIZED_MASTER_TEXTURE].layout = descriptor_set_layouts[( std::size_t )DescriptorSetLayouts::FIXED_SAMPLED_TEXTURE_1];
 	basic_descriptor_sets[( std::size_t )BasicDescriptorSets::GLYPHS].layout = descriptor_set_layouts[( std::size_t )DescriptorSetLayouts::GLYPH];
+	basic_descriptor_sets[( std::size_t )BasicDescriptorSets::GLYPH_ATLAS].layout = descriptor_set_layouts[( std::size_t )DescriptorSetLayouts::GLYPH_ATLAS];
 
 	for( const auto& basic_descriptor_set : basic_descriptor_sets )
 	{
@@ -13,17 +13,19 @@ namespace noxcain
 	{
 		SHADING_INPUT_ATTACHMENTS = 0,
 		GLYPHS,
-		FINALIZED_MASTER_TEXTURE
+		FINALIZED_MASTER_TEXTURE,
+		GLYPH_ATLAS
 	};
-	constexpr static std::size_t BASIC_DESCRIPTOR_SET_COUNT = static_cast<std::size_t>( BasicDescriptorSets::FINALIZED_MASTER_TEXTURE ) + 1;
+	constexpr static std::size_t BASIC_DESCRIPTOR_SET_COUNT = static_cast<std::size_t>( BasicDescriptorSets::GLYPH_ATLAS ) + 1;
 
 	enum class DescriptorSetLayouts : std::size_t
 	{
 		GLYPH = 0,
 		INPUT_ATTACHMENT_3,
-		FIXED_SAMPLED_TEXTURE_1
+		FIXED_SAMPLED_TEXTURE_1,
+		GLYPH_ATLAS
 	};
-	constexpr static std::size_t DESCRIPTOR_SET_LAYOUT_COUNT = static_cast<std::size_t>( DescriptorSetLayouts::FIXED_SAMPLED_TEXTURE_1 ) + 1;
+	constexpr static std::size_t DESCRIPTOR_SET_LAYOUT_COUNT = static_cast<std::size_t>( DescriptorSetLayouts::GLYPH_ATLAS ) + 1;
 	
 	class DescriptorSetManager
 	{
@@ -69,6 +71,7 @@ namespace noxcain
 		//void update();
 	private:
 		void create_descriptor_sets();
+		bool replace_descriptor_sets( const std::vector<BasicDescriptorSetUpdate>& updates, std::vector<vk::CopyDescriptorSet>& copies );
 
 		std::shared_mutex descriptor_set_mutex;
 		vk::DescriptorPool pool;
@@ -5,6 +5,8 @@
 #include <renderer/DescriptorSetManager.hpp>
 #include <renderer/GraphicCore.hpp>
 #include <renderer/MemoryManagement.hpp>
+#include <renderer/PipelineCache.hpp>
+#include <renderer/ReleaseQueue.hpp>
 #include <renderer/ShaderManager.hpp>
 #include <renderer/RenderQuery.hpp>
 
@@ -27,9 +29,12 @@ bool noxcain::GraphicEngine::clear()
 		if( r_handler.all_okay() )
 		{
 			commands.reset( nullptr );
+			render_query.reset( nullptr );
 			descriptor_sets.reset( nullptr );
 			memory.reset( nullptr );
 			shader.reset( nullptr );
+			release_queue.reset( nullptr );
+			pipeline_cache.reset( nullptr );
 			return true;
 		}
 	}
@@ -38,6 +43,8 @@ bool noxcain::GraphicEngine::clear()
 
 void noxcain::GraphicEngine::initialize()
 {
+	pipeline_cache.reset( new PipelineCache() );
+	release_queue.reset( new ReleaseQueue() );
 	commands.reset( new CommandManager() );
 	descriptor_sets.reset( new DescriptorSetManager() );
 	memory.reset( new MemoryManager() );
@@ -81,6 +88,11 @@ vk::PhysicalDevice noxcain::GraphicEngine::get_physical_device()
 	return engine->core->get_physical_device();
 }
 
+bool noxcain::GraphicEngine::is_device_extension_enabled( const char* extension_name )
+{
+	return engine->core->is_device_extension_enabled( extension_name );
+}
+
 vk::SwapchainKHR noxcain::GraphicEngine::get_swapchain()
 {
 	return engine->core->get_swapchain();
@@ -101,6 +113,31 @@ vk::ImageView noxcain::GraphicEngine::get_swapchain_image_view( std::size_t imag
 	return engine->core->get_image_view( image_index );
 }
 
+vk::ImageLayout noxcain::GraphicEngine::get_presentation_layout()
+{
+	return engine->core->get_presentation_layout();
+}
+
+noxcain::UINT64 noxcain::GraphicEngine::get_presentation_version()
+{
+	return engine->core->get_presentation_version();
+}
+
+bool noxcain::GraphicEngine::is_offscreen()
+{
+	return engine->core->is_offscreen_rendering();
+}
+
+void noxcain::GraphicEngine::complete_offscreen_frame( UINT32 image_index )
+{
+	engine->core->complete_offscreen_frame( image_index );
+}
+
+bool noxcain::GraphicEngine::read_offscreen_image( UINT32 image_index, std::vector<BYTE>& rgba_pixels )
+{
+	return engine->core->read_offscreen_image( image_index, rgba_pixels );
+}
+
 bool noxcain::GraphicEngine::execute_swapchain_recreation( bool recreate_surface )
 {
 	return engine->core->execute_swapchain_recreation( recreate_surface );
@@ -136,6 +173,16 @@ noxcain::RenderQuery& noxcain::GraphicEngine::get_render_query()
 	return *engine->render_query;
 }
 
+noxcain::PipelineCache& noxcain::GraphicEngine::get_pipeline_cache()
+{
+	return *engine->pipeline_cache;
+}
+
+noxcain::ReleaseQueue& noxcain::GraphicEngine::get_release_queue()
+{
+	return *engine->release_queue;
+}
+
 vk::ShaderModule noxcain::GraphicEngine::get_shader( FragmentShaderIds shader_id )
 {
 	return engine->shader->get( shader_id );
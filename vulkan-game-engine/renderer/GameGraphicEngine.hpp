@@ -16,11 +16,15 @@ namespace noxcain
 	class MemoryManager;
 	class CommandManager;
 	class RenderQuery;
+	class PipelineCache;
+	class ReleaseQueue;
 
 	class  GraphicEngine
 	{
 	private:
 		std::unique_ptr<GraphicCore> core;
+		std::unique_ptr<PipelineCache> pipeline_cache;
+		std::unique_ptr<ReleaseQueue> release_queue;
 		std::unique_ptr<RenderQuery> render_query;
 		std::unique_ptr<DescriptorSetManager> descriptor_sets;
 		std::unique_ptr<MemoryManager> memory;
@@ -41,10 +45,17 @@ namespace noxcain
 
 		static vk::Device get_device();
 		static vk::PhysicalDevice get_physical_device();
+		static bool is_device_extension_enabled( const char* extension_name );
 		static vk::SwapchainKHR get_swapchain();
 		static UINT32 get_swapchain_image_count();
 		static vk::Format get_swapchain_image_format();
 		static vk::ImageView get_swapchain_image_view( std::size_t image_index );
+		static vk::ImageLayout get_presentation_layout();
+		static UINT64 get_presentation_version();
+
+		static bool is_offscreen();
+		static void complete_offscreen_frame( UINT32 image_index );
+		static bool read_offscreen_image( UINT32 image_index, std::vector<BYTE>& rgba_pixels );
 		
 		static bool execute_swapchain_recreation( bool recreate_surface );
 		static bool signal_swapchain_recreation( bool recreate_surface );
@@ -59,6 +70,9 @@ namespace noxcain
 
 		static RenderQuery& get_render_query();
 
+		static PipelineCache& get_pipeline_cache();
+		static ReleaseQueue& get_release_queue();
+
 		static vk::ShaderModule get_shader( FragmentShaderIds shader_id );
 		static vk::ShaderModule get_shader( ComputeShaderIds shader_id );
 		static vk::ShaderModule get_shader( VertexShaderIds shader_id );
@@ -6,7 +6,41 @@
 
 #include <tools/ResultHandler.hpp>
 
+#include <algorithm>
 #include <array>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	// first memory type allowed by type_bits with all wanted properties
+	bool find_memory_type( const vk::PhysicalDevice& physical_device, noxcain::UINT32 type_bits, vk::MemoryPropertyFlags properties, noxcain::UINT32& type_index )
+	{
+		const vk::PhysicalDeviceMemoryProperties memory_properties = physical_device.getMemoryProperties();
+		for( noxcain::UINT32 index = 0; index < memory_properties.memoryTypeCount; ++index )
+		{
+			if( ( type_bits & ( 0x1 << index ) ) && ( memory_properties.memoryTypes[index].propertyFlags & properties ) == properties )
+			{
+				type_index = index;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	const char* const VALIDATION_LAYER_NAME = "VK_LAYER_KHRONOS_validation";
+
+	VKAPI_ATTR VkBool32 VKAPI_CALL report_validation_message( VkDebugUtilsMessageSeverityFlagBitsEXT severity, VkDebugUtilsMessageTypeFlagsEXT,
+															  const VkDebugUtilsMessengerCallbackDataEXT* callback_data, void* user_data )
+	{
+		const noxcain::PresentationSurface* surface = static_cast<const noxcain::PresentationSurface*>( user_data );
+		surface->validation_message( severity >= VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT, callback_data->pMessage );
+
+		// the call that triggered the message is never aborted
+		return VK_FALSE;
+	}
+}
 
 bool noxcain::GraphicCore::pick_physical_device()
 {
@@ -43,7 +77,7 @@ bool noxcain::GraphicCore::pick_physical_device()
 			for( UINT32 familyIndex = 0; familyIndex < queueFamilyProperties.size(); ++familyIndex )
 			{
 				if( queueFamilyProperties[familyIndex].queueFlags & vk::QueueFlagBits::eGraphics &&
-					VK_TRUE == resultHandler << device.getSurfaceSupportKHR( familyIndex, surface ) )
+					( is_offscreen || VK_TRUE == resultHandler << device.getSurfaceSupportKHR( familyIndex, surface ) ) )
 				{
 					PhysicalDeviceCandidate candidate;
 					candidate.device = device;
@@ -95,7 +129,21 @@ bool noxcain::GraphicCore::create_device()
 		vk::DeviceQueueCreateInfo( vk::DeviceQueueCreateFlags(), candidates[deviceIndex].queueFamilyIndex, UINT32( priorities.size() ), priorities.data() )
 	};
 
-	vk::DeviceCreateInfo deviceCreateInfo( vk::DeviceCreateFlags(), UINT32( queueCreateInfos.size() ), queueCreateInfos.data(), 0, nullptr, UINT32( necessaryDeviceExtensions.size() ), necessaryDeviceExtensions.data() );
+	enabledDeviceExtensions = necessaryDeviceExtensions;
+	std::vector<vk::ExtensionProperties> deviceExtensions = r_handler << get_physical_device().enumerateDeviceExtensionProperties();
+	for( const char* optionalDeviceExtension : optionalDeviceExtensions )
+	{
+		for( const vk::ExtensionProperties& deviceExtension : deviceExtensions )
+		{
+			if( !strcmp( optionalDeviceExtension, deviceExtension.extensionName ) )
+			{
+				enabledDeviceExtensions.push_back( optionalDeviceExtension );
+				break;
+			}
+		}
+	}
+
+	vk::DeviceCreateInfo deviceCreateInfo( vk::DeviceCreateFlags(), UINT32( queueCreateInfos.size() ), queueCreateInfos.data(), 0, nullptr, UINT32( enabledDeviceExtensions.size() ), enabledDeviceExtensions.data() );
 
 	logical_device = r_handler << get_physical_device().createDevice( deviceCreateInfo );
 	return r_handler.all_okay();
@@ -180,12 +228,111 @@ bool noxcain::GraphicCore::create_swapchain( vk::SwapchainKHR old_swapchain )
 					vk::ComponentMapping( vk::ComponentSwizzle::eR, vk::ComponentSwizzle::eG, vk::ComponentSwizzle::eB, vk::ComponentSwizzle::eA ),
 					vk::ImageSubresourceRange( vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 ) ) );
 			}
+			++presentation_version;
 			return r_handler.all_okay();
 		}
 	}
 	return false;
 }
 
+bool noxcain::GraphicCore::create_offscreen_images()
+{
+	ResultHandler r_handler( vk::Result::eSuccess );
+	const vk::PhysicalDevice& physical_device = candidates[deviceIndex].device;
+
+	surface_extent = surface_base->get_offscreen_extent();
+	if( !surface_extent.width || !surface_extent.height )
+	{
+		return false;
+	}
+
+	// the images are copied to the host for frame dumps
+	const vk::FormatFeatureFlags needed_features = vk::FormatFeatureFlagBits::eColorAttachment | vk::FormatFeatureFlagBits::eTransferSrc;
+	surface_format = vk::Format::eUndefined;
+	for( const vk::Format format : { vk::Format::eB8G8R8A8Unorm, vk::Format::eR8G8B8A8Unorm } )
+	{
+		if( ( physical_device.getFormatProperties( format ).optimalTilingFeatures & needed_features ) == needed_features )
+		{
+			surface_format = format;
+			break;
+		}
+	}
+	if( surface_format == vk::Format::eUndefined )
+	{
+		return false;
+	}
+
+	// same count as a fifo swapchain
+	presentation_image_count = 2;
+	offscreen_images.resize( presentation_image_count );
+	swapChainImageViews.resize( presentation_image_count );
+	for( UINT32 image_index = 0; image_index < presentation_image_count; ++image_index )
+	{
+		OffscreenImage& offscreen_image = offscreen_images[image_index];
+		offscreen_image.image = r_handler << logical_device.createImage( vk::ImageCreateInfo(
+			vk::ImageCreateFlags(), vk::ImageType::e2D, surface_format, vk::Extent3D( surface_extent, 1 ), 1, 1,
+			vk::SampleCountFlagBits::e1, vk::ImageTiling::eOptimal,
+			vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
+			vk::SharingMode::eExclusive, 0, nullptr, vk::ImageLayout::eUndefined ) );
+		if( !r_handler.all_okay() )
+		{
+			return false;
+		}
+
+		// software rasterizers may not offer device local memory
+		const vk::MemoryRequirements requirements = logical_device.getImageMemoryRequirements( offscreen_image.image );
+		UINT32 type_index = 0;
+		if( !find_memory_type( physical_device, requirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal, type_index ) &&
+			!find_memory_type( physical_device, requirements.memoryTypeBits, vk::MemoryPropertyFlags(), type_index ) )
+		{
+			return false;
+		}
+
+		offscreen_image.memory = r_handler << logical_device.allocateMemory( vk::MemoryAllocateInfo( requirements.size, type_index ) );
+		r_handler << logical_device.bindImageMemory( offscreen_image.image, offscreen_image.memory, 0 );
+
+		swapChainImageViews[image_index] = r_handler << logical_device.createImageView( vk::ImageViewCreateInfo(
+			vk::ImageViewCreateFlags(), offscreen_image.image, vk::ImageViewType::e2D, surface_format,
+			vk::ComponentMapping( vk::ComponentSwizzle::eR, vk::ComponentSwizzle::eG, vk::ComponentSwizzle::eB, vk::ComponentSwizzle::eA ),
+			vk::ImageSubresourceRange( vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 ) ) );
+		if( !r_handler.all_okay() )
+		{
+			return false;
+		}
+	}
+
+	++presentation_version;
+	return true;
+}
+
+bool noxcain::GraphicCore::create_presentation_images()
+{
+	if( is_offscreen )
+	{
+		return create_offscreen_images();
+	}
+	return create_swapchain( swapchain );
+}
+
+void noxcain::GraphicCore::destroy_presentation_images()
+{
+	for( const vk::ImageView& imageView : swapChainImageViews )
+	{
+		logical_device.destroyImageView( imageView );
+	}
+	swapChainImageViews.clear();
+
+	for( const OffscreenImage& offscreen_image : offscreen_images )
+	{
+		logical_device.destroyImage( offscreen_image.image );
+		logical_device.freeMemory( offscreen_image.memory );
+	}
+	offscreen_images.clear();
+
+	logical_device.destroySwapchainKHR( swapchain );
+	swapchain = vk::SwapchainKHR();
+}
+
 noxcain::GraphicCore::GraphicCore()
 {
 }
@@ -195,6 +342,14 @@ bool noxcain::GraphicCore::initialize( std::shared_ptr<PresentationSurface> os_s
 	if( os_surface )
 	{
 		surface_base = os_surface;
+		is_offscreen = os_surface->is_offscreen();
+	}
+
+	// offscreen images need neither a surface nor a swapchain, any device with a graphic queue can render them
+	if( is_offscreen )
+	{
+		necessary_instance_extensions.clear();
+		necessaryDeviceExtensions.clear();
 	}
 
 	ResultHandler result_handler( vk::Result::eSuccess );
@@ -226,25 +381,72 @@ bool noxcain::GraphicCore::initialize( std::shared_ptr<PresentationSurface> os_s
 		vk::ApplicationInfo application_info( noxcain::GAME_NAME, noxcain::GAME_VERSION, noxcain::GRAPHIC_ENGINE_NAME, noxcain::GRAPHIC_ENGINE_VERSION, VK_MAKE_VERSION( 1, 1, 83 ) );
 
 		std::vector<const char*> validation_layers;
+		std::vector<const char*> instance_extensions = necessary_instance_extensions;
+		bool is_validated = false;
+		if( os_surface && os_surface->is_validated() )
+		{
+			// the layer brings the debug utils extension with it, a missing layer is reported instead of failing the initialization
+			ResultHandler layer_result_handler( vk::Result::eSuccess );
+			const std::vector<vk::ExtensionProperties> layer_extensions = layer_result_handler << vk::enumerateInstanceExtensionProperties( std::string( VALIDATION_LAYER_NAME ) );
+			is_validated = layer_result_handler.all_okay() && std::any_of( layer_extensions.begin(), layer_extensions.end(), []( const vk::ExtensionProperties& extension )
+			{
+				return !strcmp( extension.extensionName, VK_EXT_DEBUG_UTILS_EXTENSION_NAME );
+			} );
+
+			if( is_validated )
+			{
+				validation_layers.push_back( VALIDATION_LAYER_NAME );
+				instance_extensions.push_back( VK_EXT_DEBUG_UTILS_EXTENSION_NAME );
+			}
+			else
+			{
+				os_surface->validation_message( true, "VK_LAYER_KHRONOS_validation with VK_EXT_debug_utils is not installed" );
+			}
+		}
 #ifndef NDEBUG
 #ifdef WIN32
-		validation_layers.push_back( "VK_LAYER_LUNARG_standard_validation" );
-		validation_layers.push_back( "VK_LAYER_LUNARG_monitor" );
+		else
+		{
+			validation_layers.push_back( "VK_LAYER_LUNARG_standard_validation" );
+			validation_layers.push_back( "VK_LAYER_LUNARG_monitor" );
+		}
 #endif // WIN32
 #endif // NDEBUG
 
 
 		instance = result_handler << vk::createInstance( vk::InstanceCreateInfo( vk::InstanceCreateFlags(), &application_info,
 																				UINT32( validation_layers.size() ), validation_layers.data(),
-																				UINT32( necessary_instance_extensions.size() ), necessary_instance_extensions.data() ) );
+																				UINT32( instance_extensions.size() ), instance_extensions.data() ) );
 		if( result_handler.all_okay() )
 		{
-			surface = os_surface->create_surface( instance );
-			if( surface )
+			if( is_validated )
+			{
+				// not exported by the loader, the messenger functions are fetched from the instance
+				const auto create_messenger = reinterpret_cast<PFN_vkCreateDebugUtilsMessengerEXT>( instance.getProcAddr( "vkCreateDebugUtilsMessengerEXT" ) );
+
+				VkDebugUtilsMessengerCreateInfoEXT messenger_info = {};
+				messenger_info.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
+				messenger_info.messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+				messenger_info.messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
+				messenger_info.pfnUserCallback = report_validation_message;
+				messenger_info.pUserData = os_surface.get();
+
+				if( !create_messenger || create_messenger( static_cast<VkInstance>( instance ), &messenger_info, nullptr, &validation_messenger ) != VK_SUCCESS )
+				{
+					os_surface->validation_message( true, "the validation messenger can not be created" );
+				}
+			}
+
+			if( !is_offscreen )
+			{
+				surface = os_surface->create_surface( instance );
+			}
+
+			if( surface || is_offscreen )
 			{
 				if( pick_physical_device() && 
 					create_device() && 
-					create_swapchain( swapchain ) )
+					create_presentation_images() )
 				{
 					return true;
 				}
@@ -258,17 +460,17 @@ noxcain::GraphicCore::~GraphicCore()
 {
 	if( logical_device )
 	{	
-		for( const vk::ImageView& imageView : swapChainImageViews )
-		{
-			logical_device.destroyImageView( imageView );
-		}
-
-		logical_device.destroySwapchainKHR( swapchain );
+		destroy_presentation_images();
 		logical_device.destroy();
 	}
 
 	if( instance )
 	{
+		if( validation_messenger )
+		{
+			const auto destroy_messenger = reinterpret_cast<PFN_vkDestroyDebugUtilsMessengerEXT>( instance.getProcAddr( "vkDestroyDebugUtilsMessengerEXT" ) );
+			destroy_messenger( static_cast<VkInstance>( instance ), validation_messenger, nullptr );
+		}
 		instance.destroySurfaceKHR( surface );
 		instance.destroy();
 	}
@@ -280,14 +482,7 @@ bool noxcain::GraphicCore::use_next_physical_device()
 	{
 		if( logical_device )
 		{
-			for( const vk::ImageView& imageView : swapChainImageViews )
-			{
-				logical_device.destroyImageView( imageView );
-			}
-			swapChainImageViews.clear();
-
-			logical_device.destroySwapchainKHR( swapchain );
-			swapchain = vk::SwapchainKHR();
+			destroy_presentation_images();
 
 			logical_device.destroy();
 			logical_device = vk::Device();
@@ -299,7 +494,7 @@ bool noxcain::GraphicCore::use_next_physical_device()
 			return false;
 		}
 	}
-	while( !create_device() || !create_swapchain( swapchain ) );
+	while( !create_device() || !create_presentation_images() );
 	return true;
 }
 
@@ -323,11 +518,35 @@ vk::Format noxcain::GraphicCore::get_presentation_surface_format() const
 	return surface_format;
 }
 
+vk::ImageLayout noxcain::GraphicCore::get_presentation_layout() const
+{
+	// the present layout is only defined with the swapchain extension
+	return is_offscreen ? vk::ImageLayout::eTransferSrcOptimal : vk::ImageLayout::ePresentSrcKHR;
+}
+
+noxcain::UINT64 noxcain::GraphicCore::get_presentation_version() const
+{
+	return presentation_version;
+}
+
+bool noxcain::GraphicCore::is_offscreen_rendering() const
+{
+	return is_offscreen;
+}
+
 vk::PhysicalDevice noxcain::GraphicCore::get_physical_device() const
 {
 	return candidates[deviceIndex].device;
 }
 
+bool noxcain::GraphicCore::is_device_extension_enabled( const char* extension_name ) const
+{
+	return std::any_of( enabledDeviceExtensions.begin(), enabledDeviceExtensions.end(), [extension_name]( const char* enabled_extension )
+	{
+		return !strcmp( enabled_extension, extension_name );
+	} );
+}
+
 vk::Device noxcain::GraphicCore::get_logical_device() const
 {
 	return logical_device;
@@ -356,8 +575,109 @@ void noxcain::GraphicCore::close_surface_base() const
 	}
 }
 
+void noxcain::GraphicCore::complete_offscreen_frame( UINT32 image_index ) const
+{
+	if( surface_base && is_offscreen )
+	{
+		surface_base->offscreen_frame_complete( image_index );
+	}
+}
+
+bool noxcain::GraphicCore::read_offscreen_image( UINT32 image_index, std::vector<BYTE>& rgba_pixels ) const
+{
+	if( !is_offscreen || image_index >= offscreen_images.size() )
+	{
+		return false;
+	}
+
+	ResultHandler r_handler( vk::Result::eSuccess );
+	const vk::PhysicalDevice& physical_device = candidates[deviceIndex].device;
+	const vk::Queue queue = logical_device.getQueue( get_graphic_queue_family_index(), 0 );
+	const vk::DeviceSize data_size = vk::DeviceSize( surface_extent.width ) * surface_extent.height * 4;
+
+	vk::Buffer buffer = r_handler << logical_device.createBuffer( vk::BufferCreateInfo( vk::BufferCreateFlags(), data_size, vk::BufferUsageFlagBits::eTransferDst, vk::SharingMode::eExclusive ) );
+	vk::DeviceMemory memory;
+	if( r_handler.all_okay() )
+	{
+		const vk::MemoryRequirements requirements = logical_device.getBufferMemoryRequirements( buffer );
+		UINT32 type_index = 0;
+		if( find_memory_type( physical_device, requirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, type_index ) )
+		{
+			memory = r_handler << logical_device.allocateMemory( vk::MemoryAllocateInfo( requirements.size, type_index ) );
+			r_handler << logical_device.bindBufferMemory( buffer, memory, 0 );
+		}
+	}
+
+	vk::Fence fence = r_handler << logical_device.createFence( vk::FenceCreateInfo() );
+	vk::CommandPool pool = r_handler << logical_device.createCommandPool( vk::CommandPoolCreateInfo( vk::CommandPoolCreateFlagBits::eTransient, get_graphic_queue_family_index() ) );
+	std::vector<vk::CommandBuffer> command_buffers;
+	if( r_handler.all_okay() )
+	{
+		command_buffers = r_handler << logical_device.allocateCommandBuffers( vk::CommandBufferAllocateInfo( pool, vk::CommandBufferLevel::ePrimary, 1 ) );
+	}
+
+	bool is_copied = false;
+	if( memory && r_handler.all_okay() && command_buffers.size() == 1 )
+	{
+		const vk::CommandBuffer& command_buffer = command_buffers.front();
+		r_handler << command_buffer.begin( vk::CommandBufferBeginInfo( vk::CommandBufferUsageFlagBits::eOneTimeSubmit ) );
+
+		// the finalize render pass left the image in transfer source layout
+		command_buffer.pipelineBarrier( vk::PipelineStageFlagBits::eColorAttachmentOutput, vk::PipelineStageFlagBits::eTransfer, vk::DependencyFlags(), {}, {},
+			{
+				vk::ImageMemoryBarrier( vk::AccessFlagBits::eColorAttachmentWrite, vk::AccessFlagBits::eTransferRead,
+										vk::ImageLayout::eTransferSrcOptimal, vk::ImageLayout::eTransferSrcOptimal, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED,
+										offscreen_images[image_index].image, vk::ImageSubresourceRange( vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 ) )
+			} );
+
+		command_buffer.copyImageToBuffer( offscreen_images[image_index].image, vk::ImageLayout::eTransferSrcOptimal, buffer,
+			{
+				vk::BufferImageCopy( 0, 0, 0, vk::ImageSubresourceLayers( vk::ImageAspectFlagBits::eColor, 0, 0, 1 ), vk::Offset3D( 0, 0, 0 ), vk::Extent3D( surface_extent, 1 ) )
+			} );
+
+		command_buffer.pipelineBarrier( vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost, vk::DependencyFlags(), {},
+			{
+				vk::BufferMemoryBarrier( vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eHostRead, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, buffer, 0, data_size )
+			}, {} );
+		r_handler << command_buffer.end();
+
+		r_handler << queue.submit( { vk::SubmitInfo( 0, nullptr, nullptr, 1, &command_buffer ) }, fence );
+		r_handler << logical_device.waitForFences( { fence }, VK_TRUE, ~UINT64( 0 ) );
+
+		const BYTE* data = static_cast<const BYTE*>( r_handler << logical_device.mapMemory( memory, 0, data_size ) );
+		if( r_handler.all_okay() && data )
+		{
+			rgba_pixels.assign( data, data + data_size );
+			logical_device.unmapMemory( memory );
+
+			if( surface_format == vk::Format::eB8G8R8A8Unorm )
+			{
+				for( std::size_t index = 0; index < rgba_pixels.size(); index += 4 )
+				{
+					std::swap( rgba_pixels[index], rgba_pixels[index + 2] );
+				}
+			}
+			is_copied = true;
+		}
+	}
+
+	logical_device.destroyCommandPool( pool );
+	logical_device.destroyFence( fence );
+	logical_device.destroyBuffer( buffer );
+	logical_device.freeMemory( memory );
+	return is_copied;
+}
+
 bool noxcain::GraphicCore::signal_swapchain_recreation( bool recreate_surface )
 {
+	if( is_offscreen )
+	{
+		// offscreen images are never out of date, they are only recreated in place
+		destroy_presentation_images();
+		surface_base->recreate_swapchain( false );
+		return true;
+	}
+
 	recreate_surface = recreate_surface || surface_base->window_changed();
 	
 	for( const vk::ImageView& imageView : swapChainImageViews )
@@ -380,5 +700,9 @@ bool noxcain::GraphicCore::signal_swapchain_recreation( bool recreate_surface )
 
 bool noxcain::GraphicCore::execute_swapchain_recreation( bool recreate_surface )
 {
+	if( is_offscreen )
+	{
+		return create_offscreen_images();
+	}
 	return create_swapchain( recreate_surface ? vk::SwapchainKHR() : swapchain );
 }
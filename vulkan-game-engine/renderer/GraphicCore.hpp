@@ -20,11 +20,18 @@ namespace noxcain
 		vk::PresentModeKHR presentationMode = vk::PresentModeKHR::eFifoRelaxed;
 
 		std::vector<const char*> necessary_instance_extensions = { VK_KHR_SURFACE_EXTENSION_NAME };
-		const std::array<const char*, 1> necessaryDeviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+		std::vector<const char*> necessaryDeviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+
+		// enabled if the picked device offers them
+		std::vector<const char*> optionalDeviceExtensions = { VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME };
+		std::vector<const char*> enabledDeviceExtensions;
 
 		vk::Instance instance;
 		vk::Device logical_device;
 
+		// reports the validation layer messages to the surface base, only created if it is validated
+		VkDebugUtilsMessengerEXT validation_messenger = VK_NULL_HANDLE;
+
 		vk::SurfaceKHR surface;
 		vk::SwapchainKHR swapchain;
 
@@ -40,9 +47,26 @@ namespace noxcain
 
 		std::vector<vk::ImageView> swapChainImageViews;
 
+		/// <summary>
+		/// replace the swapchain images if the surface base renders offscreen, the views are kept in swapChainImageViews
+		/// </summary>
+		bool is_offscreen = false;
+		struct OffscreenImage
+		{
+			vk::Image image;
+			vk::DeviceMemory memory;
+		};
+		std::vector<OffscreenImage> offscreen_images;
+
+		// changes with every new set of presentation images
+		UINT64 presentation_version = 0;
+
 		bool pick_physical_device();
 		bool create_device();
 		bool create_swapchain( vk::SwapchainKHR oldSwapChain = vk::SwapchainKHR() );
+		bool create_offscreen_images();
+		bool create_presentation_images();
+		void destroy_presentation_images();
 
 	public:
 
@@ -61,14 +85,24 @@ namespace noxcain
 
 		vk::Extent2D get_window_extent() const;
 		vk::Format get_presentation_surface_format() const;
+		vk::ImageLayout get_presentation_layout() const;
+		UINT64 get_presentation_version() const;
+		bool is_offscreen_rendering() const;
 
 		vk::PhysicalDevice get_physical_device() const;
+		bool is_device_extension_enabled( const char* extension_name ) const;
 		vk::Device get_logical_device() const;
 		vk::SurfaceKHR get_surface() const;
 		vk::SwapchainKHR get_swapchain() const;
 		vk::ImageView get_image_view( std::size_t index ) const;
 
 		void close_surface_base() const;
+		void complete_offscreen_frame( UINT32 image_index ) const;
+
+		/// <summary>
+		/// copies an offscreen image to the host as tightly packed rgba values, has to be called from the submit thread after the frame completed
+		/// </summary>
+		bool read_offscreen_image( UINT32 image_index, std::vector<BYTE>& rgba_pixels ) const;
 		bool signal_swapchain_recreation( bool recreate_surface );
 		bool execute_swapchain_recreation( bool recreate_surface );
 	};
@@ -7,4 +7,7 @@ namespace noxcain
 {
 	constexpr std::chrono::milliseconds GRAPHIC_TIMEOUT_DURATION = std::chrono::milliseconds( 100 );
 	constexpr static UINT32 RECORD_RING_SIZE = 2;
+
+	// upper limit of threads recording the buffers of one subpass task
+	constexpr static std::size_t MAX_RECORD_THREAD_COUNT = 8;
 }
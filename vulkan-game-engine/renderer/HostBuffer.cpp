@@ -0,0 +1,77 @@
+#include "HostBuffer.hpp"
+
+#include <renderer/GameGraphicEngine.hpp>
+#include <renderer/MemoryManagement.hpp>
+#include <renderer/ReleaseQueue.hpp>
+#include <tools/ResultHandler.hpp>
+
+noxcain::HostBuffer::~HostBuffer()
+{
+	destroy();
+}
+
+bool noxcain::HostBuffer::reserve( UINT64 wanted_size, vk::BufferUsageFlags wanted_usage )
+{
+	if( buffer && wanted_size <= size && ( usage & wanted_usage ) == wanted_usage )
+	{
+		return true;
+	}
+
+	destroy();
+
+	// grow in powers of two to avoid a reallocation every time the content grows a little
+	UINT64 new_size = MIN_SIZE;
+	while( new_size < wanted_size )
+	{
+		new_size *= 2;
+	}
+
+	const vk::Device& device = GraphicEngine::get_device();
+	ResultHandler r_handler( vk::Result::eSuccess );
+
+	buffer = r_handler << device.createBuffer( vk::BufferCreateInfo( vk::BufferCreateFlags(), new_size, wanted_usage, vk::SharingMode::eExclusive, 0, nullptr ) );
+	if( !r_handler.all_okay() )
+	{
+		return false;
+	}
+
+	const vk::MemoryRequirements requirements = device.getBufferMemoryRequirements( buffer );
+	memory = GraphicEngine::get_memory_manager().get_unmanaged_memory( requirements.size, vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent, requirements.memoryTypeBits );
+	if( !memory )
+	{
+		destroy();
+		return false;
+	}
+
+	r_handler << device.bindBufferMemory( buffer, memory, 0 );
+	mapped_memory = r_handler << device.mapMemory( memory, 0, VK_WHOLE_SIZE );
+	if( !r_handler.all_okay() )
+	{
+		destroy();
+		return false;
+	}
+
+	size = new_size;
+	usage = wanted_usage;
+	return true;
+}
+
+void noxcain::HostBuffer::destroy()
+{
+	const vk::Device& device = GraphicEngine::get_device();
+	if( device )
+	{
+		if( mapped_memory )
+		{
+			device.unmapMemory( memory );
+		}
+
+		// older frames may still read the buffer
+		GraphicEngine::get_release_queue().retire( buffer );
+		GraphicEngine::get_release_queue().retire( memory );
+	}
+	buffer = vk::Buffer();
+	memory = vk::DeviceMemory();
+	mapped_memory = nullptr;
+	size = 0;
+}
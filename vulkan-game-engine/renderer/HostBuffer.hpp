@@ -0,0 +1,47 @@
+#pragma once
+#include <Defines.hpp>
+
+#include <vulkan/vulkan.hpp>
+
+namespace noxcain
+{
+	/// <summary>
+	/// persistently mapped host coherent buffer for data written every frame, grows on demand and keeps its size
+	/// </summary>
+	class HostBuffer
+	{
+	public:
+		HostBuffer() = default;
+		~HostBuffer();
+
+		HostBuffer( const HostBuffer& ) = delete;
+		HostBuffer& operator=( const HostBuffer& ) = delete;
+
+		/// <summary>
+		/// recreates the buffer if it is smaller than size, the content is lost in that case
+		/// </summary>
+		/// <remarks>the gpu must not use the buffer anymore, owners keep one buffer per record ring slot</remarks>
+		bool reserve( UINT64 size, vk::BufferUsageFlags usage );
+
+		void* get_memory() const
+		{
+			return mapped_memory;
+		}
+
+		vk::Buffer get_buffer() const
+		{
+			return buffer;
+		}
+
+	private:
+		static constexpr UINT64 MIN_SIZE = 0x10000;
+
+		vk::Buffer buffer;
+		vk::DeviceMemory memory;
+		void* mapped_memory = nullptr;
+		UINT64 size = 0;
+		vk::BufferUsageFlags usage;
+
+		void destroy();
+	};
+}
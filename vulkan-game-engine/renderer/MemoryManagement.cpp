@@ -2,6 +2,7 @@
 
 #include <renderer/DescriptorSetManager.hpp>
 #include <renderer/GameGraphicEngine.hpp>
+#include <renderer/ReleaseQueue.hpp>
 
 #include <resources/GameResourceEngine.hpp>
 #include <resources/GameResource.hpp>
@@ -53,40 +54,35 @@ bool noxcain::MemoryManager::request_resource_memory()
 	if( create_managed_memory( bufferReq, std::vector<ImageRequest>() ) )
 	{
 		const auto& resource_engine = ResourceEngine::get_engine();
-		const auto& limits = resource_engine.get_resource_limits();
-		const auto& fonts = resource_engine.get_fonts();
 		
+		// offsets and points of all glyphs, located by the glyph ranges
 		DescriptorSetManager::BasicDescriptorSetUpdate font_update;
+		font_update.set = BasicDescriptorSets::GLYPHS;
 
-		std::vector<vk::DescriptorBufferInfo> point_offset_buffers;
-		std::vector<vk::DescriptorBufferInfo> point_buffers;
-
-		point_offset_buffers.reserve( limits.glyph_count );
-		point_buffers.reserve( limits.glyph_count );
+		const auto& glyph_offset_block = get_block( resource_engine.get_glyph_offset_resource_id() );
+		const auto& glyph_point_block = get_block( resource_engine.get_glyph_point_resource_id() );
+		const auto& glyph_range_block = get_block( resource_engine.get_glyph_range_resource_id() );
+		vk::DescriptorBufferInfo glyph_offset_buffer( glyph_offset_block.buffer, glyph_offset_block.offset, glyph_offset_block.size );
+		vk::DescriptorBufferInfo glyph_point_buffer( glyph_point_block.buffer, glyph_point_block.offset, glyph_point_block.size );
+		vk::DescriptorBufferInfo glyph_range_buffer( glyph_range_block.buffer, glyph_range_block.offset, glyph_range_block.size );
 
-		font_update.set = BasicDescriptorSets::GLYPHS;
+		font_update.updates.emplace_back( 0, 0, DescriptorSetManager::DescriptorUpdateInfoTypes::BUFFER_INFO, 1, &glyph_offset_buffer );
+		font_update.updates.emplace_back( 1, 0, DescriptorSetManager::DescriptorUpdateInfoTypes::BUFFER_INFO, 1, &glyph_point_buffer );
+		font_update.updates.emplace_back( 2, 0, DescriptorSetManager::DescriptorUpdateInfoTypes::BUFFER_INFO, 1, &glyph_range_buffer );
 
-		for( std::size_t font_id = 0; font_id < fonts.size(); ++font_id )
-		{	
-			// fill up offset buffers
-			for( auto offset_subresource_id : fonts[font_id].get_offset_map_resource_ids() )
-			{
-				const auto& block = get_block( offset_subresource_id );
-				point_offset_buffers.emplace_back( block.buffer, block.offset, block.size );
-			}
+		// atlas entries and texels for small text
+		DescriptorSetManager::BasicDescriptorSetUpdate atlas_update;
+		atlas_update.set = BasicDescriptorSets::GLYPH_ATLAS;
 
-			// fill up pointer buffers
-			for( auto points_subresource_id : fonts[font_id].get_point_map_resource_ids() )
-			{
-				const auto& block = get_block( points_subresource_id );
-				point_buffers.emplace_back( block.buffer, block.offset, block.size );
-			}
-		}
+		const auto& atlas_entry_block = get_block( resource_engine.get_glyph_atlas_entry_resource_id() );
+		const auto& atlas_texel_block = get_block( resource_engine.get_glyph_atlas_texel_resource_id() );
+		vk::DescriptorBufferInfo atlas_entry_buffer( atlas_entry_block.buffer, atlas_entry_block.offset, atlas_entry_block.size );
+		vk::DescriptorBufferInfo atlas_texel_buffer( atlas_texel_block.buffer, atlas_texel_block.offset, atlas_texel_block.size );
 
-		font_update.updates.emplace_back( 0, 0, DescriptorSetManager::DescriptorUpdateInfoTypes::BUFFER_INFO, UINT32( point_offset_buffers.size() ), point_offset_buffers.data() );
-		font_update.updates.emplace_back( 1, 0, DescriptorSetManager::DescriptorUpdateInfoTypes::BUFFER_INFO, UINT32( point_buffers.size() ), point_buffers.data() );
+		atlas_update.updates.emplace_back( 0, 0, DescriptorSetManager::DescriptorUpdateInfoTypes::BUFFER_INFO, 1, &atlas_entry_buffer );
+		atlas_update.updates.emplace_back( 1, 0, DescriptorSetManager::DescriptorUpdateInfoTypes::BUFFER_INFO, 1, &atlas_texel_buffer );
 
-		return GraphicEngine::get_descriptor_set_manager().update_basic_sets( { font_update } );
+		return GraphicEngine::get_descriptor_set_manager().update_basic_sets( { font_update, atlas_update } );
 	}
 	return false;
 }
@@ -96,7 +92,7 @@ bool noxcain::MemoryManager::setup_main_render_destination()
 	free_main_render_destination_memory();
 	
 	auto g_settings = LogicEngine::get_graphic_settings();
-	auto resolution = g_settings.get_accumulated_resolution();
+	auto resolution = g_settings.get_allocated_resolution();
 	UINT32 width = resolution.width;
 	UINT32 height = resolution.height;
 	
@@ -127,17 +123,9 @@ bool noxcain::MemoryManager::setup_main_render_destination()
 	//                                  NORMAL                                    //
 	//----------------------------------------------------------------------------//
 
+	// two octahedral components, the position is reconstructed from the depth
 	requests.emplace_back( main_render_destinations[static_cast<std::size_t>( RenderDestinationImages::NORMAL )], vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eLazilyAllocated, vk::ImageCreateInfo(
-		vk::ImageCreateFlags(), vk::ImageType::e2D, formats.color, extent, 1, 1, static_cast<vk::SampleCountFlagBits>( g_settings.get_sample_count() ), vk::ImageTiling::eOptimal,
-		vk::ImageUsageFlagBits::eTransientAttachment | vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eInputAttachment,
-		vk::SharingMode::eExclusive, 0, nullptr, vk::ImageLayout::eUndefined ) );
-
-	//----------------------------------------------------------------------------//
-	//                                POSITION                                    //
-	//----------------------------------------------------------------------------//
-
-	requests.emplace_back( main_render_destinations[static_cast<std::size_t>( RenderDestinationImages::POSITION )], vk::MemoryPropertyFlagBits::eDeviceLocal | vk::MemoryPropertyFlagBits::eLazilyAllocated, vk::ImageCreateInfo(
-		vk::ImageCreateFlags(), vk::ImageType::e2D, formats.color, extent, 1, 1, static_cast<vk::SampleCountFlagBits>( g_settings.get_sample_count() ), vk::ImageTiling::eOptimal,
+		vk::ImageCreateFlags(), vk::ImageType::e2D, formats.normal, extent, 1, 1, static_cast<vk::SampleCountFlagBits>( g_settings.get_sample_count() ), vk::ImageTiling::eOptimal,
 		vk::ImageUsageFlagBits::eTransientAttachment | vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eInputAttachment,
 		vk::SharingMode::eExclusive, 0, nullptr, vk::ImageLayout::eUndefined ) );
 
@@ -157,7 +145,7 @@ bool noxcain::MemoryManager::setup_main_render_destination()
 	main_render_destinations[( std::size_t ) RenderDestinationImages::DEPTH_SAMPLED].viewAspect = vk::ImageAspectFlagBits::eDepth;
 	requests.emplace_back( main_render_destinations[(std::size_t) RenderDestinationImages::DEPTH_SAMPLED], vk::MemoryPropertyFlagBits::eLazilyAllocated | vk::MemoryPropertyFlagBits::eDeviceLocal, vk::ImageCreateInfo(
 		vk::ImageCreateFlags(), vk::ImageType::e2D, formats.depth, extent, 1, 1, static_cast<vk::SampleCountFlagBits>( g_settings.get_sample_count() ), vk::ImageTiling::eOptimal,
-		vk::ImageUsageFlagBits::eTransientAttachment | vk::ImageUsageFlagBits::eDepthStencilAttachment,
+		vk::ImageUsageFlagBits::eTransientAttachment | vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eInputAttachment,
 		vk::SharingMode::eExclusive, 0, nullptr, vk::ImageLayout::eUndefined ) );
 
 	//----------------------------------------------------------------------------//
@@ -206,12 +194,13 @@ bool noxcain::MemoryManager::setup_main_render_destination()
 	auto& sampled_input_attachment = updates.emplace_back();
 	vk::DescriptorImageInfo color_info( vk::Sampler(), get_image( RenderDestinationImages::COLOR ).view , vk::ImageLayout::eShaderReadOnlyOptimal );
 	vk::DescriptorImageInfo normal_info( vk::Sampler(), get_image( RenderDestinationImages::NORMAL ).view, vk::ImageLayout::eShaderReadOnlyOptimal );
-	vk::DescriptorImageInfo position_info( vk::Sampler(), get_image( RenderDestinationImages::POSITION ).view, vk::ImageLayout::eShaderReadOnlyOptimal );
+	vk::DescriptorImageInfo depth_info( vk::Sampler(), get_image( RenderDestinationImages::DEPTH_SAMPLED ).view, vk::ImageLayout::eDepthStencilReadOnlyOptimal );
 	
+	// same order as the input attachments of the shading subpasses
 	sampled_input_attachment.set = BasicDescriptorSets::SHADING_INPUT_ATTACHMENTS;
-	sampled_input_attachment.updates.emplace_back( 0, 0, DescriptorSetManager::DescriptorUpdateInfoTypes::IMAGE_INFO, 1, &position_info );
+	sampled_input_attachment.updates.emplace_back( 0, 0, DescriptorSetManager::DescriptorUpdateInfoTypes::IMAGE_INFO, 1, &color_info );
 	sampled_input_attachment.updates.emplace_back( 1, 0, DescriptorSetManager::DescriptorUpdateInfoTypes::IMAGE_INFO, 1, &normal_info );
-	sampled_input_attachment.updates.emplace_back( 2, 0, DescriptorSetManager::DescriptorUpdateInfoTypes::IMAGE_INFO, 1, &color_info );
+	sampled_input_attachment.updates.emplace_back( 2, 0, DescriptorSetManager::DescriptorUpdateInfoTypes::IMAGE_INFO, 1, &depth_info );
 
 	// final texture attachments
 	auto& final_texture_attachment = updates.emplace_back();
@@ -618,7 +607,7 @@ inline noxcain::MemoryManager::RenderDestinationFormats noxcain::MemoryManager::
 		vk::Format::eD16Unorm, //depth only
 		vk::Format::eD16UnormS8Uint,
 		vk::Format::eD24UnormS8Uint }, //should always available
-		vk::ImageUsageFlagBits::eDepthStencilAttachment,
+		vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eInputAttachment,
 		vk::FormatFeatureFlagBits::eDepthStencilAttachment,
 		true, available_extent, available_sample_count );
 
@@ -658,6 +647,16 @@ inline noxcain::MemoryManager::RenderDestinationFormats noxcain::MemoryManager::
 		vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eInputAttachment,
 		vk::FormatFeatureFlagBits::eColorAttachmentBlend, true, available_extent, available_sample_count );
 
+	// the normal is never blended, it only needs two channels
+	formats.normal = find_format(
+		{
+			vk::Format::eR16G16Unorm,
+			vk::Format::eR16G16Sfloat, //should always available
+			formats.color
+		},
+		vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eInputAttachment | vk::ImageUsageFlagBits::eTransientAttachment,
+		vk::FormatFeatureFlagBits::eColorAttachment, true, available_extent, available_sample_count );
+
 	if( new_settings || available_extent.width < width || available_extent.height < height || available_sample_count < vk_sample_count )
 	{
 		sample_count = static_cast<UINT32>( available_sample_count );
@@ -721,17 +720,18 @@ bool noxcain::MemoryManager::has_render_destination_memory()
 
 void noxcain::MemoryManager::free_main_render_destination_memory()
 {
-	vk::Device device = GraphicEngine::get_device();
+	// frames in flight may still render into the old images
+	ReleaseQueue& release_queue = GraphicEngine::get_release_queue();
 
 	for( ImageBinding& binding : main_render_destinations )
 	{
-		device.destroyImageView( binding.view );
-		device.destroyImage( binding.image );
+		release_queue.retire( binding.view );
+		release_queue.retire( binding.image );
 
 		--memory[binding.memoryIndex].usageCount;
 		if( !memory[binding.memoryIndex].usageCount )
 		{
-			device.freeMemory( memory[binding.memoryIndex].memory );
+			release_queue.retire( memory[binding.memoryIndex].memory );
 			memory[binding.memoryIndex].memory = vk::DeviceMemory();
 		}
 
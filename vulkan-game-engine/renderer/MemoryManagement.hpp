@@ -36,7 +36,6 @@ namespace noxcain
 			COLOR = 0,
 			COLOR_RESOLVED,
 			NORMAL,
-			POSITION,
 
 			DEPTH_SAMPLED,
 			STENCIL_UNSAMPLED,
@@ -130,6 +129,7 @@ namespace noxcain
 		struct RenderDestinationFormats
 		{
 			vk::Format color;
+			vk::Format normal;
 			vk::Format depth;
 			vk::Format stencil;
 		};
@@ -0,0 +1,222 @@
+#include "PipelineCache.hpp"
+
+#include <renderer/GameGraphicEngine.hpp>
+#include <tools/ResultHandler.hpp>
+
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+
+namespace
+{
+	using noxcain::UINT32;
+	using noxcain::UINT64;
+
+	constexpr UINT32 FILE_IDENTIFIER = 0x4350584E; // "NXPC"
+	constexpr const char* FILE_NAME = "pipeline.cache";
+
+	// header of the cache data defined by the vulkan specification, header version one
+	struct CacheDataHeader
+	{
+		UINT32 header_size;
+		UINT32 header_version;
+		UINT32 vendor_id;
+		UINT32 device_id;
+		std::array<noxcain::BYTE, VK_UUID_SIZE> cache_uuid;
+	};
+	static_assert( sizeof( CacheDataHeader ) == 16 + VK_UUID_SIZE );
+}
+
+std::string noxcain::PipelineCache::directory;
+
+noxcain::PipelineCache::PipelineCache()
+{
+	ResultHandler r_handler( vk::Result::eSuccess );
+	const vk::Device device = GraphicEngine::get_device();
+	device_properties = GraphicEngine::get_physical_device().getProperties();
+	has_creation_feedback = GraphicEngine::is_device_extension_enabled( VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME );
+
+	std::vector<BYTE> data;
+	if( !load( data ) )
+	{
+		data.clear();
+	}
+
+	cache = r_handler << device.createPipelineCache( vk::PipelineCacheCreateInfo( vk::PipelineCacheCreateFlags(), data.size(), data.data() ) );
+	if( !r_handler.all_okay() && !data.empty() )
+	{
+		// the driver may still reject the data, that is a cold start
+		r_handler.reset();
+		data.clear();
+		cache = r_handler << device.createPipelineCache( vk::PipelineCacheCreateInfo() );
+	}
+	statistics.loaded_bytes = data.size();
+}
+
+noxcain::PipelineCache::~PipelineCache()
+{
+	const vk::Device device = GraphicEngine::get_device();
+	if( device && cache )
+	{
+		save();
+		device.destroyPipelineCache( cache );
+	}
+}
+
+vk::ResultValue<vk::Pipeline> noxcain::PipelineCache::create_graphics_pipeline( const vk::GraphicsPipelineCreateInfo& create_info )
+{
+	// the feedback is chained in front of the extensions of the caller
+	vk::GraphicsPipelineCreateInfo feedback_create_info = create_info;
+	vk::PipelineCreationFeedbackEXT feedback;
+	std::vector<vk::PipelineCreationFeedbackEXT> stage_feedbacks( create_info.stageCount );
+	vk::PipelineCreationFeedbackCreateInfoEXT feedback_info;
+	if( has_creation_feedback )
+	{
+		feedback_info.setPPipelineCreationFeedback( &feedback );
+		feedback_info.setPipelineStageCreationFeedbackCount( UINT32( stage_feedbacks.size() ) );
+		feedback_info.setPPipelineStageCreationFeedbacks( stage_feedbacks.data() );
+		feedback_info.setPNext( create_info.pNext );
+		feedback_create_info.setPNext( &feedback_info );
+	}
+
+	const auto start_time = std::chrono::steady_clock::now();
+	auto result = GraphicEngine::get_device().createGraphicsPipeline( cache, feedback_create_info );
+	const auto creation_time = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - start_time );
+
+	std::lock_guard<std::mutex> lock( cache_mutex );
+	if( !( feedback.flags & vk::PipelineCreationFeedbackFlagBitsEXT::eValid ) )
+	{
+		// without feedback every creation may have added data
+		++statistics.unknown_count;
+		has_new_pipelines = true;
+		statistics.unknown_time += creation_time;
+	}
+	else if( feedback.flags & vk::PipelineCreationFeedbackFlagBitsEXT::eApplicationPipelineCacheHit )
+	{
+		++statistics.hit_count;
+		statistics.hit_time += creation_time;
+	}
+	else
+	{
+		++statistics.miss_count;
+		has_new_pipelines = true;
+		statistics.miss_time += creation_time;
+	}
+	return result;
+}
+
+noxcain::PipelineCache::Statistics noxcain::PipelineCache::get_statistics() const
+{
+	std::lock_guard<std::mutex> lock( cache_mutex );
+	return statistics;
+}
+
+bool noxcain::PipelineCache::save()
+{
+	std::lock_guard<std::mutex> lock( cache_mutex );
+	if( !cache || !has_new_pipelines )
+	{
+		return true;
+	}
+
+	ResultHandler r_handler( vk::Result::eSuccess );
+	const std::vector<uint8_t> data = r_handler << GraphicEngine::get_device().getPipelineCacheData( cache );
+	if( !r_handler.all_okay() || data.empty() )
+	{
+		return false;
+	}
+
+	// the old file stays valid until the new one is complete
+	const std::string path = get_file_path();
+	const std::string temporary_path = path + ".tmp";
+	{
+		std::ofstream file( temporary_path, std::ios::binary | std::ios::trunc );
+		const UINT64 data_size = data.size();
+		file.write( reinterpret_cast<const char*>( &FILE_IDENTIFIER ), sizeof( FILE_IDENTIFIER ) );
+		file.write( reinterpret_cast<const char*>( &device_properties.driverVersion ), sizeof( device_properties.driverVersion ) );
+		file.write( reinterpret_cast<const char*>( &data_size ), sizeof( data_size ) );
+		file.write( reinterpret_cast<const char*>( data.data() ), data.size() );
+		if( !file.good() )
+		{
+			return false;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename( temporary_path, path, error );
+	if( error )
+	{
+		return false;
+	}
+
+	has_new_pipelines = false;
+	return true;
+}
+
+void noxcain::PipelineCache::Statistics::write_summary( std::ostream& stream ) const
+{
+	auto to_milliseconds = []( std::chrono::nanoseconds time )
+	{
+		return std::chrono::duration<DOUBLE, std::milli>( time ).count();
+	};
+
+	stream << std::fixed << std::setprecision( 3 ) << "pipeline cache: " << loaded_bytes << " bytes loaded, "
+		<< hit_count << " hits " << to_milliseconds( hit_time ) << " ms, " << miss_count << " misses " << to_milliseconds( miss_time ) << " ms";
+	if( unknown_count )
+	{
+		stream << ", " << unknown_count << " without feedback " << to_milliseconds( unknown_time ) << " ms";
+	}
+	stream << "\n";
+}
+
+void noxcain::PipelineCache::set_directory( const std::string& path )
+{
+	directory = path;
+}
+
+bool noxcain::PipelineCache::load( std::vector<BYTE>& data ) const
+{
+	std::ifstream file( get_file_path(), std::ios::binary );
+	if( !file.is_open() )
+	{
+		return false;
+	}
+
+	UINT32 identifier = 0;
+	UINT32 driver_version = 0;
+	UINT64 data_size = 0;
+	file.read( reinterpret_cast<char*>( &identifier ), sizeof( identifier ) );
+	file.read( reinterpret_cast<char*>( &driver_version ), sizeof( driver_version ) );
+	file.read( reinterpret_cast<char*>( &data_size ), sizeof( data_size ) );
+	if( !file.good() || identifier != FILE_IDENTIFIER || driver_version != device_properties.driverVersion || data_size < sizeof( CacheDataHeader ) )
+	{
+		return false;
+	}
+
+	data.resize( data_size );
+	file.read( reinterpret_cast<char*>( data.data() ), data_size );
+	return file.good() && is_compatible( data );
+}
+
+bool noxcain::PipelineCache::is_compatible( const std::vector<BYTE>& data ) const
+{
+	CacheDataHeader header;
+	std::memcpy( &header, data.data(), sizeof( header ) );
+
+	return header.header_size >= sizeof( CacheDataHeader ) && header.header_size <= data.size()
+		&& header.header_version == UINT32( vk::PipelineCacheHeaderVersion::eOne )
+		&& header.vendor_id == device_properties.vendorID
+		&& header.device_id == device_properties.deviceID
+		&& std::memcmp( header.cache_uuid.data(), &device_properties.pipelineCacheUUID[0], VK_UUID_SIZE ) == 0;
+}
+
+std::string noxcain::PipelineCache::get_file_path()
+{
+	if( directory.empty() )
+	{
+		return FILE_NAME;
+	}
+	return directory + "/" + FILE_NAME;
+}
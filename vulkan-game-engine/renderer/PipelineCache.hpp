@@ -0,0 +1,79 @@
+#pragma once
+#include <Defines.hpp>
+
+#include <vulkan/vulkan.hpp>
+
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace noxcain
+{
+	/// <summary>
+	/// engine wide pipeline cache, the cache file is only loaded if it was written by the same device and driver
+	/// </summary>
+	class PipelineCache
+	{
+	public:
+		struct Statistics
+		{
+			// size of the loaded cache data, zero on a cold start
+			std::size_t loaded_bytes = 0;
+
+			// the driver reports hits through VK_EXT_pipeline_creation_feedback, without it creations are only counted
+			UINT32 hit_count = 0;
+			UINT32 miss_count = 0;
+			UINT32 unknown_count = 0;
+			std::chrono::nanoseconds hit_time = std::chrono::nanoseconds( 0 );
+			std::chrono::nanoseconds miss_time = std::chrono::nanoseconds( 0 );
+			std::chrono::nanoseconds unknown_time = std::chrono::nanoseconds( 0 );
+
+			/// <summary>
+			/// one line with the loaded size and the count and creation time of hits and misses
+			/// </summary>
+			void write_summary( std::ostream& stream ) const;
+		};
+
+		PipelineCache( const PipelineCache& ) = delete;
+		PipelineCache& operator=( const PipelineCache& ) = delete;
+
+		PipelineCache();
+		~PipelineCache();
+
+		/// <summary>
+		/// creates the pipeline with the engine cache and adds it to the statistics
+		/// </summary>
+		vk::ResultValue<vk::Pipeline> create_graphics_pipeline( const vk::GraphicsPipelineCreateInfo& create_info );
+
+		Statistics get_statistics() const;
+
+		/// <summary>
+		/// writes the cache data next to the previous file, nothing is written if no pipeline was added since loading
+		/// </summary>
+		/// <returns>true if the file is up to date</returns>
+		bool save();
+
+		/// <summary>
+		/// writable directory of the cache file, the working directory is used if not set
+		/// </summary>
+		static void set_directory( const std::string& path );
+
+	private:
+		vk::PipelineCache cache;
+		vk::PhysicalDeviceProperties device_properties;
+
+		// the cache itself is synchronized by the driver, the mutex guards the statistics and saving
+		mutable std::mutex cache_mutex;
+		Statistics statistics;
+		bool has_new_pipelines = false;
+		bool has_creation_feedback = false;
+
+		bool load( std::vector<BYTE>& data ) const;
+		bool is_compatible( const std::vector<BYTE>& data ) const;
+
+		static std::string get_file_path();
+		static std::string directory;
+	};
+}
@@ -0,0 +1,111 @@
+#include "ReleaseQueue.hpp"
+
+#include <renderer/GameGraphicEngine.hpp>
+#include <tools/ResultHandler.hpp>
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+noxcain::ReleaseQueue::~ReleaseQueue()
+{
+	release_all();
+}
+
+noxcain::UINT64 noxcain::ReleaseQueue::begin_frame()
+{
+	std::unique_lock lock( queue_mutex );
+	return ++recorded_frame;
+}
+
+void noxcain::ReleaseQueue::retire( const Handle& handle )
+{
+	const bool is_null = std::visit( []( const auto& value ) { return !value; }, handle );
+	if( is_null )
+	{
+		return;
+	}
+
+	{
+		std::unique_lock lock( queue_mutex );
+		++retired_count;
+
+		// the newest recorded frame may still use the handle, even if its recording is not finished
+		if( recorded_frame > completed_frame )
+		{
+			retired_handles.push_back( { recorded_frame, handle } );
+			return;
+		}
+	}
+	destroy( handle );
+}
+
+void noxcain::ReleaseQueue::complete_frame( UINT64 frame_index )
+{
+	std::vector<Handle> released_handles;
+	{
+		std::unique_lock lock( queue_mutex );
+		completed_frame = std::max( completed_frame, frame_index );
+
+		// frame indices are retired in ascending order
+		while( !retired_handles.empty() && retired_handles.front().frame_index <= completed_frame )
+		{
+			released_handles.push_back( retired_handles.front().handle );
+			retired_handles.pop_front();
+		}
+	}
+
+	for( const Handle& handle : released_handles )
+	{
+		destroy( handle );
+	}
+}
+
+void noxcain::ReleaseQueue::release_all()
+{
+	std::deque<RetiredHandle> released_handles;
+	{
+		std::unique_lock lock( queue_mutex );
+		released_handles.swap( retired_handles );
+		completed_frame = recorded_frame;
+	}
+
+	const vk::Device device = GraphicEngine::get_device();
+	if( device && !released_handles.empty() )
+	{
+		ResultHandler r_handler( vk::Result::eSuccess );
+		r_handler << device.waitIdle();
+		if( r_handler.all_okay() )
+		{
+			for( const RetiredHandle& retired_handle : released_handles )
+			{
+				destroy( retired_handle.handle );
+			}
+		}
+	}
+}
+
+noxcain::UINT64 noxcain::ReleaseQueue::get_retired_count() const
+{
+	std::unique_lock lock( queue_mutex );
+	return retired_count;
+}
+
+void noxcain::ReleaseQueue::destroy( const Handle& handle )
+{
+	const vk::Device device = GraphicEngine::get_device();
+	if( device )
+	{
+		std::visit( [&device]( const auto& value )
+		{
+			if constexpr( std::is_same_v<std::decay_t<decltype( value )>, vk::DeviceMemory> )
+			{
+				device.freeMemory( value );
+			}
+			else
+			{
+				device.destroy( value );
+			}
+		}, handle );
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <Defines.hpp>
+
+#include <vulkan/vulkan.hpp>
+
+#include <deque>
+#include <mutex>
+#include <variant>
+
+namespace noxcain
+{
+	/// <summary>
+	/// destroys retired vulkan objects after all frames that could use them are complete, replaces a device wait before destruction
+	/// </summary>
+	class ReleaseQueue
+	{
+	public:
+		using Handle = std::variant<vk::Pipeline, vk::PipelineLayout, vk::RenderPass, vk::Framebuffer, vk::ImageView, vk::Image, vk::Buffer, vk::DeviceMemory,
+			vk::CommandPool, vk::DescriptorPool, vk::QueryPool, vk::Semaphore, vk::Fence>;
+
+		ReleaseQueue( const ReleaseQueue& ) = delete;
+		ReleaseQueue& operator=( const ReleaseQueue& ) = delete;
+
+		ReleaseQueue() = default;
+		~ReleaseQueue();
+
+		/// <summary>
+		/// has to be called before the first command of a frame is recorded
+		/// </summary>
+		/// <returns>index of the new frame, passed to complete_frame after its fence signaled</returns>
+		UINT64 begin_frame();
+
+		/// <summary>
+		/// destroys the handle once every frame recorded until now is complete or dropped, null handles are ignored
+		/// </summary>
+		void retire( const Handle& handle );
+
+		/// <summary>
+		/// destroys all handles retired up to this frame, frames are submitted in order, so all older frames are complete or were never submitted
+		/// </summary>
+		void complete_frame( UINT64 frame_index );
+
+		/// <summary>
+		/// waits for the device and destroys all handles
+		/// </summary>
+		void release_all();
+
+		/// <summary>
+		/// number of handles retired until now, recorded command buffers are invalid once a used handle is destroyed
+		/// </summary>
+		UINT64 get_retired_count() const;
+
+	private:
+		struct RetiredHandle
+		{
+			UINT64 frame_index = 0;
+			Handle handle;
+		};
+
+		mutable std::mutex queue_mutex;
+		std::deque<RetiredHandle> retired_handles;
+		UINT64 recorded_frame = 0;
+		UINT64 completed_frame = 0;
+		UINT64 retired_count = 0;
+
+		static void destroy( const Handle& handle );
+	};
+}
@@ -1,6 +1,7 @@
 #include "RenderPassDescription.hpp"
 
 #include <renderer/GameGraphicEngine.hpp>
+#include <renderer/ReleaseQueue.hpp>
 #include <tools/ResultHandler.hpp>
 
 std::size_t noxcain::RenderPassDescription::get_attachment_count() const
@@ -125,8 +126,8 @@ vk::RenderPass noxcain::RenderPassDescription::get_render_pass()
 	ResultHandler<vk::Result> result_handler( vk::Result::eSuccess );
 	if( outdated || !last_render_pass )
 	{
-		GraphicEngine::get_device().waitIdle();
-		GraphicEngine::get_device().destroy( last_render_pass );
+		// frames in flight may still use the old render pass
+		GraphicEngine::get_release_queue().retire( last_render_pass );
 		last_render_pass = vk::RenderPass();
 
 		last_attachment_count = 0;
@@ -267,16 +268,7 @@ vk::RenderPass noxcain::RenderPassDescription::get_render_pass()
 
 noxcain::RenderPassDescription::~RenderPassDescription()
 {	
-	vk::Device device = GraphicEngine::get_device();
-	if( device )
-	{
-		ResultHandler r_handler( vk::Result::eSuccess );
-		r_handler << GraphicEngine::get_device().waitIdle();
-		if( r_handler.all_okay() )
-		{
-			GraphicEngine::get_device().destroyRenderPass( last_render_pass );
-		}
-	}
+	GraphicEngine::get_release_queue().retire( last_render_pass );
 }
 
 noxcain::RenderPassDescription::operator bool() const
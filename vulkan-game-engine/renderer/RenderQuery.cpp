@@ -1,26 +1,171 @@
 #include "RenderQuery.hpp"
 
 #include <renderer/GameGraphicEngine.hpp>
+#include <renderer/ReleaseQueue.hpp>
 #include <tools/ResultHandler.hpp>
 
+#include <algorithm>
+
 noxcain::RenderQuery::RenderQuery()
 {
 	ResultHandler result_handler( vk::Result::eSuccess );
 	const vk::Device& device = GraphicEngine::get_device();
+	const vk::PhysicalDevice physical_device = GraphicEngine::get_physical_device();
 
-	timestamp_pool = result_handler << device.createQueryPool( vk::QueryPoolCreateInfo( vk::QueryPoolCreateFlags(), vk::QueryType::eTimestamp, TIMESTAMP_COUNT ) );
+	const auto queue_families = physical_device.getQueueFamilyProperties();
+	const UINT32 valid_bits = queue_families[GraphicEngine::get_graphic_queue_family_index()].timestampValidBits;
+	if( !valid_bits )
+	{
+		return;
+	}
+	timestamp_mask = valid_bits >= 64 ? ~UINT64( 0 ) : ( UINT64( 1 ) << valid_bits ) - 1;
+	timestamp_period = physical_device.getProperties().limits.timestampPeriod;
+
+	// a begin and an end query per zone
+	for( vk::QueryPool& pool : timestamp_pools )
+	{
+		pool = result_handler << device.createQueryPool( vk::QueryPoolCreateInfo( vk::QueryPoolCreateFlags(), vk::QueryType::eTimestamp, 2 * MAX_ZONE_COUNT ) );
+	}
+
+	if( !result_handler.all_okay() )
+	{
+		for( vk::QueryPool& pool : timestamp_pools )
+		{
+			device.destroyQueryPool( pool );
+			pool = vk::QueryPool();
+		}
+	}
 }
 
 noxcain::RenderQuery::~RenderQuery()
 {
-	const vk::Device& device = GraphicEngine::get_device();
-	if( device )
+	// frames in flight may still write their timestamps
+	for( const vk::QueryPool& pool : timestamp_pools )
+	{
+		GraphicEngine::get_release_queue().retire( pool );
+	}
+}
+
+noxcain::RenderQuery::ZoneId noxcain::RenderQuery::register_zone( const std::string& name, DOUBLE red, DOUBLE green, DOUBLE blue )
+{
+	std::unique_lock lock( zone_mutex );
+	for( ZoneId zone = 0; zone < zones.size(); ++zone )
+	{
+		if( zones[zone].name == name )
+		{
+			return zone;
+		}
+	}
+	zones.push_back( { name, TimeFrameZone( name, red, green, blue, 0.8 ) } );
+	return ZoneId( zones.size() - 1 );
+}
+
+vk::QueryPool noxcain::RenderQuery::get_timestamp_pool( std::size_t buffer_id ) const
+{
+	return buffer_id < timestamp_pools.size() ? timestamp_pools[buffer_id] : vk::QueryPool();
+}
+
+void noxcain::RenderQuery::reset_zones( const vk::CommandBuffer& command_buffer, std::size_t buffer_id ) const
+{
+	const vk::QueryPool pool = get_timestamp_pool( buffer_id );
+	if( pool )
+	{
+		command_buffer.resetQueryPool( pool, 0, 2 * MAX_ZONE_COUNT );
+	}
+}
+
+void noxcain::RenderQuery::begin_zone( const vk::CommandBuffer& command_buffer, std::size_t buffer_id, ZoneId zone ) const
+{
+	if( is_valid( buffer_id, zone ) )
+	{
+		command_buffer.writeTimestamp( vk::PipelineStageFlagBits::eBottomOfPipe, timestamp_pools[buffer_id], 2 * zone );
+	}
+}
+
+void noxcain::RenderQuery::end_zone( const vk::CommandBuffer& command_buffer, std::size_t buffer_id, ZoneId zone ) const
+{
+	if( is_valid( buffer_id, zone ) )
+	{
+		command_buffer.writeTimestamp( vk::PipelineStageFlagBits::eBottomOfPipe, timestamp_pools[buffer_id], 2 * zone + 1 );
+	}
+}
+
+std::chrono::nanoseconds noxcain::RenderQuery::collect_zones( std::size_t buffer_id, const debugTimePoint& end_time )
+{
+	const vk::QueryPool pool = get_timestamp_pool( buffer_id );
+	if( !pool )
+	{
+		return std::chrono::nanoseconds::zero();
+	}
+
+	std::unique_lock lock( zone_mutex );
+	const UINT32 zone_count = std::min<UINT32>( UINT32( zones.size() ), MAX_ZONE_COUNT );
+	if( !zone_count )
+	{
+		return std::chrono::nanoseconds::zero();
+	}
+
+	// every query returns its value and its availability, zones that were not recorded this frame stay unavailable
+	std::array<UINT64, 4 * MAX_ZONE_COUNT> results = {};
+	const vk::Result result = GraphicEngine::get_device().getQueryPoolResults( pool, 0, 2 * zone_count, vk::ArrayProxy<UINT64>( 4 * zone_count, results.data() ), 2 * sizeof( UINT64 ),
+																			   vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWithAvailability );
+	if( result != vk::Result::eSuccess && result != vk::Result::eNotReady )
+	{
+		return std::chrono::nanoseconds::zero();
+	}
+
+	struct ZoneTime
 	{
-		ResultHandler<vk::Result> r_handle( vk::Result::eSuccess );
-		r_handle << device.waitIdle();
-		if( r_handle.all_okay() )
+		ZoneId zone;
+		UINT64 begin;
+		UINT64 end;
+	};
+	std::vector<ZoneTime> zone_times;
+	UINT64 latest_time = 0;
+	for( ZoneId zone = 0; zone < zone_count; ++zone )
+	{
+		if( results[4 * zone + 1] && results[4 * zone + 3] )
 		{
-			device.destroyQueryPool( timestamp_pool );
+			const UINT64 begin = results[4 * zone] & timestamp_mask;
+			const UINT64 end = results[4 * zone + 2] & timestamp_mask;
+			if( end >= begin )
+			{
+				zone_times.push_back( { zone, begin, end } );
+				latest_time = std::max( latest_time, end );
+			}
 		}
 	}
+
+	// the debug view expects the time frames of a collection in order
+	std::sort( zone_times.begin(), zone_times.end(), []( const ZoneTime& first, const ZoneTime& second ) { return first.begin < second.begin; } );
+
+	for( const ZoneTime& zone_time : zone_times )
+	{
+		const Zone& zone = zones[zone_time.zone];
+		time_collection.add_time_frame(
+			end_time - std::chrono::nanoseconds( UINT64( timestamp_period * ( latest_time - zone_time.begin ) ) ),
+			end_time - std::chrono::nanoseconds( UINT64( timestamp_period * ( latest_time - zone_time.end ) ) ),
+			zone.time_frame_zone );
+	}
+
+	if( zone_times.empty() )
+	{
+		return std::chrono::nanoseconds::zero();
+	}
+	return std::chrono::nanoseconds( UINT64( timestamp_period * ( latest_time - zone_times.front().begin ) ) );
+}
+
+bool noxcain::RenderQuery::is_valid( std::size_t buffer_id, ZoneId zone ) const
+{
+	return zone < MAX_ZONE_COUNT && get_timestamp_pool( buffer_id );
+}
+
+noxcain::GpuZone::GpuZone( const vk::CommandBuffer& command_buffer, std::size_t buffer_id, RenderQuery::ZoneId zone ) : command_buffer( command_buffer ), buffer_id( buffer_id ), zone( zone )
+{
+	GraphicEngine::get_render_query().begin_zone( command_buffer, buffer_id, zone );
+}
+
+noxcain::GpuZone::~GpuZone()
+{
+	GraphicEngine::get_render_query().end_zone( command_buffer, buffer_id, zone );
 }
@@ -1,42 +1,96 @@
 #pragma once
 #include <Defines.hpp>
 
+#include <renderer/GraphicEngineConstants.hpp>
+#include <tools/TimeFrame.hpp>
+
 #include <vulkan/vulkan.hpp>
 
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <string>
 #include <vector>
 
 namespace noxcain
 {
-	
-	
+	/// <summary>
+	/// gpu timestamp zones, every record ring slot has its own query pool which is only read after the fence of its frame signaled
+	/// </summary>
 	class RenderQuery
 	{
 	public:
+		using ZoneId = UINT32;
+		static constexpr UINT32 MAX_ZONE_COUNT = 32;
 
-		enum class TimeStampIds : UINT32
-		{
-			START,
-			AFTER_GEOMETRY,
-			AFTER_GLYPHS,
-			AFTER_SHADING,
-			BEFOR_POST,
-			AFTER_POST,
-			BEFOR_OVERLAY,
-			AFTER_OVERLAY,
-			END
-		};
-		static constexpr UINT32 TIMESTAMP_COUNT = (UINT32)TimeStampIds::END + 1;
-
+		RenderQuery( const RenderQuery& ) = delete;
+		RenderQuery& operator=( const RenderQuery& ) = delete;
 
 		RenderQuery();
 		~RenderQuery();
 
-		vk::QueryPool get_timestamp_pool() const
+		/// <summary>
+		/// declares a named zone, the same name always gets the same id, zones past MAX_ZONE_COUNT are never written
+		/// </summary>
+		ZoneId register_zone( const std::string& name, DOUBLE red, DOUBLE green, DOUBLE blue );
+
+		/// <summary>
+		/// query pool of the record ring slot, null if the graphic queue has no timestamps
+		/// </summary>
+		vk::QueryPool get_timestamp_pool( std::size_t buffer_id ) const;
+
+		/// <summary>
+		/// has to be recorded before all zones of the frame
+		/// </summary>
+		void reset_zones( const vk::CommandBuffer& command_buffer, std::size_t buffer_id ) const;
+
+		/// <summary>
+		/// the start is written once all previous commands are complete, so zones of one queue do not overlap
+		/// </summary>
+		void begin_zone( const vk::CommandBuffer& command_buffer, std::size_t buffer_id, ZoneId zone ) const;
+		void end_zone( const vk::CommandBuffer& command_buffer, std::size_t buffer_id, ZoneId zone ) const;
+
+		/// <summary>
+		/// adds all zones written by the frame to the time frame collection, never waits for results
+		/// </summary>
+		/// <param name="end_time">time the frame fence was seen signaled, the latest timestamp is placed there</param>
+		/// <returns>time from the first zone start to the last zone end, zero without timestamps</returns>
+		std::chrono::nanoseconds collect_zones( std::size_t buffer_id, const debugTimePoint& end_time );
+
+	private:
+		struct Zone
 		{
-			return timestamp_pool;
-		}
+			std::string name;
+			TimeFrameZone time_frame_zone;
+		};
+
+		mutable std::mutex zone_mutex;
+		std::vector<Zone> zones;
+
+		std::array<vk::QueryPool, RECORD_RING_SIZE> timestamp_pools = {};
+		DOUBLE timestamp_period = 1.0;
+		UINT64 timestamp_mask = 0;
+
+		TimeFrameCollector time_collection = TimeFrameCollector( "GPU Zones" );
+
+		bool is_valid( std::size_t buffer_id, ZoneId zone ) const;
+	};
+
+	/// <summary>
+	/// writes a zone around all commands recorded during its lifetime
+	/// </summary>
+	class GpuZone
+	{
+	public:
+		GpuZone( const GpuZone& ) = delete;
+		GpuZone& operator=( const GpuZone& ) = delete;
+
+		GpuZone( const vk::CommandBuffer& command_buffer, std::size_t buffer_id, RenderQuery::ZoneId zone );
+		~GpuZone();
 
 	private:
-		vk::QueryPool timestamp_pool;
+		const vk::CommandBuffer command_buffer;
+		const std::size_t buffer_id;
+		const RenderQuery::ZoneId zone;
 	};
-}
\ No newline at end of file
+}
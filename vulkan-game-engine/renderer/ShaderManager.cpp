@@ -47,6 +47,7 @@ bool noxcain::ShaderManager::initialize() noexcept( false )
 	all_okay = all_okay && set( VertexShaderIds::LABEL, createShader( SHADER_ARRAY( vertex_shader_label ) ) );
 
 	all_okay = all_okay && set( FragmentShaderIds::GLYPH_CONTOUR_2D, createShader( SHADER_ARRAY( fragment_shader_glyph_contour_2D ) ) );
+	all_okay = all_okay && set( FragmentShaderIds::GLYPH_ATLAS_2D, createShader( SHADER_ARRAY( fragment_shader_glyph_atlas_2D ) ) );
 	all_okay = all_okay && set( FragmentShaderIds::GLYPH_CONTOUR_3D, createShader( SHADER_ARRAY( fragment_shader_glyph_contour_3D ) ) );
 	all_okay = all_okay && set( FragmentShaderIds::FINALIZE, createShader( SHADER_ARRAY( fragment_shader_finalize ) ) );
 	all_okay = all_okay && set( FragmentShaderIds::DEFERRED_GEOMETRY, createShader( SHADER_ARRAY( fragment_shader_deferred_geometry ) ) );
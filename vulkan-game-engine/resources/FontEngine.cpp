@@ -6,8 +6,78 @@
 #include <array>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <limits>
 
-void noxcain::FontEngine::createUnicodeMap( ResourceFile& font_file, UINT32 offset )
+namespace
+{
+	using noxcain::FLOAT32;
+	using noxcain::UINT32;
+
+	// unsigned key in the order of the float, negative values are inverted and positive values get the sign bit
+	UINT32 float_order_key( FLOAT32 value )
+	{
+		UINT32 bits = 0;
+		std::memcpy( &bits, &value, sizeof( bits ) );
+		return ( bits & 0x80000000u ) ? ~bits : ( bits | 0x80000000u );
+	}
+
+	// below this size the fixed cost of the radix passes is higher than a comparison sort
+	constexpr std::size_t RADIX_SORT_MIN_SIZE = 64;
+
+	// radix sort over the bytes of a float key, the band search sorts the curve extents of every glyph several times
+	// and a comparison sort spends most of that time in mispredicted branches
+	template<typename T, typename Key>
+	void radix_sort( std::vector<T>& values, std::vector<T>& buffer, Key key )
+	{
+		if( values.size() < RADIX_SORT_MIN_SIZE )
+		{
+			std::sort( values.begin(), values.end(), [&key]( const T& value1, const T& value2 )
+			{
+				return key( value1 ) < key( value2 );
+			} );
+			return;
+		}
+
+		std::array<std::array<UINT32, 256>, 4> counts = {};
+		for( const T& value : values )
+		{
+			const UINT32 order = float_order_key( key( value ) );
+			for( std::size_t digit = 0; digit < counts.size(); ++digit )
+			{
+				++counts[digit][( order >> ( 8 * digit ) ) & 0xFF];
+			}
+		}
+
+		buffer.resize( values.size() );
+		for( std::size_t digit = 0; digit < counts.size(); ++digit )
+		{
+			std::array<UINT32, 256>& positions = counts[digit];
+			const UINT32 shift = UINT32( 8 * digit );
+
+			// nothing to do if all values share this byte
+			if( positions[( float_order_key( key( values.front() ) ) >> shift ) & 0xFF] == values.size() )
+			{
+				continue;
+			}
+
+			UINT32 position = 0;
+			for( UINT32& count : positions )
+			{
+				const UINT32 bucketSize = count;
+				count = position;
+				position += bucketSize;
+			}
+			for( const T& value : values )
+			{
+				buffer[positions[( float_order_key( key( value ) ) >> shift ) & 0xFF]++] = value;
+			}
+			values.swap( buffer );
+		}
+	}
+}
+
+bool noxcain::FontEngine::createUnicodeMap( ResourceFile& font_file, UINT32 offset )
 {
 	font_file.set_position( offset );
 
@@ -38,53 +108,57 @@ void noxcain::FontEngine::createUnicodeMap( ResourceFile& font_file, UINT32 offs
 		UINT32 searchRange = 0;
 		UINT32 entrySelector = 0;
 		UINT32 rangeShift = 0;
-		std::vector<UINT32> endCode;
-		std::vector<UINT32> startCode;
-		std::vector<UINT32> idDelta;
-		std::vector<UINT32> idRangeOffset;
+		std::vector<UINT16> endCode;
+		std::vector<UINT16> startCode;
+		std::vector<UINT16> idDelta;
+		std::vector<UINT16> idRangeOffset;
 		UINT64 glyphIdArray = 0;
 	} format4;
 
+	//the whole subtable is buffered, the glyph id lookups below jump around a lot
+	ResourceBlock subtable;
+
 	bool has_record = false;
 	for( const EncodingRecord& record : encodingRecords )
 	{
 		if( record.platformId == 3 && record.encodingId == 1 )
 		{
-			font_file.set_position( UINT64( offset ) + record.offset );
+			const UINT64 subtableOffset = UINT64( offset ) + record.offset;
+			font_file.set_position( subtableOffset );
 			format4.format = font_file.read_fundamental<UINT16>();
 			format4.length = font_file.read_fundamental<UINT16>();
-			format4.language = font_file.read_fundamental<UINT16>();
-			format4.segCountX2 = font_file.read_fundamental<UINT16>();
-			format4.searchRange = font_file.read_fundamental<UINT16>();
-			format4.entrySelector = font_file.read_fundamental<UINT16>();
-			format4.rangeShift = font_file.read_fundamental<UINT16>();
 
-			format4.endCode.resize( format4.segCountX2 / 2 );
-			for( UINT32 index = 0; index < format4.endCode.size(); ++index )
-			{
-				format4.endCode[index] = font_file.read_fundamental<UINT16>();
-			}
-			font_file.read_fundamental<UINT16>(); //reserve pad
+			subtable = font_file.read_block( subtableOffset, format4.length );
+			subtable.set_position( 2 * sizeof( UINT16 ) );
 
-			format4.startCode.resize( format4.segCountX2 / 2 );
-			for( UINT32 index = 0; index < format4.startCode.size(); ++index )
-			{
-				format4.startCode[index] = font_file.read_fundamental<UINT16>();
-			}
+			format4.language = subtable.read_fundamental<UINT16>();
+			format4.segCountX2 = subtable.read_fundamental<UINT16>();
+			format4.searchRange = subtable.read_fundamental<UINT16>();
+			format4.entrySelector = subtable.read_fundamental<UINT16>();
+			format4.rangeShift = subtable.read_fundamental<UINT16>();
 
-			format4.idDelta.resize( format4.segCountX2 / 2 );
-			for( UINT32 index = 0; index < format4.idDelta.size(); ++index )
-			{
-				format4.idDelta[index] = font_file.read_fundamental<UINT16>();
-			}
+			const std::size_t segmentCount = format4.segCountX2 / 2;
+
+			format4.endCode.resize( segmentCount );
+			bool is_complete = subtable.read_array( format4.endCode.data(), segmentCount );
+			subtable.read_fundamental<UINT16>(); //reserve pad
+
+			format4.startCode.resize( segmentCount );
+			is_complete = subtable.read_array( format4.startCode.data(), segmentCount ) && is_complete;
+
+			format4.idDelta.resize( segmentCount );
+			is_complete = subtable.read_array( format4.idDelta.data(), segmentCount ) && is_complete;
 
-			format4.idRangeOffset.resize( format4.segCountX2 / 2 );
-			for( UINT32 index = 0; index < format4.idRangeOffset.size(); ++index )
+			format4.idRangeOffset.resize( segmentCount );
+			is_complete = subtable.read_array( format4.idRangeOffset.data(), segmentCount ) && is_complete;
+
+			if( !is_complete )
 			{
-				format4.idRangeOffset[index] = font_file.read_fundamental<UINT16>();
+				//truncated subtable, the segment arrays are not usable
+				return false;
 			}
 
-			format4.glyphIdArray = font_file.get_position();
+			format4.glyphIdArray = subtable.get_position();
 			has_record = true;
 			break;
 		}
@@ -110,9 +184,9 @@ void noxcain::FontEngine::createUnicodeMap( ResourceFile& font_file, UINT32 offs
 				{
 					//get back from glyphId array to start of idRangeOffset array and then offset to current idRangOffset entry ( - segment count + segment id )
 					//next add id range offset and step back into glyph Id Array and add offset from range start ( delta( start code, unicode )
-					UINT16 glyphArrayIndex = format4.glyphIdArray + sizeof( UINT16 )*( index + segIndex - segment_count ) + format4.idRangeOffset[segIndex];
-					font_file.set_position( glyphArrayIndex );
-					UINT32 glyph_index = font_file.read_fundamental<UINT16>();
+					UINT64 glyphArrayIndex = format4.glyphIdArray + sizeof( UINT16 )*( index + segIndex - segment_count ) + format4.idRangeOffset[segIndex];
+					subtable.set_position( glyphArrayIndex );
+					UINT32 glyph_index = subtable.read_fundamental<UINT16>();
 					if( glyph_index )
 					{
 						glyph_index = ( glyph_index + format4.idDelta[segIndex] ) % 65536;
@@ -124,6 +198,7 @@ void noxcain::FontEngine::createUnicodeMap( ResourceFile& font_file, UINT32 offs
 			}
 		}
 	}
+	return true;
 }
 
 noxcain::UINT32 noxcain::FontEngine::getNumGlyphs( ResourceFile& font_file, UINT32 offset )
@@ -200,7 +275,7 @@ bool noxcain::FontEngine::isLongOffset( ResourceFile& font_file, UINT32 offset )
 	return indexToLocFormat;
 }
 
-void noxcain::FontEngine::createHorizontalMetrics( ResourceFile& font_file, UINT32 hheaOffset, UINT32 hmtxOffset )
+bool noxcain::FontEngine::createHorizontalMetrics( ResourceFile& font_file, UINT32 hheaOffset, UINT32 hmtxOffset )
 {
 	font_file.set_position( hheaOffset );
 
@@ -224,25 +299,42 @@ void noxcain::FontEngine::createHorizontalMetrics( ResourceFile& font_file, UINT
 	INT16 	metricDataFormat = font_file.read_fundamental<INT16>();
 	UINT16 	numberOfHMetrics = font_file.read_fundamental<UINT16>();
 
+	//long metrics are pairs of advance width and left bearing
+	std::vector<INT16> longMetrics( 2 * std::size_t( numberOfHMetrics ) );
 	font_file.set_position( hmtxOffset );
+	if( !font_file.read_array( longMetrics.data(), longMetrics.size() ) )
+	{
+		return false;
+	}
+
 	for( UINT32 index = 0; index < numberOfHMetrics; ++index )
 	{
-		advance_widths[index] = FLOAT32( font_file.read_fundamental<INT16>() ) / units_per_em;
-		left_bearings[index] = FLOAT32( font_file.read_fundamental<INT16>() ) / units_per_em;
+		advance_widths[index] = FLOAT32( longMetrics[2 * std::size_t( index )] ) / units_per_em;
+		left_bearings[index] = FLOAT32( longMetrics[2 * std::size_t( index ) + 1] ) / units_per_em;
 	}
 
-	for( UINT32 index = numberOfHMetrics; index < advance_widths.size(); ++index )
+	if( numberOfHMetrics < advance_widths.size() )
 	{
-		advance_widths[index] = advance_widths[numberOfHMetrics - 1];
-		left_bearings[index] = FLOAT32( font_file.read_fundamental<INT16>() ) / units_per_em;
+		std::vector<INT16> leftBearings( advance_widths.size() - numberOfHMetrics );
+		if( !font_file.read_array( leftBearings.data(), leftBearings.size() ) )
+		{
+			return false;
+		}
+
+		for( UINT32 index = numberOfHMetrics; index < advance_widths.size(); ++index )
+		{
+			advance_widths[index] = advance_widths[numberOfHMetrics - 1];
+			left_bearings[index] = FLOAT32( leftBearings[index - numberOfHMetrics] ) / units_per_em;
+		}
 	}
+	return true;
 }
 
 void noxcain::FontEngine::createVerticalMetrics( ResourceFile& font_file, UINT32 vheaOffset, UINT32 vmtxOffset )
 {
 }
 
-void noxcain::FontEngine::computeGlyph( ResourceFile& font_file, UINT32 tableOffset, const std::vector<UINT32>& glyphOffsets )
+void noxcain::FontEngine::computeGlyph( ResourceBlock& glyph_table, const std::vector<UINT32>& glyphOffsets )
 {
 	struct RawSimpleGlyph
 	{
@@ -280,49 +372,392 @@ void noxcain::FontEngine::computeGlyph( ResourceFile& font_file, UINT32 tableOff
 		}
 	};
 
-	auto fillBand = []( const std::vector<FLOAT32>& curvePoints, const std::vector<UINT32>& curveStartOffsets, std::vector<Band>& bands, UINT32 offsetOffset, FLOAT32* corners )
+	struct BandLayout
 	{
-		const FLOAT32 glyphWidth = std::abs( corners[offsetOffset] - corners[offsetOffset + 2] );
-		const FLOAT32 bandWidth = glyphWidth / bands.size();
-		
-		UINT32 nBands = bands.size();
-		UINT32 nCurves = 0;
-		FLOAT32 lastEnd = corners[offsetOffset];
-		for( UINT32 bandIndex = 0; bandIndex < bands.size()-1; ++bandIndex )
-		{	
-			lastEnd = bands[bandIndex].end = lastEnd + bandWidth;
-		}
-		UINT32 maxFloate32;
+		UINT32 bandCount = 0;
+		UINT32 curveCount = 0;
+		UINT32 maxCurveCount = 0;
+		// curve count of each band weighted with its share of the glyph extent
+		DOUBLE coveredCurveCount = 0;
+	};
 
-		// the end of the last band technical doesent matter
-		// when a curtve doesent fit in another band it ends in the last automatically
-		bands.back().end = corners[offsetOffset + 2] + bandWidth;
+	// the extent of a curve on both axes
+	struct CurveBounds
+	{
+		std::array<FLOAT32, 2> min = {};
+		std::array<FLOAT32, 2> max = {};
+		UINT32 offset = 0;
+	};
+
+	// a curve with its maximum on one axis, sorted these are the curve ends of this axis
+	// and in reverse the order in which the bands of the other axis test their curves
+	struct CurveMax
+	{
+		FLOAT32 value = 0;
+		UINT32 curve = 0;
+	};
+
+	// a band end with the number of curves started and ended until it
+	struct BandEnd
+	{
+		FLOAT32 value = 0;
+		UINT32 started = 0;
+		UINT32 ended = 0;
+	};
 
+	struct Split
+	{
+		DOUBLE gain = 0;
+		BandEnd end;
+	};
+
+	// working memory of sortCurves and fillBand, it is kept for all glyphs so the band search does not allocate per glyph
+	struct BandScratch
+	{
+		std::vector<CurveBounds> curves;
+		std::array<std::vector<CurveMax>, 2> maxOrders;
+		std::vector<CurveMax> maxBuffer;
+		std::vector<FLOAT32> curveStarts;
+		// the largest value below each curve start, a band ending there excludes the curve
+		std::vector<FLOAT32> curveStartsBelow;
+		std::vector<FLOAT32> curveEnds;
+		std::vector<BandEnd> ends;
+		// possible band ends inside the glyph
+		std::vector<BandEnd> candidates;
+		std::vector<Split> splits;
+		std::vector<FLOAT32> valueBuffer;
+	} bandScratch;
+
+	// both axes of a glyph share the curve bounds and the curve orders by maximum
+	auto sortCurves = [&bandScratch]( const std::vector<FLOAT32>& curvePoints, const std::vector<UINT32>& curveStartOffsets )
+	{
+		std::vector<CurveBounds>& curves = bandScratch.curves;
+		curves.clear();
 		for( UINT32 offset : curveStartOffsets )
 		{
-			FLOAT32 v1 = curvePoints[std::size_t( offset ) + offsetOffset];
-			FLOAT32 v2 = curvePoints[std::size_t( offset ) + offsetOffset + 2];
-			FLOAT32 v3 = curvePoints[std::size_t( offset ) + offsetOffset + 4];
-			if( v1 == v2 && v2 == v3 )
+			CurveBounds& curve = curves.emplace_back();
+			curve.offset = offset;
+			for( std::size_t axis = 0; axis < 2; ++axis )
 			{
-				continue;
+				const FLOAT32 v1 = curvePoints[std::size_t( offset ) + axis];
+				const FLOAT32 v2 = curvePoints[std::size_t( offset ) + axis + 2];
+				const FLOAT32 v3 = curvePoints[std::size_t( offset ) + axis + 4];
+				curve.min[axis] = std::min( v1, std::min( v2, v3 ) );
+				curve.max[axis] = std::max( v1, std::max( v2, v3 ) );
 			}
+		}
 
-			for( UINT32 bandIndex = 0; bandIndex < bands.size(); ++bandIndex )
+		for( std::size_t axis = 0; axis < 2; ++axis )
+		{
+			std::vector<CurveMax>& maxOrder = bandScratch.maxOrders[axis];
+			maxOrder.resize( curves.size() );
+			for( UINT32 curveIndex = 0; curveIndex < curves.size(); ++curveIndex )
 			{
-				Band& band = bands[bandIndex];
-				if( v1 > band.end && v2 > band.end && v3 > band.end )
+				maxOrder[curveIndex] = { curves[curveIndex].max[axis], curveIndex };
+			}
+			radix_sort( maxOrder, bandScratch.maxBuffer, []( const CurveMax& curveMax )
+			{
+				return curveMax.value;
+			} );
+		}
+	};
+
+	// band boundaries follow the curve extents, first the fewest bands are placed so that the largest band holds as few curves as possible,
+	// then expensive bands are split while it pays off, so every glyph gets its own band count up to MAX_BAND_COUNT
+	// the curve starts and ends are sorted once, the curve count of any band is the difference of two prefix counts
+	// curves without extent on the axis never cross a band boundary on it and are left out
+	auto fillBand = [&bandScratch]( std::vector<Band>& bands, UINT32 offsetOffset, const FLOAT32* corners )
+	{
+		const std::vector<CurveBounds>& curves = bandScratch.curves;
+		std::vector<FLOAT32>& curveStarts = bandScratch.curveStarts;
+		std::vector<FLOAT32>& curveStartsBelow = bandScratch.curveStartsBelow;
+		std::vector<FLOAT32>& curveEnds = bandScratch.curveEnds;
+		curveStarts.clear();
+		for( const CurveBounds& curve : curves )
+		{
+			if( curve.min[offsetOffset] != curve.max[offsetOffset] )
+			{
+				curveStarts.push_back( curve.min[offsetOffset] );
+			}
+		}
+		curveEnds.clear();
+		for( const CurveMax& curveMax : bandScratch.maxOrders[offsetOffset] )
+		{
+			if( curves[curveMax.curve].min[offsetOffset] != curveMax.value )
+			{
+				curveEnds.push_back( curveMax.value );
+			}
+		}
+
+		const FLOAT32 glyphStart = corners[offsetOffset];
+		const FLOAT32 glyphEnd = corners[offsetOffset + 2];
+		const FLOAT32 glyphWidth = std::abs( glyphEnd - glyphStart );
+		const std::size_t extentCount = curveStarts.size();
+
+		// a curve ending before the band start also started before the band end,
+		// so the curves of ( bandStart, bandEnd ] are the curves started until bandEnd minus the curves ended until bandStart
+		radix_sort( curveStarts, bandScratch.valueBuffer, []( FLOAT32 value )
+		{
+			return value;
+		} );
+		curveStartsBelow.resize( extentCount );
+		for( std::size_t index = 0; index < extentCount; ++index )
+		{
+			curveStartsBelow[index] = std::nextafter( curveStarts[index], -std::numeric_limits<FLOAT32>::max() );
+		}
+
+		// greedy sweep, every band ends right before the curve start which would exceed maxCurves
+		// the last band is open ended
+		auto partition = [&curveStarts, &curveStartsBelow, &curveEnds, extentCount]( UINT32 maxCurves, std::vector<BandEnd>& ends )
+		{
+			ends.clear();
+			std::size_t nextCurve = 0;
+			// curves started in an earlier band and not ended before the current band
+			std::size_t carried = 0;
+			while( nextCurve < extentCount )
+			{
+				if( ends.size() == FontEngine::MAX_BAND_COUNT || carried >= maxCurves )
 				{
-					continue;
+					return false;
 				}
 
-				band.curveOffsets.push_back( offset );
-				++nCurves;
+				// curves starting at the same position can not be separated, so the band ends at the start of the cut group
+				std::size_t bandEnd = std::min( extentCount, nextCurve + ( maxCurves - carried ) );
+				if( bandEnd < extentCount && curveStarts[bandEnd] == curveStarts[bandEnd - 1] )
+				{
+					bandEnd = std::lower_bound( curveStarts.begin() + nextCurve, curveStarts.begin() + bandEnd, curveStarts[bandEnd] ) - curveStarts.begin();
+				}
+
+				if( bandEnd == nextCurve )
+				{
+					return false;
+				}
+
+				if( bandEnd < extentCount )
+				{
+					// the band ends right before a curve start, all curves before it started and the curves ending before it ended
+					const std::size_t searchStart = ends.empty() ? 0 : ends.back().ended;
+					const std::size_t ended = std::lower_bound( curveEnds.begin() + searchStart, curveEnds.end(), curveStarts[bandEnd] ) - curveEnds.begin();
+					ends.push_back( { curveStartsBelow[bandEnd], UINT32( bandEnd ), UINT32( ended ) } );
+					carried = bandEnd - std::min( bandEnd, ended );
+				}
+				else
+				{
+					ends.push_back( { std::numeric_limits<FLOAT32>::max(), UINT32( extentCount ), UINT32( extentCount ) } );
+				}
+				nextCurve = bandEnd;
+			}
+			if( ends.empty() )
+			{
+				ends.push_back( { std::numeric_limits<FLOAT32>::max(), 0, 0 } );
+			}
+			return true;
+		};
+
+		// a single band with all curves is always possible, so search the smallest possible maximum
+		std::vector<BandEnd>& ends = bandScratch.ends;
+		// every curve is in at least one band and a band holds at least all curves crossing one of its points
+		std::size_t crossingCurves = 0;
+		std::size_t endedCurves = 0;
+		for( std::size_t startedCurves = 1; startedCurves <= extentCount; ++startedCurves )
+		{
+			if( startedCurves < extentCount && curveStarts[startedCurves] == curveStarts[startedCurves - 1] )
+			{
+				continue;
+			}
+			while( curveEnds[endedCurves] < curveStarts[startedCurves - 1] )
+			{
+				++endedCurves;
+			}
+			crossingCurves = std::max( crossingCurves, startedCurves - endedCurves );
+		}
+		UINT32 lowerLimit = std::max<UINT32>( 1, UINT32( ( extentCount + FontEngine::MAX_BAND_COUNT - 1 ) / FontEngine::MAX_BAND_COUNT ) );
+		lowerLimit = std::max<UINT32>( lowerLimit, UINT32( crossingCurves ) );
+		UINT32 upperLimit = std::max<UINT32>( 1, UINT32( extentCount ) );
+
+		// the maximum is mostly close to the lower limit, so the search gallops upwards from it before bisecting
+		UINT32 step = 1;
+		bool galloping = true;
+		bool lastFits = false;
+		while( lowerLimit < upperLimit )
+		{
+			const UINT32 maxCurves = galloping ? std::min( lowerLimit + step - 1, upperLimit - 1 ) : lowerLimit + ( upperLimit - lowerLimit ) / 2;
+			lastFits = partition( maxCurves, ends );
+			if( lastFits )
+			{
+				upperLimit = maxCurves;
+				galloping = false;
+			}
+			else
+			{
+				lowerLimit = maxCurves + 1;
+				step *= 2;
+			}
+		}
+		if( !lastFits )
+		{
+			partition( upperLimit, ends );
+		}
 
-				if( v1 <= band.end && v2 <= band.end && v3 <= band.end )
+		// expected curve tests of a band, its curve count weighted with its share of the glyph
+		const DOUBLE glyphShare = glyphWidth > 0 ? 1.0 / glyphWidth : 0.0;
+		auto bandShare = [glyphStart, glyphEnd, glyphShare]( std::size_t count, FLOAT32 bandStart, FLOAT32 bandEnd, bool isFirst )
+		{
+			const FLOAT32 start = isFirst ? glyphStart : std::clamp( bandStart, glyphStart, glyphEnd );
+			const FLOAT32 end = std::clamp( bandEnd, glyphStart, glyphEnd );
+			return glyphShare > 0 ? DOUBLE( count ) * ( end - start ) * glyphShare : DOUBLE( count );
+		};
+
+		// the first band has no start, all curves started until its end are in it
+		const BandEnd glyphBegin =
+		{
+			glyphStart,
+			UINT32( std::upper_bound( curveStarts.begin(), curveStarts.end(), glyphStart ) - curveStarts.begin() ),
+			UINT32( std::upper_bound( curveEnds.begin(), curveEnds.end(), glyphStart ) - curveEnds.begin() )
+		};
+
+		// the remaining bands split the most expensive bands as long as a sample saves enough curve tests,
+		// splitting never increases the maximum above
+		// the cost only changes right before a curve starts or at a curve end, so only these inside the glyph are candidates
+		// they are collected once with their curve counts, so a band only walks its own candidates
+		std::vector<BandEnd>& candidates = bandScratch.candidates;
+		candidates.clear();
+		{
+			std::size_t nextStart = 0;
+			std::size_t nextEnd = 0;
+			std::size_t started = 0;
+			std::size_t ended = 0;
+			while( true )
+			{
+				const FLOAT32 startCandidate = nextStart < extentCount ? curveStartsBelow[nextStart] : std::numeric_limits<FLOAT32>::infinity();
+				const FLOAT32 endCandidate = nextEnd < extentCount ? curveEnds[nextEnd] : std::numeric_limits<FLOAT32>::infinity();
+				const FLOAT32 candidate = std::min( startCandidate, endCandidate );
+				if( candidate >= glyphEnd )
 				{
 					break;
 				}
+
+				// equal candidates give the same split
+				while( nextStart < extentCount && curveStartsBelow[nextStart] <= candidate ) ++nextStart;
+				while( nextEnd < extentCount && curveEnds[nextEnd] <= candidate ) ++nextEnd;
+				while( started < extentCount && curveStarts[started] <= candidate ) ++started;
+				while( ended < extentCount && curveEnds[ended] <= candidate ) ++ended;
+
+				if( candidate > glyphStart )
+				{
+					candidates.push_back( { candidate, UINT32( started ), UINT32( ended ) } );
+				}
+			}
+		}
+
+		constexpr DOUBLE MIN_SPLIT_GAIN = 0.1;
+		auto findSplit = [&candidates, &ends, &bandShare, &glyphBegin, glyphStart, glyphEnd, glyphShare]( std::size_t bandIndex )
+		{
+			Split split;
+			const bool isFirst = bandIndex == 0;
+			const BandEnd& lower = isFirst ? glyphBegin : ends[bandIndex - 1];
+			const BandEnd& upper = ends[bandIndex];
+			const UINT32 carried = isFirst ? 0 : lower.ended;
+			const UINT32 startedInside = upper.started;
+
+			const DOUBLE cost = bandShare( startedInside - std::min( startedInside, carried ), lower.value, upper.value, isFirst );
+			if( cost <= MIN_SPLIT_GAIN )
+			{
+				return split;
+			}
+
+			// no curve ends before it started, so both halves keep a non negative curve count
+			const FLOAT32 lowerStart = isFirst ? glyphStart : std::clamp( lower.value, glyphStart, glyphEnd );
+			const FLOAT32 upperEnd = std::clamp( upper.value, glyphStart, glyphEnd );
+			auto candidate = std::upper_bound( candidates.begin(), candidates.end(), lower.value, []( FLOAT32 value, const BandEnd& bandEnd )
+			{
+				return value < bandEnd.value;
+			} );
+			for( ; candidate != candidates.end() && candidate->value < upper.value; ++candidate )
+			{
+				const DOUBLE gain = cost
+					- DOUBLE( candidate->started - carried ) * ( candidate->value - lowerStart ) * glyphShare
+					- DOUBLE( startedInside - candidate->ended ) * ( upperEnd - candidate->value ) * glyphShare;
+				if( gain > split.gain )
+				{
+					split.gain = gain;
+					split.end = *candidate;
+				}
+			}
+			return split;
+		};
+
+		// a split only changes the two new bands, the best splits of all other bands stay valid
+		std::vector<Split>& splits = bandScratch.splits;
+		splits.clear();
+		for( std::size_t bandIndex = 0; bandIndex < ends.size(); ++bandIndex )
+		{
+			splits.push_back( findSplit( bandIndex ) );
+		}
+
+		while( ends.size() < FontEngine::MAX_BAND_COUNT )
+		{
+			DOUBLE bestGain = MIN_SPLIT_GAIN;
+			std::size_t bestBand = ends.size();
+			for( std::size_t bandIndex = 0; bandIndex < splits.size(); ++bandIndex )
+			{
+				if( splits[bandIndex].gain > bestGain )
+				{
+					bestGain = splits[bandIndex].gain;
+					bestBand = bandIndex;
+				}
+			}
+
+			if( bestBand == ends.size() )
+			{
+				break;
+			}
+			ends.insert( ends.begin() + bestBand, splits[bestBand].end );
+			splits.insert( splits.begin() + bestBand, Split() );
+			splits[bestBand] = findSplit( bestBand );
+			splits[bestBand + 1] = findSplit( bestBand + 1 );
+		}
+
+		// the end of the last band technical doesent matter
+		// when a curtve doesent fit in another band it ends in the last automatically
+		ends.back().value = glyphEnd + glyphWidth;
+
+		// the bands keep their storage from the last glyph
+		// unused ends never lie below a curve, so every curve compares against all MAX_BAND_COUNT ends without branches
+		std::array<FLOAT32, FontEngine::MAX_BAND_COUNT> endValues;
+		endValues.fill( std::numeric_limits<FLOAT32>::infinity() );
+		bands.resize( ends.size() );
+		for( std::size_t bandIndex = 0; bandIndex < ends.size(); ++bandIndex )
+		{
+			endValues[bandIndex] = bands[bandIndex].end = ends[bandIndex].value;
+			bands[bandIndex].curveOffsets.clear();
+		}
+
+		// filling the bands in descending order of the maximum on the other axis leaves every band sorted for the shader
+		const std::vector<CurveMax>& keyOrder = bandScratch.maxOrders[1 - offsetOffset];
+		for( auto curveMax = keyOrder.rbegin(); curveMax != keyOrder.rend(); ++curveMax )
+		{
+			const CurveBounds& curve = curves[curveMax->curve];
+			const FLOAT32 curveStart = curve.min[offsetOffset];
+			const FLOAT32 curveEnd = curve.max[offsetOffset];
+			if( curveStart == curveEnd )
+			{
+				continue;
+			}
+
+			// a curve covers the bands from the first band ending after its start to the first band ending after its end
+			UINT32 firstBand = 0;
+			UINT32 lastBand = 0;
+			for( FLOAT32 end : endValues )
+			{
+				firstBand += end < curveStart;
+				lastBand += end < curveEnd;
+			}
+			lastBand = std::min<UINT32>( lastBand, UINT32( bands.size() - 1 ) );
+
+			for( UINT32 bandIndex = firstBand; bandIndex <= lastBand; ++bandIndex )
+			{
+				bands[bandIndex].curveOffsets.push_back( curve.offset );
 			}
 		}
 
@@ -330,26 +765,33 @@ void noxcain::FontEngine::computeGlyph( ResourceFile& font_file, UINT32 tableOff
 		{
 			if( bands[bandIndex] == bands[bandIndex - 1] )
 			{
-				nCurves -= bands[bandIndex - 1].curveOffsets.size();
-				--nBands;
 				bands[bandIndex - 1].curveOffsets.clear();
 			}
-
 		}
 
+		BandLayout layout;
+		FLOAT32 lastEnd = glyphStart;
 		for( Band& band : bands )
 		{
-			std::sort( band.curveOffsets.begin(), band.curveOffsets.end(), [&curvePoints, &offsetOffset]( UINT32 offset1, UINT32 offset2 )
+			if( band.curveOffsets.empty() )
 			{
-				UINT32 off1 = offset1 + 1 - offsetOffset;
-				UINT32 off2 = offset2 + 1 - offsetOffset;
-				return
-					std::max<FLOAT32>( curvePoints[off1], std::max<FLOAT32>( curvePoints[std::size_t( off1 ) + 2], curvePoints[std::size_t( off1 ) + 4] ) ) >
-					std::max<FLOAT32>( curvePoints[off2], std::max<FLOAT32>( curvePoints[std::size_t( off2 )+ 2], curvePoints[std::size_t( off2 ) + 4] ) );
-			} );
+				continue;
+			}
+
+			const UINT32 curveCount = UINT32( band.curveOffsets.size() );
+			++layout.bandCount;
+			layout.curveCount += curveCount;
+			layout.maxCurveCount = std::max( layout.maxCurveCount, curveCount );
+
+			const FLOAT32 bandEnd = std::min( band.end, glyphEnd );
+			if( glyphWidth > 0 && bandEnd > lastEnd )
+			{
+				layout.coveredCurveCount += DOUBLE( curveCount ) * ( bandEnd - lastEnd ) / glyphWidth;
+				lastEnd = bandEnd;
+			}
 		}
 		
-		return std::array<UINT32, 2>( { nBands, nCurves } );
+		return layout;
 	};
 
 
@@ -363,14 +805,17 @@ void noxcain::FontEngine::computeGlyph( ResourceFile& font_file, UINT32 tableOff
 		{
 			glyph_indices[glyph_index] = rawGlyphs.size();
 			
-			font_file.set_position( UINT64( tableOffset ) + glyphOffsets[glyph_index] );
+			glyph_table.set_position( glyphOffsets[glyph_index] );
 
-			const INT16 numberOfContours = font_file.read_fundamental<INT16>();
+			//number of contours followed by minX, minY, maxX, maxY
+			std::array<INT16, 5> glyphHeader;
+			glyph_table.read_array( glyphHeader.data(), glyphHeader.size() );
+			const INT16 numberOfContours = glyphHeader[0];
 
-			glyph_corners.push_back( FLOAT32( font_file.read_fundamental<INT16>() ) / units_per_em ); // minX
-			glyph_corners.push_back( FLOAT32( font_file.read_fundamental<INT16>() ) / units_per_em ); // minY
-			glyph_corners.push_back( FLOAT32( font_file.read_fundamental<INT16>() ) / units_per_em ); // maxX
-			glyph_corners.push_back( FLOAT32( font_file.read_fundamental<INT16>() ) / units_per_em ); // maxY
+			for( std::size_t corner = 1; corner < glyphHeader.size(); ++corner )
+			{
+				glyph_corners.push_back( FLOAT32( glyphHeader[corner] ) / units_per_em );
+			}
 
 			rawGlyphs.push_back( RawSimpleGlyph() );
 
@@ -378,7 +823,7 @@ void noxcain::FontEngine::computeGlyph( ResourceFile& font_file, UINT32 tableOff
 			if( numberOfContours >= 0 )
 			{
 				rawGlyphs.back().endPointIndices.resize( numberOfContours );
-				readSimpleGlyph( font_file, rawGlyphs.back().endPointIndices, rawGlyphs.back().flags, rawGlyphs.back().xCoords, rawGlyphs.back().yCoords );
+				readSimpleGlyph( glyph_table, rawGlyphs.back().endPointIndices, rawGlyphs.back().flags, rawGlyphs.back().xCoords, rawGlyphs.back().yCoords );
 			}
 			//read as Composite glyph
 			else
@@ -392,52 +837,52 @@ void noxcain::FontEngine::computeGlyph( ResourceFile& font_file, UINT32 tableOff
 					newCompositeGlyph.components.push_back( Component() );
 					Component& newComponent = newCompositeGlyph.components.back();
 
-					newComponent.flags = font_file.read_fundamental<UINT16>();
-					newComponent.index = font_file.read_fundamental<UINT16>();
+					newComponent.flags = glyph_table.read_fundamental<UINT16>();
+					newComponent.index = glyph_table.read_fundamental<UINT16>();
 
 					switch( newComponent.flags & 0x3 )
 					{
 						case 0x1:
 						{
-							newComponent.argument1 = font_file.read_fundamental<UINT16>();
-							newComponent.argument2 = font_file.read_fundamental<UINT16>();
+							newComponent.argument1 = glyph_table.read_fundamental<UINT16>();
+							newComponent.argument2 = glyph_table.read_fundamental<UINT16>();
 							break;
 						}
 						case 0x2:
 						{
-							newComponent.argument1 = font_file.read_fundamental<INT8>();
-							newComponent.argument2 = font_file.read_fundamental<INT8>();
+							newComponent.argument1 = glyph_table.read_fundamental<INT8>();
+							newComponent.argument2 = glyph_table.read_fundamental<INT8>();
 							break;
 						}
 						case 0x3:
 						{
-							newComponent.argument1 = font_file.read_fundamental<INT16>();
-							newComponent.argument2 = font_file.read_fundamental<INT16>();
+							newComponent.argument1 = glyph_table.read_fundamental<INT16>();
+							newComponent.argument2 = glyph_table.read_fundamental<INT16>();
 							break;
 						}
 						default:
 						{
-							newComponent.argument1 = font_file.read_fundamental<UINT8>();
-							newComponent.argument2 = font_file.read_fundamental<UINT8>();
+							newComponent.argument1 = glyph_table.read_fundamental<UINT8>();
+							newComponent.argument2 = glyph_table.read_fundamental<UINT8>();
 							break;
 						}
 					}
 
 					if( newComponent.flags & 0x0008 )
 					{
-						newComponent.transformation1 = newComponent.transformation4 = font_file.read_f2dot14();
+						newComponent.transformation1 = newComponent.transformation4 = glyph_table.read_f2dot14();
 					}
 					else if( newComponent.flags & 0x0040 )
 					{
-						newComponent.transformation1 = font_file.read_f2dot14();
-						newComponent.transformation4 = font_file.read_f2dot14();
+						newComponent.transformation1 = glyph_table.read_f2dot14();
+						newComponent.transformation4 = glyph_table.read_f2dot14();
 					}
 					else if( newComponent.flags & 0x0080 )
 					{
-						newComponent.transformation1 = font_file.read_f2dot14();
-						newComponent.transformation2 = font_file.read_f2dot14();
-						newComponent.transformation3 = font_file.read_f2dot14();
-						newComponent.transformation4 = font_file.read_f2dot14();
+						newComponent.transformation1 = glyph_table.read_f2dot14();
+						newComponent.transformation2 = glyph_table.read_f2dot14();
+						newComponent.transformation3 = glyph_table.read_f2dot14();
+						newComponent.transformation4 = glyph_table.read_f2dot14();
 					}
 
 					if( newComponent.flags & 0x0200 )
@@ -526,6 +971,8 @@ void noxcain::FontEngine::computeGlyph( ResourceFile& font_file, UINT32 tableOff
 	};
 
 	//rebuild glyphs 2 map
+	std::vector<Band> xBands;
+	std::vector<Band> yBands;
 	for( UINT32 rawGlyphIndex = 0; rawGlyphIndex < rawGlyphs.size(); ++rawGlyphIndex )
 	{
 		std::vector<UINT32> curveStartOffsets;
@@ -605,14 +1052,14 @@ void noxcain::FontEngine::computeGlyph( ResourceFile& font_file, UINT32 tableOff
 		glyph_corners[corner_index+2] = max_x;
 		glyph_corners[corner_index+3] = max_y;
 
-		std::vector<Band> xBands( 32 );
-		std::array<UINT32, 2> xBandCounts = fillBand( curvePoints, curveStartOffsets, xBands, 0, &glyph_corners[std::size_t( 4 ) * rawGlyphIndex] );
+		sortCurves( curvePoints, curveStartOffsets );
 
-		std::vector<Band> yBands( 32 );
-		std::array<UINT32, 2> yBandCounts = fillBand( curvePoints, curveStartOffsets, yBands, 1, &glyph_corners[std::size_t( 4 ) * rawGlyphIndex] );
+		const BandLayout xLayout = fillBand( xBands, 0, &glyph_corners[std::size_t( 4 ) * rawGlyphIndex] );
 
-		const UINT32 bandCount = std::max<UINT32>( xBandCounts[0], yBandCounts[0] );
-		const UINT32 curveCount = xBandCounts[1] + yBandCounts[1];
+		const BandLayout yLayout = fillBand( yBands, 1, &glyph_corners[std::size_t( 4 ) * rawGlyphIndex] );
+
+		const UINT32 bandCount = std::max<UINT32>( { 1, xLayout.bandCount, yLayout.bandCount } );
+		const UINT32 curveCount = xLayout.curveCount + yLayout.curveCount;
 
 		std::vector<UINT32>& currOffsetMap = offset_maps[rawGlyphIndex];
 		std::vector<FLOAT32>& currPointMap = point_maps[rawGlyphIndex];
@@ -659,31 +1106,39 @@ void noxcain::FontEngine::computeGlyph( ResourceFile& font_file, UINT32 tableOff
 				++currentBandIndex;
 			}
 		}
+
+		const std::size_t glyphSize = currOffsetMap.size() * sizeof( UINT32 ) + currPointMap.size() * sizeof( FLOAT32 );
+		band_statistics.band_count += xLayout.bandCount + yLayout.bandCount;
+		band_statistics.max_curves_per_band = std::max( { band_statistics.max_curves_per_band, xLayout.maxCurveCount, yLayout.maxCurveCount } );
+		band_statistics.average_curves_per_band += curveCount;
+		band_statistics.average_curves_per_sample += xLayout.coveredCurveCount + yLayout.coveredCurveCount;
+		band_statistics.average_bytes_per_glyph += DOUBLE( glyphSize );
+		band_statistics.max_bytes_per_glyph = std::max( band_statistics.max_bytes_per_glyph, glyphSize );
 	}
-}
 
-void noxcain::FontEngine::readSimpleGlyph( ResourceFile& font_file, std::vector<UINT16>& endPointIndices, std::vector<BYTE>& flags, std::vector<DOUBLE>& xCoords, std::vector<DOUBLE>& yCoords )
-{
-	for( UINT32 index = 0; index < endPointIndices.size(); ++index )
+	if( glyph_count )
 	{
-		endPointIndices[index] = font_file.read_fundamental<UINT16>();
+		band_statistics.average_curves_per_band /= std::max<UINT32>( 1, band_statistics.band_count );
+		band_statistics.average_curves_per_sample /= glyph_count;
+		band_statistics.average_bytes_per_glyph /= glyph_count;
 	}
+}
 
-	UINT16 instructionLength = font_file.read_fundamental<UINT16>();
-	std::vector<BYTE> instructions( instructionLength );
+void noxcain::FontEngine::readSimpleGlyph( ResourceBlock& glyph_table, std::vector<UINT16>& endPointIndices, std::vector<BYTE>& flags, std::vector<DOUBLE>& xCoords, std::vector<DOUBLE>& yCoords )
+{
+	glyph_table.read_array( endPointIndices.data(), endPointIndices.size() );
 
-	for( UINT32 index = 0; index < instructions.size(); ++index )
-	{
-		instructions[index] = font_file.read_fundamental<BYTE>();
-	}
+	//instructions are not used
+	UINT16 instructionLength = glyph_table.read_fundamental<UINT16>();
+	glyph_table.set_position( glyph_table.get_position() + instructionLength );
 
 	while( flags.size() < std::size_t( endPointIndices.back() ) + 1 )
 	{
-		BYTE flag = font_file.read_fundamental<BYTE>();
+		BYTE flag = glyph_table.read_fundamental<BYTE>();
 		flags.push_back( flag );
 		if( flag & 0x08 )
 		{
-			BYTE count = font_file.read_fundamental<BYTE>();
+			BYTE count = glyph_table.read_fundamental<BYTE>();
 			while( count-- )
 			{
 				flags.push_back( flag );
@@ -700,7 +1155,7 @@ void noxcain::FontEngine::readSimpleGlyph( ResourceFile& font_file, std::vector<
 		{
 			case 0x02:
 			{
-				xCoords.push_back( lastValue - font_file.read_fundamental<BYTE>() );
+				xCoords.push_back( lastValue - glyph_table.read_fundamental<BYTE>() );
 				break;
 			}
 			case 0x10:
@@ -710,12 +1165,12 @@ void noxcain::FontEngine::readSimpleGlyph( ResourceFile& font_file, std::vector<
 			}
 			case 0x12:
 			{
-				xCoords.push_back( lastValue + font_file.read_fundamental<BYTE>() );
+				xCoords.push_back( lastValue + glyph_table.read_fundamental<BYTE>() );
 				break;
 			}
 			default:
 			{
-				xCoords.push_back( lastValue + font_file.read_fundamental<INT16>() );
+				xCoords.push_back( lastValue + glyph_table.read_fundamental<INT16>() );
 				break;
 			}
 		}
@@ -730,7 +1185,7 @@ void noxcain::FontEngine::readSimpleGlyph( ResourceFile& font_file, std::vector<
 		{
 			case 0x04:
 			{
-				yCoords.push_back( lastValue - font_file.read_fundamental<BYTE>() );
+				yCoords.push_back( lastValue - glyph_table.read_fundamental<BYTE>() );
 				break;
 			}
 			case 0x20:
@@ -740,12 +1195,12 @@ void noxcain::FontEngine::readSimpleGlyph( ResourceFile& font_file, std::vector<
 			}
 			case 0x24:
 			{
-				yCoords.push_back( lastValue + font_file.read_fundamental<BYTE>() );
+				yCoords.push_back( lastValue + glyph_table.read_fundamental<BYTE>() );
 				break;
 			}
 			default:
 			{
-				yCoords.push_back( lastValue + font_file.read_fundamental<INT16>() );
+				yCoords.push_back( lastValue + glyph_table.read_fundamental<INT16>() );
 				break;
 			}
 		}
@@ -756,13 +1211,15 @@ void noxcain::FontEngine::readSimpleGlyph( ResourceFile& font_file, std::vector<
 	int stop = 0;
 }
 
-void noxcain::FontEngine::readCompositeGlyph( ResourceFile& font_file )
+void noxcain::FontEngine::readCompositeGlyph( ResourceBlock& glyph_table )
 {
 	UINT16 flags = 0;
 	do
 	{
-		flags = font_file.read_fundamental<UINT16>();
-		UINT16 glyph_index = font_file.read_fundamental<UINT16>();
+		flags = glyph_table.read_fundamental<UINT16>();
+
+		// the components are not composed yet, their glyph index and transformation are only skipped
+		glyph_table.read_fundamental<UINT16>();
 
 		DOUBLE argument1;
 		DOUBLE argument2;
@@ -771,45 +1228,45 @@ void noxcain::FontEngine::readCompositeGlyph( ResourceFile& font_file )
 		{
 			case 0x1:
 			{
-				argument1 = font_file.read_fundamental<UINT16>();
-				argument2 = font_file.read_fundamental<UINT16>();
+				argument1 = glyph_table.read_fundamental<UINT16>();
+				argument2 = glyph_table.read_fundamental<UINT16>();
 				break;
 			}
 			case 0x2:
 			{
-				argument1 = font_file.read_fundamental<INT8>();
-				argument2 = font_file.read_fundamental<INT8>();
+				argument1 = glyph_table.read_fundamental<INT8>();
+				argument2 = glyph_table.read_fundamental<INT8>();
 				break;
 			}
 			case 0x3:
 			{
-				argument1 = font_file.read_fundamental<INT16>();
-				argument2 = font_file.read_fundamental<INT16>();
+				argument1 = glyph_table.read_fundamental<INT16>();
+				argument2 = glyph_table.read_fundamental<INT16>();
 				break;
 			}
 			default:
 			{
-				argument1 = font_file.read_fundamental<UINT8>();
-				argument2 = font_file.read_fundamental<UINT8>();
+				argument1 = glyph_table.read_fundamental<UINT8>();
+				argument2 = glyph_table.read_fundamental<UINT8>();
 				break;
 			}
 		}
 
 		if( flags & 0x0008 )
 		{
-			DOUBLE a1 = font_file.read_f2dot14();
+			glyph_table.read_f2dot14();
 		}
 		else if( flags & 0x0040 )
 		{
-			DOUBLE a1 = font_file.read_f2dot14();
-			DOUBLE a2 = font_file.read_f2dot14();
+			glyph_table.read_f2dot14();
+			glyph_table.read_f2dot14();
 		}
 		else if( flags & 0x0080 )
 		{
-			DOUBLE a1 = font_file.read_f2dot14();
-			DOUBLE a2 = font_file.read_f2dot14();
-			DOUBLE a3 = font_file.read_f2dot14();
-			DOUBLE a4 = font_file.read_f2dot14();
+			glyph_table.read_f2dot14();
+			glyph_table.read_f2dot14();
+			glyph_table.read_f2dot14();
+			glyph_table.read_f2dot14();
 		}
 	} while( flags & 0x0020 );
 }
@@ -836,11 +1293,18 @@ bool noxcain::FontEngine::readFont( const std::string& fontPath )
 		
 		for( UINT32 tableIndex = 0; tableIndex < nTables; ++tableIndex )
 		{
+			std::array<UINT32, 4> recordData;
+			if( !font_file.read_array( recordData.data(), recordData.size() ) )
+			{
+				font_file.close();
+				return false;
+			}
+
 			TableRecord record;
-			record.tag = font_file.read_fundamental<UINT32>();
-			record.checkSum = font_file.read_fundamental<UINT32>();
-			record.offset = font_file.read_fundamental<UINT32>();
-			record.length = font_file.read_fundamental<UINT32>();
+			record.tag = recordData[0];
+			record.checkSum = recordData[1];
+			record.offset = recordData[2];
+			record.length = recordData[3];
 
 			switch( record.tag )
 			{
@@ -887,7 +1351,11 @@ bool noxcain::FontEngine::readFont( const std::string& fontPath )
 
 		glyph_indices.resize( nGlyphs, INVALID_UNICODE );
 
-		createHorizontalMetrics( font_file, hhea.offset, hmtx.offset );
+		if( !createHorizontalMetrics( font_file, hhea.offset, hmtx.offset ) )
+		{
+			font_file.close();
+			return false;
+		}
 		if( vhea.length > 0 )
 		{
 			createVerticalMetrics( font_file, vhea.offset, vmtx.offset );
@@ -896,16 +1364,37 @@ bool noxcain::FontEngine::readFont( const std::string& fontPath )
 
 		font_file.set_position( loca.offset );
 		std::vector<UINT32> glyphTableOffsets( std::size_t( nGlyphs ) + 1 );
-		for( UINT32 glyph_index = 0; glyph_index < nGlyphs + 1; ++glyph_index )
+		bool has_offsets = false;
+		if( longOffset )
 		{
-			glyphTableOffsets[glyph_index] = longOffset ? font_file.read_fundamental<UINT32>() : UINT32( 2 )*font_file.read_fundamental<UINT16>();
+			has_offsets = font_file.read_array( glyphTableOffsets.data(), glyphTableOffsets.size() );
+		}
+		else
+		{
+			std::vector<UINT16> shortOffsets( glyphTableOffsets.size() );
+			has_offsets = font_file.read_array( shortOffsets.data(), shortOffsets.size() );
+			std::transform( shortOffsets.begin(), shortOffsets.end(), glyphTableOffsets.begin(), []( UINT16 offset )
+			{
+				return UINT32( 2 )*offset;
+			} );
+		}
+		if( !has_offsets )
+		{
+			font_file.close();
+			return false;
 		}
 
-		computeGlyph( font_file, glyf.offset, glyphTableOffsets );
+		ResourceBlock glyph_table = font_file.read_block( glyf.offset, glyf.length );
+		if( glyph_table.get_size() != glyf.length )
+		{
+			font_file.close();
+			return false;
+		}
+		computeGlyph( glyph_table, glyphTableOffsets );
 
-		createUnicodeMap( font_file, cmap.offset );
+		const bool has_unicode_map = createUnicodeMap( font_file, cmap.offset );
 		
-		if( get_glyph_count() )
+		if( has_unicode_map && get_glyph_count() )
 		{
 			return true;
 		}
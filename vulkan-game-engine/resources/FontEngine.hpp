@@ -9,6 +9,27 @@ namespace noxcain
 	class FontEngine
 	{
 		friend class ResourceEngine;
+	public:
+		/// <summary>
+		/// the glyph shaders search at most this many bands per axis
+		/// </summary>
+		static constexpr UINT32 MAX_BAND_COUNT = 32;
+
+		/// <summary>
+		/// offline estimate of the fragment cost of a font
+		/// </summary>
+		struct BandStatistics
+		{
+			// non empty bands of all glyphs, both axes
+			UINT32 band_count = 0;
+			UINT32 max_curves_per_band = 0;
+			DOUBLE average_curves_per_band = 0;
+			// curves tested by a sample inside the glyph box, summed over both axes
+			DOUBLE average_curves_per_sample = 0;
+			DOUBLE average_bytes_per_glyph = 0;
+			std::size_t max_bytes_per_glyph = 0;
+		};
+
 	private:
 		UINT32 glyph_count = 0;
 		UINT16 units_per_em = 0;
@@ -26,16 +47,17 @@ namespace noxcain
 		std::vector<std::vector<FLOAT32>> point_maps;
 		std::vector<std::vector<UINT32>>  offset_maps;
 		std::vector<UINT32> unicode_ranges;
+		BandStatistics band_statistics;
 		
-		void createUnicodeMap( ResourceFile& font_file, UINT32 offset );
+		bool createUnicodeMap( ResourceFile& font_file, UINT32 offset );
 		UINT32 getNumGlyphs( ResourceFile& font_file, UINT32 offset );
 		bool isLongOffset( ResourceFile& font_file, UINT32 offset );
 
-		void createHorizontalMetrics( ResourceFile& font_file, UINT32 hheaOffset, UINT32 hmtxOffset );
+		bool createHorizontalMetrics( ResourceFile& font_file, UINT32 hheaOffset, UINT32 hmtxOffset );
 		void createVerticalMetrics( ResourceFile& font_file, UINT32 vheaOffset, UINT32 vmtxOffset );
-		void computeGlyph( ResourceFile& font_file, UINT32 tableOffset, const std::vector<UINT32>& glyphOffsets );
-		void readSimpleGlyph( ResourceFile& font_file, std::vector<UINT16>& endPointIndices, std::vector<BYTE>& flags, std::vector<DOUBLE>& xCoords, std::vector<DOUBLE>& yCoords );
-		void readCompositeGlyph( ResourceFile& font_file );
+		void computeGlyph( ResourceBlock& glyph_table, const std::vector<UINT32>& glyphOffsets );
+		void readSimpleGlyph( ResourceBlock& glyph_table, std::vector<UINT16>& endPointIndices, std::vector<BYTE>& flags, std::vector<DOUBLE>& xCoords, std::vector<DOUBLE>& yCoords );
+		void readCompositeGlyph( ResourceBlock& glyph_table );
 
 	public:
 		static constexpr UINT32 INVALID_UNICODE = 0xFFFFFF;
@@ -62,6 +84,11 @@ namespace noxcain
 			return glyph_corners;
 		}
 
+		const BandStatistics& get_band_statistics() const
+		{
+			return band_statistics;
+		}
+
 		FLOAT32 get_ascender() const { return ascender; }
 		FLOAT32 get_descender() const { return descender; }
 		FLOAT32 get_line_gap() const { return line_gap; }
@@ -11,12 +11,10 @@ noxcain::FontResource::FontResource(
 	DOUBLE ascender,
 	DOUBLE descender,
 	DOUBLE line_gap,
-	std::vector<std::size_t>&& point_data_offset_resource_ids,
-	std::vector<std::size_t>&& point_data_resource_ids,
+	UINT32 glyph_count,
 	std::size_t vertex_resource_id ) :
-	font_offset( font_offset ), ascender( ascender ), descender( descender ), line_gap( line_gap ), vertex_resource_id( vertex_resource_id ),
-	unicode_map( std::move( unicode_ranges ) ), character_infos( std::move( character_infos ) ),
-	point_data_offset_resource_ids( point_data_offset_resource_ids ), point_data_resource_ids( point_data_resource_ids )
+	font_offset( font_offset ), glyph_count( glyph_count ), ascender( ascender ), descender( descender ), line_gap( line_gap ), vertex_resource_id( vertex_resource_id ),
+	unicode_map( std::move( unicode_ranges ) ), character_infos( std::move( character_infos ) )
 {
 }
 
@@ -33,7 +31,7 @@ noxcain::FontResource::CharacterInfo noxcain::FontResource::get_character_info(
 
 std::size_t noxcain::FontResource::get_glyph_count() const
 {
-	return point_data_offset_resource_ids.size();
+	return glyph_count;
 }
 
 const noxcain::BoundingBox noxcain::FontResource::get_character_bounding_box( UINT32 unicode ) const
@@ -49,6 +47,14 @@ const noxcain::BoundingBox noxcain::FontResource::get_character_bounding_box( UI
 	return BoundingBox( glyphQuad[0], glyphQuad[7], 0.0, glyphQuad[6], glyphQuad[1], 0.0 );
 }
 
+std::array<noxcain::FLOAT32, 4> noxcain::FontResource::get_glyph_box( UINT32 glyph_index ) const
+{
+	// top left, top right, bottom left, bottom right
+	std::array<FLOAT32, 8> glyph_quad = {};
+	ResourceEngine::get_engine().get_subresources()[vertex_resource_id].getData( glyph_quad.data(), glyph_quad.size() * sizeof( FLOAT32 ), ( std::size_t( font_offset ) + glyph_index ) * glyph_quad.size() * sizeof( FLOAT32 ) );
+	return { glyph_quad[4], glyph_quad[5], glyph_quad[2], glyph_quad[3] };
+}
+
 noxcain::UINT32 noxcain::FontResource::get_character_index( UINT32 unicode ) const
 {
 	if( unicode_map.size() && unicode >= unicode_map.front().start && unicode <= unicode_map.back().end )
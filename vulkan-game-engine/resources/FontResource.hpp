@@ -1,5 +1,6 @@
 #pragma once
 #include <Defines.hpp>
+#include <array>
 #include <vector>
 
 namespace noxcain
@@ -30,8 +31,7 @@ namespace noxcain
 					  DOUBLE ascender,
 					  DOUBLE descender,
 					  DOUBLE line_gap,
-					  std::vector<std::size_t>&& point_data_offset_resource_ids,
-					  std::vector<std::size_t>&& point_data_resource_ids,
+					  UINT32 glyph_count,
 					  std::size_t vertex_resource_id );
 
 		CharacterInfo get_character_info( UINT32 unicode ) const;
@@ -56,17 +56,11 @@ namespace noxcain
 			return line_gap;
 		}
 
+		/// <summary>
+		/// the curve data of the glyphs is found with ResourceEngine::get_glyph_range( get_font_offset() + glyph_index )
+		/// </summary>
 		std::size_t get_glyph_count() const;
 
-		const std::vector<std::size_t>& get_offset_map_resource_ids() const
-		{
-			return point_data_offset_resource_ids;
-		}
-		const std::vector<std::size_t>& get_point_map_resource_ids() const
-		{
-			return point_data_resource_ids;
-		}
-
 		std::size_t get_vertex_block_id() const
 		{
 			return vertex_resource_id;
@@ -74,13 +68,17 @@ namespace noxcain
 
 		const BoundingBox get_character_bounding_box( UINT32 unicode ) const;
 
+		/// <summary>
+		/// quad of the glyph in em as min x, min y, max x, max y
+		/// </summary>
+		std::array<FLOAT32, 4> get_glyph_box( UINT32 glyph_index ) const;
+
 	private:
 
 		std::size_t vertex_resource_id;
-		std::vector<std::size_t> point_data_offset_resource_ids;
-		std::vector<std::size_t> point_data_resource_ids;
 
 		UINT32 font_offset = 0;
+		UINT32 glyph_count = 0;
 
 		const DOUBLE ascender;
 		const DOUBLE descender;
@@ -3,11 +3,15 @@
 #include <resources/FontEngine.hpp>
 #include <resources/FontResource.hpp>
 #include <resources/GeometryResource.hpp>
+#include <resources/GlyphAtlas.hpp>
+#include <resources/GlyphQuantizer.hpp>
 
 #include <math/Vector.hpp>
 
 #include <cmath>
+#include <cstring>
 #include <algorithm>
+#include <limits>
 
 std::unique_ptr<noxcain::ResourceEngine> noxcain::ResourceEngine::resources;
 
@@ -27,6 +31,22 @@ void noxcain::ResourceEngine::read_font( const std::vector<std::string>& font_pa
 	const std::size_t vertex_buffer_resource_id = addSubResource( vertex_buffer_size, GameSubResource::SubResourceType::eVertexBuffer );
 	std::vector<BYTE> vertex_buffer( vertex_buffer_size );
 
+	// distance fields for small 2D text, in the same glyph order as the vertex buffer
+	GlyphAtlas glyph_atlas;
+
+	// curve data of all glyphs in two buffers, the ranges locate each glyph in them
+	std::vector<UINT32> glyph_offsets;
+	std::vector<FLOAT32> glyph_points;
+	glyph_ranges.clear();
+	glyph_ranges.reserve( total_glyph_count );
+
+	auto add_glyph_data = [this, &glyph_offsets, &glyph_points]( const UINT32* offset_map, std::size_t offset_count, const FLOAT32* point_map, std::size_t point_count )
+	{
+		glyph_ranges.push_back( { UINT32( glyph_offsets.size() ), UINT32( offset_count ), UINT32( glyph_points.size() ), UINT32( point_count ) } );
+		glyph_offsets.insert( glyph_offsets.end(), offset_map, offset_map + offset_count );
+		glyph_points.insert( glyph_points.end(), point_map, point_map + point_count );
+	};
+
 	//in code fallback font
 	{
 		std::vector<FontResource::CharacterInfo> chars = { { 0, 1.0F } };
@@ -55,10 +75,6 @@ void noxcain::ResourceEngine::read_font( const std::vector<std::string>& font_pa
 		offset_map[6] = 20;
 		offset_map[7] = 14;
 
-		const std::size_t offsets_resource_id = addSubResource( offsets_buffer.size(), GameSubResource::SubResourceType::eStorageBuffer );
-		std::vector<std::size_t> offset_ids = { offsets_resource_id };
-		subresources[offsets_resource_id].setData( std::move( offsets_buffer ) );
-
 		std::vector<BYTE> point_buffer( 26 * sizeof( FLOAT32 ) );
 		FLOAT32* point_map = reinterpret_cast<FLOAT32*>( point_buffer.data() );
 		point_map[0] = 1.0F;
@@ -104,12 +120,11 @@ void noxcain::ResourceEngine::read_font( const std::vector<std::string>& font_pa
 		point_map[24] = 1.0F;
 		point_map[25] = 0.0F;
 
-		const std::size_t point_resource_id = addSubResource( point_buffer.size(), GameSubResource::SubResourceType::eStorageBuffer );
-		std::vector<std::size_t> point_ids = { point_resource_id };
-		subresources[point_resource_id].setData( std::move( point_buffer ) );
+		glyph_atlas.add_glyph( std::vector<UINT32>( offset_map, offset_map + 8 ), std::vector<FLOAT32>( point_map, point_map + 26 ), { 0.0F, 0.0F, 1.0F, 1.0F } );
+		add_glyph_data( offset_map, 8, point_map, 26 );
 
 		font_resources.emplace_back( 0, std::vector<FontResource::UnicodeRange>(), std::move( chars ), 1.0, 0.0, 0.0,
-									 std::move( offset_ids ), std::move( point_ids ), vertex_buffer_resource_id );
+									 1, vertex_buffer_resource_id );
 		resource_limits.font_count = 1;
 	}
 
@@ -177,41 +192,25 @@ void noxcain::ResourceEngine::read_font( const std::vector<std::string>& font_pa
 				memory[8 * glyph_index + 7] = fe.glyph_corners[4 * glyph_index + 1];
 			}
 
-			std::vector<std::size_t> offset_ids;
-			offset_ids.reserve( current_glyph_count );
-			for( const auto& map : fe.getGlyphOffsetMaps() )
+			const auto& offset_maps = fe.getGlyphOffsetMaps();
+			const auto& point_maps = fe.getGlyphPointMaps();
+			for( std::size_t glyph_index = 0; glyph_index < current_glyph_count; ++glyph_index )
 			{
-				std::vector<BYTE> mapBuffer( map.size() * sizeof( UINT32 ) );
-				UINT32* mapMemory = reinterpret_cast<UINT32*>( mapBuffer.data() );
-				for( std::size_t index = 0; index < map.size(); ++index )
+				if( glyph_index < offset_maps.size() && glyph_index < point_maps.size() )
 				{
-					mapMemory[index] = map[index];
+					add_glyph_data( offset_maps[glyph_index].data(), offset_maps[glyph_index].size(), point_maps[glyph_index].data(), point_maps[glyph_index].size() );
 				}
-
-				const std::size_t id = addSubResource( mapBuffer.size(), GameSubResource::SubResourceType::eStorageBuffer );
-				offset_ids.emplace_back( id );
-				subresources[id].setData( std::move( mapBuffer ) );
-			}
-
-			std::vector<std::size_t> pointIds;
-			pointIds.reserve( current_glyph_count );
-			for( const auto& map : fe.getGlyphPointMaps() )
-			{
-				std::vector<BYTE> mapBuffer( map.size() * sizeof( FLOAT32 ) );
-				FLOAT32* mapMemory = reinterpret_cast<FLOAT32*>( mapBuffer.data() );
-				for( std::size_t index = 0; index < map.size(); ++index )
+				else
 				{
-					mapMemory[index] = map[index];
+					add_glyph_data( nullptr, 0, nullptr, 0 );
 				}
-				const std::size_t id = addSubResource( mapBuffer.size(), GameSubResource::SubResourceType::eStorageBuffer );
-				pointIds.emplace_back( id );
-				subresources[id].setData( std::move( mapBuffer ) );
 			}
 
+			glyph_atlas.add_font( fe );
+
 			font_resources.push_back( FontResource( font_offset, std::move( unicode ), std::move( chars ),
 													fe.ascender, fe.descender, fe.line_gap, 
-													std::move( offset_ids ), std::move( pointIds ),
-													vertex_buffer_resource_id ) );
+													UINT32( current_glyph_count ), vertex_buffer_resource_id ) );
 			resource_limits.font_count++;
 
 			font_offset += current_glyph_count;
@@ -219,6 +218,80 @@ void noxcain::ResourceEngine::read_font( const std::vector<std::string>& font_pa
 	}
 	resource_limits.glyph_count = total_glyph_count;
 	subresources[vertex_buffer_resource_id].setData( std::move( vertex_buffer ) );
+
+	// the 16 bit encoding is only used if every glyph fits, the shaders decode one format for all glyphs
+	std::vector<BYTE> offset_data;
+	std::vector<BYTE> point_data;
+	glyphs_quantized = false;
+	if( QUANTIZE_GLYPHS )
+	{
+		std::vector<UINT16> quantized_offsets;
+		std::vector<UINT16> quantized_points;
+		quantized_offsets.reserve( glyph_offsets.size() );
+		quantized_points.reserve( glyph_points.size() );
+
+		std::vector<GlyphRange> quantized_ranges;
+		quantized_ranges.reserve( glyph_ranges.size() );
+		bool all_quantized = true;
+		for( const GlyphRange& range : glyph_ranges )
+		{
+			GlyphRange& quantized_range = quantized_ranges.emplace_back();
+			quantized_range.offset_start = UINT32( quantized_offsets.size() );
+			quantized_range.offset_count = range.offset_count;
+			quantized_range.point_start = UINT32( quantized_points.size() );
+			quantized_range.point_count = range.point_count;
+
+			GlyphQuantizer::PointTransform transform;
+			if( !GlyphQuantizer::quantize( glyph_offsets.data() + range.offset_start, range.offset_count, glyph_points.data() + range.point_start, range.point_count,
+										   quantized_offsets, quantized_points, transform ) )
+			{
+				all_quantized = false;
+				break;
+			}
+			quantized_range.point_origin = transform.origin;
+			quantized_range.point_scale = transform.scale;
+		}
+
+		if( all_quantized && quantized_points.size() < std::numeric_limits<UINT32>::max() )
+		{
+			glyphs_quantized = true;
+			glyph_ranges = std::move( quantized_ranges );
+
+			// two elements per 32 bit word, the buffers are padded to full words
+			offset_data.resize( ( quantized_offsets.size() + 1 ) / 2 * sizeof( UINT32 ) );
+			std::memcpy( offset_data.data(), quantized_offsets.data(), quantized_offsets.size() * sizeof( UINT16 ) );
+			point_data.resize( ( quantized_points.size() + 1 ) / 2 * sizeof( UINT32 ) );
+			std::memcpy( point_data.data(), quantized_points.data(), quantized_points.size() * sizeof( UINT16 ) );
+		}
+	}
+
+	if( !glyphs_quantized )
+	{
+		offset_data.resize( glyph_offsets.size() * sizeof( UINT32 ) );
+		std::memcpy( offset_data.data(), glyph_offsets.data(), offset_data.size() );
+		point_data.resize( glyph_points.size() * sizeof( FLOAT32 ) );
+		std::memcpy( point_data.data(), glyph_points.data(), point_data.size() );
+	}
+
+	glyph_offset_resource_id = addSubResource( offset_data.size(), GameSubResource::SubResourceType::eStorageBuffer );
+	subresources[glyph_offset_resource_id].setData( std::move( offset_data ) );
+
+	glyph_point_resource_id = addSubResource( point_data.size(), GameSubResource::SubResourceType::eStorageBuffer );
+	subresources[glyph_point_resource_id].setData( std::move( point_data ) );
+
+	static_assert( sizeof( GlyphRange ) == 8 * sizeof( UINT32 ), "glyph ranges are read as GlyphRange of the contour shaders" );
+	std::vector<BYTE> range_data( glyph_ranges.size() * sizeof( GlyphRange ) );
+	std::memcpy( range_data.data(), glyph_ranges.data(), range_data.size() );
+	glyph_range_resource_id = addSubResource( range_data.size(), GameSubResource::SubResourceType::eStorageBuffer );
+	subresources[glyph_range_resource_id].setData( std::move( range_data ) );
+
+	std::vector<BYTE> atlas_entries = glyph_atlas.get_entry_data();
+	glyph_atlas_entry_resource_id = addSubResource( atlas_entries.size(), GameSubResource::SubResourceType::eStorageBuffer );
+	subresources[glyph_atlas_entry_resource_id].setData( std::move( atlas_entries ) );
+
+	std::vector<BYTE> atlas_texels = glyph_atlas.get_texel_data();
+	glyph_atlas_texel_resource_id = addSubResource( atlas_texels.size(), GameSubResource::SubResourceType::eStorageBuffer );
+	subresources[glyph_atlas_texel_resource_id].setData( std::move( atlas_texels ) );
 }
 
 void noxcain::ResourceEngine::read_hex_geometry()
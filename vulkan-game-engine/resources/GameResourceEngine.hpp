@@ -53,6 +53,68 @@ namespace noxcain
 		std::size_t get_invalid_geomtry_id() const;
 		std::size_t get_invalid_font_id() const;
 
+		//SPECIAL GLYPH CURVE CASE
+
+		/// <summary>
+		/// the offset and point maps are stored as 16 bit values if every glyph fits, see GlyphQuantizer
+		/// </summary>
+		static constexpr bool QUANTIZE_GLYPHS = true;
+
+		/// <summary>
+		/// position of one glyph in the shared offset and point buffers, counted in elements
+		/// </summary>
+		struct GlyphRange
+		{
+			UINT32 offset_start = 0;
+			UINT32 offset_count = 0;
+			UINT32 point_start = 0;
+			UINT32 point_count = 0;
+
+			// decodes quantized points to origin + value * scale, x and y
+			std::array<FLOAT32, 2> point_origin = {};
+			std::array<FLOAT32, 2> point_scale = {};
+		};
+
+		/// <summary>
+		/// true if the glyph buffers hold two 16 bit elements per 32 bit word
+		/// </summary>
+		bool are_glyphs_quantized() const
+		{
+			return glyphs_quantized;
+		}
+
+		/// <param name="glyph_id">global glyph index, font offset plus glyph index</param>
+		const GlyphRange& get_glyph_range( std::size_t glyph_id ) const
+		{
+			return glyph_ranges[glyph_id];
+		}
+
+		std::size_t get_glyph_offset_resource_id() const
+		{
+			return glyph_offset_resource_id;
+		}
+
+		std::size_t get_glyph_point_resource_id() const
+		{
+			return glyph_point_resource_id;
+		}
+
+		std::size_t get_glyph_range_resource_id() const
+		{
+			return glyph_range_resource_id;
+		}
+
+		//SPECIAL GLYPH ATLAS CASE
+		std::size_t get_glyph_atlas_entry_resource_id() const
+		{
+			return glyph_atlas_entry_resource_id;
+		}
+
+		std::size_t get_glyph_atlas_texel_resource_id() const
+		{
+			return glyph_atlas_texel_resource_id;
+		}
+
 	private:
 		
 		ResourceEngine();
@@ -66,6 +128,15 @@ namespace noxcain
 		
 		std::vector<FontResource> font_resources;
 		std::vector<GeometryResource> indexed_geometry_objects;
+
+		std::vector<GlyphRange> glyph_ranges;
+		std::size_t glyph_offset_resource_id = 0;
+		std::size_t glyph_point_resource_id = 0;
+		std::size_t glyph_range_resource_id = 0;
+		bool glyphs_quantized = false;
+
+		std::size_t glyph_atlas_entry_resource_id = 0;
+		std::size_t glyph_atlas_texel_resource_id = 0;
 		
 		void read_hex_geometry();
 		void read_font( const std::vector<std::string>& font_paths );
@@ -0,0 +1,210 @@
+#include "GlyphAtlas.hpp"
+
+#include <resources/FontEngine.hpp>
+#include <resources/GlyphRasterizer.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+	using noxcain::FLOAT32;
+
+	// quadratic curves are measured as polylines with this many segments
+	constexpr std::size_t CURVE_SEGMENT_COUNT = 8;
+
+	// large enough for the rasterizer to take one sample per axis
+	constexpr FLOAT32 SIGN_PIXEL_PER_EM = 1024.0F;
+
+	struct Curve
+	{
+		std::array<FLOAT32, 2 * ( CURVE_SEGMENT_COUNT + 1 )> points;
+		FLOAT32 min_x;
+		FLOAT32 min_y;
+		FLOAT32 max_x;
+		FLOAT32 max_y;
+	};
+
+	FLOAT32 segment_distance( FLOAT32 x, FLOAT32 y, FLOAT32 x1, FLOAT32 y1, FLOAT32 x2, FLOAT32 y2 )
+	{
+		const FLOAT32 dx = x2 - x1;
+		const FLOAT32 dy = y2 - y1;
+		const FLOAT32 length = dx * dx + dy * dy;
+		FLOAT32 t = length > 0.0F ? ( ( x - x1 ) * dx + ( y - y1 ) * dy ) / length : 0.0F;
+		t = std::clamp( t, 0.0F, 1.0F );
+		return std::hypot( x1 + t * dx - x, y1 + t * dy - y );
+	}
+}
+
+noxcain::GlyphAtlas::DistanceField noxcain::GlyphAtlas::create_distance_field( const std::vector<UINT32>& offset_map, const std::vector<FLOAT32>& point_map, const std::array<FLOAT32, 4>& corners )
+{
+	DistanceField field;
+
+	// the curve offsets follow the band headers, the first x band points to the first of them
+	const std::size_t header_size = offset_map.size() > 1 ? offset_map[1] : 0;
+	if( header_size == 0 || header_size >= offset_map.size() || corners[2] <= corners[0] || corners[3] <= corners[1] )
+	{
+		return field;
+	}
+
+	// every curve is listed in several bands
+	std::vector<UINT32> curve_offsets( offset_map.begin() + header_size, offset_map.end() );
+	std::sort( curve_offsets.begin(), curve_offsets.end() );
+	curve_offsets.erase( std::unique( curve_offsets.begin(), curve_offsets.end() ), curve_offsets.end() );
+
+	std::vector<Curve> curves;
+	curves.reserve( curve_offsets.size() );
+	for( UINT32 curve_offset : curve_offsets )
+	{
+		if( std::size_t( curve_offset ) + 6 > point_map.size() )
+		{
+			continue;
+		}
+
+		const FLOAT32* p = point_map.data() + curve_offset;
+		Curve& curve = curves.emplace_back();
+		curve.min_x = std::min( { p[0], p[2], p[4] } );
+		curve.min_y = std::min( { p[1], p[3], p[5] } );
+		curve.max_x = std::max( { p[0], p[2], p[4] } );
+		curve.max_y = std::max( { p[1], p[3], p[5] } );
+
+		for( std::size_t index = 0; index <= CURVE_SEGMENT_COUNT; ++index )
+		{
+			const FLOAT32 t = FLOAT32( index ) / CURVE_SEGMENT_COUNT;
+			const FLOAT32 s = 1.0F - t;
+			curve.points[2 * index] = s * s * p[0] + 2.0F * s * t * p[2] + t * t * p[4];
+			curve.points[2 * index + 1] = s * s * p[1] + 2.0F * s * t * p[3] + t * t * p[5];
+		}
+	}
+
+	field.entry.origin_x = corners[0] - DISTANCE_RANGE;
+	field.entry.origin_y = corners[1] - DISTANCE_RANGE;
+	field.entry.width = UINT32( std::ceil( ( corners[2] - corners[0] + 2.0F * DISTANCE_RANGE ) * TEXEL_PER_EM ) );
+	field.entry.height = UINT32( std::ceil( ( corners[3] - corners[1] + 2.0F * DISTANCE_RANGE ) * TEXEL_PER_EM ) );
+	field.texels.resize( std::size_t( field.entry.width ) * field.entry.height );
+
+	// the sign is the coverage of a single sample at the texel center
+	const GlyphRasterizer rasterizer( SIGN_PIXEL_PER_EM );
+	UINT64 curve_tests = 0;
+
+	for( UINT32 row = 0; row < field.entry.height; ++row )
+	{
+		const FLOAT32 y = field.entry.origin_y + ( row + 0.5F ) / TEXEL_PER_EM;
+		for( UINT32 column = 0; column < field.entry.width; ++column )
+		{
+			const FLOAT32 x = field.entry.origin_x + ( column + 0.5F ) / TEXEL_PER_EM;
+
+			FLOAT32 distance = DISTANCE_RANGE;
+			for( const Curve& curve : curves )
+			{
+				const FLOAT32 box_x = std::max( { curve.min_x - x, 0.0F, x - curve.max_x } );
+				const FLOAT32 box_y = std::max( { curve.min_y - y, 0.0F, y - curve.max_y } );
+				if( box_x >= distance || box_y >= distance )
+				{
+					continue;
+				}
+
+				for( std::size_t index = 0; index < CURVE_SEGMENT_COUNT; ++index )
+				{
+					distance = std::min( distance, segment_distance( x, y,
+																	 curve.points[2 * index], curve.points[2 * index + 1],
+																	 curve.points[2 * index + 2], curve.points[2 * index + 3] ) );
+				}
+			}
+
+			const FLOAT32 coverage = rasterizer.compute_coverage( offset_map.data(), offset_map.size(), point_map.data(), point_map.size(), x, y, curve_tests );
+			if( coverage < 0.5F )
+			{
+				distance = -distance;
+			}
+
+			const FLOAT32 value = std::clamp( 0.5F + 0.5F * distance / DISTANCE_RANGE, 0.0F, 1.0F );
+			field.texels[std::size_t( row ) * field.entry.width + column] = BYTE( value * 255.0F + 0.5F );
+		}
+	}
+	return field;
+}
+
+void noxcain::GlyphAtlas::append( DistanceField&& field )
+{
+	field.entry.texel_offset = UINT32( texels.size() );
+	entries.push_back( field.entry );
+	texels.insert( texels.end(), field.texels.begin(), field.texels.end() );
+}
+
+void noxcain::GlyphAtlas::add_glyph( const std::vector<UINT32>& offset_map, const std::vector<FLOAT32>& point_map, const std::array<FLOAT32, 4>& corners )
+{
+	append( create_distance_field( offset_map, point_map, corners ) );
+}
+
+void noxcain::GlyphAtlas::add_font( const FontEngine& font, std::size_t thread_count )
+{
+	const auto& offset_maps = font.getGlyphOffsetMaps();
+	const auto& point_maps = font.getGlyphPointMaps();
+	const auto& corners = font.getGlyphCorners();
+	const std::size_t glyph_count = std::min( { std::size_t( font.get_glyph_count() ), offset_maps.size(), point_maps.size(), corners.size() / 4 } );
+
+	std::vector<DistanceField> fields( glyph_count );
+
+	if( thread_count == 0 )
+	{
+		thread_count = std::max<std::size_t>( 1, std::thread::hardware_concurrency() );
+	}
+	thread_count = std::min( thread_count, std::max<std::size_t>( 1, glyph_count ) );
+
+	std::atomic<std::size_t> next_glyph = 0;
+	auto create_fields = [&]()
+	{
+		for( std::size_t glyph_index = next_glyph++; glyph_index < glyph_count; glyph_index = next_glyph++ )
+		{
+			fields[glyph_index] = create_distance_field( offset_maps[glyph_index], point_maps[glyph_index],
+														 { corners[4 * glyph_index], corners[4 * glyph_index + 1], corners[4 * glyph_index + 2], corners[4 * glyph_index + 3] } );
+		}
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve( thread_count - 1 );
+	for( std::size_t thread_index = 1; thread_index < thread_count; ++thread_index )
+	{
+		workers.emplace_back( create_fields );
+	}
+	create_fields();
+
+	for( auto& worker : workers )
+	{
+		worker.join();
+	}
+
+	// the glyph ids of the font have to stay continuous in the atlas
+	for( std::size_t glyph_index = glyph_count; glyph_index < font.get_glyph_count(); ++glyph_index )
+	{
+		fields.emplace_back();
+	}
+
+	for( auto& field : fields )
+	{
+		append( std::move( field ) );
+	}
+}
+
+std::vector<noxcain::BYTE> noxcain::GlyphAtlas::get_entry_data() const
+{
+	static_assert( sizeof( Entry ) == 5 * sizeof( UINT32 ), "atlas entries are read as std430 structs" );
+
+	std::vector<BYTE> data( std::max<std::size_t>( 1, entries.size() ) * sizeof( Entry ) );
+	if( !entries.empty() )
+	{
+		std::memcpy( data.data(), entries.data(), entries.size() * sizeof( Entry ) );
+	}
+	return data;
+}
+
+std::vector<noxcain::BYTE> noxcain::GlyphAtlas::get_texel_data() const
+{
+	std::vector<BYTE> data( std::max<std::size_t>( 1, ( texels.size() + 3 ) / 4 ) * sizeof( UINT32 ) );
+	std::copy( texels.begin(), texels.end(), data.begin() );
+	return data;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <Defines.hpp>
+
+#include <array>
+#include <vector>
+
+namespace noxcain
+{
+	class FontEngine;
+
+	/// <summary>
+	/// signed distance fields of all glyphs, small overlay text samples them instead of solving the glyph curves per pixel
+	/// </summary>
+	class GlyphAtlas
+	{
+	public:
+		/// <summary>
+		/// resolution of the distance fields
+		/// </summary>
+		static constexpr FLOAT32 TEXEL_PER_EM = 32.0F;
+
+		/// <summary>
+		/// distances in em which are covered by the 8 bit texels, the fields are padded by this range
+		/// </summary>
+		static constexpr FLOAT32 DISTANCE_RANGE = 0.125F;
+
+		/// <summary>
+		/// 2D text smaller than this is drawn from the atlas, larger and 3D text keeps the vector path
+		/// </summary>
+		static constexpr DOUBLE MAX_PIXEL_PER_EM = 32.0;
+
+		/// <summary>
+		/// same layout as AtlasEntry in glyph_atlas_2D.frag
+		/// </summary>
+		struct Entry
+		{
+			UINT32 texel_offset = 0;
+			UINT32 width = 0;
+			UINT32 height = 0;
+
+			// em space position of the lower left texel corner
+			FLOAT32 origin_x = 0;
+			FLOAT32 origin_y = 0;
+		};
+
+		/// <summary>
+		/// appends the distance field of one glyph from the maps created by the font engine
+		/// </summary>
+		/// <param name="corners">minX, minY, maxX, maxY of the glyph in em</param>
+		void add_glyph( const std::vector<UINT32>& offset_map, const std::vector<FLOAT32>& point_map, const std::array<FLOAT32, 4>& corners );
+
+		/// <summary>
+		/// appends all glyphs of the font, the glyphs are shared between thread_count threads
+		/// </summary>
+		/// <param name="thread_count">0 uses the hardware concurrency</param>
+		void add_font( const FontEngine& font, std::size_t thread_count = 0 );
+
+		std::size_t get_glyph_count() const
+		{
+			return entries.size();
+		}
+
+		/// <summary>
+		/// one entry per glyph in the order the glyphs were added
+		/// </summary>
+		std::vector<BYTE> get_entry_data() const;
+
+		/// <summary>
+		/// texels of all glyphs, row by row from the bottom, padded to whole UINT32 words
+		/// </summary>
+		std::vector<BYTE> get_texel_data() const;
+
+	private:
+		struct DistanceField
+		{
+			Entry entry;
+			std::vector<BYTE> texels;
+		};
+
+		static DistanceField create_distance_field( const std::vector<UINT32>& offset_map, const std::vector<FLOAT32>& point_map, const std::array<FLOAT32, 4>& corners );
+		void append( DistanceField&& field );
+
+		std::vector<Entry> entries;
+		std::vector<BYTE> texels;
+	};
+}
@@ -0,0 +1,181 @@
+#include "GlyphQuantizer.hpp"
+
+#include <resources/FontEngine.hpp>
+#include <resources/GlyphRasterizer.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+	using noxcain::FLOAT32;
+	using noxcain::UINT32;
+
+	// points are quantized to even values, only the control points of lines are placed between them
+	constexpr FLOAT32 MAX_GRID_VALUE = FLOAT32( std::numeric_limits<noxcain::UINT16>::max() - 1 );
+
+	// same limit as solvePolyX and solvePolyY of the contour shaders
+	constexpr FLOAT32 LINEAR_THRESHOLD = 0.0000001F;
+
+	constexpr FLOAT32 COVERAGE_STEP = 1.0F / 255.0F;
+
+	// the band header ends where the first curve list starts, all following offsets are curve offsets into the point map
+	std::size_t get_curve_list_start( const UINT32* offset_map, std::size_t offset_count )
+	{
+		std::size_t list_start = offset_count;
+		for( std::size_t band_index = 0; 4 * band_index + 3 < list_start; ++band_index )
+		{
+			if( offset_map[4 * band_index] ) list_start = std::min<std::size_t>( list_start, offset_map[4 * band_index + 1] );
+			if( offset_map[4 * band_index + 2] ) list_start = std::min<std::size_t>( list_start, offset_map[4 * band_index + 3] );
+		}
+		return list_start;
+	}
+}
+
+bool noxcain::GlyphQuantizer::quantize( const UINT32* offset_map, std::size_t offset_count, const FLOAT32* point_map, std::size_t point_count,
+										 std::vector<UINT16>& offsets, std::vector<UINT16>& points, PointTransform& transform )
+{
+	for( std::size_t index = 0; index < offset_count; ++index )
+	{
+		if( offset_map[index] > std::numeric_limits<UINT16>::max() )
+		{
+			return false;
+		}
+	}
+
+	// band ends and curve points share the range, the band ends behind the glyph stay in order with the curves
+	std::array<FLOAT32, 2> min_value = { std::numeric_limits<FLOAT32>::max(), std::numeric_limits<FLOAT32>::max() };
+	std::array<FLOAT32, 2> max_value = { std::numeric_limits<FLOAT32>::lowest(), std::numeric_limits<FLOAT32>::lowest() };
+	for( std::size_t index = 0; index < point_count; ++index )
+	{
+		if( !std::isfinite( point_map[index] ) )
+		{
+			return false;
+		}
+		min_value[index & 1] = std::min( min_value[index & 1], point_map[index] );
+		max_value[index & 1] = std::max( max_value[index & 1], point_map[index] );
+	}
+
+	transform = PointTransform();
+	for( std::size_t axis = 0; axis < 2 && point_count > axis; ++axis )
+	{
+		transform.origin[axis] = min_value[axis];
+		transform.scale[axis] = ( max_value[axis] - min_value[axis] ) / MAX_GRID_VALUE;
+	}
+
+	offsets.reserve( offsets.size() + offset_count );
+	for( std::size_t index = 0; index < offset_count; ++index )
+	{
+		offsets.push_back( UINT16( offset_map[index] ) );
+	}
+
+	// every value is rounded to an even step, rounding is monotonic, so the band ends keep their order with the curve extents and the curves keep their sort order
+	const std::size_t point_start = points.size();
+	points.reserve( point_start + point_count );
+	for( std::size_t index = 0; index < point_count; ++index )
+	{
+		const FLOAT32 scale = transform.scale[index & 1];
+		const FLOAT32 value = scale > 0.0F ? 2.0F * std::round( 0.5F * ( point_map[index] - transform.origin[index & 1] ) / scale ) : 0.0F;
+		points.push_back( UINT16( std::clamp( value, 0.0F, MAX_GRID_VALUE ) ) );
+	}
+
+	// lines are stored with the control point in the middle, the shaders only solve them linearly while the curve stays exactly straight
+	const std::size_t list_start = get_curve_list_start( offset_map, offset_count );
+	for( std::size_t index = list_start; index < offset_count; ++index )
+	{
+		const std::size_t curve_offset = offset_map[index];
+		if( curve_offset + 5 >= point_count )
+		{
+			continue;
+		}
+		for( std::size_t axis = 0; axis < 2; ++axis )
+		{
+			const FLOAT32 p1 = point_map[curve_offset + axis];
+			const FLOAT32 p2 = point_map[curve_offset + 2 + axis];
+			const FLOAT32 p3 = point_map[curve_offset + 4 + axis];
+			if( std::abs( p1 - 2.0F * p2 + p3 ) <= LINEAR_THRESHOLD )
+			{
+				UINT16* curve = points.data() + point_start + curve_offset;
+				curve[2 + axis] = UINT16( ( UINT32( curve[axis] ) + curve[4 + axis] ) / 2 );
+			}
+		}
+	}
+	return true;
+}
+
+void noxcain::GlyphQuantizer::dequantize( const UINT16* offsets, std::size_t offset_count, const UINT16* points, std::size_t point_count, const PointTransform& transform,
+										   std::vector<UINT32>& offset_map, std::vector<FLOAT32>& point_map )
+{
+	offset_map.assign( offsets, offsets + offset_count );
+
+	point_map.resize( point_count );
+	for( std::size_t index = 0; index < point_count; ++index )
+	{
+		point_map[index] = transform.origin[index & 1] + FLOAT32( points[index] ) * transform.scale[index & 1];
+	}
+}
+
+noxcain::GlyphQuantizer::ErrorReport noxcain::GlyphQuantizer::measure_error( const FontEngine& font, FLOAT32 pixel_per_em )
+{
+	ErrorReport report;
+	report.pixel_per_em = pixel_per_em;
+
+	const GlyphRasterizer rasterizer( pixel_per_em );
+	const auto& offset_maps = font.getGlyphOffsetMaps();
+	const auto& point_maps = font.getGlyphPointMaps();
+	const auto& corners = font.getGlyphCorners();
+
+	std::vector<UINT16> offsets;
+	std::vector<UINT16> points;
+	std::vector<UINT32> offset_map;
+	std::vector<FLOAT32> point_map;
+
+	const std::size_t glyph_count = std::min( { offset_maps.size(), point_maps.size(), corners.size() / 4 } );
+	DOUBLE deviation_sum = 0.0;
+	for( std::size_t glyph_index = 0; glyph_index < glyph_count; ++glyph_index )
+	{
+		const auto& reference_offsets = offset_maps[glyph_index];
+		const auto& reference_points = point_maps[glyph_index];
+
+		offsets.clear();
+		points.clear();
+		PointTransform transform;
+		if( !quantize( reference_offsets.data(), reference_offsets.size(), reference_points.data(), reference_points.size(), offsets, points, transform ) )
+		{
+			// the resource engine keeps the float maps in this case
+			report.max_deviation = std::numeric_limits<FLOAT32>::infinity();
+			report.worst_glyph_index = UINT32( glyph_index );
+			return report;
+		}
+		dequantize( offsets.data(), offsets.size(), points.data(), points.size(), transform, offset_map, point_map );
+
+		const std::array<FLOAT32, 4> glyph_corners = { corners[4 * glyph_index], corners[4 * glyph_index + 1], corners[4 * glyph_index + 2], corners[4 * glyph_index + 3] };
+		const auto reference = rasterizer.render_glyph( reference_offsets, reference_points, glyph_corners, UINT32( glyph_index ) );
+		const auto quantized = rasterizer.render_glyph( offset_map, point_map, glyph_corners, UINT32( glyph_index ) );
+
+		const FLOAT32 deviation = GlyphRasterizer::compare( reference, quantized );
+		if( deviation > report.max_deviation )
+		{
+			report.max_deviation = deviation;
+			report.worst_glyph_index = UINT32( glyph_index );
+		}
+		deviation_sum += deviation;
+
+		report.pixel_count += reference.coverage.size();
+		for( std::size_t pixel_index = 0; pixel_index < reference.coverage.size() && pixel_index < quantized.coverage.size(); ++pixel_index )
+		{
+			if( std::abs( reference.coverage[pixel_index] - quantized.coverage[pixel_index] ) > COVERAGE_STEP )
+			{
+				++report.deviating_pixel_count;
+			}
+		}
+
+		report.float_bytes += reference_offsets.size() * sizeof( UINT32 ) + reference_points.size() * sizeof( FLOAT32 );
+		report.quantized_bytes += ( offsets.size() + points.size() ) * sizeof( UINT16 );
+	}
+
+	report.glyph_count = glyph_count;
+	report.average_deviation = glyph_count ? FLOAT32( deviation_sum / glyph_count ) : 0.0F;
+	return report;
+}
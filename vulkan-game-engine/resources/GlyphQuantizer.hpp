@@ -0,0 +1,64 @@
+#pragma once
+#include <Defines.hpp>
+
+#include <array>
+#include <vector>
+
+namespace noxcain
+{
+	class FontEngine;
+
+	/// <summary>
+	/// 16 bit encoding of the glyph offset and point maps, points are stored relative to the value range of their glyph per axis
+	/// </summary>
+	class GlyphQuantizer
+	{
+	public:
+		/// <summary>
+		/// decodes a quantized point value to origin + value * scale, x and y alternate like in the point map
+		/// </summary>
+		struct PointTransform
+		{
+			std::array<FLOAT32, 2> origin = {};
+			std::array<FLOAT32, 2> scale = {};
+		};
+
+		/// <summary>
+		/// appends the 16 bit maps of one glyph to offsets and points
+		/// </summary>
+		/// <returns>false and nothing is appended if an offset does not fit into 16 bit or a point is not finite</returns>
+		static bool quantize( const UINT32* offset_map, std::size_t offset_count, const FLOAT32* point_map, std::size_t point_count,
+							  std::vector<UINT16>& offsets, std::vector<UINT16>& points, PointTransform& transform );
+
+		/// <summary>
+		/// restores the maps like glyph_contour_2D.frag decodes them
+		/// </summary>
+		static void dequantize( const UINT16* offsets, std::size_t offset_count, const UINT16* points, std::size_t point_count, const PointTransform& transform,
+								std::vector<UINT32>& offset_map, std::vector<FLOAT32>& point_map );
+
+		struct ErrorReport
+		{
+			FLOAT32 pixel_per_em = 0;
+			std::size_t glyph_count = 0;
+
+			// largest coverage difference of all pixels and the glyph it belongs to
+			FLOAT32 max_deviation = 0;
+			UINT32 worst_glyph_index = 0;
+
+			// mean of the largest coverage difference per glyph
+			FLOAT32 average_deviation = 0;
+
+			// pixels whose coverage differs by more than one 8 bit step
+			std::size_t pixel_count = 0;
+			std::size_t deviating_pixel_count = 0;
+
+			std::size_t float_bytes = 0;
+			std::size_t quantized_bytes = 0;
+		};
+
+		/// <summary>
+		/// renders every glyph of the font from the float maps and from the quantized maps with the GlyphRasterizer and compares the coverage
+		/// </summary>
+		static ErrorReport measure_error( const FontEngine& font, FLOAT32 pixel_per_em );
+	};
+}
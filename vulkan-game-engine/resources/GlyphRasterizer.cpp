@@ -0,0 +1,295 @@
+#include "GlyphRasterizer.hpp"
+
+#include <resources/FontEngine.hpp>
+#include <resources/FontResource.hpp>
+#include <resources/GameResourceEngine.hpp>
+#include <resources/GlyphQuantizer.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+namespace
+{
+	using noxcain::FLOAT32;
+	using noxcain::INT32;
+
+	struct Point
+	{
+		FLOAT32 x = 0;
+		FLOAT32 y = 0;
+	};
+
+	// solvePolyY and solvePolyX of glyph_contour_2D.frag, the curve points are relative to the sample
+	std::array<FLOAT32, 2> solve_poly_y( const Point& p1, const Point& p2, const Point& p3 )
+	{
+		const Point a = { p1.x - 2.0F * p2.x + p3.x, p1.y - 2.0F * p2.y + p3.y };
+		const Point b = { p1.x - p2.x, p1.y - p2.y };
+		const FLOAT32 d = std::sqrt( std::max( b.y * b.y - a.y * p1.y, 0.0F ) );
+		FLOAT32 t1;
+		FLOAT32 t2;
+
+		if( std::abs( a.y ) > 0.0000001F )
+		{
+			const FLOAT32 ra = 1.0F / a.y;
+			t1 = ( b.y - d ) * ra;
+			t2 = ( b.y + d ) * ra;
+		}
+		else
+		{
+			const FLOAT32 rb = 0.5F / b.y;
+			t1 = t2 = p1.y * rb;
+		}
+
+		return { ( a.x * t1 - 2.0F * b.x ) * t1 + p1.x, ( a.x * t2 - 2.0F * b.x ) * t2 + p1.x };
+	}
+
+	std::array<FLOAT32, 2> solve_poly_x( const Point& p1, const Point& p2, const Point& p3 )
+	{
+		const Point a = { p1.x - 2.0F * p2.x + p3.x, p1.y - 2.0F * p2.y + p3.y };
+		const Point b = { p1.x - p2.x, p1.y - p2.y };
+		const FLOAT32 d = std::sqrt( std::max( b.x * b.x - a.x * p1.x, 0.0F ) );
+		FLOAT32 t1;
+		FLOAT32 t2;
+
+		if( std::abs( a.x ) > 0.0000001F )
+		{
+			const FLOAT32 ra = 1.0F / a.x;
+			t1 = ( b.x - d ) * ra;
+			t2 = ( b.x + d ) * ra;
+		}
+		else
+		{
+			const FLOAT32 rb = 0.5F / b.x;
+			t1 = t2 = p1.x * rb;
+		}
+
+		return { ( a.y * t1 - 2.0F * b.y ) * t1 + p1.y, ( a.y * t2 - 2.0F * b.y ) * t2 + p1.y };
+	}
+
+	// the sign bits of the two codes tell if the first and the second root are crossings
+	std::array<INT32, 2> calc_root_code( FLOAT32 v1, FLOAT32 v2, FLOAT32 v3 )
+	{
+		const INT32 a = INT32( std::floor( v1 ) );
+		const INT32 b = INT32( std::floor( v2 ) );
+		const INT32 c = INT32( std::floor( v3 ) );
+
+		return { ( ~a & ( b | c ) ) | ( ~b & c ), ( a & ( ~b | ~c ) ) | ( b & ~c ) };
+	}
+}
+
+noxcain::GlyphRasterizer::GlyphRasterizer( FLOAT32 pixel_per_em ) : pixel_per_em( pixel_per_em )
+{
+}
+
+noxcain::FLOAT32 noxcain::GlyphRasterizer::compute_coverage( const UINT32* offsets, std::size_t offset_count, const FLOAT32* points, std::size_t point_count, FLOAT32 x, FLOAT32 y, UINT64& curve_tests ) const
+{
+	auto point = [points, point_count]( std::size_t index, const Point& origin )
+	{
+		if( index + 1 < point_count )
+		{
+			return Point{ points[index] - origin.x, points[index + 1] - origin.y };
+		}
+		return Point{ -origin.x, -origin.y };
+	};
+
+	auto offset = [offsets, offset_count]( std::size_t index )
+	{
+		return index < offset_count ? offsets[index] : 0;
+	};
+
+	UINT32 nXCurve = 0;
+	UINT32 xOffset = 0;
+
+	const UINT32 stepCount = std::clamp<UINT32>( UINT32( 1000.0F / pixel_per_em ), 1, 8 );
+	const FLOAT32 offsetStep = 1.0F / stepCount;
+
+	FLOAT32 coverage = 0.0F;
+	for( FLOAT32 pixelOffset = -0.5F + 0.5F * offsetStep; pixelOffset < 0.5F; pixelOffset += offsetStep )
+	{
+		const Point posX = { x + pixelOffset / pixel_per_em, y };
+		const Point posY = { x, y + pixelOffset / pixel_per_em };
+
+		for( UINT32 bandIndex = 0; bandIndex < FontEngine::MAX_BAND_COUNT && 2 * std::size_t( bandIndex ) < point_count; ++bandIndex )
+		{
+			if( posX.x <= points[2 * bandIndex] )
+			{
+				nXCurve = offset( 4 * std::size_t( bandIndex ) );
+				xOffset = offset( 4 * std::size_t( bandIndex ) + 1 );
+				break;
+			}
+		}
+
+		UINT32 nYCurve = 0;
+		UINT32 yOffset = 0;
+
+		for( UINT32 bandIndex = 0; bandIndex < FontEngine::MAX_BAND_COUNT && 2 * std::size_t( bandIndex ) + 1 < point_count; ++bandIndex )
+		{
+			if( posY.y <= points[2 * bandIndex + 1] )
+			{
+				nYCurve = offset( 4 * std::size_t( bandIndex ) + 2 );
+				yOffset = offset( 4 * std::size_t( bandIndex ) + 3 );
+				break;
+			}
+		}
+
+		for( UINT32 curveIndex = 0; curveIndex < nXCurve; ++curveIndex )
+		{
+			const std::size_t curveOffset = offset( std::size_t( xOffset ) + curveIndex );
+			const Point startPoint = point( curveOffset, posX );
+			const Point controlPoint = point( curveOffset + 2, posX );
+			const Point endPoint = point( curveOffset + 4, posX );
+
+			++curve_tests;
+			if( std::max( std::max( startPoint.y, controlPoint.y ), endPoint.y ) < 0.0F ) break;
+			const auto code = calc_root_code( startPoint.x, controlPoint.x, endPoint.x );
+			if( ( code[0] | code[1] ) < 0 )
+			{
+				const auto r = solve_poly_x( startPoint, controlPoint, endPoint );
+
+				if( code[0] < 0 ) coverage -= std::clamp( r[0] * pixel_per_em + 0.5F, 0.0F, 1.0F );
+				if( code[1] < 0 ) coverage += std::clamp( r[1] * pixel_per_em + 0.5F, 0.0F, 1.0F );
+			}
+		}
+
+		for( UINT32 curveIndex = 0; curveIndex < nYCurve; ++curveIndex )
+		{
+			const std::size_t curveOffset = offset( std::size_t( yOffset ) + curveIndex );
+			const Point startPoint = point( curveOffset, posY );
+			const Point controlPoint = point( curveOffset + 2, posY );
+			const Point endPoint = point( curveOffset + 4, posY );
+
+			++curve_tests;
+			if( std::max( std::max( startPoint.x, controlPoint.x ), endPoint.x ) < 0.0F ) break;
+			const auto code = calc_root_code( startPoint.y, controlPoint.y, endPoint.y );
+			if( ( code[0] | code[1] ) < 0 )
+			{
+				const auto r = solve_poly_y( startPoint, controlPoint, endPoint );
+
+				if( code[0] < 0 ) coverage += std::clamp( r[0] * pixel_per_em + 0.5F, 0.0F, 1.0F );
+				if( code[1] < 0 ) coverage -= std::clamp( r[1] * pixel_per_em + 0.5F, 0.0F, 1.0F );
+			}
+		}
+	}
+
+	// the render target clamps the alpha
+	return std::min( std::abs( coverage ) / ( 2.0F * stepCount ), 1.0F );
+}
+
+noxcain::GlyphRasterizer::GlyphBitmap noxcain::GlyphRasterizer::render_glyph( const std::vector<UINT32>& offset_map, const std::vector<FLOAT32>& point_map, const std::array<FLOAT32, 4>& corners, UINT32 glyph_index ) const
+{
+	GlyphBitmap bitmap;
+	bitmap.glyph_index = glyph_index;
+	bitmap.origin_x = corners[0];
+	bitmap.width = UINT32( std::ceil( std::max( corners[2] - corners[0], 0.0F ) * pixel_per_em ) );
+	bitmap.height = UINT32( std::ceil( std::max( corners[3] - corners[1], 0.0F ) * pixel_per_em ) );
+	bitmap.coverage.resize( std::size_t( bitmap.width ) * bitmap.height );
+
+	for( UINT32 row = 0; row < bitmap.height; ++row )
+	{
+		const FLOAT32 y = corners[3] - ( row + 0.5F ) / pixel_per_em;
+		for( UINT32 column = 0; column < bitmap.width; ++column )
+		{
+			const FLOAT32 x = corners[0] + ( column + 0.5F ) / pixel_per_em;
+			bitmap.coverage[std::size_t( row ) * bitmap.width + column] = compute_coverage( offset_map.data(), offset_map.size(), point_map.data(), point_map.size(), x, y, bitmap.curve_tests );
+		}
+	}
+	bitmap.origin_y = corners[3] - FLOAT32( bitmap.height ) / pixel_per_em;
+	return bitmap;
+}
+
+noxcain::GlyphRasterizer::GlyphBitmap noxcain::GlyphRasterizer::render_glyph( const FontResource& font, UINT32 glyph_index ) const
+{
+	const auto& resources = ResourceEngine::get_engine();
+	const auto& subresources = resources.get_subresources();
+	if( glyph_index >= font.get_glyph_count() )
+	{
+		GlyphBitmap empty;
+		empty.glyph_index = glyph_index;
+		return empty;
+	}
+
+	const auto& range = resources.get_glyph_range( std::size_t( font.get_font_offset() ) + glyph_index );
+	if( !range.offset_count )
+	{
+		GlyphBitmap empty;
+		empty.glyph_index = glyph_index;
+		return empty;
+	}
+
+	std::vector<UINT32> offset_map( range.offset_count );
+	std::vector<FLOAT32> point_map( range.point_count );
+	if( resources.are_glyphs_quantized() )
+	{
+		std::vector<UINT16> offsets( range.offset_count );
+		subresources[resources.get_glyph_offset_resource_id()].getData( offsets.data(), offsets.size() * sizeof( UINT16 ), std::size_t( range.offset_start ) * sizeof( UINT16 ) );
+
+		std::vector<UINT16> points( range.point_count );
+		subresources[resources.get_glyph_point_resource_id()].getData( points.data(), points.size() * sizeof( UINT16 ), std::size_t( range.point_start ) * sizeof( UINT16 ) );
+
+		GlyphQuantizer::dequantize( offsets.data(), offsets.size(), points.data(), points.size(), { range.point_origin, range.point_scale }, offset_map, point_map );
+	}
+	else
+	{
+		subresources[resources.get_glyph_offset_resource_id()].getData( offset_map.data(), offset_map.size() * sizeof( UINT32 ), std::size_t( range.offset_start ) * sizeof( UINT32 ) );
+		subresources[resources.get_glyph_point_resource_id()].getData( point_map.data(), point_map.size() * sizeof( FLOAT32 ), std::size_t( range.point_start ) * sizeof( FLOAT32 ) );
+	}
+
+	// same quad as the vertex buffer, top left, top right, bottom left, bottom right
+	std::array<FLOAT32, 8> glyph_quad;
+	subresources[font.get_vertex_block_id()].getData( glyph_quad.data(), glyph_quad.size() * sizeof( FLOAT32 ), ( std::size_t( font.get_font_offset() ) + glyph_index ) * glyph_quad.size() * sizeof( FLOAT32 ) );
+
+	return render_glyph( offset_map, point_map, { glyph_quad[4], glyph_quad[5], glyph_quad[2], glyph_quad[3] }, glyph_index );
+}
+
+std::vector<noxcain::GlyphRasterizer::GlyphBitmap> noxcain::GlyphRasterizer::render_font( const FontResource& font, std::size_t thread_count ) const
+{
+	const std::size_t glyph_count = font.get_glyph_count();
+	std::vector<GlyphBitmap> bitmaps( glyph_count );
+
+	if( thread_count == 0 )
+	{
+		thread_count = std::max<std::size_t>( 1, std::thread::hardware_concurrency() );
+	}
+	thread_count = std::min( thread_count, std::max<std::size_t>( 1, glyph_count ) );
+
+	// glyph costs differ a lot, so every thread takes the next free glyph
+	std::atomic<std::size_t> next_glyph = 0;
+	auto render_glyphs = [this, &font, &bitmaps, &next_glyph, glyph_count]()
+	{
+		for( std::size_t glyph_index = next_glyph++; glyph_index < glyph_count; glyph_index = next_glyph++ )
+		{
+			bitmaps[glyph_index] = render_glyph( font, UINT32( glyph_index ) );
+		}
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve( thread_count - 1 );
+	for( std::size_t thread_index = 1; thread_index < thread_count; ++thread_index )
+	{
+		workers.emplace_back( render_glyphs );
+	}
+	render_glyphs();
+
+	for( auto& worker : workers )
+	{
+		worker.join();
+	}
+	return bitmaps;
+}
+
+noxcain::FLOAT32 noxcain::GlyphRasterizer::compare( const GlyphBitmap& bitmap1, const GlyphBitmap& bitmap2 )
+{
+	if( bitmap1.width != bitmap2.width || bitmap1.height != bitmap2.height )
+	{
+		return 1.0F;
+	}
+
+	FLOAT32 difference = 0.0F;
+	for( std::size_t index = 0; index < bitmap1.coverage.size(); ++index )
+	{
+		difference = std::max( difference, std::abs( bitmap1.coverage[index] - bitmap2.coverage[index] ) );
+	}
+	return difference;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <Defines.hpp>
+
+#include <array>
+#include <vector>
+
+namespace noxcain
+{
+	class FontResource;
+
+	/// <summary>
+	/// cpu port of glyph_contour_2D.frag, renders glyphs from their band offset and point maps into coverage bitmaps
+	/// </summary>
+	class GlyphRasterizer
+	{
+	public:
+		struct GlyphBitmap
+		{
+			UINT32 glyph_index = 0;
+			UINT32 width = 0;
+			UINT32 height = 0;
+
+			// em space position of the lower left bitmap corner
+			FLOAT32 origin_x = 0;
+			FLOAT32 origin_y = 0;
+
+			// row major coverage in [0,1], first row is the top row
+			std::vector<FLOAT32> coverage;
+
+			// curves solved over all samples, the fragment cost of the glyph
+			UINT64 curve_tests = 0;
+		};
+
+		/// <summary>
+		/// the glyph box is sampled with pixel_per_em pixels per em like the quad on the screen
+		/// </summary>
+		explicit GlyphRasterizer( FLOAT32 pixel_per_em );
+
+		/// <summary>
+		/// renders a glyph from the maps created by the font engine
+		/// </summary>
+		/// <param name="corners">minX, minY, maxX, maxY of the glyph in em</param>
+		GlyphBitmap render_glyph( const std::vector<UINT32>& offset_map, const std::vector<FLOAT32>& point_map, const std::array<FLOAT32, 4>& corners, UINT32 glyph_index = 0 ) const;
+
+		/// <summary>
+		/// renders a font glyph with the sub resource data which is uploaded to the gpu, quantized data is decoded like in the shader
+		/// </summary>
+		/// <param name="glyph_index">font local glyph index</param>
+		GlyphBitmap render_glyph( const FontResource& font, UINT32 glyph_index ) const;
+
+		/// <summary>
+		/// renders all glyphs of the font, the glyphs are shared between thread_count threads
+		/// </summary>
+		/// <param name="thread_count">0 uses the hardware concurrency</param>
+		std::vector<GlyphBitmap> render_font( const FontResource& font, std::size_t thread_count = 0 ) const;
+
+		/// <summary>
+		/// shader equivalent coverage of one pixel centered at x, y in em
+		/// </summary>
+		/// <param name="curve_tests">is increased by the count of solved curves</param>
+		FLOAT32 compute_coverage( const UINT32* offsets, std::size_t offset_count, const FLOAT32* points, std::size_t point_count, FLOAT32 x, FLOAT32 y, UINT64& curve_tests ) const;
+
+		/// <summary>
+		/// largest coverage difference, bitmaps of different size are completely different
+		/// </summary>
+		static FLOAT32 compare( const GlyphBitmap& bitmap1, const GlyphBitmap& bitmap2 );
+
+	private:
+		FLOAT32 pixel_per_em;
+	};
+}
@@ -0,0 +1,83 @@
+#include <tools/TimeFrame.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	using namespace noxcain;
+
+	constexpr std::size_t THREAD_COUNT = 4;
+	constexpr std::size_t RING_DEPTH = 64;
+
+	// many times the ring depth, the merge thread can not keep up with a tight loop
+	constexpr std::size_t FRAMES_PER_THREAD = 200 * RING_DEPTH;
+
+	bool check( bool condition, const char* message )
+	{
+		if( !condition )
+		{
+			std::cerr << "time frame test failed: " << message << "\n";
+		}
+		return condition;
+	}
+}
+
+/// <summary>
+/// fills the rings of several threads far past their capacity and checks that every time frame reaches the merged history
+/// </summary>
+int main()
+{
+	TimeFrameCollector::set_thread_buffer_depth( RING_DEPTH );
+	TimeFrameCollector::set_history_depth( THREAD_COUNT * FRAMES_PER_THREAD );
+	TimeFrameCollector::activate();
+
+	static const TimeFrameZone zone( "fill", 1.0, 0.0, 0.0 );
+	const debugTimePoint base = std::chrono::steady_clock::now();
+
+	// the start of a time frame encodes its thread and its index
+	std::vector<std::thread> threads;
+	for( std::size_t thread_index = 0; thread_index < THREAD_COUNT; ++thread_index )
+	{
+		threads.emplace_back( [thread_index, base]()
+		{
+			TimeFrameCollector collector( "thread " + std::to_string( thread_index ) );
+			for( std::size_t frame_index = 0; frame_index < FRAMES_PER_THREAD; ++frame_index )
+			{
+				const debugTimePoint start = base + std::chrono::nanoseconds( thread_index * FRAMES_PER_THREAD + frame_index );
+				collector.add_time_frame( start, start + std::chrono::nanoseconds( 1 ), zone );
+			}
+		} );
+	}
+	for( std::thread& thread : threads )
+	{
+		thread.join();
+	}
+
+	std::vector<bool> is_merged( THREAD_COUNT * FRAMES_PER_THREAD, false );
+	std::size_t merged_count = 0;
+	bool is_okay = true;
+	for( const TimeFrameCollection& collection : TimeFrameCollector::get_time_frames() )
+	{
+		for( const TimeFrameData& time_frame : collection )
+		{
+			const auto index = std::size_t( std::chrono::duration_cast<std::chrono::nanoseconds>( time_frame.start_frame - base ).count() );
+			is_okay = check( index < is_merged.size() && !is_merged[index], "unknown or repeated time frame" ) && is_okay;
+			if( index < is_merged.size() )
+			{
+				is_merged[index] = true;
+			}
+			++merged_count;
+		}
+	}
+	is_okay = check( merged_count == is_merged.size(), "time frames were lost" ) && is_okay;
+
+	if( !is_okay )
+	{
+		std::cerr << merged_count << " of " << is_merged.size() << " time frames merged\n";
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,228 @@
+#include <tools/FrameStatistics.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+namespace
+{
+	noxcain::DOUBLE to_milliseconds( std::chrono::nanoseconds duration )
+	{
+		return std::chrono::duration<noxcain::DOUBLE, std::milli>( duration ).count();
+	}
+}
+
+noxcain::FrameStatistics::FrameStatistics( std::string name, ZoneFilter zone_filter ) : name( std::move( name ) ), zone_filter( std::move( zone_filter ) )
+{
+}
+
+void noxcain::FrameStatistics::add_frame( const debugTimePoint& start, const debugTimePoint& end )
+{
+	const std::chrono::nanoseconds duration = std::chrono::duration_cast<std::chrono::nanoseconds>( end - start );
+	const std::size_t bucket = get_bucket( duration );
+
+	Hitch hitch;
+	bool is_hitch = false;
+	{
+		std::unique_lock lock( statistics_mutex );
+		const std::size_t window_count = std::min<UINT64>( frame_count, WINDOW_SIZE );
+		if( window_count >= WARMUP_FRAME_COUNT )
+		{
+			const std::chrono::nanoseconds median = get_percentiles( window_counts, total_max ).p50;
+			if( duration.count() > hitch_factor * median.count() )
+			{
+				is_hitch = true;
+				hitch.frame = frame_count;
+				hitch.duration = duration;
+				hitch.median = median;
+			}
+		}
+
+		std::chrono::nanoseconds& window_slot = window[frame_count % WINDOW_SIZE];
+		if( frame_count >= WINDOW_SIZE )
+		{
+			--window_counts[get_bucket( window_slot )];
+		}
+		window_slot = duration;
+		++window_counts[bucket];
+		++total_counts[bucket];
+		total_max = std::max( total_max, duration );
+		++frame_count;
+	}
+
+	if( !is_hitch )
+	{
+		return;
+	}
+
+	// searching the zone merges all recorded time frames, the statistics stay unlocked meanwhile
+	TimeFrameData zone_time_frame;
+	std::string collection_description;
+	if( TimeFrameCollector::find_longest_time_frame( start, end, zone_filter, zone_time_frame, collection_description ) )
+	{
+		hitch.zone = collection_description + " / " + ( zone_time_frame.zone->description.empty() ? "-" : zone_time_frame.zone->description );
+		hitch.zone_duration = std::chrono::duration_cast<std::chrono::nanoseconds>( std::min( end, zone_time_frame.end ) - std::max( start, zone_time_frame.start_frame ) );
+	}
+
+	std::unique_lock lock( statistics_mutex );
+	++hitch_count;
+	hitches.push_back( std::move( hitch ) );
+	if( hitches.size() > HITCH_LOG_SIZE )
+	{
+		hitches.pop_front();
+	}
+}
+
+void noxcain::FrameStatistics::set_hitch_factor( DOUBLE factor )
+{
+	std::unique_lock lock( statistics_mutex );
+	hitch_factor = factor;
+}
+
+noxcain::FrameStatistics::Percentiles noxcain::FrameStatistics::get_window_percentiles() const
+{
+	std::unique_lock lock( statistics_mutex );
+	const std::size_t window_count = std::min<UINT64>( frame_count, WINDOW_SIZE );
+	const std::chrono::nanoseconds window_max = window_count ? *std::max_element( window.begin(), window.begin() + window_count ) : std::chrono::nanoseconds::zero();
+	return get_percentiles( window_counts, window_max );
+}
+
+noxcain::FrameStatistics::Percentiles noxcain::FrameStatistics::get_total_percentiles() const
+{
+	std::unique_lock lock( statistics_mutex );
+	return get_percentiles( total_counts, total_max );
+}
+
+noxcain::UINT64 noxcain::FrameStatistics::get_hitch_count() const
+{
+	std::unique_lock lock( statistics_mutex );
+	return hitch_count;
+}
+
+std::vector<noxcain::FrameStatistics::Hitch> noxcain::FrameStatistics::get_hitches() const
+{
+	std::unique_lock lock( statistics_mutex );
+	return std::vector<Hitch>( hitches.begin(), hitches.end() );
+}
+
+void noxcain::FrameStatistics::write_summary( std::ostream& stream ) const
+{
+	const Percentiles total = get_total_percentiles();
+	stream << std::fixed << std::setprecision( 3 ) << name << " frame [ms]: p50 " << to_milliseconds( total.p50 ) << ", p95 " << to_milliseconds( total.p95 )
+		<< ", p99 " << to_milliseconds( total.p99 ) << ", max " << to_milliseconds( total.max ) << ", frames " << total.frame_count << ", hitches " << get_hitch_count() << "\n";
+}
+
+void noxcain::FrameStatistics::write_csv_header( std::ostream& stream )
+{
+	stream << "source,row,frames,duration_ms,p50_ms,p95_ms,p99_ms,max_ms,hitches,zone,zone_ms\n";
+}
+
+void noxcain::FrameStatistics::write_csv_rows( std::ostream& stream ) const
+{
+	const Percentiles total = get_total_percentiles();
+	const UINT64 total_hitch_count = get_hitch_count();
+
+	stream << std::fixed << std::setprecision( 3 );
+	stream << name << ",total," << total.frame_count << ",," << to_milliseconds( total.p50 ) << "," << to_milliseconds( total.p95 ) << "," << to_milliseconds( total.p99 ) << ","
+		<< to_milliseconds( total.max ) << "," << total_hitch_count << ",,\n";
+
+	for( const Hitch& hitch : get_hitches() )
+	{
+		// zone names are chosen in code, quotes keep separators in them harmless
+		stream << name << ",hitch," << hitch.frame << "," << to_milliseconds( hitch.duration ) << "," << to_milliseconds( hitch.median ) << ",,,,,\"" << hitch.zone << "\","
+			<< to_milliseconds( hitch.zone_duration ) << "\n";
+	}
+}
+
+std::size_t noxcain::FrameStatistics::get_bucket( std::chrono::nanoseconds duration )
+{
+	if( duration.count() < MIN_BUCKET_DURATION )
+	{
+		return 0;
+	}
+	const DOUBLE octaves = std::log2( duration.count() / MIN_BUCKET_DURATION );
+	return std::min<std::size_t>( 1 + std::size_t( octaves * BUCKETS_PER_OCTAVE ), BUCKET_COUNT - 1 );
+}
+
+std::chrono::nanoseconds noxcain::FrameStatistics::get_bucket_duration( std::size_t bucket )
+{
+	// upper bound of the bucket, so percentiles are never reported too low
+	return std::chrono::nanoseconds( std::chrono::nanoseconds::rep( MIN_BUCKET_DURATION * std::exp2( DOUBLE( bucket ) / BUCKETS_PER_OCTAVE ) ) );
+}
+
+template<typename Count>
+noxcain::FrameStatistics::Percentiles noxcain::FrameStatistics::get_percentiles( const std::array<Count, BUCKET_COUNT>& counts, std::chrono::nanoseconds max )
+{
+	Percentiles percentiles;
+	for( const Count count : counts )
+	{
+		percentiles.frame_count += count;
+	}
+	percentiles.max = max;
+	if( !percentiles.frame_count )
+	{
+		return percentiles;
+	}
+
+	const std::array<std::pair<DOUBLE, std::chrono::nanoseconds*>, 3> targets =
+	{
+		std::make_pair( 0.50, &percentiles.p50 ),
+		std::make_pair( 0.95, &percentiles.p95 ),
+		std::make_pair( 0.99, &percentiles.p99 )
+	};
+
+	std::size_t target = 0;
+	UINT64 accumulated = 0;
+	for( std::size_t bucket = 0; bucket < BUCKET_COUNT && target < targets.size(); ++bucket )
+	{
+		accumulated += counts[bucket];
+		while( target < targets.size() && accumulated >= std::ceil( targets[target].first * percentiles.frame_count ) )
+		{
+			*targets[target].second = std::min( get_bucket_duration( bucket ), max );
+			++target;
+		}
+	}
+	return percentiles;
+}
+
+void noxcain::write_stage_summary( std::ostream& stream )
+{
+	struct StageTimes
+	{
+		std::string description;
+		std::size_t count = 0;
+		DOUBLE sum = 0.0;
+		DOUBLE min = 0.0;
+		DOUBLE max = 0.0;
+	};
+
+	stream << "stage timings over the last " << TimeFrameCollector::get_history_depth() << " samples [ms]:\n";
+	for( const auto& collection : TimeFrameCollector::get_time_frames() )
+	{
+		std::vector<StageTimes> stages;
+		for( const TimeFrameData& time_frame : collection )
+		{
+			if( time_frame.end == time_frame.start_frame )
+			{
+				// markers have no duration
+				continue;
+			}
+			const DOUBLE duration = std::chrono::duration<DOUBLE, std::milli>( time_frame.end - time_frame.start_frame ).count();
+			auto stage = std::find_if( stages.begin(), stages.end(), [&time_frame]( const StageTimes& times ) { return times.description == time_frame.zone->description; } );
+			if( stage == stages.end() )
+			{
+				stage = stages.insert( stages.end(), { time_frame.zone->description, 0, 0.0, duration, duration } );
+			}
+			++stage->count;
+			stage->sum += duration;
+			stage->min = std::min( stage->min, duration );
+			stage->max = std::max( stage->max, duration );
+		}
+
+		for( const StageTimes& stage : stages )
+		{
+			stream << std::fixed << std::setprecision( 3 ) << "  " << collection.get_description() << " / " << ( stage.description.empty() ? "-" : stage.description )
+				<< ": average " << stage.sum / stage.count << ", min " << stage.min << ", max " << stage.max << ", samples " << stage.count << "\n";
+		}
+	}
+}
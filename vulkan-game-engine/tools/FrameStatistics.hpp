@@ -0,0 +1,116 @@
+#pragma once
+#include <Defines.hpp>
+
+#include <tools/TimeFrame.hpp>
+
+#include <array>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace noxcain
+{
+	/// <summary>
+	/// rolling frame time percentiles from a fixed size log histogram, frames far above the median are kept as hitches
+	/// </summary>
+	class FrameStatistics
+	{
+	public:
+		/// <summary>
+		/// decides which time frames a hitch may be attributed to
+		/// </summary>
+		using ZoneFilter = std::function<bool( const std::string& collection_description, const TimeFrameZoneInfo& zone )>;
+
+		constexpr static std::size_t WINDOW_SIZE = 1024;
+		constexpr static std::size_t HITCH_LOG_SIZE = 256;
+
+		// no hitches are detected before the window has a meaningful median
+		constexpr static std::size_t WARMUP_FRAME_COUNT = 60;
+
+		struct Percentiles
+		{
+			std::chrono::nanoseconds p50 = std::chrono::nanoseconds::zero();
+			std::chrono::nanoseconds p95 = std::chrono::nanoseconds::zero();
+			std::chrono::nanoseconds p99 = std::chrono::nanoseconds::zero();
+			std::chrono::nanoseconds max = std::chrono::nanoseconds::zero();
+			UINT64 frame_count = 0;
+		};
+
+		struct Hitch
+		{
+			UINT64 frame = 0;
+			std::chrono::nanoseconds duration;
+			std::chrono::nanoseconds median;
+
+			// slowest time frame during the hitch, empty if nothing was recorded
+			std::string zone;
+			std::chrono::nanoseconds zone_duration = std::chrono::nanoseconds::zero();
+		};
+
+		FrameStatistics( std::string name, ZoneFilter zone_filter );
+
+		void add_frame( const debugTimePoint& start, const debugTimePoint& end );
+
+		/// <summary>
+		/// a frame is a hitch if it takes longer than factor times the median of the window
+		/// </summary>
+		void set_hitch_factor( DOUBLE factor );
+
+		Percentiles get_window_percentiles() const;
+		Percentiles get_total_percentiles() const;
+		UINT64 get_hitch_count() const;
+
+		/// <summary>
+		/// the most recent hitches, the oldest first
+		/// </summary>
+		std::vector<Hitch> get_hitches() const;
+
+		/// <summary>
+		/// one line with the percentiles of the whole run
+		/// </summary>
+		void write_summary( std::ostream& stream ) const;
+
+		static void write_csv_header( std::ostream& stream );
+
+		/// <summary>
+		/// one row for the whole run and one row per logged hitch
+		/// </summary>
+		void write_csv_rows( std::ostream& stream ) const;
+
+	private:
+		// 16 buckets per octave starting at 10 microseconds, the last bucket takes everything above 10 seconds
+		constexpr static DOUBLE MIN_BUCKET_DURATION = 10000.0;
+		constexpr static std::size_t BUCKETS_PER_OCTAVE = 16;
+		constexpr static std::size_t BUCKET_COUNT = 20 * BUCKETS_PER_OCTAVE + 2;
+
+		const std::string name;
+		const ZoneFilter zone_filter;
+
+		mutable std::mutex statistics_mutex;
+		DOUBLE hitch_factor = 2.0;
+
+		std::array<std::chrono::nanoseconds, WINDOW_SIZE> window = {};
+		std::array<UINT32, BUCKET_COUNT> window_counts = {};
+		std::array<UINT64, BUCKET_COUNT> total_counts = {};
+		std::chrono::nanoseconds total_max = std::chrono::nanoseconds::zero();
+		UINT64 frame_count = 0;
+
+		UINT64 hitch_count = 0;
+		std::deque<Hitch> hitches;
+
+		static std::size_t get_bucket( std::chrono::nanoseconds duration );
+		static std::chrono::nanoseconds get_bucket_duration( std::size_t bucket );
+
+		template<typename Count>
+		static Percentiles get_percentiles( const std::array<Count, BUCKET_COUNT>& counts, std::chrono::nanoseconds max );
+	};
+
+	/// <summary>
+	/// average, min and max of every zone of every collection over the merged time frame history
+	/// </summary>
+	void write_stage_summary( std::ostream& stream );
+}
@@ -1,4 +1,330 @@
 #include <tools/TimeFrame.hpp>
+#include <tools/TimeFrameTrace.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace
+{
+	using namespace noxcain;
+
+	struct ThreadEntry
+	{
+		std::size_t collection_id;
+		TimeFrameData time_frame;
+	};
+
+	/// <summary>
+	/// single producer single consumer ring, written by its thread and read by the merge
+	/// </summary>
+	struct ThreadRing
+	{
+		std::vector<ThreadEntry> entries;
+		std::atomic<std::size_t> write_count = 0;
+		std::atomic<std::size_t> read_count = 0;
+
+		// set by the writing thread when the ring is full, nothing is written into this ring afterwards
+		std::atomic<ThreadRing*> next = nullptr;
+
+		ThreadRing( std::size_t depth ) : entries( std::max<std::size_t>( depth, 1 ) )
+		{
+		}
+	};
+
+	/// <summary>
+	/// chain of rings of one thread, a full ring is followed by a new one instead of waiting for the merge or losing time frames
+	/// </summary>
+	struct ThreadBuffer
+	{
+		// the oldest ring, only used by the merge, rings read empty are freed once a newer one follows
+		ThreadRing* read_ring = nullptr;
+
+		// the newest ring, only used by the writing thread
+		ThreadRing* write_ring = nullptr;
+
+		std::atomic<bool> is_retired = false;
+
+		ThreadBuffer( std::size_t depth ) : read_ring( new ThreadRing( depth ) ), write_ring( read_ring )
+		{
+		}
+
+		ThreadBuffer( const ThreadBuffer& ) = delete;
+		ThreadBuffer& operator=( const ThreadBuffer& ) = delete;
+
+		~ThreadBuffer()
+		{
+			while( read_ring )
+			{
+				delete std::exchange( read_ring, read_ring->next.load( std::memory_order_acquire ) );
+			}
+		}
+	};
+
+	struct Collection
+	{
+		std::string description;
+		std::deque<TimeFrameData> history;
+	};
+
+	struct Registry
+	{
+		std::mutex zone_mutex;
+		std::deque<TimeFrameZoneInfo> zones;
+
+		// only taken when a thread records for the first time and by the merge
+		std::mutex buffer_mutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+		// the merge is the only consumer of the rings and the only writer of the trace
+		std::mutex merge_mutex;
+		TimeFrameTrace trace;
+
+		// merges every few milliseconds while recording, waits for the condition otherwise
+		std::mutex merge_thread_mutex;
+		std::condition_variable merge_thread_condition;
+		std::thread merge_thread;
+		bool is_merge_thread_stopped = false;
+
+		std::mutex history_mutex;
+		std::deque<Collection> collections;
+
+		std::atomic<bool> is_activ = true;
+		std::atomic<bool> is_tracing = false;
+		std::atomic<std::size_t> thread_buffer_depth = 4096;
+		std::atomic<std::size_t> history_depth = 1000;
+	};
+
+	/// <summary>
+	/// never destroyed, threads ending during shutdown may still use it
+	/// </summary>
+	Registry& get_registry()
+	{
+		static Registry* registry = new Registry();
+		return *registry;
+	}
+
+	bool is_recording()
+	{
+		const Registry& registry = get_registry();
+		return registry.is_activ.load( std::memory_order_relaxed ) || registry.is_tracing.load( std::memory_order_relaxed );
+	}
+
+	void merge()
+	{
+		Registry& registry = get_registry();
+		std::unique_lock merge_lock( registry.merge_mutex );
+
+		std::vector<ThreadBuffer*> buffers;
+		{
+			std::unique_lock lock( registry.buffer_mutex );
+			// rings of ended threads are removed once they are read empty
+			registry.buffers.erase( std::remove_if( registry.buffers.begin(), registry.buffers.end(), []( const std::unique_ptr<ThreadBuffer>& buffer )
+			{
+				const ThreadRing* ring = buffer->read_ring;
+				return buffer->is_retired.load( std::memory_order_acquire ) && !ring->next.load( std::memory_order_acquire )
+					&& ring->read_count.load( std::memory_order_relaxed ) == ring->write_count.load( std::memory_order_acquire );
+			} ), registry.buffers.end() );
+
+			buffers.reserve( registry.buffers.size() );
+			for( const auto& buffer : registry.buffers )
+			{
+				buffers.push_back( buffer.get() );
+			}
+		}
+
+		std::vector<ThreadEntry> entries;
+		for( ThreadBuffer* buffer : buffers )
+		{
+			while( true )
+			{
+				// the next ring is loaded first, once it is set the write count of this ring is final
+				ThreadRing& ring = *buffer->read_ring;
+				ThreadRing* next_ring = ring.next.load( std::memory_order_acquire );
+				const std::size_t read_count = ring.read_count.load( std::memory_order_relaxed );
+				const std::size_t write_count = ring.write_count.load( std::memory_order_acquire );
+				for( std::size_t count = read_count; count < write_count; ++count )
+				{
+					entries.push_back( ring.entries[count % ring.entries.size()] );
+				}
+				ring.read_count.store( write_count, std::memory_order_release );
+
+				if( !next_ring )
+				{
+					break;
+				}
+				delete std::exchange( buffer->read_ring, next_ring );
+			}
+		}
+
+		if( entries.empty() )
+		{
+			return;
+		}
+
+		// rings of different threads may hold time frames of the same collection
+		std::stable_sort( entries.begin(), entries.end(), []( const ThreadEntry& first, const ThreadEntry& second )
+		{
+			return first.collection_id < second.collection_id || ( first.collection_id == second.collection_id && first.time_frame.start_frame < second.time_frame.start_frame );
+		} );
+
+		const std::size_t history_depth = registry.history_depth.load( std::memory_order_relaxed );
+		std::unique_lock lock( registry.history_mutex );
+		auto entry = entries.begin();
+		while( entry != entries.end() )
+		{
+			const std::size_t collection_id = entry->collection_id;
+			if( !collection_id || collection_id > registry.collections.size() )
+			{
+				++entry;
+				continue;
+			}
+
+			Collection& collection = registry.collections[collection_id - 1];
+			std::deque<TimeFrameData>& history = collection.history;
+			const std::size_t old_size = history.size();
+			for( ; entry != entries.end() && entry->collection_id == collection_id; ++entry )
+			{
+				history.push_back( entry->time_frame );
+				registry.trace.write( collection_id, collection.description, entry->time_frame );
+			}
+
+			// keeps the history ordered if a late ring delivered older time frames
+			if( old_size && history[old_size].start_frame < history[old_size - 1].start_frame )
+			{
+				std::inplace_merge( history.begin(), history.begin() + old_size, history.end(), []( const TimeFrameData& first, const TimeFrameData& second )
+				{
+					return first.start_frame < second.start_frame;
+				} );
+			}
+
+			if( history.size() > history_depth )
+			{
+				history.erase( history.begin(), history.begin() + ( history.size() - history_depth ) );
+			}
+		}
+		registry.trace.flush();
+	}
+
+	void run_merge_thread()
+	{
+		Registry& registry = get_registry();
+		std::unique_lock lock( registry.merge_thread_mutex );
+		while( !registry.is_merge_thread_stopped )
+		{
+			if( is_recording() )
+			{
+				registry.merge_thread_condition.wait_for( lock, std::chrono::milliseconds( 2 ), [&registry]() { return registry.is_merge_thread_stopped; } );
+			}
+			else
+			{
+				registry.merge_thread_condition.wait( lock, [&registry]() { return registry.is_merge_thread_stopped || is_recording(); } );
+			}
+
+			lock.unlock();
+			merge();
+			lock.lock();
+		}
+	}
+
+	void start_merge_thread()
+	{
+		Registry& registry = get_registry();
+		std::unique_lock lock( registry.merge_thread_mutex );
+		if( !registry.merge_thread.joinable() && !registry.is_merge_thread_stopped )
+		{
+			registry.merge_thread = std::thread( run_merge_thread );
+		}
+	}
+
+	/// <summary>
+	/// has to be called after the recording state changed, a merge thread waiting for the recording to start may continue
+	/// </summary>
+	void notify_merge_thread()
+	{
+		Registry& registry = get_registry();
+		{
+			std::unique_lock lock( registry.merge_thread_mutex );
+		}
+		registry.merge_thread_condition.notify_all();
+	}
+
+	/// <summary>
+	/// stops and joins the merge thread at exit, later time frames are merged by the reading calls
+	/// </summary>
+	struct MergeThreadOwner
+	{
+		~MergeThreadOwner()
+		{
+			Registry& registry = get_registry();
+			std::thread merge_thread;
+			{
+				std::unique_lock lock( registry.merge_thread_mutex );
+				registry.is_merge_thread_stopped = true;
+				merge_thread.swap( registry.merge_thread );
+			}
+			registry.merge_thread_condition.notify_all();
+			if( merge_thread.joinable() )
+			{
+				merge_thread.join();
+			}
+		}
+	} merge_thread_owner;
+
+	/// <summary>
+	/// retires the ring of its thread when the thread ends
+	/// </summary>
+	struct ThreadBufferOwner
+	{
+		ThreadBuffer* buffer = nullptr;
+
+		~ThreadBufferOwner()
+		{
+			if( buffer )
+			{
+				buffer->is_retired.store( true, std::memory_order_release );
+			}
+		}
+	};
+
+	ThreadBuffer& get_thread_buffer()
+	{
+		thread_local ThreadBufferOwner owner;
+		if( !owner.buffer )
+		{
+			Registry& registry = get_registry();
+			auto buffer = std::make_unique<ThreadBuffer>( registry.thread_buffer_depth.load( std::memory_order_relaxed ) );
+			owner.buffer = buffer.get();
+			{
+				std::unique_lock lock( registry.buffer_mutex );
+				registry.buffers.push_back( std::move( buffer ) );
+			}
+			start_merge_thread();
+		}
+		return *owner.buffer;
+	}
+}
+
+noxcain::TimeFrameZone::TimeFrameZone( const std::string& description, DOUBLE red, DOUBLE green, DOUBLE blue, DOUBLE alpha )
+{
+	Registry& registry = get_registry();
+	const std::array<DOUBLE, 4> color = { red, green, blue, alpha };
+
+	std::unique_lock lock( registry.zone_mutex );
+	auto zone = std::find_if( registry.zones.begin(), registry.zones.end(), [&description, &color]( const TimeFrameZoneInfo& zone_info )
+	{
+		return zone_info.description == description && zone_info.color == color;
+	} );
+	if( zone == registry.zones.end() )
+	{
+		zone = registry.zones.insert( registry.zones.end(), { description, color } );
+	}
+	info = &*zone;
+}
 
 noxcain::TimeFrameCollector::TimeFrameCollector()
 {
@@ -6,7 +332,7 @@ noxcain::TimeFrameCollector::TimeFrameCollector()
 
 noxcain::TimeFrameCollector::TimeFrameCollector( std::string name ) : id( TimeFrameCollector::block_id( name ) )
 {
-	
+
 }
 
 noxcain::TimeFrameCollector::TimeFrameCollector( std::size_t blocked_id ) : id( blocked_id )
@@ -22,140 +348,214 @@ void noxcain::TimeFrameCollector::name_collection( std::string name )
 	}
 }
 
-void noxcain::TimeFrameCollector::start_frame( DOUBLE red, DOUBLE green, DOUBLE blue, DOUBLE alpha, const std::string& description )
+void noxcain::TimeFrameCollector::push( std::size_t collection_id, const TimeFrameData& time_frame )
 {
-	if( id && is_activ )
+	ThreadBuffer& buffer = get_thread_buffer();
+	ThreadRing* ring = buffer.write_ring;
+	std::size_t write_count = ring->write_count.load( std::memory_order_relaxed );
+	if( write_count - ring->read_count.load( std::memory_order_acquire ) >= ring->entries.size() )
 	{
-		current_time_frame.start_frame = std::chrono::steady_clock::now();
-		current_time_frame.color = { red, green, blue, alpha };
-		current_time_frame.description = description;
+		// the merge thread fell behind, waiting for it would stall the recording thread on the trace output
+		ThreadRing* next_ring = new ThreadRing( get_registry().thread_buffer_depth.load( std::memory_order_relaxed ) );
+		ring->next.store( next_ring, std::memory_order_release );
+		buffer.write_ring = ring = next_ring;
+		write_count = 0;
+	}
+	ring->entries[write_count % ring->entries.size()] = { collection_id, time_frame };
+	ring->write_count.store( write_count + 1, std::memory_order_release );
+}
+
+void noxcain::TimeFrameCollector::start_frame( const TimeFrameZone& zone )
+{
+	if( id && is_recording() )
+	{
+		current_start = std::chrono::steady_clock::now();
+		current_zone = zone.get_info();
 	}
 }
 
 void noxcain::TimeFrameCollector::end_frame()
 {
-	if( id && is_activ && current_time_frame.start_frame.time_since_epoch().count() )
+	if( id && current_zone )
 	{
-		current_time_frame.end = std::chrono::steady_clock::now();
-		if( frame_mutex.try_lock() )
+		if( is_recording() )
 		{
-			collections[id-1]->add( current_time_frame );
-			frame_mutex.unlock();
+			push( id, { current_zone, current_start, std::chrono::steady_clock::now() } );
 		}
-		current_time_frame.start_frame = std::chrono::steady_clock::time_point();
+		current_zone = nullptr;
 	}
 }
 
-void noxcain::TimeFrameCollector::end_is_start( DOUBLE red, DOUBLE green, DOUBLE blue, DOUBLE alpha, const std::string& description )
+void noxcain::TimeFrameCollector::end_is_start( const TimeFrameZone& zone )
 {
-	if( id && is_activ )
+	if( id && is_recording() )
 	{
-		current_time_frame.end = std::chrono::steady_clock::now();
-		if( current_time_frame.start_frame.time_since_epoch().count() )
+		const debugTimePoint now = std::chrono::steady_clock::now();
+		if( current_zone )
 		{
-			if( frame_mutex.try_lock() )
-			{
-				collections[id-1]->add( current_time_frame );
-				frame_mutex.unlock();
-			}
+			push( id, { current_zone, current_start, now } );
 		}
-		current_time_frame.description = description;
-		current_time_frame.color = { red, green, blue, alpha };
-		current_time_frame.start_frame = current_time_frame.end;
+		current_zone = zone.get_info();
+		current_start = now;
 	}
 }
 
-void noxcain::TimeFrameCollector::add_time_frame( const debugTimePoint& start_frame, const debugTimePoint& end, DOUBLE red, DOUBLE green, DOUBLE blue, DOUBLE alpha, const std::string& description )
+void noxcain::TimeFrameCollector::add_time_frame( const debugTimePoint& start_frame, const debugTimePoint& end, const TimeFrameZone& zone )
 {
-	if( id && is_activ && frame_mutex.try_lock() )
+	if( id && is_recording() )
 	{
-		collections[id-1]->add( TimeFrameData( 
-			{
-				description,
-				{red,green,blue,alpha},
-				start_frame,
-				end 
-			} ) );
-		frame_mutex.unlock();
+		push( id, { zone.get_info(), start_frame, end } );
+	}
+}
+
+void noxcain::TimeFrameCollector::add_marker( const TimeFrameZone& zone )
+{
+	if( id && is_recording() )
+	{
+		const debugTimePoint now = std::chrono::steady_clock::now();
+		push( id, { zone.get_info(), now, now } );
 	}
 }
 
 std::size_t noxcain::TimeFrameCollector::block_id( const std::string& description )
 {
-	std::unique_lock lock( frame_mutex );
-	collections.emplace_back( new TimeFrameCollection( description ) );
-	return collections.size();
+	Registry& registry = get_registry();
+	std::unique_lock lock( registry.history_mutex );
+	registry.collections.push_back( { description, {} } );
+	return registry.collections.size();
 }
 
-const std::vector<std::unique_ptr<noxcain::TimeFrameCollection>>& noxcain::TimeFrameCollector::get_time_frames()
+std::vector<noxcain::TimeFrameCollection> noxcain::TimeFrameCollector::get_time_frames()
 {
+	merge();
+
+	Registry& registry = get_registry();
+	std::unique_lock lock( registry.history_mutex );
+	std::vector<TimeFrameCollection> collections( registry.collections.size() );
+	for( std::size_t index = 0; index < collections.size(); ++index )
+	{
+		collections[index].description = registry.collections[index].description;
+		collections[index].time_frames.assign( registry.collections[index].history.begin(), registry.collections[index].history.end() );
+	}
 	return collections;
 }
 
+bool noxcain::TimeFrameCollector::find_longest_time_frame( const debugTimePoint& start, const debugTimePoint& end, const std::function<bool( const std::string& collection_description, const TimeFrameZoneInfo& zone )>& filter,
+															 TimeFrameData& longest_time_frame, std::string& collection_description )
+{
+	merge();
+
+	Registry& registry = get_registry();
+	std::unique_lock lock( registry.history_mutex );
+	debugTimePoint::duration longest_overlap = debugTimePoint::duration::zero();
+	for( const Collection& collection : registry.collections )
+	{
+		for( const TimeFrameData& time_frame : collection.history )
+		{
+			if( time_frame.start_frame >= end )
+			{
+				// the history is ordered by start
+				break;
+			}
+			const debugTimePoint::duration overlap = std::min( end, time_frame.end ) - std::max( start, time_frame.start_frame );
+			if( overlap > longest_overlap && time_frame.end != time_frame.start_frame && filter( collection.description, *time_frame.zone ) )
+			{
+				longest_overlap = overlap;
+				longest_time_frame = time_frame;
+				collection_description = collection.description;
+			}
+		}
+	}
+	return longest_overlap > debugTimePoint::duration::zero();
+}
+
 void noxcain::TimeFrameCollector::activate()
 {
-	std::unique_lock lock( frame_mutex );
-	is_activ = true;
+	get_registry().is_activ.store( true, std::memory_order_relaxed );
+	notify_merge_thread();
 }
 
 void noxcain::TimeFrameCollector::deactivate()
 {
-	std::unique_lock lock( frame_mutex );
-	is_activ = false;
+	get_registry().is_activ.store( false, std::memory_order_relaxed );
 }
 
-noxcain::TimeFrameCollection::TimeFrameCollection( const std::string& name ) : description( name ), count( 0 )
+bool noxcain::TimeFrameCollector::start_trace( const std::string& file_name )
 {
+	// time frames recorded before the start stay out of the trace
+	merge();
+
+	Registry& registry = get_registry();
+	{
+		std::unique_lock lock( registry.merge_mutex );
+		if( !registry.trace.open( file_name, std::chrono::steady_clock::now() ) )
+		{
+			return false;
+		}
+	}
+	registry.is_tracing.store( true, std::memory_order_relaxed );
+	start_merge_thread();
+	notify_merge_thread();
+	return true;
 }
 
-std::size_t noxcain::TimeFrameCollection::add( const TimeFrameData& time_frame )
+void noxcain::TimeFrameCollector::stop_trace()
 {
-	dataBuffer[count % MAX_TIME_FRAMES] = time_frame;
-	return ++count;
+	Registry& registry = get_registry();
+	registry.is_tracing.store( false, std::memory_order_relaxed );
+	merge();
+
+	std::unique_lock lock( registry.merge_mutex );
+	registry.trace.close();
 }
 
-inline noxcain::TimeFrameCollection::ConstIterator::ConstIterator( const TimeFrameCollection& base_collection, std::size_t index ) : collection( base_collection ), index( index )
+bool noxcain::TimeFrameCollector::is_tracing()
 {
+	return get_registry().is_tracing.load( std::memory_order_relaxed );
 }
 
-noxcain::TimeFrameCollection::ConstIterator noxcain::TimeFrameCollection::begin() const
+void noxcain::TimeFrameCollector::add_counters( const std::string& name, const std::vector<std::pair<std::string, UINT64>>& values )
 {
-	return ConstIterator( *this, 0 );
+	Registry& registry = get_registry();
+	if( !registry.is_tracing.load( std::memory_order_relaxed ) )
+	{
+		return;
+	}
+
+	// counters are written right away, the next merge flushes them
+	const debugTimePoint time = std::chrono::steady_clock::now();
+	std::unique_lock lock( registry.merge_mutex );
+	registry.trace.write_counters( name, time, values );
 }
 
-noxcain::TimeFrameCollection::ConstIterator noxcain::TimeFrameCollection::end() const
+void noxcain::TimeFrameCollector::set_thread_buffer_depth( std::size_t depth )
 {
-	return ConstIterator( *this, std::min( MAX_TIME_FRAMES, count ) );
+	get_registry().thread_buffer_depth.store( depth, std::memory_order_relaxed );
 }
 
-noxcain::TimeFrameCollection::ConstIterator& noxcain::TimeFrameCollection::ConstIterator::operator++()
+void noxcain::TimeFrameCollector::set_history_depth( std::size_t depth )
 {
-	++index;
-	return *this;
+	get_registry().history_depth.store( depth, std::memory_order_relaxed );
 }
 
-bool noxcain::TimeFrameCollection::ConstIterator::operator!=( const ConstIterator& other ) const
+std::size_t noxcain::TimeFrameCollector::get_history_depth()
 {
-	return &other.collection != &collection || other.index != index;
+	return get_registry().history_depth.load( std::memory_order_relaxed );
 }
 
-const noxcain::TimeFrameData& noxcain::TimeFrameCollection::ConstIterator::operator*() const
+noxcain::TimeFrameCollection::ConstIterator noxcain::TimeFrameCollection::begin() const
 {
-	return collection.dataBuffer[( ( collection.count > MAX_TIME_FRAMES ? collection.count % MAX_TIME_FRAMES : 0 ) + index ) % MAX_TIME_FRAMES];
+	return time_frames.begin();
 }
 
-const noxcain::TimeFrameData* noxcain::TimeFrameCollection::ConstIterator::operator->() const
+noxcain::TimeFrameCollection::ConstIterator noxcain::TimeFrameCollection::end() const
 {
-	return &( operator*() );
+	return time_frames.end();
 }
 
-std::vector<std::unique_ptr<noxcain::TimeFrameCollection>> noxcain::TimeFrameCollector::collections;
-std::mutex noxcain::TimeFrameCollector::frame_mutex;
-bool noxcain::TimeFrameCollector::is_activ = true;
-
-noxcain::TimeFrame::TimeFrame( TimeFrameCollector& frame_collector, DOUBLE red, DOUBLE green, DOUBLE blue, DOUBLE alpha, const std::string& description ) : collector( frame_collector )
+noxcain::TimeFrame::TimeFrame( TimeFrameCollector& frame_collector, const TimeFrameZone& zone ) : collector( frame_collector )
 {
-	collector.start_frame( red, green, blue, alpha, description );
+	collector.start_frame( zone );
 }
 
 noxcain::TimeFrame::~TimeFrame()
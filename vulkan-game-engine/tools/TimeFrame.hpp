@@ -6,45 +6,57 @@
 #include <mutex>
 #include <string>
 #include <array>
+#include <functional>
+#include <utility>
 
 namespace noxcain
 {
 	typedef std::chrono::time_point<std::chrono::steady_clock> debugTimePoint;
 
-	constexpr static std::size_t MAX_TIME_FRAMES = 100;
-
-	struct TimeFrameData
+	/// <summary>
+	/// description and color of a zone, interned once and never moved or freed
+	/// </summary>
+	struct TimeFrameZoneInfo
 	{
 		std::string description;
 		std::array<DOUBLE, 4> color;
+	};
+
+	/// <summary>
+	/// handle of an interned zone, should be created once, e.g. as static local, recording with it copies no strings
+	/// </summary>
+	class TimeFrameZone
+	{
+	public:
+		TimeFrameZone( const std::string& description, DOUBLE red, DOUBLE green, DOUBLE blue, DOUBLE alpha = 1.0 );
+
+		const TimeFrameZoneInfo* get_info() const
+		{
+			return info;
+		}
+
+	private:
+		const TimeFrameZoneInfo* info;
+	};
+
+	struct TimeFrameData
+	{
+		const TimeFrameZoneInfo* zone = nullptr;
 		debugTimePoint start_frame;
 		debugTimePoint end;
 	};
 
+	/// <summary>
+	/// copy of the merged time frames of one collector, ordered by start
+	/// </summary>
 	class TimeFrameCollection
 	{
 		friend class TimeFrameCollector;
-		
-		TimeFrameCollection( const std::string& name );
-		std::size_t add( const TimeFrameData& time_frame );
 
 		std::string description;
-		std::array<TimeFrameData, MAX_TIME_FRAMES> dataBuffer;
-		std::size_t count;
+		std::vector<TimeFrameData> time_frames;
 	public:
-
-		class ConstIterator
-		{
-			friend class TimeFrameCollection;
-			const TimeFrameCollection& collection;
-			std::size_t index = 0;
-			ConstIterator( const TimeFrameCollection& base_collection, std::size_t index );
-		public:
-			ConstIterator& operator++();
-			bool operator!=( const ConstIterator& other ) const;
-			const TimeFrameData& operator*() const;
-			const TimeFrameData* operator->() const;
-		};
+		using ConstIterator = std::vector<TimeFrameData>::const_iterator;
 
 		const std::string& get_description() const
 		{
@@ -55,39 +67,82 @@ namespace noxcain
 		ConstIterator end() const;
 	};
 
+	/// <summary>
+	/// records time frames into a lock free ring buffer of the calling thread, a merge thread moves them into the collections
+	/// </summary>
+	/// <remarks>one collector must only be used by one thread at a time</remarks>
 	class TimeFrameCollector
 	{
 	private:
-		static std::vector<std::unique_ptr<TimeFrameCollection>> collections;
-		static std::mutex frame_mutex;
-		static bool is_activ;
-
 		std::size_t id = 0;
-		TimeFrameData current_time_frame;
+		const TimeFrameZoneInfo* current_zone = nullptr;
+		debugTimePoint current_start;
+
+		static void push( std::size_t collection_id, const TimeFrameData& time_frame );
 	public:
 		TimeFrameCollector();
 		TimeFrameCollector( std::string name );
 		TimeFrameCollector( std::size_t id );
-		
+
 		void name_collection( std::string name );
-		void start_frame( DOUBLE red, DOUBLE green, DOUBLE blue, DOUBLE alpha = 1.0, const std::string& description = "" );
+		void start_frame( const TimeFrameZone& zone );
 		void end_frame();
-		void end_is_start( DOUBLE red, DOUBLE green, DOUBLE blue, DOUBLE alpha = 1.0, const std::string& description = "" );
-		void add_time_frame( const debugTimePoint& start_frame, const debugTimePoint& end, DOUBLE red, DOUBLE green, DOUBLE blue, DOUBLE alpha = 1.0, const std::string& description = "" );
+		void end_is_start( const TimeFrameZone& zone );
+		void add_time_frame( const debugTimePoint& start_frame, const debugTimePoint& end, const TimeFrameZone& zone );
+
+		/// <summary>
+		/// records a time frame without length, e.g. the start of a frame
+		/// </summary>
+		void add_marker( const TimeFrameZone& zone );
 
 		static std::size_t block_id( const std::string& description );
 
-		static const std::vector<std::unique_ptr<TimeFrameCollection>>& get_time_frames();
+		/// <summary>
+		/// merges all pending time frames and copies the collections
+		/// </summary>
+		static std::vector<TimeFrameCollection> get_time_frames();
 		static void activate();
 		static void deactivate();
+
+		/// <summary>
+		/// merges all pending time frames and searches the time frame with the longest overlap of start and end
+		/// </summary>
+		/// <param name="filter">only time frames it accepts are considered, markers never are</param>
+		/// <returns>false if no accepted time frame overlaps</returns>
+		static bool find_longest_time_frame( const debugTimePoint& start, const debugTimePoint& end, const std::function<bool( const std::string& collection_description, const TimeFrameZoneInfo& zone )>& filter,
+											 TimeFrameData& longest_time_frame, std::string& collection_description );
+
+		/// <summary>
+		/// streams all time frames merged from now on into a chrome trace file, time frames are recorded while tracing even if deactivated
+		/// </summary>
+		/// <returns>false if the file can not be written</returns>
+		static bool start_trace( const std::string& file_name );
+		static void stop_trace();
+		static bool is_tracing();
+
+		/// <summary>
+		/// writes the values as counter track into the trace, nothing is written if not tracing
+		/// </summary>
+		static void add_counters( const std::string& name, const std::vector<std::pair<std::string, UINT64>>& values );
+
+		/// <summary>
+		/// capacity of ring buffers created from now on, a full ring is followed by another one of this capacity until the merge read it
+		/// </summary>
+		static void set_thread_buffer_depth( std::size_t depth );
+
+		/// <summary>
+		/// number of time frames each collection keeps after merging
+		/// </summary>
+		static void set_history_depth( std::size_t depth );
+		static std::size_t get_history_depth();
 	};
 
 	class TimeFrame
 	{
 	public:
-		TimeFrame( TimeFrameCollector& frame, DOUBLE red, DOUBLE green, DOUBLE blue, DOUBLE alpha = 1.0, const std::string& description = "" );
+		TimeFrame( TimeFrameCollector& frame, const TimeFrameZone& zone );
 		~TimeFrame();
 	private:
 		TimeFrameCollector& collector;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,146 @@
+#include <tools/TimeFrameTrace.hpp>
+
+#include <iomanip>
+
+namespace
+{
+	void write_json_string( std::ostream& stream, const std::string& text )
+	{
+		stream << '"';
+		for( const char character : text )
+		{
+			switch( character )
+			{
+				case '"': stream << "\\\""; break;
+				case '\\': stream << "\\\\"; break;
+				case '\n': stream << "\\n"; break;
+				case '\t': stream << "\\t"; break;
+				default:
+					if( static_cast<unsigned char>( character ) < 0x20 )
+					{
+						stream << "\\u" << std::hex << std::setw( 4 ) << std::setfill( '0' ) << int( character ) << std::dec << std::setfill( ' ' );
+					}
+					else
+					{
+						stream << character;
+					}
+			}
+		}
+		stream << '"';
+	}
+
+	noxcain::DOUBLE to_microseconds( const std::chrono::steady_clock::duration& duration )
+	{
+		return std::chrono::duration<noxcain::DOUBLE, std::micro>( duration ).count();
+	}
+}
+
+bool noxcain::TimeFrameTrace::open( const std::string& file_name, const debugTimePoint& trace_start_time )
+{
+	close();
+
+	file.open( file_name, std::ios::out | std::ios::trunc );
+	if( !file )
+	{
+		return false;
+	}
+
+	start_time = trace_start_time;
+	named_tracks.clear();
+	is_first_event = true;
+
+	// the array format stays readable if the process ends before the trace is closed
+	file << std::fixed << std::setprecision( 3 ) << "[\n";
+	begin_event();
+	file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"noxcain\"}}";
+	return true;
+}
+
+void noxcain::TimeFrameTrace::close()
+{
+	if( file.is_open() )
+	{
+		file << "\n]\n";
+		file.close();
+	}
+}
+
+void noxcain::TimeFrameTrace::write( std::size_t collection_id, const std::string& collection_description, const TimeFrameData& time_frame )
+{
+	if( !file.is_open() || !time_frame.zone || time_frame.end < start_time )
+	{
+		return;
+	}
+
+	if( collection_id >= named_tracks.size() )
+	{
+		named_tracks.resize( collection_id + 1, false );
+	}
+	if( !named_tracks[collection_id] )
+	{
+		named_tracks[collection_id] = true;
+		begin_event();
+		file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << collection_id << ",\"args\":{\"name\":";
+		write_json_string( file, collection_description );
+		file << "}}";
+		begin_event();
+		file << "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":" << collection_id << ",\"args\":{\"sort_index\":" << collection_id << "}}";
+	}
+
+	begin_event();
+	file << "{\"name\":";
+	write_json_string( file, time_frame.zone->description.empty() ? collection_description : time_frame.zone->description );
+	file << ",\"cat\":";
+	write_json_string( file, collection_description );
+	if( time_frame.end == time_frame.start_frame )
+	{
+		file << ",\"ph\":\"i\",\"s\":\"t\"";
+	}
+	else
+	{
+		file << ",\"ph\":\"X\",\"dur\":" << to_microseconds( time_frame.end - time_frame.start_frame );
+	}
+	file << ",\"ts\":" << to_microseconds( time_frame.start_frame - start_time ) << ",\"pid\":1,\"tid\":" << collection_id << "}";
+}
+
+void noxcain::TimeFrameTrace::write_counters( const std::string& name, const debugTimePoint& time, const std::vector<std::pair<std::string, UINT64>>& values )
+{
+	if( !file.is_open() || time < start_time )
+	{
+		return;
+	}
+
+	begin_event();
+	file << "{\"name\":";
+	write_json_string( file, name );
+	file << ",\"ph\":\"C\",\"ts\":" << to_microseconds( time - start_time ) << ",\"pid\":1,\"args\":{";
+	for( std::size_t index = 0; index < values.size(); ++index )
+	{
+		if( index ) file << ",";
+		write_json_string( file, values[index].first );
+		file << ":" << values[index].second;
+	}
+	file << "}}";
+}
+
+void noxcain::TimeFrameTrace::flush()
+{
+	if( file.is_open() )
+	{
+		file.flush();
+	}
+}
+
+noxcain::TimeFrameTrace::operator bool() const
+{
+	return file.is_open();
+}
+
+void noxcain::TimeFrameTrace::begin_event()
+{
+	if( !is_first_event )
+	{
+		file << ",\n";
+	}
+	is_first_event = false;
+}
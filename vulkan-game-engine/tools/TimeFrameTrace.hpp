@@ -0,0 +1,48 @@
+#pragma once
+#include <Defines.hpp>
+
+#include <tools/TimeFrame.hpp>
+
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace noxcain
+{
+	/// <summary>
+	/// streams time frames as chrome trace events, readable by chrome://tracing and ui.perfetto.dev
+	/// </summary>
+	/// <remarks>every collection becomes one track, zero length time frames become instant events</remarks>
+	class TimeFrameTrace
+	{
+	public:
+		bool open( const std::string& file_name, const debugTimePoint& start_time );
+		void close();
+
+		/// <summary>
+		/// time frames that ended before the trace was opened are skipped
+		/// </summary>
+		void write( std::size_t collection_id, const std::string& collection_description, const TimeFrameData& time_frame );
+
+		/// <summary>
+		/// one counter track per name, every value is drawn as its own series
+		/// </summary>
+		void write_counters( const std::string& name, const debugTimePoint& time, const std::vector<std::pair<std::string, UINT64>>& values );
+
+		/// <summary>
+		/// hands the written events to the file, the trace only buffers what is written between two flushes
+		/// </summary>
+		void flush();
+
+		explicit operator bool() const;
+
+	private:
+		std::ofstream file;
+		debugTimePoint start_time;
+		std::vector<bool> named_tracks;
+		bool is_first_event = true;
+
+		void begin_event();
+	};
+}
@@ -0,0 +1,161 @@
+#include "Utf8Decoder.hpp"
+
+#if defined( __AVX2__ )
+#include <immintrin.h>
+#define NX_UTF8_AVX2
+#elif defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#include <emmintrin.h>
+#define NX_UTF8_SSE2
+#elif defined( __ARM_NEON ) && defined( __aarch64__ )
+#include <arm_neon.h>
+#define NX_UTF8_NEON
+#endif
+
+namespace
+{
+	using noxcain::BYTE;
+	using noxcain::UINT32;
+
+	/// <summary>
+	/// widens the ascii bytes at the front of the input, stops in front of the first block with a non ascii byte or '\0'
+	/// </summary>
+	std::size_t widen_ascii( const BYTE* input, std::size_t size, UINT32* output )
+	{
+		std::size_t position = 0;
+#if defined( NX_UTF8_AVX2 )
+		const __m256i zero = _mm256_setzero_si256();
+		for( ; position + 32 <= size; position += 32 )
+		{
+			const __m256i bytes = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( input + position ) );
+			if( _mm256_movemask_epi8( bytes ) | _mm256_movemask_epi8( _mm256_cmpeq_epi8( bytes, zero ) ) )
+			{
+				break;
+			}
+			for( std::size_t offset = 0; offset < 32; offset += 8 )
+			{
+				const __m128i eight_bytes = _mm_loadl_epi64( reinterpret_cast<const __m128i*>( input + position + offset ) );
+				_mm256_storeu_si256( reinterpret_cast<__m256i*>( output + position + offset ), _mm256_cvtepu8_epi32( eight_bytes ) );
+			}
+		}
+#elif defined( NX_UTF8_SSE2 )
+		const __m128i zero = _mm_setzero_si128();
+		for( ; position + 16 <= size; position += 16 )
+		{
+			const __m128i bytes = _mm_loadu_si128( reinterpret_cast<const __m128i*>( input + position ) );
+			if( _mm_movemask_epi8( bytes ) | _mm_movemask_epi8( _mm_cmpeq_epi8( bytes, zero ) ) )
+			{
+				break;
+			}
+			const __m128i low = _mm_unpacklo_epi8( bytes, zero );
+			const __m128i high = _mm_unpackhi_epi8( bytes, zero );
+			__m128i* target = reinterpret_cast<__m128i*>( output + position );
+			_mm_storeu_si128( target, _mm_unpacklo_epi16( low, zero ) );
+			_mm_storeu_si128( target + 1, _mm_unpackhi_epi16( low, zero ) );
+			_mm_storeu_si128( target + 2, _mm_unpacklo_epi16( high, zero ) );
+			_mm_storeu_si128( target + 3, _mm_unpackhi_epi16( high, zero ) );
+		}
+#elif defined( NX_UTF8_NEON )
+		for( ; position + 16 <= size; position += 16 )
+		{
+			const uint8x16_t bytes = vld1q_u8( input + position );
+			if( vmaxvq_u8( bytes ) >= 0x80 || vminvq_u8( bytes ) == 0 )
+			{
+				break;
+			}
+			const uint16x8_t low = vmovl_u8( vget_low_u8( bytes ) );
+			const uint16x8_t high = vmovl_u8( vget_high_u8( bytes ) );
+			vst1q_u32( output + position, vmovl_u16( vget_low_u16( low ) ) );
+			vst1q_u32( output + position + 4, vmovl_u16( vget_high_u16( low ) ) );
+			vst1q_u32( output + position + 8, vmovl_u16( vget_low_u16( high ) ) );
+			vst1q_u32( output + position + 12, vmovl_u16( vget_high_u16( high ) ) );
+		}
+#endif
+		return position;
+	}
+}
+
+bool noxcain::decode_utf8( std::string_view utf8, std::vector<UINT32>& unicodes )
+{
+	// every byte creates at most one unicode
+	unicodes.resize( utf8.size() );
+
+	const BYTE* input = reinterpret_cast<const BYTE*>( utf8.data() );
+	const std::size_t size = utf8.size();
+	UINT32* output = unicodes.data();
+
+	bool valid = true;
+	std::size_t position = 0;
+	while( position < size )
+	{
+		// the fast path only runs over full blocks, the remainder and everything else is decoded bytewise
+		const std::size_t ascii_count = widen_ascii( input + position, size - position, output );
+		position += ascii_count;
+		output += ascii_count;
+		if( position >= size )
+		{
+			break;
+		}
+
+		const BYTE lead = input[position];
+		if( lead < 0x80 )
+		{
+			if( lead == 0 )
+			{
+				break;
+			}
+			*output++ = lead;
+			++position;
+			continue;
+		}
+
+		// sequence length and the allowed range of the second byte excludes overlong forms and surrogates
+		std::size_t length = 0;
+		BYTE second_min = 0x80;
+		BYTE second_max = 0xBF;
+		if( lead >= 0xC2 && lead <= 0xDF )
+		{
+			length = 2;
+		}
+		else if( lead >= 0xE0 && lead <= 0xEF )
+		{
+			length = 3;
+			if( lead == 0xE0 ) second_min = 0xA0;
+			if( lead == 0xED ) second_max = 0x9F;
+		}
+		else if( lead >= 0xF0 && lead <= 0xF4 )
+		{
+			length = 4;
+			if( lead == 0xF0 ) second_min = 0x90;
+			if( lead == 0xF4 ) second_max = 0x8F;
+		}
+
+		UINT32 unicode = length ? lead & ( 0x7F >> length ) : 0;
+		std::size_t consumed = 1;
+		for( ; consumed < length && position + consumed < size; ++consumed )
+		{
+			const BYTE continuation = input[position + consumed];
+			const BYTE min = consumed == 1 ? second_min : 0x80;
+			const BYTE max = consumed == 1 ? second_max : 0xBF;
+			if( continuation < min || continuation > max )
+			{
+				break;
+			}
+			unicode = ( unicode << 6 ) | ( continuation & 0x3F );
+		}
+
+		if( length && consumed == length )
+		{
+			*output++ = unicode;
+		}
+		else
+		{
+			// invalid lead, truncated or broken sequence, the offending byte starts the next sequence
+			*output++ = UNICODE_REPLACEMENT_CHARACTER;
+			valid = false;
+		}
+		position += consumed;
+	}
+
+	unicodes.resize( output - unicodes.data() );
+	return valid;
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <Defines.hpp>
+
+#include <string_view>
+#include <vector>
+
+namespace noxcain
+{
+	/// <summary>
+	/// replaces every maximal invalid subsequence of the utf-8 input
+	/// </summary>
+	constexpr UINT32 UNICODE_REPLACEMENT_CHARACTER = 0xFFFD;
+
+	/// <summary>
+	/// validating utf-8 to utf-32 decoder, runs of ascii are widened 16 or 32 bytes at once
+	/// </summary>
+	/// <param name="unicodes">is overwritten and keeps its capacity, decoding stops at the first '\0'</param>
+	/// <returns>false if invalid sequences were replaced</returns>
+	bool decode_utf8( std::string_view utf8, std::vector<UINT32>& unicodes );
+}